@@ -105,3 +105,48 @@ C_INTERFACE GenerateGraphObstacles(
 	*out_graph = G;
 	return OK;
 }
+
+C_INTERFACE GenerateGraphWithCosts(
+	HF::RayTracer::EmbreeRayTracer* ray_tracer,
+	const float* start_point,
+	const float* spacing,
+	int MaxNodes,
+	float UpStep,
+	float UpSlope,
+	float DownStep,
+	float DownSlope,
+	int max_step_connections,
+	int min_connections,
+	int core_count,
+	int inline_costs,
+	Graph** out_graph
+) {
+	const std::array<float, 3> start_array{ start_point[0], start_point[1], start_point[2] };
+	const std::array<double, 3> spacing_array{ spacing[0], spacing[1], spacing[2] };
+
+	Graph* G = new Graph();
+	GraphGenerator GraphGen(*ray_tracer);
+	*G = GraphGen.BuildNetwork(
+		start_array,
+		spacing_array,
+		MaxNodes,
+		UpStep,
+		UpSlope,
+		DownStep,
+		DownSlope,
+		max_step_connections,
+		min_connections,
+		core_count,
+		HF::GraphGenerator::default_z_precision,
+		HF::GraphGenerator::default_spacing_precision,
+		HF::GraphGenerator::default_ground_offset,
+		inline_costs
+	);
+
+	if (G->Nodes().size() < 1) {
+		delete G;
+		return HF_STATUS::NO_GRAPH;
+	}
+	*out_graph = G;
+	return OK;
+}
@@ -223,6 +223,56 @@ C_INTERFACE GenerateGraphObstacles(
 	HF::SpatialStructures::Graph** out_graph
 );
 
+/*!
+	\brief		Construct a graph like \link GenerateGraph \endlink, calculating alternate costs for every edge as it's created
+
+	\param		ray_tracer				Raytracer containing the geometry to use for graph generation.
+	\param		start_point				The starting point for the graph generator to begin searching from.
+	\param		spacing					Space between nodes for each step of the search.
+	\param		MaxNodes				Stop generation after this many nodes. A value of -1 will generate an infinite amount of nodes.
+	\param		UpStep					Maximum height of a step the graph can traverse.
+	\param		UpSlope					Maximum upward slope the graph can traverse in degrees.
+	\param		DownStep				Maximum step down the graph can traverse.
+	\param		DownSlope				The maximum downward slope the graph can traverse.
+	\param		max_step_connection		Multiplier for number of children to generate for each node.
+	\param		min_connections			The required out-degree for a node to be valid and stored.
+	\param		core_count				Number of cores to use. -1 will use all available cores,
+										and 0 or 1 will run a serialized version of the algorithm.
+
+	\param		inline_costs			\link HF::GraphGenerator::INLINE_COST \endlink flags of the costs to calculate,
+										combined with |. 1 calculates "EnergyExpenditure", 2 calculates "CrossSlope",
+										and 4 calculates "Slope". Step types are always stored, and can be turned
+										into a cost with \link CreateStepCost \endlink.
+
+	\param		out_graph				Address of a (\link HF::SpatialStructures::Graph \endlink *);
+										*out_graph will address heap-allocated memory to an initialized
+										\link HF::SpatialStructures::Graph \endlink on success.
+
+	\returns	\link HF_STATUS::OK \endlink if graph creation was successful.
+				\link HF_STATUS::NO_GRAPH \endlink if \link GenerateGraphWithCosts \endlink failed to generate a graph with more than a single node.
+
+	\details
+	Each selected cost is calculated while its edges are generated and stored in the graph as an
+	alternate cost array with the name listed above, so it can be read with GetEdgesForNode, GetCSRPointers
+	or any pathfinding function that accepts a cost type, without a call to CalculateAndStoreEnergyExpenditure
+	or CalculateAndStoreCrossSlope. If inline_costs isn't 0, the graph is compressed before it's returned.
+*/
+C_INTERFACE GenerateGraphWithCosts(
+	HF::RayTracer::EmbreeRayTracer* ray_tracer,
+	const float* start_point,
+	const float* spacing,
+	int MaxNodes,
+	float UpStep,
+	float UpSlope,
+	float DownStep,
+	float DownSlope,
+	int max_step_connection,
+	int min_connections,
+	int core_count,
+	int inline_costs,
+	HF::SpatialStructures::Graph** out_graph
+);
+
 /**@}*/
 
 #endif /* ANALYSIS_C_H */
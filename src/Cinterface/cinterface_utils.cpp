@@ -1,5 +1,6 @@
 #include <cinterface_utils.h>
 #include <HFExceptions.h>
+#include <parallelism.h>
 
 
 std::vector<std::array<float, 3>> ConvertRawFloatArrayToPoints(const float* raw_array, int size) {
@@ -41,3 +42,12 @@ C_INTERFACE DestroyCharArray(char* char_array) {
 	return HF::Exceptions::HF_STATUS::OK;
 }
 
+C_INTERFACE SetThreadCount(int threads) {
+	HF::Parallel::SetThreadCount(threads);
+	return HF::Exceptions::HF_STATUS::OK;
+}
+
+C_INTERFACE GetThreadCount(int* out_threads) {
+	*out_threads = HF::Parallel::GetThreadCount();
+	return HF::Exceptions::HF_STATUS::OK;
+}
@@ -88,6 +88,30 @@ C_INTERFACE DestroyIntVector(std::vector<int>* int_vector);
 
 C_INTERFACE DestroyCharArray(char* char_array);
 
+/*!
+	\brief Set the maximum number of threads DHARTAPI may use at once.
+
+	\param threads Number of threads. If less than 1, every hardware thread is used.
+
+	\returns `HF_STATUS.OK` on completion.
+
+	\details Applies to every analysis started after this is called, and to the BVHs of raytracers
+	created after this is called. Analyses running at the same time share this many threads.
+
+	\see HF::Parallel for details on how threads are divided between analyses.
+*/
+C_INTERFACE SetThreadCount(int threads);
+
+/*!
+	\brief Get the maximum number of threads DHARTAPI may use at once.
+
+	\param out_threads Set to the count given to SetThreadCount, or the number of hardware threads
+	if it wasn't called.
+
+	\returns `HF_STATUS.OK` on completion.
+*/
+C_INTERFACE GetThreadCount(int* out_threads);
+
 /// <summary>
 /// Delete some object pointed to by ptr
 /// </summary>
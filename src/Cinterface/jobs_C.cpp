@@ -0,0 +1,236 @@
+#include <jobs_C.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <HFExceptions.h>
+#include <cancellation.h>
+#include <embree_raytracer.h>
+#include <graph.h>
+#include <node.h>
+#include <path.h>
+#include <path_finder.h>
+#include <view_analysis.h>
+#include <visibility_graph.h>
+
+using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::Node;
+using HF::SpatialStructures::Path;
+using HF::SpatialStructures::PathMember;
+using HF::RayTracer::EmbreeRayTracer;
+using HF::Exceptions::CancellationToken;
+using HF::Jobs::Job;
+using namespace HF::Exceptions;
+using std::vector;
+using std::string;
+
+namespace HF::Jobs {
+
+	/*!
+		\brief An operation running on its own thread.
+
+		\details
+		The operation is given the job's token, and must return the HF_STATUS to finish with. Exceptions
+		thrown by the operation are converted to the matching HF_STATUS, since they can't leave the thread.
+	*/
+	class Job {
+		CancellationToken token;							///< Token the operation checks for cancellation.
+		std::atomic<int> status{ HF_STATUS::IN_PROGRESS };	///< Status the operation finished with.
+		std::mutex join_mutex;								///< Prevents two threads from joining worker at once.
+		std::thread worker;									///< Thread running the operation. Declared last so it
+															///< starts after every other member is constructed.
+
+		/*! \brief Run work and convert any exception it throws to an HF_STATUS. */
+		int Run(const std::function<int(CancellationToken&)>& work) {
+			try {
+				return work(token);
+			}
+			catch (const OperationCancelled&) {
+				return HF_STATUS::CANCELLED;
+			}
+			catch (const NoCost&) {
+				return HF_STATUS::NO_COST;
+			}
+			catch (const std::bad_alloc&) {
+				return HF_STATUS::OUT_OF_MEMORY;
+			}
+			catch (...) {
+				return HF_STATUS::GENERIC_ERROR;
+			}
+		}
+
+	public:
+		/*! \brief Start work on a new thread. */
+		Job(std::function<int(CancellationToken&)> work)
+			: worker([this, work = std::move(work)] { status.store(Run(work)); }) {}
+
+		/*! \brief Cancel the operation and wait for it to stop. */
+		~Job() {
+			Cancel();
+			Wait();
+		}
+
+		/*! \brief Get the status the operation finished with, or HF_STATUS::IN_PROGRESS if it's running. */
+		inline int Status() const { return status.load(); }
+
+		/*! \brief Get the fraction of the operation's work that has finished. */
+		inline float Progress() const { return token.Progress(); }
+
+		/*! \brief Ask the operation to stop. */
+		inline void Cancel() { token.Cancel(); }
+
+		/*! \brief Block until the operation has finished, then return its status. */
+		int Wait() {
+			std::lock_guard<std::mutex> lock(join_mutex);
+			if (worker.joinable()) worker.join();
+			return Status();
+		}
+	};
+}
+
+/*! \brief Start work as a new job and store a handle to it in out_job. */
+static int StartJob(std::function<int(CancellationToken&)> work, Job** out_job) {
+	try {
+		*out_job = new Job(std::move(work));
+	}
+	catch (const std::system_error&) {
+		// The thread couldn't be created
+		*out_job = nullptr;
+		return HF_STATUS::GENERIC_ERROR;
+	}
+	catch (const std::bad_alloc&) {
+		*out_job = nullptr;
+		return HF_STATUS::OUT_OF_MEMORY;
+	}
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE StartVisibilityGraphAllToAllJob(
+	EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	Graph** out_graph,
+	float height,
+	Job** out_job
+) {
+	auto array_of_nodes = ConvertRawFloatArrayToPoints(nodes, num_nodes);
+
+	vector<Node> vector_of_nodes(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		const auto& arr = array_of_nodes[i];
+		auto& vec = vector_of_nodes[i];
+
+		vec[0] = arr[0]; vec[1] = arr[1]; vec[2] = arr[2];
+	}
+
+	return StartJob([=, node_vec = std::move(vector_of_nodes)](CancellationToken& token) {
+		auto vg = std::make_unique<Graph>(
+			HF::VisibilityGraph::AllToAll(*ert, node_vec, height, -1.0f, 90.0f, 90.0f, &token)
+		);
+
+		*out_graph = vg.release();
+		return HF_STATUS::OK;
+	}, out_job);
+}
+
+C_INTERFACE StartSphericalViewAnalysisNoAggregateJob(
+	EmbreeRayTracer* ERT,
+	const Node* node_ptr,
+	int node_size,
+	int* max_rays,
+	float upward_fov,
+	float downward_fov,
+	float height,
+	vector<RayResult>** out_results,
+	RayResult** out_results_ptr,
+	Job** out_job
+) {
+	vector<Node> nodes(node_ptr, node_ptr + node_size);
+	const int num_rays = *max_rays;
+
+	return StartJob([=, node_vec = std::move(nodes)](CancellationToken& token) {
+		auto scores = std::make_unique<vector<RayResult>>(
+			HF::ViewAnalysis::SphericalViewAnalysis<RayResult>(
+				*ERT, node_vec, num_rays, upward_fov, downward_fov, height, &token
+			)
+		);
+
+		*max_rays = (node_size > 0) ? static_cast<int>(scores->size() / node_size) : 0;
+		*out_results_ptr = scores->data();
+		*out_results = scores.release();
+		return HF_STATUS::OK;
+	}, out_job);
+}
+
+C_INTERFACE StartAllToAllPathsJob(
+	const Graph* g,
+	const char* cost_type,
+	Path** out_path_ptr_holder,
+	PathMember** out_path_member_ptr_holder,
+	int* out_sizes,
+	int num_paths,
+	Job** out_job
+) {
+	// Copy the cost type since the caller's string may be freed before the job starts
+	const string cost(cost_type);
+
+	return StartJob([=](CancellationToken& token) {
+		auto bg = HF::Pathfinding::CreateBoostGraph(*g, cost);
+
+		HF::Pathfinding::InsertAllToAllPathsIntoArray(
+			bg.get(), out_path_ptr_holder, out_path_member_ptr_holder, out_sizes, &token
+		);
+		return HF_STATUS::OK;
+	}, out_job);
+}
+
+C_INTERFACE StartDistanceAndPredecessorJob(
+	const Graph* g,
+	const char* cost_name,
+	vector<float>** out_dist_vector,
+	float** out_dist_data,
+	vector<int>** out_pred_vector,
+	int** out_pred_data,
+	Job** out_job
+) {
+	const string cost(cost_name);
+
+	return StartJob([=](CancellationToken& token) {
+		auto bg = HF::Pathfinding::CreateBoostGraph(*g, cost);
+		auto matricies = HF::Pathfinding::GenerateDistanceAndPred(*bg, &token);
+
+		*out_dist_vector = matricies.dist;
+		*out_dist_data = matricies.dist->data();
+		*out_pred_vector = matricies.pred;
+		*out_pred_data = matricies.pred->data();
+		return HF_STATUS::OK;
+	}, out_job);
+}
+
+C_INTERFACE PollJob(const Job* job, int* out_status, float* out_progress) {
+	*out_status = job->Status();
+	*out_progress = job->Progress();
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE CancelJob(Job* job) {
+	job->Cancel();
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE WaitForJob(Job* job, int* out_status) {
+	*out_status = job->Wait();
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE DestroyJob(Job* job) {
+	delete job;
+	return HF_STATUS::OK;
+}
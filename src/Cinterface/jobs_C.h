@@ -0,0 +1,238 @@
+/*!
+	\file		jobs_C.h
+	\brief		Header file for running long operations in the background through the C Interface
+
+	\author		TBA
+	\date		18 Oct 2026
+*/
+
+#ifndef JOBS_C_H
+#define JOBS_C_H
+
+#include <cinterface_utils.h>
+#include <vector>
+#include <raytracer_C.h>
+
+#define C_INTERFACE extern "C" __declspec(dllexport) int
+
+namespace HF {
+	namespace SpatialStructures {
+		struct Node;
+		class Graph;
+		class Path;
+		class PathMember;
+	}
+	namespace RayTracer {
+		class EmbreeRayTracer;
+	}
+
+	/*!
+		\brief Run operations of the C Interface on background threads.
+
+		\see Jobs for the functions that start and manage jobs.
+	*/
+	namespace Jobs {
+		class Job;
+	}
+}
+
+/*!
+	\defgroup	Jobs
+	Run long operations in the background, then poll, wait for, or cancel them.
+
+	\details
+	Each Start...Job function takes the same arguments as the function of the same name without Start
+	and Job, then starts that function on a new thread and returns a handle to it in out_job. The
+	function returns immediately, so callers such as a UI thread stay responsive while the operation runs,
+	and can show its progress with \link PollJob \endlink or stop it with \link CancelJob \endlink.
+
+	Results are written to the output arguments of the Start...Job function when the job finishes, so
+	every output argument must remain valid until the job is no longer running. Inputs copied into arrays,
+	such as nodes, may be freed as soon as the Start...Job function returns, but objects passed by pointer,
+	such as graphs and raytracers, must not be modified or destroyed until the job is no longer running.
+	Outputs are only written if the job finishes with HF_STATUS::OK, and must be freed the same way as the
+	outputs of the synchronous function.
+
+	Cancellation is cooperative. Work that has already started, such as the rays of a single node, is
+	finished before the job stops, and anything it allocated is freed. A cancelled job finishes with
+	HF_STATUS::CANCELLED.
+
+	\par Example
+	\code
+		HF::Jobs::Job* job = nullptr;
+		HF::SpatialStructures::Graph* graph = nullptr;
+		StartVisibilityGraphAllToAllJob(bvh, nodes, num_nodes, &graph, 1.7f, &job);
+
+		int status = HF_STATUS::IN_PROGRESS;
+		float progress = 0;
+		while (status == HF_STATUS::IN_PROGRESS) {
+			PollJob(job, &status, &progress);
+			std::cout << "Progress: " << progress << std::endl;
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+		DestroyJob(job);
+
+		// status will be HF_STATUS::OK and graph will be set if the job wasn't cancelled
+		if (status == HF_STATUS::OK) DestroyGraph(graph);
+	\endcode
+
+	@{
+*/
+
+/*!
+	\brief		Start \link CreateVisibilityGraphAllToAll \endlink on a background thread.
+
+	\param		ert			The raytracer to cast rays from. Must not be destroyed while the job is running.
+	\param		nodes		Coordinates of the nodes, with three floats for every node. Copied before returning.
+	\param		num_nodes	Number of nodes in nodes.
+	\param		out_graph	Set to a new graph once the job finishes successfully.
+	\param		height		How far to offset nodes from the ground.
+	\param		out_job		Set to a handle to the new job. Must be destroyed with \link DestroyJob \endlink.
+
+	\returns	HF_STATUS::OK if the job was started.
+	\returns	HF_STATUS::GENERIC_ERROR if a thread couldn't be created for the job.
+*/
+C_INTERFACE StartVisibilityGraphAllToAllJob(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	HF::SpatialStructures::Graph** out_graph,
+	float height,
+	HF::Jobs::Job** out_job
+);
+
+/*!
+	\brief		Start \link SphericalViewAnalysisNoAggregate \endlink on a background thread.
+
+	\param		ERT				Raytracer to intersect rays with. Must not be destroyed while the job is running.
+	\param		node_ptr		Observer points for the view analysis. Copied before returning.
+	\param		node_size		Number of nodes in node_ptr.
+	\param		max_rays		Number of rays to cast from each node. Updated to the number of rays cast
+								from each node once the job finishes successfully, or 0 if node_size is 0.
+	\param		upward_fov		Maximum angle in degrees to cast rays above the viewpoint.
+	\param		downward_fov	Maximum angle in degrees to cast rays below the viewpoint.
+	\param		height			Height to offset nodes from the ground before casting rays.
+	\param		out_results		Set to a new vector of results once the job finishes successfully.
+	\param		out_results_ptr	Set to the data of out_results once the job finishes successfully.
+	\param		out_job			Set to a handle to the new job. Must be destroyed with \link DestroyJob \endlink.
+
+	\returns	HF_STATUS::OK if the job was started.
+	\returns	HF_STATUS::GENERIC_ERROR if a thread couldn't be created for the job.
+*/
+C_INTERFACE StartSphericalViewAnalysisNoAggregateJob(
+	HF::RayTracer::EmbreeRayTracer* ERT,
+	const HF::SpatialStructures::Node* node_ptr,
+	int node_size,
+	int* max_rays,
+	float upward_fov,
+	float downward_fov,
+	float height,
+	std::vector<RayResult>** out_results,
+	RayResult** out_results_ptr,
+	HF::Jobs::Job** out_job
+);
+
+/*!
+	\brief		Start \link CreateAllToAllPaths \endlink on a background thread.
+
+	\param		g							Graph to generate paths in. Must not be modified or destroyed while
+											the job is running.
+	\param		cost_type					Name of the cost type to use. Copied before returning.
+	\param		out_path_ptr_holder			Array of num_paths path pointers, filled as the job runs.
+	\param		out_path_member_ptr_holder	Array of num_paths path member pointers, filled as the job runs.
+	\param		out_sizes					Array of num_paths sizes, filled as the job runs.
+	\param		num_paths					Number of nodes in g squared.
+	\param		out_job						Set to a handle to the new job. Must be destroyed with
+											\link DestroyJob \endlink.
+
+	\returns	HF_STATUS::OK if the job was started.
+	\returns	HF_STATUS::GENERIC_ERROR if a thread couldn't be created for the job.
+
+	\remarks	The output arrays are filled while the job runs, so their contents can't be used until the job
+				finishes successfully. If the job is cancelled, every path is deleted and every element of the
+				output arrays is set to null or zero.
+*/
+C_INTERFACE StartAllToAllPathsJob(
+	const HF::SpatialStructures::Graph* g,
+	const char* cost_type,
+	HF::SpatialStructures::Path** out_path_ptr_holder,
+	HF::SpatialStructures::PathMember** out_path_member_ptr_holder,
+	int* out_sizes,
+	int num_paths,
+	HF::Jobs::Job** out_job
+);
+
+/*!
+	\brief		Start \link CalculateDistanceAndPredecessor \endlink on a background thread.
+
+	\param		g					Graph to calculate the matricies for. Must not be modified or destroyed
+									while the job is running.
+	\param		cost_name			Name of the cost type to use. Copied before returning.
+	\param		out_dist_vector		Set to the distance matrix once the job finishes successfully.
+	\param		out_dist_data		Set to the data of out_dist_vector once the job finishes successfully.
+	\param		out_pred_vector		Set to the predecessor matrix once the job finishes successfully.
+	\param		out_pred_data		Set to the data of out_pred_vector once the job finishes successfully.
+	\param		out_job				Set to a handle to the new job. Must be destroyed with \link DestroyJob \endlink.
+
+	\returns	HF_STATUS::OK if the job was started.
+	\returns	HF_STATUS::GENERIC_ERROR if a thread couldn't be created for the job.
+*/
+C_INTERFACE StartDistanceAndPredecessorJob(
+	const HF::SpatialStructures::Graph* g,
+	const char* cost_name,
+	std::vector<float>** out_dist_vector,
+	float** out_dist_data,
+	std::vector<int>** out_pred_vector,
+	int** out_pred_data,
+	HF::Jobs::Job** out_job
+);
+
+/*!
+	\brief		Check if a job has finished without blocking.
+
+	\param		job				Job to check.
+	\param		out_status		Set to HF_STATUS::IN_PROGRESS if the job is still running, otherwise set to the
+								status the operation finished with, such as HF_STATUS::OK or HF_STATUS::CANCELLED.
+	\param		out_progress	Set to the fraction of the job's work that has finished, from 0 to 1.
+
+	\returns	HF_STATUS::OK on completion.
+*/
+C_INTERFACE PollJob(const HF::Jobs::Job* job, int* out_status, float* out_progress);
+
+/*!
+	\brief		Ask a job to stop as soon as possible.
+
+	\param		job		Job to cancel.
+
+	\returns	HF_STATUS::OK on completion.
+
+	\details	This returns immediately. The job keeps running until it reaches a point where it can stop,
+				so use \link PollJob \endlink or \link WaitForJob \endlink to find out when it has. A job that
+				finishes before noticing it was cancelled still finishes with HF_STATUS::OK.
+*/
+C_INTERFACE CancelJob(HF::Jobs::Job* job);
+
+/*!
+	\brief		Block until a job has finished.
+
+	\param		job			Job to wait for.
+	\param		out_status	Set to the status the operation finished with.
+
+	\returns	HF_STATUS::OK on completion.
+*/
+C_INTERFACE WaitForJob(HF::Jobs::Job* job, int* out_status);
+
+/*!
+	\brief		Delete a job, cancelling it and waiting for it to stop if it's still running.
+
+	\param		job		Job to delete.
+
+	\returns	HF_STATUS::OK on completion.
+
+	\details	The outputs of a job that finished successfully are not deleted with it.
+*/
+C_INTERFACE DestroyJob(HF::Jobs::Job* job);
+
+/**@}*/
+
+#endif /* JOBS_C_H */
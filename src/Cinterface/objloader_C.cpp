@@ -1,5 +1,9 @@
 #include <objloader_C.h>
 #include <objloader.h>
+#include <mesh_cache.h>
+#include <ply_loader.h>
+#include <gltf_loader.h>
+#include <scene_generator.h>
 #include <meshinfo.h>
 #include <vector>
 
@@ -56,6 +60,164 @@ C_INTERFACE LoadOBJ(
 	return HF_STATUS::OK;
 }
 
+C_INTERFACE LoadOBJCached(
+	const char* obj_path,
+	HF::Geometry::GROUP_METHOD gm,
+	float xrot,
+	float yrot,
+	float zrot,
+	MeshInfo<float>*** out_data_array,
+	int* num_meshes
+) {
+	try {
+		auto loaded_objs = HF::Geometry::LoadMeshObjectsCached(std::string(obj_path), gm, false);
+
+		// Rotate the meshes, then copy them into the output array
+		*num_meshes = loaded_objs.size();
+		MeshInfo<float>** data_array = new MeshInfo<float>*[*num_meshes];
+		for (int i = 0; i < *num_meshes; i++) {
+			loaded_objs[i].PerformRotation(xrot, yrot, zrot);
+			data_array[i] = new MeshInfo<float>(std::move(loaded_objs[i]));
+		}
+		*out_data_array = data_array;
+	}
+	catch (const HF::Exceptions::InvalidOBJ & e) {
+		return HF_STATUS::INVALID_OBJ;
+	}
+	catch (const HF::Exceptions::FileNotFound & e) {
+		return HF_STATUS::NOT_FOUND;
+	}
+	catch (...) {
+		std::cerr << "Generic Error" << std::endl;
+		return HF_STATUS::GENERIC_ERROR;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE LoadOBJParallel(
+	const char* obj_path,
+	float xrot,
+	float yrot,
+	float zrot,
+	MeshInfo<float>** out_mesh
+) {
+	try {
+		auto mesh = HF::Geometry::LoadMeshObjectsParallel(std::string(obj_path));
+		mesh.PerformRotation(xrot, yrot, zrot);
+
+		*out_mesh = new MeshInfo<float>(std::move(mesh));
+	}
+	catch (const HF::Exceptions::InvalidOBJ & e) {
+		return HF_STATUS::INVALID_OBJ;
+	}
+	catch (const HF::Exceptions::FileNotFound & e) {
+		return HF_STATUS::NOT_FOUND;
+	}
+	catch (...) {
+		std::cerr << "Generic Error" << std::endl;
+		return HF_STATUS::GENERIC_ERROR;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE LoadPLYFile(
+	const char* ply_path,
+	float xrot,
+	float yrot,
+	float zrot,
+	MeshInfo<float>** out_mesh
+) {
+	try {
+		auto mesh = HF::Geometry::LoadPLY(std::string(ply_path));
+		mesh.PerformRotation(xrot, yrot, zrot);
+
+		*out_mesh = new MeshInfo<float>(std::move(mesh));
+	}
+	catch (const HF::Exceptions::InvalidOBJ & e) {
+		return HF_STATUS::INVALID_OBJ;
+	}
+	catch (const HF::Exceptions::FileNotFound & e) {
+		return HF_STATUS::NOT_FOUND;
+	}
+	catch (...) {
+		std::cerr << "Generic Error" << std::endl;
+		return HF_STATUS::GENERIC_ERROR;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE LoadGLBFile(
+	const char* glb_path,
+	float xrot,
+	float yrot,
+	float zrot,
+	MeshInfo<float>*** out_data_array,
+	int* num_meshes
+) {
+	try {
+		auto loaded_meshes = HF::Geometry::LoadGLB(std::string(glb_path));
+
+		// Rotate the meshes, then copy them into the output array
+		*num_meshes = loaded_meshes.size();
+		MeshInfo<float>** data_array = new MeshInfo<float>*[*num_meshes];
+		for (int i = 0; i < *num_meshes; i++) {
+			loaded_meshes[i].PerformRotation(xrot, yrot, zrot);
+			data_array[i] = new MeshInfo<float>(std::move(loaded_meshes[i]));
+		}
+		*out_data_array = data_array;
+	}
+	catch (const HF::Exceptions::InvalidOBJ & e) {
+		return HF_STATUS::INVALID_OBJ;
+	}
+	catch (const HF::Exceptions::FileNotFound & e) {
+		return HF_STATUS::NOT_FOUND;
+	}
+	catch (...) {
+		std::cerr << "Generic Error" << std::endl;
+		return HF_STATUS::GENERIC_ERROR;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE GenerateBuildingMesh(
+	int floors,
+	float width,
+	float depth,
+	float storey_height,
+	int rooms_per_floor,
+	bool stairs,
+	float obstacle_density,
+	int seed,
+	MeshInfo<float>** out_mesh
+) {
+	BuildingParameters params;
+	params.floors = floors;
+	params.width = width;
+	params.depth = depth;
+	params.storey_height = storey_height;
+	params.rooms_per_floor = rooms_per_floor;
+	params.stairs = stairs;
+	params.obstacle_density = obstacle_density;
+	params.seed = static_cast<uint32_t>(seed);
+
+	try {
+		*out_mesh = new MeshInfo<float>(HF::Geometry::GenerateBuilding(params));
+	}
+	catch (const std::invalid_argument & e) {
+		return HF_STATUS::OUT_OF_RANGE;
+	}
+	catch (...) {
+		std::cerr << "Generic Error" << std::endl;
+		return HF_STATUS::GENERIC_ERROR;
+	}
+
+	return HF_STATUS::OK;
+}
+
 C_INTERFACE StoreMesh(
 	MeshInfo<float> ** out_info,
 	const int* indices,
@@ -91,6 +253,52 @@ C_INTERFACE RotateMesh(MeshInfo<float> * mesh_to_rotate, float xrot, float yrot,
 	return HF_STATUS::OK;
 }
 
+C_INTERFACE TransformMesh(MeshInfo<float>* mesh, const float* matrix, bool defer)
+{
+	if (!mesh || !matrix)
+		return HF_STATUS::INVALID_PTR;
+
+	std::array<float, 16> transform;
+	std::copy(matrix, matrix + 16, transform.begin());
+
+	try {
+		if (defer)
+			mesh->QueueTransform(transform);
+		else
+			mesh->Transform(transform);
+	}
+	catch (const std::invalid_argument&) {
+		return HF_STATUS::OUT_OF_RANGE;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE CropMesh(MeshInfo<float>* mesh, const float* min_point, const float* max_point, float margin, int* out_num_removed)
+{
+	*out_num_removed = mesh->CropToBox(
+		std::array<float, 3>{ min_point[0], min_point[1], min_point[2] },
+		std::array<float, 3>{ max_point[0], max_point[1], max_point[2] },
+		margin
+	);
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE CropMeshToPolygon(MeshInfo<float>* mesh, const float* polygon, int num_points, float margin, int* out_num_removed)
+{
+	if (num_points < 3)
+		return HF_STATUS::OUT_OF_RANGE;
+
+	vector<std::array<float, 2>> points(num_points);
+	for (int i = 0; i < num_points; i++)
+		points[i] = std::array<float, 2>{ polygon[2 * i], polygon[2 * i + 1] };
+
+	*out_num_removed = mesh->CropToPolygon(points, margin);
+
+	return HF_STATUS::OK;
+}
+
 C_INTERFACE GetVertsAndTris(const MeshInfo<float> * MI, int** index_out, int* num_triangles, float** vertex_out, int* num_vertices)
 {
 	auto mesh_vertices = MI->GetVertexPointer();
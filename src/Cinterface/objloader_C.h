@@ -143,6 +143,143 @@ C_INTERFACE LoadOBJ(
 	int * num_meshes
 );
 
+/*!
+	\brief		Load an OBJ file like \link LoadOBJ \endlink, reusing a binary cache of the file when possible.
+
+	\param		obj_path		Path to the OBJ file to load.
+	\param		gm				Method of grouping submeshes in the file.
+	\param		xrot			Degrees to rotate the meshes about the x axis after loading.
+	\param		yrot			Degrees to rotate the meshes about the y axis after loading.
+	\param		zrot			Degrees to rotate the meshes about the z axis after loading.
+	\param		out_data_array	Output parameter for an array of pointers to the loaded meshes.
+	\param		num_meshes		Output parameter for the number of meshes in out_data_array.
+
+	\returns	\link HF_STATUS::OK \endlink if the meshes were loaded successfully.
+				\link HF_STATUS::NOT_FOUND \endlink if no file exists at obj_path.
+				\link HF_STATUS::INVALID_OBJ \endlink if the file isn't a valid OBJ.
+
+	\details	The first time a file is loaded, its meshes are written to `obj_path + ".dhmesh"`. Later
+				calls read the meshes straight from this cache unless the OBJ has changed since.
+				See HF::Geometry::LoadMeshObjectsCached for details. Memory is freed the same way as
+				\link LoadOBJ \endlink.
+*/
+C_INTERFACE LoadOBJCached(
+	const char* obj_path,
+	HF::Geometry::GROUP_METHOD gm,
+	float xrot,
+	float yrot,
+	float zrot,
+	HF::Geometry::MeshInfo<float>*** out_data_array,
+	int* num_meshes
+);
+
+/*!
+	\brief		Load all of the geometry in an OBJ file as a single mesh, parsing the file in parallel.
+
+	\param		obj_path		Path to the OBJ file to load.
+	\param		xrot			Degrees to rotate the mesh about the x axis after loading.
+	\param		yrot			Degrees to rotate the mesh about the y axis after loading.
+	\param		zrot			Degrees to rotate the mesh about the z axis after loading.
+	\param		out_mesh		Output parameter for the loaded mesh.
+
+	\returns	\link HF_STATUS::OK \endlink if the mesh was loaded successfully.
+				\link HF_STATUS::NOT_FOUND \endlink if no file exists at obj_path.
+				\link HF_STATUS::INVALID_OBJ \endlink if the file isn't a valid OBJ.
+
+	\details	Equivalent to \link LoadOBJ \endlink with \link HF::Geometry::GROUP_METHOD::ONLY_FILE \endlink,
+				but much faster for large files. See HF::Geometry::LoadMeshObjectsParallel for details.
+				The mesh must be freed with \link DestroyMeshInfo \endlink.
+*/
+C_INTERFACE LoadOBJParallel(
+	const char* obj_path,
+	float xrot,
+	float yrot,
+	float zrot,
+	HF::Geometry::MeshInfo<float>** out_mesh
+);
+
+/*!
+	\brief		Load a binary PLY file as a single mesh.
+
+	\param		ply_path		Path to the PLY file to load.
+	\param		xrot			Degrees to rotate the mesh about the x axis after loading.
+	\param		yrot			Degrees to rotate the mesh about the y axis after loading.
+	\param		zrot			Degrees to rotate the mesh about the z axis after loading.
+	\param		out_mesh		Output parameter for the loaded mesh.
+
+	\returns	\link HF_STATUS::OK \endlink if the mesh was loaded successfully.
+				\link HF_STATUS::NOT_FOUND \endlink if no file exists at ply_path.
+				\link HF_STATUS::INVALID_OBJ \endlink if the file isn't a valid binary PLY file.
+
+	\details	See HF::Geometry::LoadPLY for details. The mesh must be freed with \link DestroyMeshInfo \endlink.
+*/
+C_INTERFACE LoadPLYFile(
+	const char* ply_path,
+	float xrot,
+	float yrot,
+	float zrot,
+	HF::Geometry::MeshInfo<float>** out_mesh
+);
+
+/*!
+	\brief		Load every mesh in a binary glTF (.glb) file.
+
+	\param		glb_path		Path to the .glb file to load.
+	\param		xrot			Degrees to rotate the meshes about the x axis after loading.
+	\param		yrot			Degrees to rotate the meshes about the y axis after loading.
+	\param		zrot			Degrees to rotate the meshes about the z axis after loading.
+	\param		out_data_array	Output parameter for an array of pointers to the loaded meshes.
+	\param		num_meshes		Output parameter for the number of meshes in out_data_array.
+
+	\returns	\link HF_STATUS::OK \endlink if the meshes were loaded successfully.
+				\link HF_STATUS::NOT_FOUND \endlink if no file exists at glb_path.
+				\link HF_STATUS::INVALID_OBJ \endlink if the file isn't a supported glTF binary.
+
+	\details	Each mesh is named after the node that placed it. See HF::Geometry::LoadGLB for details.
+				Memory is freed the same way as \link LoadOBJ \endlink.
+*/
+C_INTERFACE LoadGLBFile(
+	const char* glb_path,
+	float xrot,
+	float yrot,
+	float zrot,
+	HF::Geometry::MeshInfo<float>*** out_data_array,
+	int* num_meshes
+);
+
+/*!
+	\brief		Generate a synthetic multi-storey building as a single mesh.
+
+	\param		floors				Number of storeys.
+	\param		width				Length of the building along the x axis in meters. At most 10000.
+	\param		depth				Length of the building along the y axis in meters. At most 10000.
+	\param		storey_height		Distance from the top of one floor to the top of the next in meters. At most 10000.
+	\param		rooms_per_floor		Number of rooms on every floor.
+	\param		stairs				Connect every floor to the one above it with a flight of stairs.
+	\param		obstacle_density	Fraction of each room's floor covered by obstacles, from 0 to 1.
+	\param		seed				Seed for the placement of obstacles.
+	\param		out_mesh			Output parameter for the generated mesh.
+
+	\returns	\link HF_STATUS::OK \endlink if the building was generated successfully.
+				\link HF_STATUS::OUT_OF_RANGE \endlink if any parameter is out of range, or the building is too
+				small to fit its corridor, rooms or stairs.
+
+	\details	The same parameters always produce the same mesh, so buildings of increasing size can be used
+				to measure how an analysis scales. See HF::Geometry::GenerateBuilding for the layout of the
+				building. The mesh must be freed with \link DestroyMeshInfo \endlink.
+*/
+C_INTERFACE GenerateBuildingMesh(
+	int floors,
+	float width,
+	float depth,
+	float storey_height,
+	int rooms_per_floor,
+	bool stairs,
+	float obstacle_density,
+	int seed,
+	HF::Geometry::MeshInfo<float>** out_mesh
+);
+
 /*!
 	\brief Store a mesh in a format usable with DHARTAPI
 	
@@ -207,6 +344,71 @@ C_INTERFACE RotateMesh(
 	float zrot
 );
 
+/*!
+	\brief		Transform every vertex of a mesh by an affine matrix.
+
+	\param		mesh			The mesh to transform.
+	\param		matrix			16 floats containing a 4x4 affine transform in row-major order. The bottom row is ignored.
+	\param		defer			If true, don't transform the vertices until the mesh is added to a raytracer. Deferred
+								transforms are combined, so the vertices are only transformed once.
+
+	\returns	\link HF_STATUS::OK \endlink on completion.
+				\link HF_STATUS::INVALID_PTR \endlink if mesh or matrix is null.
+				\link HF_STATUS::OUT_OF_RANGE \endlink if matrix contains NaN or infinity outside of its bottom
+				row. The mesh is left unchanged.
+
+	\details	See HF::Geometry::MeshInfo::Transform and HF::Geometry::MeshInfo::QueueTransform for details.
+*/
+C_INTERFACE TransformMesh(
+	HF::Geometry::MeshInfo<float>* mesh,
+	const float* matrix,
+	bool defer
+);
+
+/*!
+	\brief		Remove every triangle of a mesh that doesn't overlap a box.
+
+	\param		mesh			The mesh to crop.
+	\param		min_point		X, Y and Z coordinates of the corner of the box with the smallest coordinates.
+	\param		max_point		X, Y and Z coordinates of the corner of the box with the largest coordinates.
+	\param		margin			Distance to grow the box by on every side.
+	\param		out_num_removed	Output parameter for the number of triangles that were removed.
+
+	\returns	\link HF_STATUS::OK \endlink if the mesh was cropped successfully.
+
+	\details	Call this before creating a raytracer from the mesh. See HF::Geometry::MeshInfo::CropToBox
+				for details.
+*/
+C_INTERFACE CropMesh(
+	HF::Geometry::MeshInfo<float>* mesh,
+	const float* min_point,
+	const float* max_point,
+	float margin,
+	int* out_num_removed
+);
+
+/*!
+	\brief		Remove every triangle of a mesh that isn't within a distance of a polygon on the XY plane.
+
+	\param		mesh			The mesh to crop.
+	\param		polygon			X and Y coordinates of every vertex of the polygon in order. Every 2 floats is a new vertex.
+	\param		num_points		Number of vertices in polygon. This is equal to the length of polygon divided by 2.
+	\param		margin			Horizontal distance from the polygon at which triangles are still kept.
+	\param		out_num_removed	Output parameter for the number of triangles that were removed.
+
+	\returns	\link HF_STATUS::OK \endlink if the mesh was cropped successfully.
+				\link HF_STATUS::OUT_OF_RANGE \endlink if the polygon has fewer than 3 vertices.
+
+	\details	See HF::Geometry::MeshInfo::CropToPolygon for details.
+*/
+C_INTERFACE CropMeshToPolygon(
+	HF::Geometry::MeshInfo<float>* mesh,
+	const float* polygon,
+	int num_points,
+	float margin,
+	int* out_num_removed
+);
+
 
 /*! 
 	\brief Get a pointer to and the size of a mesh's triangle and vertex arrays
@@ -3,7 +3,10 @@
 
 #include <embree_raytracer.h>
 #include <meshinfo.h>
+#include <mesh_cache.h>
+#include <memory>
 #include <HFExceptions.h>
+#include <parallelism.h>
 #include <cinterface_utils.h>
 
 using std::vector;
@@ -81,6 +84,24 @@ C_INTERFACE AddMeshes(HF::RayTracer::EmbreeRayTracer* ERT, MeshInfo ** MI, int n
 	return HF_STATUS::OK;
 }
 
+C_INTERFACE CreateRaytracerFromMeshCache(const char* cache_path, EmbreeRayTracer** out_raytracer, bool use_precise)
+{
+	try {
+		// Map the cache, then let the raytracer take ownership of the mapping
+		auto cache = std::make_shared<const HF::Geometry::MeshCache>(std::string(cache_path));
+
+		auto raytracer = std::make_unique<EmbreeRayTracer>(use_precise);
+		raytracer->AddSharedMeshes(cache, true);
+		*out_raytracer = raytracer.release();
+		return OK;
+	}
+	catch (const HF::Exceptions::FileNotFound& e) { return NOT_FOUND; }
+	catch (const HF::Exceptions::InvalidOBJ& e) { return INVALID_OBJ; }
+	catch (const HF::Exceptions::MissingDependency& e) { return MISSING_DEPEND; }
+	catch (const std::runtime_error& e) { return GENERIC_ERROR; }
+	return GENERIC_ERROR;
+}
+
 C_INTERFACE AddMesh(HF::RayTracer::EmbreeRayTracer* ERT,MeshInfo* MI)
 {
 	ERT->AddMesh(*MI, true);
@@ -144,7 +165,8 @@ C_INTERFACE CastRaysDistance(
 
 		output_results = new std::vector<RayResult>(num_origins);
 
-#pragma omp parallel for schedule(dynamic)
+		HF::Parallel::ThreadLease lease(-1, num_origins);
+#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
 		for (int i = 0; i < num_origins; i++) {
 			float out_distance = -1;
 			int out_id = -1;
@@ -160,7 +182,8 @@ C_INTERFACE CastRaysDistance(
 		auto direction_pts = ConvertRawFloatArrayToPoints(directions, num_directions);
 
 		output_results = new std::vector<RayResult>(num_origins);
-	#pragma omp parallel for schedule(dynamic)
+		HF::Parallel::ThreadLease lease(-1, num_directions);
+	#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
 		for (int i = 0; i < num_directions; i++) {
 			float out_distance = -1; int out_id = -1;
 			if (ert->IntersectOutputArguments(origin, direction_pts[i], out_distance, out_id))
@@ -174,7 +197,8 @@ C_INTERFACE CastRaysDistance(
 		auto origin_pts = ConvertRawFloatArrayToPoints(origins, num_origins);
 
 		output_results = new std::vector<RayResult>(num_origins);
-	#pragma omp parallel for schedule(dynamic)
+		HF::Parallel::ThreadLease lease(-1, num_origins);
+	#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
 		for (int i = 0; i < num_origins; i++) {
 			float out_distance = -1; int out_id = -1;
 			if (ert->IntersectOutputArguments(origin_pts[i], direction, out_distance, out_id))
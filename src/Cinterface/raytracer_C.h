@@ -174,6 +174,30 @@ C_INTERFACE AddMeshes(
 	int number_of_meshes
 );
 
+/*!
+	\brief Create a new raytracer directly from the meshes in a binary mesh cache.
+
+	\param cache_path Path to a .dhmesh file written by SaveMeshCache or LoadOBJCached.
+	\param out_raytracer Output parameter for the new raytracer.
+	\param use_precise If true, use a more precise but slower method of triangle intersections
+
+	\returns HF_STATUS::OK on completion.
+			  HF_STATUS::NOT_FOUND if no file exists at cache_path.
+			  HF_STATUS::INVALID_OBJ if the file isn't a valid mesh cache or contains an empty mesh.
+			  HF_STATUS::MISSING_DEPEND if Embree's dll couldn't be found.
+
+	\details
+	The cache is mapped into memory and its vertex and index arrays are handed to Embree as shared
+	buffers, so no copy of the meshes is ever made. The mapping is released when the raytracer is destroyed.
+
+	\see EmbreeRayTracer::AddSharedMeshes
+*/
+C_INTERFACE CreateRaytracerFromMeshCache(
+	const char* cache_path,
+	HF::RayTracer::EmbreeRayTracer** out_raytracer,
+	bool use_precise
+);
+
 
 /*!
 	\brief		Delete an existing raytracer.
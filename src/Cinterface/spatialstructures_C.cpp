@@ -5,6 +5,7 @@
 #include <edge.h>
 #include <node.h>
 #include <robin_hood.h>
+#include <algorithm>
 #include <iostream>
 
 using HF::SpatialStructures::Graph;
@@ -214,6 +215,46 @@ C_INTERFACE GetCSRPointers(
 	}
 }
 
+C_INTERFACE GetStepTypes(
+	Graph* graph,
+	int* out_nnz,
+	const unsigned char** out_step_types
+) {
+	try {
+		const auto& step_types = graph->GetStepTypes();
+		if (step_types.empty()) return NOT_FOUND;
+
+		*out_nnz = static_cast<int>(step_types.size());
+		*out_step_types = step_types.data();
+		return OK;
+	}
+	catch (...) {
+		return GENERIC_ERROR;
+	}
+}
+
+C_INTERFACE CreateStepCost(
+	Graph* graph,
+	const float* step_multipliers,
+	const char* cost_type
+) {
+	if (!graph->HasStepTypes()) return NOT_FOUND;
+
+	std::array<float, 5> multipliers;
+	std::copy(step_multipliers, step_multipliers + multipliers.size(), multipliers.begin());
+
+	try {
+		graph->CreateStepCost(std::string(cost_type), multipliers);
+	}
+	catch (std::logic_error) {
+		return INVALID_COST;
+	}
+	catch (...) {
+		return GENERIC_ERROR;
+	}
+	return OK;
+}
+
 C_INTERFACE GetNodeID(
 	HF::SpatialStructures::Graph* graph,
 	const float * point,
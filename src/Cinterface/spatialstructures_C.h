@@ -543,6 +543,49 @@ C_INTERFACE GetCSRPointers(
 	const char* cost_type
 );
 
+/*!
+	\brief		Get the step required to traverse every edge of a graph.
+				This will compress the graph if it was not already compressed.
+
+	\param		graph			Graph to get the step types of.
+	\param		out_nnz			Number of step types, which is the number of non-zero values in the CSR.
+	\param		out_step_types	Pointer to the graph's step types. Each is a
+								\link HF::SpatialStructures::STEP \endlink, in the same order
+								as the data array from \link GetCSRPointers \endlink.
+
+	\returns	\link HF_STATUS::OK \endlink on success.
+	\returns	\link HF_STATUS::NOT_FOUND \endlink if no edge in the graph was added with a step type.
+				Graphs from \link GenerateGraph \endlink always have step types.
+
+	\details	The pointer is owned by the graph, and is invalidated by any change to it.
+*/
+C_INTERFACE GetStepTypes(
+	HF::SpatialStructures::Graph* graph,
+	int* out_nnz,
+	const unsigned char** out_step_types
+);
+
+/*!
+	\brief		Create a cost array that multiplies the default cost of each edge by a value for its step type.
+
+	\param		graph				Graph to create the cost array in.
+	\param		step_multipliers	Array of 5 multipliers, one for each
+									\link HF::SpatialStructures::STEP \endlink in the order of its values.
+	\param		cost_type			Name of the cost array to create. Replaces any existing cost array with this name.
+
+	\returns	\link HF_STATUS::OK \endlink on success.
+	\returns	\link HF_STATUS::NOT_FOUND \endlink if no edge in the graph was added with a step type.
+	\returns	\link HF_STATUS::INVALID_COST \endlink if cost_type is the graph's default cost.
+
+	\details	Pass a large multiplier for UP and DOWN to route around stairs, without recalculating
+				anything about the graph.
+*/
+C_INTERFACE CreateStepCost(
+	HF::SpatialStructures::Graph* graph,
+	const float* step_multipliers,
+	const char* cost_type
+);
+
 /*!
 	\brief		Get the ID of the given node in the graph.
 				If the node does not exist,
@@ -0,0 +1,55 @@
+#include <tracing_C.h>
+
+#include <string>
+
+#include <HFExceptions.h>
+#include <tracing.h>
+
+using namespace HF::Exceptions;
+using namespace HF::Tracing;
+
+C_INTERFACE EnableTracing(bool enable) {
+	Enable(enable);
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE ResetTracing() {
+	Reset();
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE GetTraceStats(TraceStats* out_stats) {
+	if (!out_stats) return HF_STATUS::INVALID_PTR;
+
+	out_stats->occlusion_rays = GetCount(OCCLUSION_RAYS);
+	out_stats->intersection_rays = GetCount(INTERSECTION_RAYS);
+	out_stats->nodes_popped = GetCount(NODES_POPPED);
+	out_stats->edges_added = GetCount(EDGES_ADDED);
+	out_stats->hash_probes = GetCount(HASH_PROBES);
+
+	out_stats->generate_graph_ms = GetStageMilliseconds(GENERATE_GRAPH);
+	out_stats->compress_graph_ms = GetStageMilliseconds(COMPRESS_GRAPH);
+	out_stats->visibility_graph_ms = GetStageMilliseconds(VISIBILITY_GRAPH);
+	out_stats->view_analysis_ms = GetStageMilliseconds(VIEW_ANALYSIS);
+	out_stats->pathfinding_ms = GetStageMilliseconds(PATHFINDING);
+
+	out_stats->generate_graph_calls = GetStageCalls(GENERATE_GRAPH);
+	out_stats->compress_graph_calls = GetStageCalls(COMPRESS_GRAPH);
+	out_stats->visibility_graph_calls = GetStageCalls(VISIBILITY_GRAPH);
+	out_stats->view_analysis_calls = GetStageCalls(VIEW_ANALYSIS);
+	out_stats->pathfinding_calls = GetStageCalls(PATHFINDING);
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE WriteChromeTrace(const char* path) {
+	if (!path) return HF_STATUS::INVALID_PTR;
+
+	try {
+		HF::Tracing::WriteChromeTrace(std::string(path));
+	}
+	catch (const FileNotFound&) {
+		return HF_STATUS::NOT_FOUND;
+	}
+	return HF_STATUS::OK;
+}
@@ -0,0 +1,114 @@
+/*!
+	\file		tracing_C.h
+	\brief		Header file for measuring where time is spent through the C Interface
+
+	\author		TBA
+	\date		18 Oct 2026
+*/
+
+#ifndef TRACING_C_H
+#define TRACING_C_H
+
+#include <cinterface_utils.h>
+#include <cstdint>
+
+#define C_INTERFACE extern "C" __declspec(dllexport) int
+
+/*!
+	\brief Totals recorded by tracing since it was last reset.
+
+	\details Times are in milliseconds. Calls are the number of times a stage was run.
+
+	\see HF::Tracing for what each counter and stage measures.
+*/
+struct TraceStats {
+	int64_t occlusion_rays;			///< Occlusion rays cast.
+	int64_t intersection_rays;		///< Intersection rays cast.
+	int64_t nodes_popped;			///< Nodes taken from the graph generator's queue.
+	int64_t edges_added;			///< Edges added by the graph generator or visibility graph.
+	int64_t hash_probes;			///< Lookups of a node in a hash table.
+
+	double generate_graph_ms;		///< Time spent generating graphs.
+	double compress_graph_ms;		///< Time spent compressing graphs.
+	double visibility_graph_ms;		///< Time spent generating visibility graphs.
+	double view_analysis_ms;		///< Time spent in view analysis.
+	double pathfinding_ms;			///< Time spent finding paths.
+
+	int64_t generate_graph_calls;	///< Number of graphs generated.
+	int64_t compress_graph_calls;	///< Number of graphs compressed.
+	int64_t visibility_graph_calls;	///< Number of visibility graphs generated.
+	int64_t view_analysis_calls;	///< Number of view analyses run.
+	int64_t pathfinding_calls;		///< Number of pathfinding calls.
+};
+
+/*!
+	\defgroup	Tracing
+	Count rays, nodes, and edges, and time each stage of an analysis.
+
+	\details
+	Tracing is off by default, and costs almost nothing while it's off. Call \link EnableTracing \endlink,
+	run the analyses to measure, then read the totals with \link GetTraceStats \endlink or save every
+	timed stage as a Chrome trace with \link WriteChromeTrace \endlink. The trace can be opened in
+	chrome://tracing or Perfetto.
+
+	\par Example
+	\code
+		EnableTracing(true);
+		GenerateGraph(bvh, start, spacing, 5000, 0.2f, 20, 0.2f, 20, 1, 1, -1, &graph);
+		EnableTracing(false);
+
+		TraceStats stats;
+		GetTraceStats(&stats);
+		std::cout << stats.occlusion_rays << " occlusion rays in " << stats.generate_graph_ms << "ms" << std::endl;
+
+		WriteChromeTrace("graph_generator.json");
+		ResetTracing();
+	\endcode
+
+	@{
+*/
+
+/*!
+	\brief		Start or stop recording.
+
+	\param		enable	True to start recording, false to stop. Totals are kept until \link ResetTracing \endlink
+						is called.
+
+	\returns	HF_STATUS::OK on completion.
+*/
+C_INTERFACE EnableTracing(bool enable);
+
+/*!
+	\brief		Clear every total and stage recorded so far.
+
+	\returns	HF_STATUS::OK on completion.
+
+	\pre		No analysis or job is running. Totals recorded while the reset is in progress may be kept
+				or lost.
+*/
+C_INTERFACE ResetTracing();
+
+/*!
+	\brief		Get the totals recorded since tracing was last reset.
+
+	\param		out_stats	Set to the totals.
+
+	\returns	HF_STATUS::OK on completion.
+	\returns	HF_STATUS::INVALID_PTR if out_stats is null.
+*/
+C_INTERFACE GetTraceStats(TraceStats* out_stats);
+
+/*!
+	\brief		Save every stage recorded since tracing was last reset as a Chrome trace event JSON file.
+
+	\param		path	Path of the file to write. Overwritten if it already exists.
+
+	\returns	HF_STATUS::OK if the file was written.
+	\returns	HF_STATUS::INVALID_PTR if path is null.
+	\returns	HF_STATUS::NOT_FOUND if the file couldn't be opened for writing.
+*/
+C_INTERFACE WriteChromeTrace(const char* path);
+
+/**@}*/
+
+#endif /* TRACING_C_H */
@@ -1,6 +1,7 @@
 #include "visibility_graph_C.h"
 
 #include <vector>
+#include <stdexcept>
 #include <visibility_graph.h>
 #include <embree_raytracer.h>
 #include <graph.h>
@@ -97,3 +98,189 @@ C_INTERFACE CreateVisibilityGraphGroupToGroup(
 		return HF::Exceptions::HF_STATUS::NO_GRAPH;
 	}
 }
+
+C_INTERFACE CreateVisibilityGraphAllToAllInRange(
+	EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	Graph** out_graph,
+	float height,
+	float max_distance,
+	float upward_limit,
+	float downward_limit
+) {
+	auto array_of_nodes = ConvertRawFloatArrayToPoints(nodes, num_nodes);
+
+	vector<Node> vector_of_nodes(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		const auto& arr = array_of_nodes[i];
+		auto& vec = vector_of_nodes[i];
+
+		vec[0] = arr[0]; vec[1] = arr[1]; vec[2] = arr[2];
+	}
+
+	Graph* vg = new Graph();
+	*vg = VisibilityGraph::AllToAll(*ert, vector_of_nodes, height, max_distance, upward_limit, downward_limit);
+
+	*out_graph = vg;
+	return HF::Exceptions::HF_STATUS::OK;
+}
+
+C_INTERFACE CreateVisibilityGraphGroupToGroupInRange(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* group_a,
+	const int size_a,
+	const float* group_b,
+	const int size_b,
+	Graph** out_graph,
+	float height,
+	float max_distance,
+	float upward_limit,
+	float downward_limit
+) {
+	auto array_a = ConvertRawFloatArrayToPoints(group_a, size_a);
+	auto array_b = ConvertRawFloatArrayToPoints(group_b, size_b);
+
+	vector<Node> vector_a(size_a);
+	vector<Node> vector_b(size_b);
+	for (int i = 0; i < size_a; i++) {
+		const auto& arra = array_a[i];
+		auto& va = vector_a[i];
+		va[0] = arra[0]; va[1] = arra[1]; va[2] = arra[2];
+	}
+	for (int i = 0; i < size_b; i++) {
+		const auto& arrb = array_b[i];
+		auto& vb = vector_b[i];
+		vb[0] = arrb[0]; vb[1] = arrb[1]; vb[2] = arrb[2];
+	}
+	*out_graph = new Graph();
+
+	**out_graph = VisibilityGraph::GroupToGroup(
+		*ert, vector_a, vector_b, height, max_distance, upward_limit, downward_limit
+	);
+
+	if ((*out_graph)->GetCSRPointers().AreValid()) {
+		return HF::Exceptions::HF_STATUS::OK;
+	}
+	else {
+		delete* out_graph;
+		return HF::Exceptions::HF_STATUS::NO_GRAPH;
+	}
+}
+
+C_INTERFACE CreateVisibilityGraphAllToAllToFile(
+	EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	const char* path,
+	float height,
+	int storage,
+	int block_size,
+	long long* out_num_edges
+) {
+	// Files written with any other storage can't be loaded
+	const auto vg_storage = static_cast<VisibilityGraph::VG_STORAGE>(storage);
+	if (vg_storage != VisibilityGraph::VG_STORAGE::DISTANCES && vg_storage != VisibilityGraph::VG_STORAGE::VISIBILITY_ONLY)
+		return HF::Exceptions::HF_STATUS::OUT_OF_RANGE;
+
+	auto array_of_nodes = ConvertRawFloatArrayToPoints(nodes, num_nodes);
+
+	vector<Node> vector_of_nodes(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		const auto& arr = array_of_nodes[i];
+		auto& vec = vector_of_nodes[i];
+
+		vec[0] = arr[0]; vec[1] = arr[1]; vec[2] = arr[2];
+	}
+
+	try {
+		*out_num_edges = VisibilityGraph::AllToAllToFile(
+			*ert, vector_of_nodes, std::string(path), height, vg_storage, block_size
+		);
+	}
+	catch (...) {
+		return HF::Exceptions::HF_STATUS::GENERIC_ERROR;
+	}
+	return HF::Exceptions::HF_STATUS::OK;
+}
+
+C_INTERFACE LoadVisibilityGraphFromFile(
+	const char* path,
+	Graph** out_graph
+) {
+	try {
+		*out_graph = new Graph(VisibilityGraph::LoadVisibilityGraph(std::string(path)));
+	}
+	catch (const HF::Exceptions::FileNotFound&) {
+		return HF::Exceptions::HF_STATUS::NOT_FOUND;
+	}
+	catch (...) {
+		return HF::Exceptions::HF_STATUS::GENERIC_ERROR;
+	}
+	return HF::Exceptions::HF_STATUS::OK;
+}
+
+C_INTERFACE CalculateVisibilityDegreesAllToAll(
+	EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	float height,
+	float max_distance,
+	float upward_limit,
+	float downward_limit,
+	int* out_counts,
+	float* out_sum_distance,
+	float* out_max_distance
+) {
+	auto array_of_nodes = ConvertRawFloatArrayToPoints(nodes, num_nodes);
+
+	vector<Node> vector_of_nodes(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		const auto& arr = array_of_nodes[i];
+		auto& vec = vector_of_nodes[i];
+
+		vec[0] = arr[0]; vec[1] = arr[1]; vec[2] = arr[2];
+	}
+
+	auto degrees = VisibilityGraph::AllToAllDegrees(
+		*ert, vector_of_nodes, height, max_distance, upward_limit, downward_limit
+	);
+
+	std::copy(degrees.counts.begin(), degrees.counts.end(), out_counts);
+	std::copy(degrees.sum_distance.begin(), degrees.sum_distance.end(), out_sum_distance);
+	std::copy(degrees.max_distance.begin(), degrees.max_distance.end(), out_max_distance);
+
+	return HF::Exceptions::HF_STATUS::OK;
+}
+
+C_INTERFACE CreateVisibilityGraphAllToAllApproximate(
+	EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	Graph** out_graph,
+	float height,
+	float cluster_size,
+	float max_error
+) {
+	auto array_of_nodes = ConvertRawFloatArrayToPoints(nodes, num_nodes);
+
+	vector<Node> vector_of_nodes(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		const auto& arr = array_of_nodes[i];
+		auto& vec = vector_of_nodes[i];
+
+		vec[0] = arr[0]; vec[1] = arr[1]; vec[2] = arr[2];
+	}
+
+	Graph* vg = new Graph();
+	try {
+		*vg = VisibilityGraph::AllToAllApproximate(*ert, vector_of_nodes, height, cluster_size, max_error);
+	}
+	catch (const std::invalid_argument &) {
+		delete vg;
+		return HF::Exceptions::HF_STATUS::OUT_OF_RANGE;
+	}
+
+	*out_graph = vg;
+	return HF::Exceptions::HF_STATUS::OK;
+}
@@ -226,6 +226,233 @@ C_INTERFACE CreateVisibilityGraphGroupToGroup(
 	float height
 );
 
+/*!
+	\brief		Create a new directed visibility graph between all nodes in nodes, only connecting nodes within range
+				of eachother.
+
+	\param		ert				The raytracer to cast rays from
+
+	\param		nodes			Coordinates of nodes to use in generating the visibility graph.
+								Every three floats (every three members in nodes)
+								should represent a single node (point) {x, y, z}
+
+	\param		num_nodes		Amount of nodes (points) that will be used to generate the visibility graph.
+								This should be equal to (size of nodes / 3),
+								since every three floats represents a single point.
+
+	\param		out_graph		Address of (\link HF::SpatialStructures::Graph \endlink *); address of a pointer to a \link HF::SpatialStructures::Graph \endlink.
+								*(out_graph) will point to memory allocated by \link CreateVisibilityGraphAllToAllInRange \endlink.
+
+	\param		height			How far to offset nodes from the ground.
+
+	\param		max_distance	Maximum length of a sightline in meters. Set to -1 for no limit.
+
+	\param		upward_limit	Maximum angle in degrees above the horizon a node can see. 90 or more for no limit.
+
+	\param		downward_limit	Maximum angle in degrees below the horizon a node can see. 90 or more for no limit.
+
+	\returns	HF_STATUS::OK on completion
+
+	\details	Identical to \link CreateVisibilityGraphAllToAll \endlink, however pairs of nodes that are out of
+				range of eachother are never checked. See HF::VisibilityGraph::AllToAll for details.
+
+	\see		\link CreateVisibilityGraphAllToAll \endlink for an example of how to read the resulting graph.
+*/
+C_INTERFACE CreateVisibilityGraphAllToAllInRange(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	HF::SpatialStructures::Graph** out_graph,
+	float height,
+	float max_distance,
+	float upward_limit,
+	float downward_limit
+);
+
+/*!
+	\brief		Create a new visibility graph from the nodes in group_a, into the nodes of group_b, only connecting
+				nodes within range of eachother.
+
+	\param		ert				The raytracer to cast rays from
+
+	\param		group_a			Coordinates of nodes to cast rays from. (source node coordinates)
+								Every three floats (every three members in nodes)
+								should represent a single node (point) {x, y, z}
+
+	\param		size_a			Amount of nodes (points) in group_a.
+
+	\param		group_b			Coordinates of nodes to cast rays at. (destination node coordinates)
+
+	\param		size_b			Amount of nodes (points) in group_b.
+
+	\param		out_graph		Address of (\link HF::SpatialStructures::Graph \endlink *); address of a pointer to a \link HF::SpatialStructures::Graph \endlink.
+								*(out_graph) will point to memory allocated by \link CreateVisibilityGraphGroupToGroupInRange \endlink.
+
+	\param		height			How far to offset nodes from the ground.
+
+	\param		max_distance	Maximum length of a sightline in meters. Set to -1 for no limit.
+
+	\param		upward_limit	Maximum angle in degrees above the horizon a node in group_a can see. 90 or more for no limit.
+
+	\param		downward_limit	Maximum angle in degrees below the horizon a node in group_a can see. 90 or more for no limit.
+
+	\returns	HF_STATUS::OK on completion, HF_STATUS::NO_GRAPH if the resulting graph was invalid.
+
+	\see		\link CreateVisibilityGraphGroupToGroup \endlink for an example of how to read the resulting graph.
+*/
+C_INTERFACE CreateVisibilityGraphGroupToGroupInRange(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* group_a,
+	const int size_a,
+	const float* group_b,
+	const int size_b,
+	HF::SpatialStructures::Graph** out_graph,
+	float height,
+	float max_distance,
+	float upward_limit,
+	float downward_limit
+);
+
+/*!
+	\brief		Create a directed visibility graph between all nodes in nodes and write it straight to a file.
+
+	\param		ert				The raytracer to cast rays from
+
+	\param		nodes			Coordinates of nodes to use in generating the visibility graph.
+								Every three floats (every three members in nodes)
+								should represent a single node (point) {x, y, z}
+
+	\param		num_nodes		Amount of nodes (points) that will be used to generate the visibility graph.
+
+	\param		path			Path to write the visibility graph to. Will be overwritten if it already exists.
+
+	\param		height			How far to offset nodes from the ground.
+
+	\param		storage			0 to store the distance of every edge, 1 to only store which nodes are visible
+								from eachother. See HF::VisibilityGraph::VG_STORAGE.
+
+	\param		block_size		Number of nodes to calculate edges for before writing them to the file.
+
+	\param		out_num_edges	Output parameter for the number of edges written to the file.
+
+	\returns	HF_STATUS::OK on completion, HF_STATUS::OUT_OF_RANGE if storage isn't 0 or 1,
+				HF_STATUS::GENERIC_ERROR if the file couldn't be written.
+
+	\details	The entire graph is never held in memory, allowing graphs far larger than the available memory
+				to be generated. See HF::VisibilityGraph::AllToAllToFile for details. Use
+				\link LoadVisibilityGraphFromFile \endlink to read the graph back.
+*/
+C_INTERFACE CreateVisibilityGraphAllToAllToFile(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	const char* path,
+	float height,
+	int storage,
+	int block_size,
+	long long* out_num_edges
+);
+
+/*!
+	\brief		Load a visibility graph written by \link CreateVisibilityGraphAllToAllToFile \endlink.
+
+	\param		path			Path to the visibility graph file.
+
+	\param		out_graph		Address of (\link HF::SpatialStructures::Graph \endlink *); address of a pointer to a \link HF::SpatialStructures::Graph \endlink.
+								*(out_graph) will point to memory allocated by \link LoadVisibilityGraphFromFile \endlink.
+
+	\returns	HF_STATUS::OK on completion, HF_STATUS::NOT_FOUND if path doesn't exist,
+				HF_STATUS::GENERIC_ERROR if path isn't a valid visibility graph file.
+*/
+C_INTERFACE LoadVisibilityGraphFromFile(
+	const char* path,
+	HF::SpatialStructures::Graph** out_graph
+);
+
+/*!
+	\brief		Calculate how many nodes each node can see, and the sum and maximum distance of their sightlines,
+				without creating a graph.
+
+	\param		ert					The raytracer to cast rays from
+
+	\param		nodes				Coordinates of nodes to check visibility for.
+									Every three floats should represent a single node (point) {x, y, z}
+
+	\param		num_nodes			Amount of nodes (points) in nodes.
+
+	\param		height				How far to offset nodes from the ground.
+
+	\param		max_distance		Maximum length of a sightline in meters. Set to -1 for no limit.
+
+	\param		upward_limit		Maximum angle in degrees above the horizon a node can see. 90 or more for no limit.
+
+	\param		downward_limit		Maximum angle in degrees below the horizon a node can see. 90 or more for no limit.
+
+	\param		out_counts			Array of num_nodes ints that will be filled with the number of nodes visible from each node.
+
+	\param		out_sum_distance	Array of num_nodes floats that will be filled with the sum of the distances to every 
+									node visible from each node.
+
+	\param		out_max_distance	Array of num_nodes floats that will be filled with the distance to the furthest 
+									node visible from each node.
+
+	\returns	HF_STATUS::OK on completion.
+
+	\details	Memory for all output arrays must be allocated by the caller. See HF::VisibilityGraph::AllToAllDegrees
+				for details.
+*/
+C_INTERFACE CalculateVisibilityDegreesAllToAll(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	float height,
+	float max_distance,
+	float upward_limit,
+	float downward_limit,
+	int* out_counts,
+	float* out_sum_distance,
+	float* out_max_distance
+);
+
+/*!
+	\brief		Create an approximate visibility graph between all nodes in nodes by checking visibility between
+				clusters of nodes.
+
+	\param		ert				The raytracer to cast rays from
+
+	\param		nodes			Coordinates of nodes to use in generating the visibility graph.
+								Every three floats (every three members in nodes)
+								should represent a single node (point) {x, y, z}
+
+	\param		num_nodes		Amount of nodes (points) that will be used to generate the visibility graph.
+
+	\param		out_graph		Address of (\link HF::SpatialStructures::Graph \endlink *); address of a pointer to a \link HF::SpatialStructures::Graph \endlink.
+								*(out_graph) will point to memory allocated by \link CreateVisibilityGraphAllToAllApproximate \endlink.
+
+	\param		height			How far to offset nodes from the ground.
+
+	\param		cluster_size	Width in meters of the cells nodes are clustered into. Must be greater than 0.
+
+	\param		max_error		Fraction of representative rays between two clusters that may disagree before the
+								pair is checked node by node. 0 only accepts pairs where every ray agrees.
+
+	\returns	HF_STATUS::OK on completion
+	\returns	HF_STATUS::OUT_OF_RANGE if cluster_size is not greater than 0, or max_error is not between 0 and 1.
+
+	\details	See HF::VisibilityGraph::AllToAllApproximate for details.
+
+	\see		\link CreateVisibilityGraphAllToAll \endlink for an example of how to read the resulting graph.
+*/
+C_INTERFACE CreateVisibilityGraphAllToAllApproximate(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	HF::SpatialStructures::Graph** out_graph,
+	float height,
+	float cluster_size,
+	float max_error
+);
+
 /**@}*/
 
 #endif /* VISIBILITY_GRAPH_C_H */
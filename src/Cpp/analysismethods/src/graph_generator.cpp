@@ -10,17 +10,23 @@
 #include <node.h>
 #include <Edge.h>
 #include <graph.h>
+#include <cost_algorithms.h>
 #include <robin_hood.h>
 #include <omp.h>
+#include <parallelism.h>
+#include <tracing.h>
 
 #include <unique_queue.h>
 
+#include <algorithm>
 #include <iostream>
 #include <thread>
 
 using HF::SpatialStructures::Graph;
 using HF::SpatialStructures::Node;
 using HF::SpatialStructures::Edge;
+using HF::SpatialStructures::IntEdge;
+using HF::SpatialStructures::Subgraph;
 using HF::SpatialStructures::roundhf_tmp;
 using HF::SpatialStructures::trunchf_tmp;
 
@@ -28,15 +34,6 @@ using std::vector;
 using HF::GraphGenerator::GeometryFlagMap;
 
 namespace HF::GraphGenerator{ 
-	/*! \brief Sets the core count of OpenMP
-
-		\param cores Number of cores to use. If -1, use every as many cores as possible 
-	*/
-	inline void SetupCoreCount(int cores = -1) {
-		if (cores > 1)	omp_set_num_threads(cores);
-		else omp_set_num_threads(std::thread::hardware_concurrency());
-	}
-
 	/*! \brief Converts the raytracer to a multiRT if required, then map geometry ids to hitflags 
 		
 		\param gg Pointer to the graph generator to update
@@ -52,6 +49,112 @@ namespace HF::GraphGenerator{
 		gg->params.geom_ids.SetGeometryIds(obs_ids, walk_ids);
 	}
 
+	/*! \brief Get every INLINE_COST set in inline_costs, in the order their arrays are stored. */
+	inline vector<INLINE_COST> SelectedCosts(int inline_costs) {
+		vector<INLINE_COST> selected;
+		for (INLINE_COST cost : { INLINE_ENERGY_EXPENDITURE, INLINE_CROSS_SLOPE, INLINE_SLOPE })
+			if (inline_costs & cost) selected.push_back(cost);
+		return selected;
+	}
+
+	/*! \brief Calculate the selected costs of every edge from a parent, except for cross slope.
+
+		\param parent Node the edges extend from.
+		\param edges Edges from parent, in the order they'll be added to the graph.
+		\param selected Costs to calculate, from SelectedCosts.
+
+		\returns Every selected cost of the first edge, followed by every selected cost of the second edge,
+				 and so on. Cross slopes are left at 0 for CalculateInlineCrossSlopes.
+	*/
+	inline vector<float> CalculateInlineCosts(const Node& parent, const vector<Edge>& edges, const vector<INLINE_COST>& selected)
+	{
+		using namespace HF::SpatialStructures::CostAlgorithms;
+
+		vector<float> costs(edges.size() * selected.size());
+		for (size_t e = 0; e < edges.size(); e++) {
+			for (size_t c = 0; c < selected.size(); c++) {
+				float& cost = costs[e * selected.size() + c];
+				switch (selected[c]) {
+				case INLINE_ENERGY_EXPENDITURE:
+					cost = static_cast<float>(CalculateEnergyExpenditure(parent, edges[e].child));
+					break;
+				case INLINE_SLOPE:
+					cost = static_cast<float>(CalculateSlope(parent, edges[e].child));
+					break;
+				default:
+					break;
+				}
+			}
+		}
+		return costs;
+	}
+
+	/*! \brief Calculate the cross slope of every edge from a parent, after the edges were added to G.
+
+		\param G Graph the edges were added to.
+		\param parent Node the edges extend from.
+		\param edges Edges from parent, in the order they were added to the graph.
+		\param selected Costs that are being calculated, from SelectedCosts.
+		\param costs Costs of the edges from CalculateInlineCosts. The cross slope of each edge is written here.
+
+		\details
+		Cross slope compares every edge to the other edges from the same parent, and uses the first
+		perpendicular edge it finds, so the edges are passed to CalculateCrossSlope ordered by child ID.
+		That's the order the graph stores them in, so the costs match CalculateCrossSlope on the finished graph.
+	*/
+	inline void CalculateInlineCrossSlopes(
+		const Graph& G,
+		const Node& parent,
+		const vector<Edge>& edges,
+		const vector<INLINE_COST>& selected,
+		vector<float>& costs
+	) {
+		const auto slot = std::find(selected.begin(), selected.end(), INLINE_CROSS_SLOPE) - selected.begin();
+		if (slot == selected.size()) return;
+
+		vector<std::pair<int, size_t>> order(edges.size());
+		for (size_t e = 0; e < edges.size(); e++)
+			order[e] = { G.getID(edges[e].child), e };
+		std::sort(order.begin(), order.end());
+
+		Subgraph sg{ parent, {} };
+		for (const auto& child : order)
+			sg.m_edges.push_back(edges[child.second]);
+
+		const vector<IntEdge> cross_slopes = HF::SpatialStructures::CostAlgorithms::CalculateCrossSlope(sg);
+		for (size_t i = 0; i < order.size(); i++)
+			costs[order[i].second * selected.size() + slot] = cross_slopes[i].weight;
+	}
+
+	/*! \brief Store the inline costs in G and compress it, if any costs were selected. 
+	
+		\param G Graph the costs were calculated for.
+		\param selected Costs that were calculated, from SelectedCosts.
+		\param costs Array of every edge's cost for each cost in selected, in the order the edges were added.
+	*/
+	inline void StoreInlineCosts(Graph& G, const vector<INLINE_COST>& selected, const vector<vector<float>>& costs) {
+		if (selected.empty()) return;
+
+		vector<std::string> names;
+		for (INLINE_COST cost : selected)
+			names.push_back(InlineCostName(cost));
+
+		G.CompressWithCosts(names, costs);
+	}
+
+	const char* InlineCostName(INLINE_COST cost) {
+		switch (cost) {
+		case INLINE_ENERGY_EXPENDITURE:
+			return "EnergyExpenditure";
+		case INLINE_CROSS_SLOPE:
+			return "CrossSlope";
+		case INLINE_SLOPE:
+			return "Slope";
+		default:
+			return "";
+		}
+	}
+
 	GraphGenerator::GraphGenerator(HF::RayTracer::EmbreeRayTracer & rt, const vector<int> & obstacle_ids, const vector<int> & walkable_ids){
 		setupRT<HF::RayTracer::EmbreeRayTracer> (this, rt, obstacle_ids, walkable_ids);
 	}
@@ -66,6 +169,25 @@ namespace HF::GraphGenerator{
 		this->params.geom_ids.SetGeometryIds(obstacle_ids, walkable_ids);
 	}
 
+	std::array<real3, 2> GraphGenerator::MaxExtent(
+		const real3& start_point,
+		const real3& Spacing,
+		int MaxNodes,
+		int max_step_connections)
+	{
+		const real_t infinity = std::numeric_limits<real_t>::infinity();
+		std::array<real3, 2> extent{ real3{ -infinity, -infinity, -infinity }, real3{ infinity, infinity, infinity } };
+		if (MaxNodes < 0) return extent;
+
+		// Every node is at most MaxNodes steps from the start
+		for (int axis = 0; axis < 2; axis++) {
+			const real_t reach = static_cast<real_t>(MaxNodes) * std::max(max_step_connections, 1) * std::abs(Spacing[axis]);
+			extent[0][axis] = start_point[axis] - reach;
+			extent[1][axis] = start_point[axis] + reach;
+		}
+		return extent;
+	}
+
 	SpatialStructures::Graph GraphGenerator::IMPL_BuildNetwork(
 		const real3& start_point,
 		const real3& Spacing,
@@ -79,8 +201,11 @@ namespace HF::GraphGenerator{
 		int cores,
 		real_t node_z_precision,
 		real_t node_spacing_precision,
-		real_t ground_offset)
+		real_t ground_offset,
+		int inline_costs)
 	{
+		HF::Tracing::ScopedTimer timer(HF::Tracing::GENERATE_GRAPH);
+
 		if (ground_offset < node_z_precision)
 		{
 			std::cerr << "Ground offset is less than z-precision. Setting node offset to Z-Precision." << std::endl;
@@ -102,6 +227,7 @@ namespace HF::GraphGenerator{
 		this->core_count = cores;
 		this->max_step_connection = max_step_connections;
 		this->min_connections = min_connections;
+		this->inline_costs = inline_costs;
 		
 		// Take the user defined start point and round it to the precision
 		// that the dhart package can handle. 
@@ -127,7 +253,6 @@ namespace HF::GraphGenerator{
 			// If no connection was found, return an empty graph
 			if (this->core_count != 0 && this->core_count != 1)
 			{
-				SetupCoreCount(this->core_count);
 				return CrawlGeomParallel(to_do_list);
 			}
 			// Run the single core version of the graph generator
@@ -149,6 +274,10 @@ namespace HF::GraphGenerator{
 
 		RayTracer & rt_ref = this->ray_tracer;
 
+		// Alternate costs of every edge, in the order the edges are added
+		const auto selected_costs = SelectedCosts(this->inline_costs);
+		vector<vector<float>> costs(selected_costs.size());
+
 		Graph G;
 		// Iterate through every node int the todo-list while it does not reach the maximum number of nodes limit
 		while (!todo.empty() && (num_nodes < max_nodes || max_nodes < 0))
@@ -161,6 +290,7 @@ namespace HF::GraphGenerator{
 
 			// Get as many nodes as possible out of the queue
 			auto to_be_done = todo.popMany(to_do_count);
+			HF::Tracing::Count(HF::Tracing::NODES_POPPED, to_be_done.size());
 
 			// If this happens, that means something is wrong with the algorithm
 			// since to_be_done with a size of zero would just cause the outer
@@ -169,9 +299,11 @@ namespace HF::GraphGenerator{
 
 			// Create array arrays of edges that will be used to store results
 			vector<vector<Edge>> OutEdges(to_do_count);
+			vector<vector<float>> OutCosts(to_do_count);
 
 			// Compute valid children for every node in parallel.
-			#pragma omp parallel for schedule(dynamic) if (to_be_done.size() > 100)
+			HF::Parallel::ThreadLease lease(this->core_count, to_do_count);
+			#pragma omp parallel for schedule(dynamic) if (to_be_done.size() > 100) num_threads(lease.size())
 			for (int i = 0; i < to_do_count; i++)
 			{
 				// Get the parent node from the todo list at index i
@@ -195,6 +327,10 @@ namespace HF::GraphGenerator{
 					rt_ref,
 					params
 				);
+
+				// Calculate the alternate costs while the edges are still in hand
+				if (!selected_costs.empty() && !OutEdges[i].empty() && OutEdges[i].size() >= this->min_connections)
+					OutCosts[i] = CalculateInlineCosts(n, OutEdges[i], selected_costs);
 			}
 
 			// Go through each edge array we just calculated, then 
@@ -207,8 +343,12 @@ namespace HF::GraphGenerator{
 					// Iterate through each edge and add it to the graph / todolist
 					for (const auto& e : OutEdges[i]) {
 						todo.push(e.child);
-						G.addEdge(to_be_done[i], e.child, e.score);
+						G.addEdge(to_be_done[i], e.child, e.score, e.step_type);
 					}
+					CalculateInlineCrossSlopes(G, to_be_done[i], OutEdges[i], selected_costs, OutCosts[i]);
+					for (size_t j = 0; j < OutCosts[i].size(); j++)
+						costs[j % selected_costs.size()].push_back(OutCosts[i][j]);
+					HF::Tracing::Count(HF::Tracing::EDGES_ADDED, OutEdges[i].size());
 					
 					// Increment max nodes
 					num_nodes++;
@@ -216,6 +356,7 @@ namespace HF::GraphGenerator{
 			}
 		}
 
+		StoreInlineCosts(G, selected_costs, costs);
 		return G;
 	}
 
@@ -227,12 +368,17 @@ namespace HF::GraphGenerator{
 		// Cast this to a reference to avoid dereferencing every time
 		RayTracer& rt_ref = this->ray_tracer;
 
+		// Alternate costs of every edge, in the order the edges are added
+		const auto selected_costs = SelectedCosts(this->inline_costs);
+		vector<vector<float>> costs(selected_costs.size());
+
 		int num_nodes = 0;
 		Graph G;
 		while (!todo.empty() && (num_nodes < this->max_nodes || this->max_nodes < 0)) {
 
 			// Get the parent node from the todo list
 			const auto parent = todo.pop();
+			HF::Tracing::Count(HF::Tracing::NODES_POPPED);
 
 			// To maintain our precision standards, we'll convert this node to a real3.
 			const auto real_parent = CastToReal3(parent);
@@ -265,12 +411,22 @@ namespace HF::GraphGenerator{
 				// Add new edges to the graph
 				if (!OutEdges.empty())
 					for (const auto& edge : OutEdges)
-						G.addEdge(parent, edge.child, edge.score);
+						G.addEdge(parent, edge.child, edge.score, edge.step_type);
+				HF::Tracing::Count(HF::Tracing::EDGES_ADDED, OutEdges.size());
+
+				if (!selected_costs.empty()) {
+					auto edge_costs = CalculateInlineCosts(parent, OutEdges, selected_costs);
+					CalculateInlineCrossSlopes(G, parent, OutEdges, selected_costs, edge_costs);
+					for (size_t j = 0; j < edge_costs.size(); j++)
+						costs[j % selected_costs.size()].push_back(edge_costs[j]);
+				}
 
 				// Increment node count
 				num_nodes++;
 			}
 		}
+
+		StoreInlineCosts(G, selected_costs, costs);
 		return G;
 	}
 }
\ No newline at end of file
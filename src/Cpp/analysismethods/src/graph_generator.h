@@ -11,6 +11,7 @@
 #include <set>
 #include <vector>
 #include <array>
+#include <limits>
 #include <Node.h>
 #include <cassert>
 #include <variant>
@@ -261,6 +262,37 @@ namespace HF::GraphGenerator {
 		GeometryFlagMap geom_ids; ///< Stores a map of geometry IDs to their HIT_FLAGS and the current filter mode of the graph
 	};
 
+	/*!
+		\brief Alternate costs the GraphGenerator can calculate for every edge as the edge is created.
+
+		\details
+		Combine these with | to calculate several costs at once. Each cost is stored in the generated
+		graph as an alternate cost array named InlineCostName(cost), and matches the cost the equivalent
+		function in HF::SpatialStructures::CostAlgorithms calculates for the same edge afterwards.
+
+		Step types aren't an inline cost, since every generated graph already stores the step of each
+		edge. Read them with Graph::GetStepType(), or turn them into a cost array with
+		Graph::CreateStepCost().
+	*/
+	enum INLINE_COST {
+		/// Don't calculate any alternate costs.
+		INLINE_NONE = 0,
+		/// Energy expended traversing the edge. See CostAlgorithms::CalculateEnergyExpenditure.
+		INLINE_ENERGY_EXPENDITURE = 1,
+		/// Cross slope of the edge. See CostAlgorithms::CalculateCrossSlope.
+		INLINE_CROSS_SLOPE = 2,
+		/// Slope from the parent to the child in degrees. See CostAlgorithms::CalculateSlope.
+		INLINE_SLOPE = 4
+	};
+
+	/*!
+		\brief Get the name of the cost array an INLINE_COST is stored in.
+
+		\returns "EnergyExpenditure", "CrossSlope" or "Slope". The first two match the
+		names used by the C interface's CalculateAndStore functions.
+	*/
+	const char* InlineCostName(INLINE_COST cost);
+
 	/*! 
 		\brief A simple wrapper for real3 that is able to determine whether or not it's defined.
 		
@@ -350,6 +382,7 @@ namespace HF::GraphGenerator {
 		int min_connections;  ///< Minimum number of step connections for a node to be valid (minimum out degree of node)
 		int max_step_connection; ///< Multiplier for number of children to generate. The higher this is, the more directions there will be
 		real3 spacing;			///< Spacing between nodes. New nodes will be generated with atleast this much distance between them. 
+		int inline_costs = INLINE_NONE;	///< INLINE_COST flags of the alternate costs to calculate for every edge.
 
 		GraphParams params; ///< Parameters to run the graph generator. 
 
@@ -429,8 +462,10 @@ namespace HF::GraphGenerator {
 			\param node_z_precision		  Precision to round the z-component of nodes after a raycast is performed
 			\param node_spacing_precision Precision to round nodes after spacing is calculated
 			\param ground_offset		  Distance to offset nodes from the ground before checking line of sight
+			\param inline_costs		  INLINE_COST flags of alternate costs to calculate for every edge as it's created.
 
-			\returns The resulting graph or an empty graph if the start check failed
+			\returns The resulting graph or an empty graph if the start check failed. If any inline_costs
+			 were requested, the graph is already compressed and holds a cost array for each of them.
 			 
 			\note All parameters relating to distances are in meters, and all angles are in degrees.
 			\note Geometry MUST be Z-UP in order for this to work. 
@@ -474,7 +509,8 @@ namespace HF::GraphGenerator {
 			int cores = -1,
 			z_precision_type node_z_precision = default_z_precision,
 			connect_offset_type  node_spacing_precision = default_spacing_precision,
-			spacing_precision_type ground_offset = default_ground_offset
+			spacing_precision_type ground_offset = default_ground_offset,
+			int inline_costs = INLINE_NONE
 		) {
 			assert(node_z_precision != 0);
 			return IMPL_BuildNetwork(
@@ -490,7 +526,8 @@ namespace HF::GraphGenerator {
 				cores,
 				CastToReal(node_z_precision),
 				CastToReal(node_spacing_precision),
-				CastToReal(ground_offset)
+				CastToReal(ground_offset),
+				inline_costs
 			);
 		}
 
@@ -525,9 +562,16 @@ namespace HF::GraphGenerator {
 			\param node_z_precision		  Precision to round the z-component of nodes after a raycast is performed
 			\param node_spacing_precision Precision to round nodes after spacing is calculated
 			\param ground_offset		  Distance to offset nodes from the ground before checking line of sight
+			\param inline_costs		  INLINE_COST flags of alternate costs to calculate for every edge as it's created.
 
 			\returns The resulting graph or an empty graph if the start check failed.
 			 
+			\details
+			When inline_costs is set, each cost is calculated from the parent and its edges while they're
+			still in hand, in parallel with the raycasts when multiple cores are used. The costs are kept in
+			the order the edges are added, then laid out by Graph::CompressWithCosts, which saves the
+			second pass over every subgraph that CostAlgorithms needs.
+			 
 			\note All parameters relating to distances are in meters, and all angles are in degrees.
 			\note Geometry MUST be Z-UP in order for this to work. 
 			
@@ -546,10 +590,42 @@ namespace HF::GraphGenerator {
 			int cores = -1,
 			real_t node_z_precision = default_z_precision,
 			real_t node_spacing_precision = default_spacing_precision,
-			real_t ground_offset = default_ground_offset
+			real_t ground_offset = default_ground_offset,
+			int inline_costs = INLINE_NONE
 		);
 
 
+		/*!
+			\brief Get a box that contains every point a graph with these settings could reach.
+
+			\param start_point The starting point for the graph generator.
+			\param Spacing Space between nodes.
+			\param MaxNodes The maximum amount of nodes to generate. If less than zero, the box is infinite.
+			\param max_step_connections Multiplier for number of children to generate for each node.
+
+			\returns The corners of the box with the smallest and largest coordinates, in that order.
+
+			\details
+			Every node is at most one step away from the node it was found from, and each step covers at
+			most `max_step_connections` times the spacing in x and y. Since only MaxNodes nodes are ever
+			expanded, no node or ray cast during generation can be more than MaxNodes steps away from
+			the start point. The z axis is left unbounded, since walls and ceilings above or below a
+			node still block its edges.
+
+			Pass the result to HF::Geometry::MeshInfo::CropToBox before creating a raytracer, so the BVH
+			only contains geometry the graph generator could touch.
+
+			\remarks
+			This bound is exact for a graph that walks in a straight line, so for open areas it's much
+			larger than the graph that's actually produced.
+		*/
+		static std::array<real3, 2> MaxExtent(
+			const real3& start_point,
+			const real3& Spacing,
+			int MaxNodes,
+			int max_step_connections
+		);
+
 		/*!
 			\brief Perform breadth first search to populate the graph with with nodes and edges. 
 
@@ -6,10 +6,13 @@
 ///	\date		26 Jun 2020
 
 #include <unique_queue.h>
+#include <tracing.h>
 
 namespace HF::GraphGenerator{
 	bool UniqueQueue::push(const HF::SpatialStructures::Node& p)
 	{
+		HF::Tracing::Count(HF::Tracing::HASH_PROBES);
+
 		// Only insert if it's not set to 1
 		if (hashmap[p])
 			return false;
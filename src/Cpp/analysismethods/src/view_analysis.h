@@ -12,6 +12,10 @@
 #include <assert.h>
 #include <limits>
 
+#include <cancellation.h>
+#include <parallelism.h>
+#include <tracing.h>
+
 #ifndef VIEW_ANALYSIS_G
 #define VIEW_ANALYSIS_G
 
@@ -230,6 +234,7 @@ namespace HF::ViewAnalysis {
 	/// \param downward_limit Maximum angle in degrees to cast rays below the viewpoint.
 	/// \param height Height off the ground to cast from. All points in Nodes will be offset
 	/// this distance from the ground (+Z) before calculations are performed
+	/// \param token Token to cancel the analysis and report its progress through. May be nullptr.
 	/*!
 		\ingroup ViewAnalysis
 		\tparam RES A class or struct that has a .SetHit() function. This function will be called with the
@@ -249,8 +254,12 @@ namespace HF::ViewAnalysis {
 		This function will run in parallel using all available cores. Depending on RES, this function's complexity and results
 		can vary.
 
+		If token is cancelled, nodes that haven't been analyzed yet are skipped. Progress is reported once
+		for every node.
+
 		\exception std::bad_array_new_length The number of rays is larger than that which can be stored
 		in a std::vector.
+		\exception HF::Exceptions::OperationCancelled token was cancelled before every node was analyzed.
 
 		\see FibbonacciDistributePoints For details on how the directions are calculated from num_rays.
 		\see SphericalRayshootWithAnyRTForDistance for a more efficent method of getting a summary of the results.
@@ -338,8 +347,11 @@ namespace HF::ViewAnalysis {
 		int num_rays,
 		float upward_limit = 50.0f,
 		float downward_limit = 70.0f,
-		float height = 1.7f)
+		float height = 1.7f,
+		HF::Exceptions::CancellationToken* token = nullptr)
 	{
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VIEW_ANALYSIS);
+
 		// Calculate directions then perform a quick check to see if we can even hold this vector
 		const auto directions = FibbonacciDistributePoints(num_rays, upward_limit, downward_limit);
 		int required_vector_size = directions.size() * Nodes.size();
@@ -355,13 +367,18 @@ namespace HF::ViewAnalysis {
 
 		// Size of the vector is the number of rays
 		num_rays = directions.size();
+		if (token) token->AddWork(Nodes.size());
 
-		#pragma omp parallel
+		HF::Parallel::ThreadLease lease(-1, Nodes.size());
+		#pragma omp parallel num_threads(lease.size())
 		{
 		// Start parallel intersections
 		#pragma omp for schedule(dynamic) 
 			for (int i = 0; i < Nodes.size(); i++)
 			{
+				// Skip the remaining nodes once cancelled, since an OpenMP loop can't break early
+				if (token && token->IsCancelled()) continue;
+
 				// Reset out values to temporarily store results. Kept private by defining here
 				float out_distance = 0;
 				int out_mid = 0;
@@ -380,8 +397,11 @@ namespace HF::ViewAnalysis {
 						out_results[idx].SetHit(node, directions[k], out_distance, out_mid);
 					}
 				} // End direction loop
+
+				if (token) token->Advance();
 			} // End node loop
 		} // End omp space
+		if (token) token->ThrowIfCancelled();
 
 		return out_results;
 	}
@@ -490,11 +510,14 @@ namespace HF::ViewAnalysis {
 		float height = 1.7f,
 		const AGGREGATE_TYPE aggregation = AGGREGATE_TYPE::SUM)
 	{
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VIEW_ANALYSIS);
+
 		// Allocate score array and calculate directions
 		std::vector<float> out_scores(Nodes.size());
 		const auto directions = FibbonacciDistributePoints(num_rays, upward_limit, downward_limit);
 
-		#pragma omp parallel
+		HF::Parallel::ThreadLease lease(-1, Nodes.size());
+		#pragma omp parallel num_threads(lease.size())
 		{
 			// Start parallel intersections
 		#pragma omp for schedule(dynamic) 
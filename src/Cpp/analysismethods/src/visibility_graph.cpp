@@ -6,9 +6,16 @@
 ///	\date		17 Jun 2020
 
 #include <visibility_graph.h>
+#include <visibility_matrix.h>
 
 #include <array>
 #include <thread>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+#include <fstream>
+#include <memory>
 #include <omp.h>
 #include<algorithm>
 
@@ -18,6 +25,10 @@
 #include <Edge.h>
 #include <node.h>
 #include <Constants.h>
+#include <HFExceptions.h>
+#include <cancellation.h>
+#include <parallelism.h>
+#include <tracing.h>
 
 using namespace HF;
 using namespace HF::SpatialStructures;
@@ -55,6 +66,58 @@ namespace HF::VisibilityGraph {
 	}
 
 
+	/*!
+		\brief Get the index of every element in occluded that is false.
+
+		\param occluded Results of a set of occlusion rays.
+
+		\returns The indexes of every element in occluded that is false in ascending order.
+
+		\details
+		A parallel stream compaction. occluded is split into one block per thread, and every block counts
+		how many of its elements are unoccluded. An exclusive prefix sum over these counts gives the offset
+		that each block will start writing at in the output array, so every block can then write
+		its indexes in parallel without any synchronization.
+	*/
+	vector<int> UnoccludedIndices(const vector<char>& occluded) {
+		const int n = occluded.size();
+		HF::Parallel::ThreadLease lease(-1, n);
+		const int num_blocks = lease.size();
+		const int block_size = (n + num_blocks - 1) / num_blocks;
+
+		// Count the number of unoccluded elements in every block
+		vector<int> block_offsets(num_blocks + 1, 0);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int b = 0; b < num_blocks; b++) {
+			const int start = b * block_size;
+			const int end = std::min(n, start + block_size);
+
+			int count = 0;
+			for (int i = start; i < end; i++)
+				if (!occluded[i]) count++;
+
+			block_offsets[b + 1] = count;
+		}
+
+		// Prefix sum over the counts to find where each block begins in the output
+		for (int b = 0; b < num_blocks; b++)
+			block_offsets[b + 1] += block_offsets[b];
+
+		// Write the indexes of every block into their place in the output
+		vector<int> out_indices(block_offsets[num_blocks]);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int b = 0; b < num_blocks; b++) {
+			const int start = b * block_size;
+			const int end = std::min(n, start + block_size);
+
+			int write_index = block_offsets[b];
+			for (int i = start; i < end; i++)
+				if (!occluded[i]) out_indices[write_index++] = i;
+		}
+
+		return out_indices;
+	}
+
 	/*!
 		\brief Obtain the indexes of all nodes that pass the HeightCheck.
 
@@ -64,21 +127,163 @@ namespace HF::VisibilityGraph {
 
 		\returns The indexes in nodes_to_filter of all nodes that pass the height check.
 
+		\details
+		Every height check is cast at once in parallel using EmbreeRayTracer::Occlusions, then the
+		indexes of the nodes that passed are gathered with UnoccludedIndices. 
+
 		\see HeightCheck
 	*/
 	vector<int> HeightCheckAllNodes(const vector<Node>& nodes_to_filter, float height, EmbreeRayTracer& ert) {
-		vector<int> valid_nodes;
+		const int n = nodes_to_filter.size();
+		if (n == 0) return vector<int>();
+
+		// Create a copy of every node that's slightly offset off of the ground to ensure
+		// it doesn't intersect with the ground
+		vector<array<float, 3>> origins(n);
+		{
+			HF::Parallel::ThreadLease lease(-1, n);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+			for (int i = 0; i < n; i++) {
+				const auto& node = nodes_to_filter[i];
+				origins[i] = array<float, 3>{node[0], node[1], node[2] + ROUNDING_PRECISION};
+			}
+		}
+
+		// Cast an occlusion ray straight up from every node with a distance of height.
+		const vector<array<float, 3>> up{ array<float, 3>{ 0,0,1 } };
+		const vector<char> occluded = ert.Occlusions(origins, up, height);
+
+		return UnoccludedIndices(occluded);
+	}
+
+	/*!
+		\brief A uniform grid over a subset of nodes for fixed radius neighbour queries.
+
+		\details
+		Space is divided into cubic cells with a width equal to the search radius, so every node within
+		range of a point is guaranteed to be in the point's cell or one of the 26 cells surrounding it.
+		Cells are stored sparsely in a hashmap keyed on their packed integer coordinates, so empty space
+		costs nothing.
+
+		\remarks
+		Cell coordinates are packed into 21 bits per axis. Coordinates that overflow this range wrap
+		around and share cells with other nodes. This only ever adds extra candidates to a query,
+		which are then rejected by the distance check. For the same reason, coordinates too far from
+		the origin to fit in an int are clamped to the outermost cell instead of overflowing.
+	*/
+	class NodeGrid {
+		static constexpr int max_cell = 1 << 30;			///< Largest cell coordinate on any axis. Leaves room for the neighbors of a cell.
+
+		double cell_size = 1.0;								///< Width of each cell in meters.
+		robin_hood::unordered_map<long long, vector<int>> cells;	///< Packed cell coordinates : indexes of the nodes in that cell.
+
+		/*! \brief Get the integer coordinate of the cell containing value on one axis, clamped to max_cell. */
+		inline int CellCoord(float value) const {
+			const double cell = std::floor(static_cast<double>(value) / cell_size);
+
+			// Also catches NaN, which fails every comparison
+			if (!(cell > -max_cell)) return -max_cell;
+			else if (cell > max_cell) return max_cell;
+			else return static_cast<int>(cell);
+		}
+
+		/*! \brief Pack the coordinates of a cell into a single key. */
+		inline static long long CellKey(int x, int y, int z) {
+			const long long mask = 0x1FFFFF;
+			return ((static_cast<long long>(x) & mask) << 42)
+				| ((static_cast<long long>(y) & mask) << 21)
+				| (static_cast<long long>(z) & mask);
+		}
+
+	public:
+		/*! \brief Construct an empty grid. */
+		NodeGrid() {};
+
+		/*!
+			\brief Sort the nodes at indices into cells of width cell_size.
+
+			\param nodes Nodes to index into.
+			\param indices Indexes of the nodes in nodes to insert into the grid.
+			\param cell_size Width of every cell. Should be equal to the radius that will be used for queries.
+
+			\throws std::invalid_argument cell_size is NaN or not greater than 0.
+		*/
+		NodeGrid(const vector<Node>& nodes, const vector<int>& indices, float cell_size) : cell_size(cell_size) {
+			if (!(cell_size > 0.0f))
+				throw std::invalid_argument("Cell size must be greater than 0");
+
+			for (int index : indices) {
+				const Node& node = nodes[index];
+				cells[CellKey(CellCoord(node.x), CellCoord(node.y), CellCoord(node.z))].push_back(index);
+			}
+		}
+
+		/*!
+			\brief Get the indexes of every node in the cells surrounding point.
+
+			\param point Point to search around.
+			\param out_candidates Output vector for indexes. Will be cleared before anything is inserted.
+
+			\post out_candidates contains every indexed node within cell_size of point in ascending order.
+			Nodes farther than cell_size may also be included, so callers must still check distance.
+		*/
+		void Candidates(const Node& point, vector<int>& out_candidates) const {
+			out_candidates.clear();
+
+			const int cx = CellCoord(point.x);
+			const int cy = CellCoord(point.y);
+			const int cz = CellCoord(point.z);
 
-		// Loop through every node in nodes_to_filter
-		for (int i = 0; i < nodes_to_filter.size(); i++) {
+			// Gather nodes from this cell and every adjacent cell
+			for (int x = cx - 1; x <= cx + 1; x++)
+				for (int y = cy - 1; y <= cy + 1; y++)
+					for (int z = cz - 1; z <= cz + 1; z++) {
+						const auto cell = cells.find(CellKey(x, y, z));
+						if (cell != cells.end())
+							out_candidates.insert(out_candidates.end(), cell->second.begin(), cell->second.end());
+					}
+
+			// Sort so edges are added in the same order as they would be without the grid
+			std::sort(out_candidates.begin(), out_candidates.end());
+		}
 
-			// If the node passes the height check, insert its index
-			// into valid_nodes.
-			const auto& node = nodes_to_filter[i];
-			if (HeightCheck(node, height, ert))
-				valid_nodes.push_back(i);
+		/*! \brief Get the indexes of the nodes in every non-empty cell of the grid. */
+		vector<vector<int>> Cells() const {
+			vector<vector<int>> out_cells;
+			out_cells.reserve(cells.size());
+			for (const auto& cell : cells)
+				out_cells.push_back(cell.second);
+			return out_cells;
 		}
-		return valid_nodes;
+	};
+
+	/*!
+		\brief Determine if node_b is within the vertical field of view of node_a.
+
+		\param node_a Node that is looking.
+		\param node_b Node being looked at.
+		\param distance Distance between node_a and node_b.
+		\param sin_up Sine of the maximum angle above the horizon that node_a can see.
+		\param sin_down Sine of the maximum angle below the horizon that node_a can see.
+
+		\returns True if the angle between the horizon and the line from node_a to node_b is within
+		the limits, false otherwise.
+	*/
+	inline bool InFieldOfView(const Node& node_a, const Node& node_b, float distance, float sin_up, float sin_down) {
+		if (distance <= 0) return true;
+
+		const float sin_angle = (node_b.z - node_a.z) / distance;
+		return (sin_angle <= sin_up && -sin_angle <= sin_down);
+	}
+
+	/*!
+		\brief Convert an angle limit in degrees to its sine, clamping it to 90 degrees.
+
+		\param limit Angle in degrees. Values of 90 or greater impose no limit.
+	*/
+	inline float LimitToSine(float limit) {
+		if (limit >= 90.0f) return 2.0f; // Higher than any sine, so nothing is ever rejected
+		return std::sin(limit * static_cast<float>(M_PI) / 180.0f);
 	}
 
 	/*!
@@ -125,68 +330,123 @@ namespace HF::VisibilityGraph {
 		return ert.Occluded(heightened_node, direction, distance);
 	}
 
-	Graph AllToAll(EmbreeRayTracer& ert, const vector<Node>& nodes, float height) {
+	/*! \brief Add the number of edges in a jagged array of edges to the trace's edge count. */
+	inline void CountEdges(const vector<vector<int>>& edges) {
+		if (!HF::Tracing::IsEnabled()) return;
+
+		int64_t num_edges = 0;
+		for (const auto& edge_list : edges) num_edges += edge_list.size();
+		HF::Tracing::Count(HF::Tracing::EDGES_ADDED, num_edges);
+	}
+
+	Graph AllToAll(
+		EmbreeRayTracer& ert,
+		const vector<Node>& nodes,
+		float height,
+		float max_distance,
+		float upward_limit,
+		float downward_limit,
+		HF::Exceptions::CancellationToken* token
+	) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
 
 		// Create a jagged array for edges and costs
 		const int n = nodes.size();
 		vector<vector<int>> edges(n);
 		vector<vector<float>> costs(n);
 
-		// Set the degree of parallelism to the number of cores of the client machine
-		int cores = -1;
-		if (cores < 0) {
-			cores = std::thread::hardware_concurrency();
-			omp_set_num_threads(cores);
-		}
-		else if (cores > 0)
-			omp_set_num_threads(cores);
-
-		// Discard nodes that don't pass the height check. 
+		// Discard nodes that don't pass the height check
 		auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+		if (token) token->AddWork(valid_nodes.size());
+
+		// Reserve threads for checking every valid node
+		HF::Parallel::ThreadLease lease(-1, valid_nodes.size());
+
+		// If a maximum distance was specified, index the valid nodes in a grid
+		// so each node only needs to check the nodes around it. 
+		const bool limit_distance = max_distance > 0;
+		NodeGrid grid;
+		if (limit_distance)
+			grid = NodeGrid(nodes, valid_nodes, max_distance);
+		const float sin_up = LimitToSine(upward_limit);
+		const float sin_down = LimitToSine(downward_limit);
 		
 		// Calculate edges for every node in parallel
-#pragma omp parallel for schedule(static)
-		for (int i = 0; i < valid_nodes.size(); i++) {
-			
-			// Acquire the id of the node we're calculating this for
-			int node_id = valid_nodes[i];
-			
-			// Get the node we're calculating the edges for
-			const Node& node_a = nodes[node_id];
-		
-			// Get references to the cost and edge arrays for this node
-			// to save an index operation  for every check.
-			vector<int>& edge_list = edges[node_id];
-			vector<float>& cost_list = costs[node_id];
+#pragma omp parallel num_threads(lease.size())
+		{
+			// Buffer for the nodes in range of the current node. Only used if the distance is limited.
+			vector<int> candidates;
 
-			// Check connection between this node and every other valid node
-			for (int k = 0; k < valid_nodes.size(); k++) {
-				
-				// Don't check this node against itself
-				if (i == k) continue;
-				
-				// Get the next node from its index in valid_nodes
-				int node_b_id = valid_nodes[k];
+#pragma omp for schedule(static)
+			for (int i = 0; i < valid_nodes.size(); i++) {
 
-				// Calculate distance between node_a and node_b
-				const Node& node_b = nodes[node_b_id];
-				float distance = node_a.distanceTo(node_b);
+				// OpenMP loops can't break early, so skip every node left once cancelled
+				if (token && token->IsCancelled()) continue;
+
+				// Acquire the id of the node we're calculating this for
+				int node_id = valid_nodes[i];
+
+				// Get the node we're calculating the edges for
+				const Node& node_a = nodes[node_id];
+
+				// Get references to the cost and edge arrays for this node
+				// to save an index operation  for every check.
+				vector<int>& edge_list = edges[node_id];
+				vector<float>& cost_list = costs[node_id];
+
+				// Only check the nodes close enough to this node if a limit was set
+				if (limit_distance)
+					grid.Candidates(node_a, candidates);
+				const vector<int>& nodes_to_check = limit_distance ? candidates : valid_nodes;
 
-				// Check if they have a clear line of sight. If they do, then add the distance
-				// between them, and node_b's id to node_a's edge and cost array. 
-				if (!IsOcclusionBetween(node_a, nodes[node_b_id], ert, height, distance)) {
-					edge_list.push_back(node_b_id);
-					cost_list.push_back(distance);
+				// Check connection between this node and every other valid node
+				for (int k = 0; k < nodes_to_check.size(); k++) {
+
+					// Get the next node from its index in valid_nodes
+					int node_b_id = nodes_to_check[k];
+
+					// Don't check this node against itself
+					if (node_id == node_b_id) continue;
+
+					// Calculate distance between node_a and node_b
+					const Node& node_b = nodes[node_b_id];
+					float distance = node_a.distanceTo(node_b);
+
+					// Skip nodes that are out of range or outside of the field of view
+					if (limit_distance && distance > max_distance) continue;
+					if (!InFieldOfView(node_a, node_b, distance, sin_up, sin_down)) continue;
+
+					// Check if they have a clear line of sight. If they do, then add the distance
+					// between them, and node_b's id to node_a's edge and cost array. 
+					if (!IsOcclusionBetween(node_a, node_b, ert, height, distance)) {
+						edge_list.push_back(node_b_id);
+						cost_list.push_back(distance);
+					}
 				}
+
+				if (token) token->Advance();
 			}
 		}
+		if (token) token->ThrowIfCancelled();
+
 		// Construct and return a graph from the set of nodes, the edge array
 		// and the node array.
+		CountEdges(edges);
 		return Graph(edges, costs, nodes);
 	}
 
 
-	Graph GroupToGroup(EmbreeRayTracer& ert, const vector<Node>& from, const vector<Node>& to, float height) {
+	Graph GroupToGroup(
+		EmbreeRayTracer& ert,
+		const vector<Node>& from,
+		const vector<Node>& to,
+		float height,
+		float max_distance,
+		float upward_limit,
+		float downward_limit
+	) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
 		// Determine how many nodes are in both arrays
 		const int from_count = from.size();
 		const int to_count = to.size();
@@ -198,44 +458,61 @@ namespace HF::VisibilityGraph {
 		vector<vector<float>> costs(from_count + to_count);
 
 
-		// Use as many cores as the host machine can
-		int cores = -1;
-		if (cores < 0) {
-			cores = std::thread::hardware_concurrency();
-			omp_set_num_threads(cores);
-		}
-		else if (cores > 0) omp_set_num_threads(cores);
-
 		// Perform height check on every node in nodes.
 		auto valid_nodes = HeightCheckAllNodes(from, height, ert);
 		auto valid_to_nodes = HeightCheckAllNodes(to, height, ert);
 
+		// Reserve threads for checking every valid node in from
+		HF::Parallel::ThreadLease lease(-1, valid_nodes.size());
+
+		// Index the nodes in to if the distance is limited 
+		const bool limit_distance = max_distance > 0;
+		NodeGrid grid;
+		if (limit_distance)
+			grid = NodeGrid(to, valid_to_nodes, max_distance);
+		const float sin_up = LimitToSine(upward_limit);
+		const float sin_down = LimitToSine(downward_limit);
+
 		// Iterate through every node in valid_nodes in parallel
-#pragma omp parallel for schedule(static)
-		for (int i = 0; i < valid_nodes.size(); i++) {
-			
-			// Get the id, node, and references to its arrays.
-			int id = valid_nodes[i];
-			const Node& node_a = from[id];
-			vector<int>& edge_list = edges[id];
-			vector<float>& cost_list = costs[id];
+#pragma omp parallel num_threads(lease.size())
+		{
+			vector<int> candidates;
+
+#pragma omp for schedule(static)
+			for (int i = 0; i < valid_nodes.size(); i++) {
 
-			// Check if it has a connection to every node in to
-			for (int k = 0; k < valid_to_nodes.size(); k++) {
+				// Get the id, node, and references to its arrays.
+				int id = valid_nodes[i];
+				const Node& node_a = from[id];
+				vector<int>& edge_list = edges[id];
+				vector<float>& cost_list = costs[id];
 
-				// Get the node at this ID in to
-				int to_id = valid_to_nodes[k];
-				const Node& node_b = to[to_id];
+				// Only consider nodes in range if a limit was set
+				if (limit_distance)
+					grid.Candidates(node_a, candidates);
+				const vector<int>& nodes_to_check = limit_distance ? candidates : valid_to_nodes;
 
-				// Calculate the distance between node_a and node_b
-				float distance = node_a.distanceTo(node_b);
+				// Check if it has a connection to every node in to
+				for (int k = 0; k < nodes_to_check.size(); k++) {
 
-				// Check if there's an occlusion between node_a and node_b. If they have
-				// a clear line of sight, then add the edge and cost to node_a's arrays.
-				if (!IsOcclusionBetween(node_a, node_b, ert, height, distance)) {
+					// Get the node at this ID in to
+					int to_id = nodes_to_check[k];
+					const Node& node_b = to[to_id];
 
-					edge_list.push_back(to_id + from_count);
-					cost_list.push_back(distance);
+					// Calculate the distance between node_a and node_b
+					float distance = node_a.distanceTo(node_b);
+
+					// Skip nodes that are out of range or outside of the field of view
+					if (limit_distance && distance > max_distance) continue;
+					if (!InFieldOfView(node_a, node_b, distance, sin_up, sin_down)) continue;
+
+					// Check if there's an occlusion between node_a and node_b. If they have
+					// a clear line of sight, then add the edge and cost to node_a's arrays.
+					if (!IsOcclusionBetween(node_a, node_b, ert, height, distance)) {
+
+						edge_list.push_back(to_id + from_count);
+						cost_list.push_back(distance);
+					}
 				}
 			}
 		}
@@ -246,27 +523,25 @@ namespace HF::VisibilityGraph {
 		std::copy(to.begin(), to.end(), graph_nodes.begin() + from.size());
 
 		// Create a new graph. 
+		CountEdges(edges);
 		return Graph(edges, costs, graph_nodes);
 	}
 
 	Graph AllToAllUndirected(EmbreeRayTracer& ert, const vector<Node>& nodes, float height, int cores) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
 		const int n = nodes.size();
 		vector<vector<int>> edges(n);
 		vector<vector<float>> costs(n);
 
-		// Use as many cores as this machine has or the number of cores in cores
-		if (cores < 0) {
-			cores = std::thread::hardware_concurrency();
-			omp_set_num_threads(cores);
-		}
-		else if (cores > 0)
-			omp_set_num_threads(cores);
-
 		// Perform a height check on every node
 		const auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
 
+		// Use the number of threads in cores, or the library's default if it's less than 1
+		HF::Parallel::ThreadLease lease(cores, valid_nodes.size());
+
 		// Iterate through every node in nodes
-#pragma omp parallel
+#pragma omp parallel num_threads(lease.size())
 		{
 #pragma omp for schedule(dynamic)
 			for (int i = 0; i < valid_nodes.size(); i++) {
@@ -296,6 +571,788 @@ namespace HF::VisibilityGraph {
 			}
 		}
 		// Create and return a new graph from this information.
+		CountEdges(edges);
+		return Graph(edges, costs, nodes);
+	}
+
+	VisibilityDegrees AllToAllDegrees(
+		EmbreeRayTracer& ert,
+		const vector<Node>& nodes,
+		float height,
+		float max_distance,
+		float upward_limit,
+		float downward_limit
+	) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
+		// Every node starts with nothing visible
+		const int n = nodes.size();
+		VisibilityDegrees degrees;
+		degrees.counts.resize(n, 0);
+		degrees.sum_distance.resize(n, 0.0f);
+		degrees.max_distance.resize(n, 0.0f);
+
+		// Discard nodes that don't pass the height check
+		auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+
+		// Reserve threads for checking every valid node
+		HF::Parallel::ThreadLease lease(-1, valid_nodes.size());
+
+		// Only check nodes in range if a maximum distance was specified
+		const bool limit_distance = max_distance > 0;
+		NodeGrid grid;
+		if (limit_distance)
+			grid = NodeGrid(nodes, valid_nodes, max_distance);
+		const float sin_up = LimitToSine(upward_limit);
+		const float sin_down = LimitToSine(downward_limit);
+
+#pragma omp parallel num_threads(lease.size())
+		{
+			vector<int> candidates;
+
+#pragma omp for schedule(dynamic)
+			for (int i = 0; i < valid_nodes.size(); i++) {
+				int node_id = valid_nodes[i];
+				const Node& node_a = nodes[node_id];
+
+				if (limit_distance)
+					grid.Candidates(node_a, candidates);
+				const vector<int>& nodes_to_check = limit_distance ? candidates : valid_nodes;
+
+				// Accumulate locally, then write this node's results once. Each node is
+				// only ever written by a single thread so nothing needs to be merged.
+				int count = 0;
+				double sum_distance = 0;
+				float furthest = 0;
+				for (int k = 0; k < nodes_to_check.size(); k++) {
+					int node_b_id = nodes_to_check[k];
+					if (node_id == node_b_id) continue;
+
+					const Node& node_b = nodes[node_b_id];
+					float distance = node_a.distanceTo(node_b);
+
+					if (limit_distance && distance > max_distance) continue;
+					if (!InFieldOfView(node_a, node_b, distance, sin_up, sin_down)) continue;
+
+					if (!IsOcclusionBetween(node_a, node_b, ert, height, distance)) {
+						count++;
+						sum_distance += distance;
+						furthest = std::max(furthest, distance);
+					}
+				}
+
+				degrees.counts[node_id] = count;
+				degrees.sum_distance[node_id] = static_cast<float>(sum_distance);
+				degrees.max_distance[node_id] = furthest;
+			}
+		}
+		return degrees;
+	}
+
+	VisibilityMatrix AllToAllMatrix(EmbreeRayTracer& ert, const vector<Node>& nodes, float height, bool upper_triangular) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
+		const int n = nodes.size();
+		VisibilityMatrix matrix(n, upper_triangular);
+
+		// Discard nodes that don't pass the height check
+		const auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+		const int num_valid = valid_nodes.size();
+
+		// Reserve threads for checking every valid node
+		HF::Parallel::ThreadLease lease(-1, valid_nodes.size());
+
+		// Each node's row is only written by the thread checking it. For an upper triangular
+		// matrix only nodes after this one need to be checked, and valid_nodes is in ascending
+		// order so every bit will be above the diagonal.
+#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
+		for (int i = 0; i < num_valid; i++) {
+			const int node_a_id = valid_nodes[i];
+			const Node& node_a = nodes[node_a_id];
+
+			for (int k = upper_triangular ? i + 1 : 0; k < num_valid; k++) {
+				const int node_b_id = valid_nodes[k];
+				if (node_a_id == node_b_id) continue;
+
+				const Node& node_b = nodes[node_b_id];
+				if (!IsOcclusionBetween(node_a, node_b, ert, height, node_a.distanceTo(node_b)))
+					matrix.Set(node_a_id, node_b_id);
+			}
+		}
+		return matrix;
+	}
+
+	/*!
+		\brief Pick a few nodes that represent the extent of a cluster.
+
+		\param nodes Nodes the cluster indexes into.
+		\param cluster Indexes of the nodes in the cluster.
+
+		\returns The indexes of the node closest to the cluster's centroid, and the nodes with
+		the minimum and maximum x and y coordinates, without duplicates.
+	*/
+	vector<int> ClusterRepresentatives(const vector<Node>& nodes, const vector<int>& cluster) {
+		// Find the centroid of the cluster
+		Node centroid(0, 0, 0);
+		for (int index : cluster) {
+			centroid.x += nodes[index].x;
+			centroid.y += nodes[index].y;
+			centroid.z += nodes[index].z;
+		}
+		centroid.x /= cluster.size(); centroid.y /= cluster.size(); centroid.z /= cluster.size();
+
+		// Find the node closest to the centroid and the extremes of the cluster
+		int center = cluster[0], min_x = cluster[0], max_x = cluster[0], min_y = cluster[0], max_y = cluster[0];
+		for (int index : cluster) {
+			const Node& node = nodes[index];
+			if (node.distanceTo(centroid) < nodes[center].distanceTo(centroid)) center = index;
+			if (node.x < nodes[min_x].x) min_x = index;
+			if (node.x > nodes[max_x].x) max_x = index;
+			if (node.y < nodes[min_y].y) min_y = index;
+			if (node.y > nodes[max_y].y) max_y = index;
+		}
+
+		vector<int> representatives{ center, min_x, max_x, min_y, max_y };
+		std::sort(representatives.begin(), representatives.end());
+		representatives.erase(std::unique(representatives.begin(), representatives.end()), representatives.end());
+		return representatives;
+	}
+
+	Graph AllToAllApproximate(
+		EmbreeRayTracer& ert,
+		const vector<Node>& nodes,
+		float height,
+		float cluster_size,
+		float max_error
+	) {
+		if (!(cluster_size > 0.0f))
+			throw std::invalid_argument("Cluster size must be greater than 0");
+		if (!(max_error >= 0.0f && max_error <= 1.0f))
+			throw std::invalid_argument("Max error must be between 0 and 1");
+
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
+		const int n = nodes.size();
+		vector<vector<int>> edges(n);
+		vector<vector<float>> costs(n);
+
+		// Discard nodes that don't pass the height check
+		auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+
+		// Reserve threads for checking every valid node
+		HF::Parallel::ThreadLease lease(-1, valid_nodes.size());
+
+		// Group nodes into clusters by the grid cell they fall into, then pick
+		// the nodes that will represent each cluster
+		const auto clusters = NodeGrid(nodes, valid_nodes, cluster_size).Cells();
+		const int num_clusters = clusters.size();
+		vector<vector<int>> representatives(num_clusters);
+		for (int c = 0; c < num_clusters; c++)
+			representatives[c] = ClusterRepresentatives(nodes, clusters[c]);
+
+		// Every cluster is handled by one thread, so the edges of its nodes are only ever written once.
+#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
+		for (int a = 0; a < num_clusters; a++) {
+			const auto& cluster_a = clusters[a];
+			const auto& reps_a = representatives[a];
+
+			for (int b = 0; b < num_clusters; b++) {
+				const auto& cluster_b = clusters[b];
+				const auto& reps_b = representatives[b];
+
+				// Classify the pair from its representative rays unless checking
+				// every node would be cheaper, or both clusters are the same.
+				int state = -1; // -1: Refine. 0: Fully Blocked. 1: Fully Visible.
+				const int num_rays = reps_a.size() * reps_b.size();
+				if (a != b && num_rays < cluster_a.size() * cluster_b.size()) {
+					int num_visible = 0;
+					for (int rep_a : reps_a)
+						for (int rep_b : reps_b)
+							num_visible += !IsOcclusionBetween(nodes[rep_a], nodes[rep_b], ert, height);
+
+					// Accept the majority if few enough of the rays disagree with it
+					const float visible_fraction = static_cast<float>(num_visible) / num_rays;
+					if (1.0f - visible_fraction <= max_error) state = 1;
+					else if (visible_fraction <= max_error) state = 0;
+				}
+
+				if (state == 0) continue;
+				for (int node_a_id : cluster_a) {
+					const Node& node_a = nodes[node_a_id];
+					for (int node_b_id : cluster_b) {
+						if (node_a_id == node_b_id) continue;
+
+						const Node& node_b = nodes[node_b_id];
+						const float distance = node_a.distanceTo(node_b);
+						if (state == 1 || !IsOcclusionBetween(node_a, node_b, ert, height, distance)) {
+							edges[node_a_id].push_back(node_b_id);
+							costs[node_a_id].push_back(distance);
+						}
+					}
+				}
+			}
+		}
+
+		// Keep the edges of each node in ascending order, matching AllToAll
+#pragma omp parallel for schedule(dynamic, 64) num_threads(lease.size())
+		for (int i = 0; i < n; i++) {
+			auto& edge_list = edges[i];
+			auto& cost_list = costs[i];
+			if (edge_list.size() < 2) continue;
+
+			vector<int> order(edge_list.size());
+			for (int k = 0; k < order.size(); k++) order[k] = k;
+			std::sort(order.begin(), order.end(), [&](int l, int r) { return edge_list[l] < edge_list[r]; });
+
+			vector<int> sorted_edges(order.size());
+			vector<float> sorted_costs(order.size());
+			for (int k = 0; k < order.size(); k++) {
+				sorted_edges[k] = edge_list[order[k]];
+				sorted_costs[k] = cost_list[order[k]];
+			}
+			edge_list.swap(sorted_edges);
+			cost_list.swap(sorted_costs);
+		}
+
+		CountEdges(edges);
 		return Graph(edges, costs, nodes);
 	}
-}
\ No newline at end of file
+
+	/*!
+		\brief Append the existing edges of a row in a compressed graph to a CSR.
+
+		\param csr Pointers to the compressed graph's CSR.
+		\param row Row to copy.
+		\param inner_indices Inner indices of the CSR being built.
+		\param values Values of the CSR being built.
+	*/
+	inline void AppendExistingRow(const CSRPtrs& csr, int row, vector<int>& inner_indices, vector<float>& values) {
+		if (row >= csr.rows || csr.nnz <= 0) return;
+
+		const int begin = csr.outer_indices[row];
+		const int end = csr.outer_indices[row + 1];
+		inner_indices.insert(inner_indices.end(), csr.inner_indices + begin, csr.inner_indices + end);
+		values.insert(values.end(), csr.data + begin, csr.data + end);
+	}
+
+	void AddNodes(EmbreeRayTracer& ert, Graph& graph, const vector<Node>& new_nodes, float height) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
+		// Get the existing nodes and edges of the graph
+		graph.Compress();
+		const CSRPtrs csr = graph.GetCSRPointers();
+		vector<Node> nodes = graph.Nodes();
+		const int num_old = nodes.size();
+
+		// Add every node that isn't already in the graph after the existing nodes, only once
+		robin_hood::unordered_flat_set<Node> added_nodes;
+		for (const auto& node : new_nodes)
+			if (!graph.hasKey(node) && added_nodes.insert(node).second)
+				nodes.push_back(node);
+		const int n = nodes.size();
+		if (n == num_old) return;
+
+		// Height check every node, since old nodes were never marked as valid or invalid.
+		const auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+		const auto first_new = std::lower_bound(valid_nodes.begin(), valid_nodes.end(), num_old);
+		const vector<int> valid_old(valid_nodes.begin(), first_new);
+		const vector<int> valid_new(first_new, valid_nodes.end());
+
+		// Reserve threads for checking every valid node
+		HF::Parallel::ThreadLease lease(-1, valid_nodes.size());
+
+		// Only new nodes need to be checked. Old nodes check against the new ones, and new
+		// nodes check against everything else.
+		vector<vector<int>> edges(n);
+		vector<vector<float>> costs(n);
+#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
+		for (int i = 0; i < valid_nodes.size(); i++) {
+			const int node_a_id = valid_nodes[i];
+			const Node& node_a = nodes[node_a_id];
+			const vector<int>& nodes_to_check = node_a_id < num_old ? valid_new : valid_nodes;
+
+			for (int node_b_id : nodes_to_check) {
+				if (node_a_id == node_b_id) continue;
+
+				const Node& node_b = nodes[node_b_id];
+				const float distance = node_a.distanceTo(node_b);
+				if (!IsOcclusionBetween(node_a, node_b, ert, height, distance)) {
+					edges[node_a_id].push_back(node_b_id);
+					costs[node_a_id].push_back(distance);
+				}
+			}
+		}
+
+		// Merge the new edges into the existing CSR. New nodes have higher IDs than every old
+		// node, so appending them to the end of each existing row keeps the row sorted.
+		vector<int> outer_indices(1, 0);
+		vector<int> inner_indices;
+		vector<float> values;
+		outer_indices.reserve(n + 1);
+		for (int row = 0; row < n; row++) {
+			if (row < num_old)
+				AppendExistingRow(csr, row, inner_indices, values);
+
+			inner_indices.insert(inner_indices.end(), edges[row].begin(), edges[row].end());
+			values.insert(values.end(), costs[row].begin(), costs[row].end());
+			outer_indices.push_back(inner_indices.size());
+		}
+
+		graph = Graph(outer_indices, inner_indices, values, nodes);
+	}
+
+	/*! 
+		\brief Determine if the line segment between two points intersects an axis aligned bounding box.
+
+		\details Uses the slab method, clipping the segment against each pair of planes in turn.
+	*/
+	inline bool SegmentIntersectsBox(
+		const std::array<float, 3>& start,
+		const std::array<float, 3>& end,
+		const std::array<float, 3>& box_min,
+		const std::array<float, 3>& box_max
+	) {
+		float t_min = 0.0f;
+		float t_max = 1.0f;
+		for (int axis = 0; axis < 3; axis++) {
+			const float delta = end[axis] - start[axis];
+
+			// If the segment is parallel to these planes, it must already be between them
+			if (std::abs(delta) < 1e-12f) {
+				if (start[axis] < box_min[axis] || start[axis] > box_max[axis]) return false;
+				continue;
+			}
+
+			float t_near = (box_min[axis] - start[axis]) / delta;
+			float t_far = (box_max[axis] - start[axis]) / delta;
+			if (t_near > t_far) std::swap(t_near, t_far);
+
+			t_min = std::max(t_min, t_near);
+			t_max = std::min(t_max, t_far);
+			if (t_min > t_max) return false;
+		}
+		return true;
+	}
+
+	int UpdateRegion(
+		EmbreeRayTracer& ert,
+		Graph& graph,
+		const std::array<float, 3>& box_min,
+		const std::array<float, 3>& box_max,
+		float height
+	) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
+		graph.Compress();
+		const CSRPtrs csr = graph.GetCSRPointers();
+		const vector<Node> nodes = graph.Nodes();
+		const int n = nodes.size();
+
+		// Find the start of each node's sightlines, and whether its height check crosses the box.
+		vector<std::array<float, 3>> eyes(n);
+		vector<char> height_changed(n);
+		for (int i = 0; i < n; i++) {
+			const Node& node = nodes[i];
+			eyes[i] = { node.x, node.y, node.z + height };
+			height_changed[i] = SegmentIntersectsBox(
+				{ node.x, node.y, node.z + ROUNDING_PRECISION }, eyes[i], box_min, box_max
+			);
+		}
+
+		// The geometry in the raytracer has already changed, so the height check
+		// reflects the current state of the model.
+		const auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+		vector<char> is_valid(n, false);
+		for (int id : valid_nodes) is_valid[id] = true;
+
+		// Reserve threads for checking every valid node
+		HF::Parallel::ThreadLease lease(-1, valid_nodes.size());
+
+		// Rebuild every row, reusing edges whose sightline doesn't pass through the box
+		vector<vector<int>> edges(n);
+		vector<vector<float>> costs(n);
+		int num_rechecked = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+:num_rechecked) num_threads(lease.size())
+		for (int node_a_id = 0; node_a_id < n; node_a_id++) {
+			if (!is_valid[node_a_id]) continue;
+			const Node& node_a = nodes[node_a_id];
+
+			// Walk through the existing row alongside the valid nodes
+			int existing = 0, existing_end = 0;
+			if (node_a_id < csr.rows && csr.nnz > 0) {
+				existing = csr.outer_indices[node_a_id];
+				existing_end = csr.outer_indices[node_a_id + 1];
+			}
+
+			for (int node_b_id : valid_nodes) {
+				if (node_a_id == node_b_id) continue;
+
+				while (existing < existing_end && csr.inner_indices[existing] < node_b_id) existing++;
+				const bool had_edge = existing < existing_end && csr.inner_indices[existing] == node_b_id;
+
+				const Node& node_b = nodes[node_b_id];
+				const bool changed = height_changed[node_a_id] || height_changed[node_b_id] ||
+					SegmentIntersectsBox(eyes[node_a_id], eyes[node_b_id], box_min, box_max);
+
+				if (!changed) {
+					if (had_edge) {
+						edges[node_a_id].push_back(node_b_id);
+						costs[node_a_id].push_back(csr.data[existing]);
+					}
+					continue;
+				}
+
+				num_rechecked++;
+				const float distance = node_a.distanceTo(node_b);
+				if (!IsOcclusionBetween(node_a, node_b, ert, height, distance)) {
+					edges[node_a_id].push_back(node_b_id);
+					costs[node_a_id].push_back(distance);
+				}
+			}
+		}
+
+		CountEdges(edges);
+		graph = Graph(edges, costs, nodes);
+		return num_rechecked;
+	}
+
+	/*!
+		\brief Calculate a visibility graph one block of rows at a time, passing each finished block to a handler.
+
+		\tparam BlockHandler Callable with the signature 
+		`void(int first_row, const vector<int>& row_sizes, const vector<int>& columns)`.
+
+		\param ert Raytracer containing the geometry to use as obstacles.
+		\param nodes Nodes to generate the visibility graph from.
+		\param height Height to offset nodes in the z-direction.
+		\param block_size Number of parent nodes (rows) to calculate before calling on_block.
+		\param tile_size Number of child nodes checked by a single task.
+		\param on_block Handler to call with the edges of every finished block. row_sizes contains the
+		number of edges of every row in the block, and columns contains the child of every edge in these
+		rows in order.
+
+		\details
+		Every block of rows is split into tasks of one row by one tile of tile_size valid child nodes,
+		which are then run in parallel. Once every task in the block is finished, the tiles of each row
+		are concatenated in order then passed to the handler. Since only one block is held in memory at
+		a time, the memory used here is proportional to the number of edges in a block, rather than 
+		the number of edges in the graph. 
+
+		\remarks
+		Invalid rows are still passed to on_block, with a size of zero.
+	*/
+	template <typename BlockHandler>
+	void StreamAllToAll(
+		EmbreeRayTracer& ert,
+		const vector<Node>& nodes,
+		float height,
+		int block_size,
+		int tile_size,
+		BlockHandler& on_block
+	) {
+		const int n = nodes.size();
+		block_size = std::max(1, block_size);
+		tile_size = std::max(1, tile_size);
+
+		// Discard nodes that don't pass the height check, and mark the ones that do
+		const auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+		const int num_valid = valid_nodes.size();
+		vector<char> is_valid(n, false);
+		for (int id : valid_nodes) is_valid[id] = true;
+
+		// Reserve threads for checking every valid node
+		HF::Parallel::ThreadLease lease(-1, valid_nodes.size());
+
+		// Edges found for every task in the current block.
+		const int num_tiles = std::max(1, (num_valid + tile_size - 1) / tile_size);
+		vector<vector<int>> task_edges(block_size * num_tiles);
+
+		vector<int> row_sizes;
+		vector<int> columns;
+		for (int first_row = 0; first_row < n; first_row += block_size) {
+			const int rows_in_block = std::min(block_size, n - first_row);
+			const int num_tasks = rows_in_block * num_tiles;
+
+#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
+			for (int task = 0; task < num_tasks; task++) {
+				const int row = first_row + task / num_tiles;
+				const int tile = task % num_tiles;
+
+				vector<int>& edge_list = task_edges[task];
+				edge_list.clear();
+				if (!is_valid[row]) continue;
+
+				// Check every valid node in this tile against the node for this row
+				const Node& node_a = nodes[row];
+				const int tile_end = std::min(num_valid, (tile + 1) * tile_size);
+				for (int k = tile * tile_size; k < tile_end; k++) {
+					const int node_b_id = valid_nodes[k];
+					if (node_b_id == row) continue;
+
+					const Node& node_b = nodes[node_b_id];
+					if (!IsOcclusionBetween(node_a, node_b, ert, height, node_a.distanceTo(node_b)))
+						edge_list.push_back(node_b_id);
+				}
+			}
+
+			// Concatenate the tiles of every row. Tiles are in ascending order
+			// so the columns of every row will be as well.
+			row_sizes.assign(rows_in_block, 0);
+			columns.clear();
+			for (int r = 0; r < rows_in_block; r++) {
+				for (int tile = 0; tile < num_tiles; tile++) {
+					const auto& edge_list = task_edges[r * num_tiles + tile];
+					columns.insert(columns.end(), edge_list.begin(), edge_list.end());
+					row_sizes[r] += edge_list.size();
+				}
+			}
+
+			on_block(first_row, row_sizes, columns);
+		}
+	}
+
+	Graph AllToAllBlocked(EmbreeRayTracer& ert, const vector<Node>& nodes, float height, int block_size, int tile_size) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
+		const int n = nodes.size();
+
+		// Build the CSR of the graph directly as blocks are finished
+		vector<int> outer_indices;
+		vector<int> inner_indices;
+		vector<float> values;
+		outer_indices.reserve(n + 1);
+		outer_indices.push_back(0);
+
+		auto add_block = [&](int first_row, const vector<int>& row_sizes, const vector<int>& columns) {
+			int column_index = 0;
+			for (int r = 0; r < row_sizes.size(); r++) {
+				const Node& parent = nodes[first_row + r];
+				for (int e = 0; e < row_sizes[r]; e++, column_index++) {
+					const int child = columns[column_index];
+					inner_indices.push_back(child);
+					values.push_back(parent.distanceTo(nodes[child]));
+				}
+				outer_indices.push_back(inner_indices.size());
+			}
+		};
+		StreamAllToAll(ert, nodes, height, block_size, tile_size, add_block);
+
+		HF::Tracing::Count(HF::Tracing::EDGES_ADDED, inner_indices.size());
+		return Graph(outer_indices, inner_indices, values, nodes);
+	}
+
+	/*! \brief Identifies visibility graph files. Spells DHVG. */
+	const char VG_FILE_MAGIC[4] = { 'D', 'H', 'V', 'G' };
+
+	/*! \brief Version of the visibility graph file format written by AllToAllToFile. */
+	const int32_t VG_FILE_VERSION = 1;
+
+	/*!
+		\brief The header at the start of every visibility graph file.
+
+		\details
+		The header is followed by:
+		1) The x, y, z coordinates of every node as 32 bit floats.
+		2) The outer indices of the CSR as `num_nodes + 1` 64 bit integers.
+		3) The inner indices of the CSR as `num_edges` 32 bit integers.
+		4) If storage is VG_STORAGE::DISTANCES, the distance of every edge as `num_edges` 32 bit floats.
+	*/
+	struct VGFileHeader {
+		char magic[4];			///< Always VG_FILE_MAGIC.
+		int32_t version;		///< Version of the file format.
+		int32_t num_nodes;		///< Number of nodes in the graph.
+		int32_t storage;		///< The VG_STORAGE used for this file.
+		int64_t num_edges;		///< Number of edges in the graph.
+	};
+
+	/*! \brief Write the contents of an array to a binary stream. */
+	template <typename T>
+	inline void WriteArray(std::ostream& stream, const T* data, size_t count) {
+		stream.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+	}
+
+	/*! \brief Read count elements from a binary stream into an array. */
+	template <typename T>
+	inline void ReadArray(std::istream& stream, T* data, size_t count) {
+		stream.read(reinterpret_cast<char*>(data), count * sizeof(T));
+	}
+
+	/*! \brief Deletes a file when destroyed, so temporary files are removed even if an exception is thrown. */
+	struct TemporaryFile {
+		std::string path;	///< Path of the file to delete.
+
+		/*! \brief Delete the file at path if it exists. */
+		~TemporaryFile() { std::remove(path.c_str()); }
+	};
+
+	long long AllToAllToFile(
+		EmbreeRayTracer& ert,
+		const vector<Node>& nodes,
+		const std::string& path,
+		float height,
+		VG_STORAGE storage,
+		int block_size,
+		int tile_size
+	) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::VISIBILITY_GRAPH);
+
+		const int n = nodes.size();
+		const bool store_distances = (storage == VG_STORAGE::DISTANCES);
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			throw std::runtime_error("Couldn't open " + path + " for writing!");
+
+		// Write the header. The number of edges will be filled in at the end
+		VGFileHeader header{ {VG_FILE_MAGIC[0], VG_FILE_MAGIC[1], VG_FILE_MAGIC[2], VG_FILE_MAGIC[3]},
+			VG_FILE_VERSION, n, static_cast<int32_t>(storage), 0 };
+		WriteArray(file, &header, 1);
+
+		// Write the nodes
+		for (const auto& node : nodes) {
+			const float position[3] = { node.x, node.y, node.z };
+			WriteArray(file, position, 3);
+		}
+
+		// Reserve space for the outer indices. These will be filled in at the end
+		const auto outer_offset = file.tellp();
+		vector<int64_t> outer_indices(n + 1, 0);
+		WriteArray(file, outer_indices.data(), outer_indices.size());
+
+		// Distances go into a temporary file, since they must come after every inner index. The
+		// guard is declared first so the file is closed before it's deleted.
+		const std::string values_path = path + ".values";
+		std::unique_ptr<TemporaryFile> values_guard;
+		std::ofstream values_file;
+		if (store_distances) {
+			values_guard = std::make_unique<TemporaryFile>(TemporaryFile{ values_path });
+			values_file.open(values_path, std::ios::binary | std::ios::trunc);
+			if (!values_file.is_open())
+				throw std::runtime_error("Couldn't open " + values_path + " for writing!");
+		}
+
+		// Stream every block into the file as soon as it's finished
+		int64_t num_edges = 0;
+		vector<float> distances;
+		auto write_block = [&](int first_row, const vector<int>& row_sizes, const vector<int>& columns) {
+			WriteArray(file, columns.data(), columns.size());
+
+			if (store_distances) {
+				distances.resize(columns.size());
+				int column_index = 0;
+				for (int r = 0; r < row_sizes.size(); r++) {
+					const Node& parent = nodes[first_row + r];
+					for (int e = 0; e < row_sizes[r]; e++, column_index++)
+						distances[column_index] = parent.distanceTo(nodes[columns[column_index]]);
+				}
+				WriteArray(values_file, distances.data(), distances.size());
+			}
+
+			for (int r = 0; r < row_sizes.size(); r++) {
+				num_edges += row_sizes[r];
+				outer_indices[first_row + r + 1] = num_edges;
+			}
+		};
+		StreamAllToAll(ert, nodes, height, block_size, tile_size, write_block);
+
+		// Append the distances to the end of the file in chunks
+		if (store_distances) {
+			values_file.close();
+			std::ifstream values_in(values_path, std::ios::binary);
+			vector<char> buffer(1 << 20);
+			while (values_in) {
+				values_in.read(buffer.data(), buffer.size());
+				file.write(buffer.data(), values_in.gcount());
+			}
+			values_in.close();
+		}
+
+		// Fill in the number of edges and the outer indices
+		header.num_edges = num_edges;
+		file.seekp(0);
+		WriteArray(file, &header, 1);
+		file.seekp(outer_offset);
+		WriteArray(file, outer_indices.data(), outer_indices.size());
+
+		if (!file.good())
+			throw std::runtime_error("Failed to write visibility graph to " + path);
+
+		return num_edges;
+	}
+
+	Graph LoadVisibilityGraph(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			throw HF::Exceptions::FileNotFound();
+
+		// Read and validate the header
+		VGFileHeader header;
+		ReadArray(file, &header, 1);
+		if (!file.good() || !std::equal(header.magic, header.magic + 4, VG_FILE_MAGIC) || header.version != VG_FILE_VERSION)
+			throw std::invalid_argument(path + " is not a valid visibility graph file!");
+
+		const bool has_distances = header.storage == static_cast<int32_t>(VG_STORAGE::DISTANCES);
+		if (header.num_nodes < 0 || header.num_edges < 0 
+			|| (!has_distances && header.storage != static_cast<int32_t>(VG_STORAGE::VISIBILITY_ONLY)))
+			throw std::invalid_argument(path + " has an invalid visibility graph header!");
+
+		// The graph's CSR uses 32 bit indices
+		if (header.num_edges > INT_MAX)
+			throw std::length_error(path + " contains too many edges to be loaded into a graph!");
+
+		const int n = header.num_nodes;
+		const int num_edges = static_cast<int>(header.num_edges);
+
+		// Make sure the file is large enough for every array before allocating any of them
+		const auto data_offset = file.tellg();
+		file.seekg(0, std::ios::end);
+		const int64_t data_size = static_cast<int64_t>(file.tellg() - data_offset);
+		file.seekg(data_offset);
+
+		const int64_t expected_size = int64_t(n) * 3 * sizeof(float) + (int64_t(n) + 1) * sizeof(int64_t)
+			+ int64_t(num_edges) * sizeof(int) + (has_distances ? int64_t(num_edges) * sizeof(float) : 0);
+		if (data_size < expected_size)
+			throw std::invalid_argument(path + " ended before the entire visibility graph could be read!");
+
+		// Read nodes
+		vector<float> positions(size_t(n) * 3);
+		ReadArray(file, positions.data(), positions.size());
+		vector<Node> nodes(n);
+		for (int i = 0; i < n; i++)
+			nodes[i] = Node(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+
+		// Read the CSR. Every row must start where the last ended and the rows must cover every
+		// edge, which also keeps every outer index small enough to fit in an int.
+		vector<int64_t> outer_indices_64(size_t(n) + 1);
+		ReadArray(file, outer_indices_64.data(), outer_indices_64.size());
+		if (outer_indices_64.front() != 0 || outer_indices_64.back() != num_edges)
+			throw std::invalid_argument(path + " has an invalid CSR!");
+		for (int i = 0; i < n; i++)
+			if (outer_indices_64[i] > outer_indices_64[i + 1])
+				throw std::invalid_argument(path + " has an invalid CSR!");
+		vector<int> outer_indices(outer_indices_64.begin(), outer_indices_64.end());
+
+		vector<int> inner_indices(num_edges);
+		ReadArray(file, inner_indices.data(), inner_indices.size());
+		for (int child : inner_indices)
+			if (child < 0 || child >= n)
+				throw std::invalid_argument(path + " has an edge to a node that doesn't exist!");
+
+		// Read distances if they were stored, otherwise calculate them from the nodes
+		vector<float> values(num_edges);
+		if (has_distances)
+			ReadArray(file, values.data(), values.size());
+		else {
+			HF::Parallel::ThreadLease lease(-1, n);
+#pragma omp parallel for schedule(dynamic, 256) num_threads(lease.size())
+			for (int parent = 0; parent < n; parent++)
+				for (int e = outer_indices[parent]; e < outer_indices[parent + 1]; e++)
+					values[e] = nodes[parent].distanceTo(nodes[inner_indices[e]]);
+		}
+
+		if (file.fail())
+			throw std::invalid_argument(path + " ended before the entire visibility graph could be read!");
+
+		return Graph(outer_indices, inner_indices, values, nodes);
+	}
+}
@@ -6,6 +6,8 @@
 ///	\date		17 Jun 2020
 
 #include <vector>
+#include <string>
+#include <array>
 
 // Forward Declares
 namespace HF {
@@ -18,6 +20,10 @@ namespace HF {
 	namespace RayTracer {
 		class EmbreeRayTracer;	///< see embree_raytracer.h in raytracer
 	}
+
+	namespace Exceptions {
+		class CancellationToken;	///< see cancellation.h in exceptions
+	}
 }
 
 
@@ -44,6 +50,10 @@ namespace HF::VisibilityGraph {
 	/// <param name="ert"> A Raytracer conatining the geometry to use as obstacles for occlusion checks. </param>
 	/// <param name="input_nodes"> X,Y,Z locations of nodes for the Visibility Graph. </param>
 	/// <param name="height"> Height to offset nodes in the z-direction before generating the VisibilityGraph.</param>
+	/// <param name="max_distance"> Maximum length of a sightline in meters. Set to -1 for no limit.</param>
+	/// <param name="upward_limit"> Maximum angle in degrees above the horizon a node can see. 90 or more for no limit.</param>
+	/// <param name="downward_limit"> Maximum angle in degrees below the horizon a node can see. 90 or more for no limit.</param>
+	/// <param name="token"> Token to cancel the operation and report its progress through. May be nullptr.</param>
 	/*!
 		\returns 
 		A VisibilityGraph for generated from every node in input_nodes. The cost of each edge in the graph
@@ -62,14 +72,27 @@ namespace HF::VisibilityGraph {
 		graph in memory by about 50% and reduces the number of checks since every node will only need to check for
 		edges with nodes that have a higher ID than itself. 
 
+		\par Range Limits
+		If max_distance is greater than zero, the valid nodes are first sorted into a uniform grid with cells
+		max_distance meters wide, and each node only checks the nodes in its own cell and the cells directly
+		around it. Pairs that are farther apart than max_distance, or where one node is outside the vertical field
+		of view of the other as specified by upward_limit and downward_limit, are skipped without casting a ray.
+
 		\par Parallelism
-		Edges are checked on a seperate core for each node. This algorithm will always use every core on a user's
-		machine. 
+		Edges are checked on a seperate core for each node. This algorithm uses as many threads as HF::Parallel
+		allows, which is every core on a user's machine unless a thread count was set.
+
+		\par Cancellation
+		If token is cancelled, nodes that haven't started checking for edges are skipped and OperationCancelled
+		is thrown once the nodes being checked finish. Progress is reported once for every valid node.
+
+		\exception HF::Exceptions::OperationCancelled token was cancelled before every node was checked.
 
 		\par Complexity
 		The time complexity of this algorithm is O(n^2), performing approximately (n^2+n)/2 operations gauranteed
 		for each execution.	The space complexity matches the time complexity, but the actual space used can be less
-		depending on the number	of edges created.
+		depending on the number	of edges created. If max_distance is set, the time complexity becomes O(nk) where
+		k is the average number of nodes within max_distance of each node.
 
 		\see AllToAllUndirected for a version of this algorithm that checks for edges between every node
 		in nodes regardless of ID. 
@@ -113,7 +136,11 @@ namespace HF::VisibilityGraph {
 	HF::SpatialStructures::Graph AllToAll(
 		HF::RayTracer::EmbreeRayTracer& ert,
 		const std::vector<HF::SpatialStructures::Node>& input_nodes,
-		float height = 1.7f
+		float height = 1.7f,
+		float max_distance = -1.0f,
+		float upward_limit = 90.0f,
+		float downward_limit = 90.0f,
+		HF::Exceptions::CancellationToken* token = nullptr
 	);
 
 	/// <summary>
@@ -125,6 +152,9 @@ namespace HF::VisibilityGraph {
 		\param from X,Y,Z locations of nodes to cast rays from.
 		\param to X,Y,Z locations of nodes to cast rays to.
 		\param Height to offset nodes in the z-direction before generating the VisibilityGraph.
+		\param max_distance Maximum length of a sightline in meters. Set to -1 for no limit.
+		\param upward_limit Maximum angle in degrees above the horizon a node in from can see. 90 or more for no limit.
+		\param downward_limit Maximum angle in degrees below the horizon a node in from can see. 90 or more for no limit.
 
 		\returns
 		A VisibilityGraph generated from every node in from to every node in to. The cost of each edge in the graph
@@ -144,13 +174,17 @@ namespace HF::VisibilityGraph {
 		This can be useful for generating the visibility graph for a subset of nodes, such as the visibility from
 		a building to the outside, without needing to calculate the visibility from every node to every other node.
 
+		\par Range Limits
+		Range limits behave the same as in AllToAll, except only the nodes in to are indexed in the grid.
+
 		\par Parallelism
-		Edges are checked on a seperate core for each node. This algorithm will always use every core on a user's
-		machine.
+		Edges are checked on a seperate core for each node. This algorithm uses as many threads as HF::Parallel
+		allows, which is every core on a user's machine unless a thread count was set.
 
 		\par Complexity
 		In time: O(ft) where f is the number of nodes in from, and t is the number of nodes in to. In space,
-		O(ft) as well.
+		O(ft) as well. If max_distance is set this becomes O(fk) where k is the average number of nodes in to
+		within max_distance of each node in from.
 	
 
 		\code
@@ -201,7 +235,10 @@ namespace HF::VisibilityGraph {
 		HF::RayTracer::EmbreeRayTracer& ert,
 		const std::vector<HF::SpatialStructures::Node>& from,
 		const std::vector<HF::SpatialStructures::Node>& to,
-		float height = 1.7f
+		float height = 1.7f,
+		float max_distance = -1.0f,
+		float upward_limit = 90.0f,
+		float downward_limit = 90.0f
 	);
 
 	/// <summary> Generate a Visibility Graph with every edge stored twice. </summary>
@@ -226,8 +263,8 @@ namespace HF::VisibilityGraph {
 		however it may be advantageous to have edges stored in both nodes for certain applications. 
 
 		\par Parallelism
-		Edges are checked on a seperate core for each node. This algorithm will use every core on a user's
-		machine if cores is set to -1. Otherwise it will use the number of cores specified in cores.
+		Edges are checked on a seperate core for each node. If cores is set to -1, this algorithm uses as many
+		threads as HF::Parallel allows. Otherwise it will use the number of cores specified in cores.
 
 		\par complexity
 		O(n^2) in space and time.  
@@ -274,4 +311,238 @@ namespace HF::VisibilityGraph {
 		float height,
 		int cores = -1
 	);
-}
+
+	/// <summary> Generate an approximate Visibility Graph by checking visibility between clusters of nodes. </summary>
+	/*!
+		\param ert A Raytracer containing the geometry to use as obstacles for occlusion checks.
+		\param nodes X,Y,Z locations of nodes for the Visibility Graph.
+		\param height Height to offset nodes in the z-direction before generating the VisibilityGraph.
+		\param cluster_size Width in meters of the cubic cells nodes are clustered into. Must be greater than 0.
+		\param max_error Fraction of representative rays between two clusters, from 0 to 1, that are
+		allowed to disagree with the rest before the pair is checked node by node. 
+
+		\returns
+		An approximation of the Visibility Graph returned by AllToAll for the same nodes.
+
+		\throws std::invalid_argument if cluster_size is not greater than 0, or max_error is not between 0 and 1.
+
+		\details
+		Valid nodes are grouped into clusters by the grid cell they fall into. Each cluster is represented by
+		up to five of its nodes: the one closest to its centroid and the ones at the extremes of its x and y
+		coordinates. For every pair of clusters, rays are cast between each of their representatives. If
+		at least (1 - max_error) of these rays are unoccluded, every node in the first cluster is connected
+		to every node in the second without any further checks. If at least (1 - max_error) of them are
+		occluded, no nodes are connected. Otherwise the pair is only partially visible and is refined by
+		checking every pair of nodes, exactly as AllToAll would. Nodes in the same cluster are always
+		checked exactly.
+
+		\par Accuracy
+		max_error only limits how many representative rays may disagree, not how many edges of the
+		result are wrong. Even with a max_error of zero, an occluder that falls between every
+		representative ray of two clusters is missed, and every edge between them is added. Larger
+		values of max_error accept more pairs without refining them. On large open floors
+		most pairs of clusters are entirely visible or entirely blocked, so the number of rays cast
+		drops from the square of the number of nodes to roughly 25 times the square of the number
+		of clusters.
+
+		\see AllToAll for an exact version of this algorithm.
+	*/
+	HF::SpatialStructures::Graph AllToAllApproximate(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		const std::vector<HF::SpatialStructures::Node>& nodes,
+		float height = 1.7f,
+		float cluster_size = 5.0f,
+		float max_error = 0.0f
+	);
+
+	/// <summary> Add nodes to an existing Visibility Graph, only checking pairs that involve a new node. </summary>
+	/*!
+		\param ert A Raytracer containing the geometry to use as obstacles for occlusion checks.
+		\param graph A Visibility Graph generated by AllToAll or AllToAllBlocked for the same geometry.
+		Its nodes must have sequential IDs starting at zero.
+		\param new_nodes X,Y,Z locations of the nodes to add to graph. Nodes that are already in graph,
+		or that appear earlier in new_nodes, are ignored.
+		\param height Height that was used to generate graph.
+
+		\pre graph is directed and was generated without a max_distance or field of view limit. Graphs
+		from AllToAllUndirected, AllToAllApproximate, or AllToAll with limits aren't supported, since the
+		new edges would ignore their limits and direction.
+
+		\post graph contains every node in new_nodes after its existing nodes, and every edge between
+		a new node and any other node with a clear line of sight.
+
+		\details
+		Only new x (old + new) pairs are checked in either direction. Existing edges are never rechecked, and
+		are merged with the new edges directly into a new CSR, so adding m nodes to a graph of n nodes costs
+		O(m(n + m)) occlusion checks rather than the O((n + m)^2) of calling AllToAll again.
+
+		\remarks
+		The graph is rebuilt from its default cost. Any other cost types or node attributes
+		stored in graph are discarded.
+	*/
+	void AddNodes(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		HF::SpatialStructures::Graph& graph,
+		const std::vector<HF::SpatialStructures::Node>& new_nodes,
+		float height = 1.7f
+	);
+
+	/// <summary> Update a Visibility Graph after the geometry inside of a bounding box has changed. </summary>
+	/*!
+		\param ert A Raytracer containing the geometry after the change.
+		\param graph A Visibility Graph generated by AllToAll or AllToAllBlocked before the change.
+		Its nodes must have sequential IDs starting at zero.
+		\param box_min Minimum corner of an axis aligned box containing every piece of geometry that was
+		added, moved, or removed.
+		\param box_max Maximum corner of the box.
+		\param height Height that was used to generate graph.
+
+		\returns The number of pairs of nodes that had to be checked again.
+
+		\pre graph is directed and was generated without a max_distance or field of view limit. Graphs
+		from AllToAllUndirected, AllToAllApproximate, or AllToAll with limits aren't supported, since the
+		pairs that are checked again would ignore their limits and direction.
+
+		\post graph matches the result of AllToAll for the new geometry.
+
+		\details
+		An occlusion check can only change if the ray it casts passes through changed geometry. Pairs of
+		nodes whose sightline doesn't intersect the box, and whose height checks don't either, keep their
+		existing edge or lack of one. Every other pair is checked again against the updated geometry.
+
+		\remarks
+		The graph is rebuilt from its default cost. Any other cost types or node attributes
+		stored in graph are discarded.
+	*/
+	int UpdateRegion(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		HF::SpatialStructures::Graph& graph,
+		const std::array<float, 3>& box_min,
+		const std::array<float, 3>& box_max,
+		float height = 1.7f
+	);
+
+	/*! 
+		\brief Summary of the visibility of every node in a set of nodes, without any edges.
+
+		\details
+		Every array has one element per node, in the same order as the nodes they were calculated for.
+		Nodes that failed the height check can't see anything, and have zero in every array.
+	*/
+	struct VisibilityDegrees {
+		std::vector<int> counts;			///< Number of nodes visible from each node.
+		std::vector<float> sum_distance;	///< Sum of the distances to every node visible from each node.
+		std::vector<float> max_distance;	///< Distance to the furthest node visible from each node.
+	};
+
+	/// <summary> Calculate how many nodes every node can see and how far away they are, without storing any edges. </summary>
+	/*!
+		\param ert A Raytracer containing the geometry to use as obstacles for occlusion checks.
+		\param nodes X,Y,Z locations of nodes to calculate visibility for.
+		\param height Height to offset nodes in the z-direction before checking for occlusions.
+		\param max_distance Maximum length of a sightline in meters. Set to -1 for no limit.
+		\param upward_limit Maximum angle in degrees above the horizon a node can see. 90 or more for no limit.
+		\param downward_limit Maximum angle in degrees below the horizon a node can see. 90 or more for no limit.
+
+		\returns The number of visible nodes, sum of distances and maximum distance for every node in nodes.
+
+		\details
+		Performs the same checks as AllToAll, however instead of storing an edge for every unoccluded
+		pair of nodes, only the count, sum, and maximum of each node's sightlines are kept. Every node is
+		summarized entirely by the thread that checks it, so memory use is O(n) rather than O(e) and there
+		is no need to build or aggregate a graph afterwards. The mean visual depth of a node is its
+		sum_distance divided by its count. 
+
+		\see AllToAll for details on the height check and range limits.
+	*/
+	VisibilityDegrees AllToAllDegrees(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		const std::vector<HF::SpatialStructures::Node>& nodes,
+		float height = 1.7f,
+		float max_distance = -1.0f,
+		float upward_limit = 90.0f,
+		float downward_limit = 90.0f
+	);
+
+	/*! \brief How edges are stored in a visibility graph file. */
+	enum class VG_STORAGE : int {
+		DISTANCES = 0,		///< Store the distance of every edge alongside the CSR.
+		VISIBILITY_ONLY = 1	///< Only store which nodes can see eachother. Distances are recalculated on load.
+	};
+
+	/// <summary> Generate a Visibility Graph between every node in a set of nodes in tiled blocks. </summary>
+	/*!
+		\param ert A Raytracer containing the geometry to use as obstacles for occlusion checks.
+		\param nodes X,Y,Z locations of nodes for the Visibility Graph.
+		\param height Height to offset nodes in the z-direction before generating the VisibilityGraph.
+		\param block_size Number of nodes to finish calculating edges for before adding them to the graph.
+		\param tile_size Number of nodes each node is checked against in a single parallel task.
+
+		\returns
+		A Visibility Graph identical to the one returned by AllToAll.
+
+		\details
+		Nodes are processed in blocks of block_size. Each block is split into tiles of one node by
+		tile_size other nodes which are checked in parallel. When every tile of a block is finished, its edges
+		are appended directly to the arrays of the graph's CSR in order. Unlike AllToAll, this never stores
+		the entire graph as jagged arrays of edges and costs, and can use every core even when the graph
+		has very few nodes. 
+
+		\see AllToAllToFile for a version of this that writes the graph straight to disk.
+	*/
+	HF::SpatialStructures::Graph AllToAllBlocked(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		const std::vector<HF::SpatialStructures::Node>& nodes,
+		float height = 1.7f,
+		int block_size = 256,
+		int tile_size = 2048
+	);
+
+	/// <summary> Generate a Visibility Graph between every node in a set of nodes and stream it to a file. </summary>
+	/*!
+		\param ert A Raytracer containing the geometry to use as obstacles for occlusion checks.
+		\param nodes X,Y,Z locations of nodes for the Visibility Graph.
+		\param path Path to write the visibility graph to. Will be overwritten if it already exists.
+		\param height Height to offset nodes in the z-direction before generating the VisibilityGraph.
+		\param storage Whether to store the distance of every edge or only the edges themselves.
+		\param block_size Number of nodes to finish calculating edges for before writing them to the file.
+		\param tile_size Number of nodes each node is checked against in a single parallel task.
+
+		\returns The number of edges written to the file.
+
+		\throws std::runtime_error if path couldn't be written to. The temporary file for distances is
+		deleted whether or not this throws.
+
+		\details
+		Calculates the same graph as AllToAll in the same way as AllToAllBlocked, but every finished block
+		of edges is written straight to a binary CSR at path. Only the outer indices of the CSR and the 
+		edges of one block are ever held in memory, so graphs with far more edges than would fit in memory
+		can be generated. If storage is VG_STORAGE::DISTANCES, distances are written to a temporary file
+		next to path then appended to the end of the CSR once every block is finished.
+
+		\see LoadVisibilityGraph to read the file back into a graph.
+	*/
+	long long AllToAllToFile(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		const std::vector<HF::SpatialStructures::Node>& nodes,
+		const std::string& path,
+		float height = 1.7f,
+		VG_STORAGE storage = VG_STORAGE::DISTANCES,
+		int block_size = 256,
+		int tile_size = 2048
+	);
+
+	/// <summary> Load a Visibility Graph written by AllToAllToFile. </summary>
+	/*!
+		\param path Path to the file to read.
+
+		\returns The graph stored in path. If the file was written with VG_STORAGE::VISIBILITY_ONLY
+		the cost of every edge is recalculated from the positions of its nodes.
+
+		\throws HF::Exceptions::FileNotFound if path doesn't lead to a file.
+		\throws std::invalid_argument if path isn't a valid visibility graph file, is truncated, or has a
+		CSR with rows out of order or edges to nodes that don't exist.
+		\throws std::length_error if the file contains more edges than a graph can hold.
+	*/
+	HF::SpatialStructures::Graph LoadVisibilityGraph(const std::string& path);
+}
\ No newline at end of file
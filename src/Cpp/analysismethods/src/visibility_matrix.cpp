@@ -0,0 +1,244 @@
+///
+/// \file		visibility_matrix.cpp
+/// \brief		Contains implementation for the <see cref="HF::VisibilityGraph::VisibilityMatrix">VisibilityMatrix</see> class
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <visibility_matrix.h>
+#include <graph.h>
+#include <node.h>
+#include <parallelism.h>
+#include <stdexcept>
+#include <algorithm>
+#include <omp.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using std::vector;
+using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::Node;
+
+namespace HF::VisibilityGraph {
+
+	/*! \brief Count the number of set bits in word. */
+	inline int PopCount(uint64_t word) {
+#if defined(_MSC_VER)
+		return static_cast<int>(__popcnt64(word));
+#else
+		return __builtin_popcountll(word);
+#endif
+	}
+
+	/*! \brief Get the index of the lowest set bit in word. Word must not be zero. */
+	inline int LowestSetBit(uint64_t word) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	/*!
+		\brief Call func with the column of every set bit in an array of words.
+
+		\param words Words to iterate through.
+		\param num_words Number of words in words.
+		\param first_column Column of the first bit of the first word.
+		\param func Callable with the signature `void(int column)`.
+	*/
+	template <typename Func>
+	inline void ForEachSetBit(const uint64_t* words, int num_words, int first_column, Func& func) {
+		for (int w = 0; w < num_words; w++) {
+			uint64_t word = words[w];
+			while (word != 0) {
+				func(first_column + w * 64 + LowestSetBit(word));
+				word &= word - 1;
+			}
+		}
+	}
+
+	VisibilityMatrix::VisibilityMatrix(int num_nodes, bool upper_triangular)
+		: num_nodes(num_nodes), upper_triangular(upper_triangular)
+	{
+		words_per_row = (num_nodes + 63) / 64;
+		bits.resize(RowOffset(num_nodes), 0);
+	}
+
+	size_t VisibilityMatrix::RowOffset(int row) const {
+		if (!upper_triangular)
+			return static_cast<size_t>(row) * words_per_row;
+
+		// Row r skips the first r / 64 words of a full row, so the offset of row
+		// is the size of every previous full row minus the sum of skipped words
+		const size_t q = row / 64;
+		const size_t r = row % 64;
+		const size_t skipped = (q > 0 ? 64 * q * (q - 1) / 2 : 0) + q * r;
+		return static_cast<size_t>(row) * words_per_row - skipped;
+	}
+
+	void VisibilityMatrix::Set(int a, int b, bool visible) {
+		if (a == b) return;
+		if (upper_triangular && a > b) std::swap(a, b);
+
+		const int column = b - FirstStoredColumn(a);
+		uint64_t& word = bits[RowOffset(a) + column / 64];
+		const uint64_t mask = uint64_t(1) << (column % 64);
+
+		if (visible) word |= mask;
+		else word &= ~mask;
+	}
+
+	bool VisibilityMatrix::IsVisible(int a, int b) const {
+		if (a == b) return false;
+		if (upper_triangular && a > b) std::swap(a, b);
+
+		const int column = b - FirstStoredColumn(a);
+		return (bits[RowOffset(a) + column / 64] >> (column % 64)) & 1;
+	}
+
+	void VisibilityMatrix::FullRow(int row, vector<uint64_t>& out_row) const {
+		out_row.assign(words_per_row, 0);
+
+		// Copy the stored part of the row
+		const int first_word = FirstStoredColumn(row) / 64;
+		const size_t offset = RowOffset(row);
+		for (int w = first_word; w < words_per_row; w++)
+			out_row[w] = bits[offset + w - first_word];
+
+		// Fill in the lower half from the column of this row in every previous row
+		if (upper_triangular)
+			for (int other = 0; other < row; other++)
+				if (IsVisible(other, row))
+					out_row[other / 64] |= uint64_t(1) << (other % 64);
+	}
+
+	int VisibilityMatrix::Degree(int node) const {
+		const int first_word = FirstStoredColumn(node) / 64;
+		const size_t offset = RowOffset(node);
+
+		int degree = 0;
+		for (int w = first_word; w < words_per_row; w++)
+			degree += PopCount(bits[offset + w - first_word]);
+
+		// Bits before the diagonal in the first stored word are never set, so only
+		// the lower half needs to be counted seperately
+		if (upper_triangular)
+			for (int other = 0; other < node; other++)
+				degree += IsVisible(other, node);
+
+		return degree;
+	}
+
+	vector<int> VisibilityMatrix::Degrees() const {
+		vector<int> degrees(num_nodes, 0);
+
+		if (!upper_triangular) {
+			HF::Parallel::ThreadLease lease(-1, num_nodes);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+			for (int node = 0; node < num_nodes; node++)
+				degrees[node] = Degree(node);
+		}
+		else {
+			// Count each stored bit for both its row and its column in a single pass.
+			// Done serially since columns are shared between rows.
+			for (int row = 0; row < num_nodes; row++) {
+				const int first_column = FirstStoredColumn(row);
+				auto add_edge = [&](int column) {
+					degrees[row]++;
+					degrees[column]++;
+				};
+				ForEachSetBit(bits.data() + RowOffset(row), words_per_row - first_column / 64, first_column, add_edge);
+			}
+		}
+		return degrees;
+	}
+
+	int VisibilityMatrix::CoVisibleCount(int a, int b) const {
+		if (!upper_triangular) {
+			const uint64_t* row_a = bits.data() + RowOffset(a);
+			const uint64_t* row_b = bits.data() + RowOffset(b);
+
+			int count = 0;
+			for (int w = 0; w < words_per_row; w++)
+				count += PopCount(row_a[w] & row_b[w]);
+			return count;
+		}
+		else {
+			vector<uint64_t> row_a, row_b;
+			FullRow(a, row_a);
+			FullRow(b, row_b);
+
+			int count = 0;
+			for (int w = 0; w < words_per_row; w++)
+				count += PopCount(row_a[w] & row_b[w]);
+			return count;
+		}
+	}
+
+	vector<int> VisibilityMatrix::CoVisible(int a, int b) const {
+		vector<uint64_t> row_a, row_b;
+		FullRow(a, row_a);
+		FullRow(b, row_b);
+
+		for (int w = 0; w < words_per_row; w++)
+			row_a[w] &= row_b[w];
+
+		vector<int> covisible;
+		auto add_node = [&](int column) { covisible.push_back(column); };
+		ForEachSetBit(row_a.data(), words_per_row, 0, add_node);
+		return covisible;
+	}
+
+	Graph VisibilityMatrix::ToGraph(const vector<Node>& nodes) const {
+		if (nodes.size() != num_nodes)
+			throw std::invalid_argument("The number of nodes doesn't match the size of the visibility matrix!");
+
+		// Calculate the start of every row in the CSR from the degree of every node
+		const auto degrees = Degrees();
+		vector<int> outer_indices(num_nodes + 1, 0);
+		for (int i = 0; i < num_nodes; i++)
+			outer_indices[i + 1] = outer_indices[i] + degrees[i];
+
+		const int num_edges = outer_indices.back();
+		vector<int> inner_indices(num_edges);
+		vector<float> values(num_edges);
+
+		if (!upper_triangular) {
+			// Every row can be written independently
+			HF::Parallel::ThreadLease lease(-1, num_nodes);
+#pragma omp parallel for schedule(dynamic, 64) num_threads(lease.size())
+			for (int row = 0; row < num_nodes; row++) {
+				int cursor = outer_indices[row];
+				auto add_edge = [&](int column) {
+					inner_indices[cursor] = column;
+					values[cursor] = nodes[row].distanceTo(nodes[column]);
+					cursor++;
+				};
+				ForEachSetBit(bits.data() + RowOffset(row), words_per_row, 0, add_edge);
+			}
+		}
+		else {
+			// Every stored bit is added to both its row and its column. Rows are visited in
+			// ascending order, so the columns of every row in the CSR end up sorted.
+			vector<int> cursors(outer_indices.begin(), outer_indices.end() - 1);
+			for (int row = 0; row < num_nodes; row++) {
+				const int first_column = FirstStoredColumn(row);
+				auto add_edge = [&](int column) {
+					const float distance = nodes[row].distanceTo(nodes[column]);
+					inner_indices[cursors[row]] = column;
+					values[cursors[row]++] = distance;
+					inner_indices[cursors[column]] = row;
+					values[cursors[column]++] = distance;
+				};
+				ForEachSetBit(bits.data() + RowOffset(row), words_per_row - first_column / 64, first_column, add_edge);
+			}
+		}
+
+		return Graph(outer_indices, inner_indices, values, nodes);
+	}
+}
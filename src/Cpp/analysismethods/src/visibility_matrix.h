@@ -0,0 +1,160 @@
+///
+/// \file		visibility_matrix.h
+/// \brief		Contains definitions for the <see cref="HF::VisibilityGraph::VisibilityMatrix">VisibilityMatrix</see> class
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Forward Declares
+namespace HF {
+	namespace SpatialStructures {
+		class Graph;
+		struct Node;
+	}
+	namespace RayTracer {
+		class EmbreeRayTracer;
+	}
+}
+
+namespace HF::VisibilityGraph {
+
+	/*!
+		\brief A packed matrix of bits storing which nodes are visible from eachother.
+
+		\details
+		Every row of the matrix is stored as an array of 64 bit words, with one bit for every node
+		in the graph. Since the distance between two nodes can always be recalculated from their positions,
+		this stores a dense visibility graph in 1/32nd of the space required for the values alone of a CSR.
+		Degrees and co-visible nodes are calculated a word at a time using popcount.
+
+		\par Upper Triangular Storage
+		If the matrix is upper triangular, visibility is treated as symmetric and only the bits for columns
+		greater than the row are stored, halving memory usage. Each row still starts on a word boundary
+		so rows can be processed a word at a time, but queries that need the lower half of a row, such as
+		Degree and CoVisible, must check a single bit in every previous row.
+
+		\remarks
+		Calling Set on different rows from different threads is safe. Calling Set on the same row from
+		multiple threads is not.
+
+		\see AllToAllMatrix to generate a VisibilityMatrix from a set of nodes.
+	*/
+	class VisibilityMatrix {
+		int num_nodes = 0;					///< Number of rows and columns in the matrix.
+		int words_per_row = 0;				///< Number of words in a full row of the matrix.
+		bool upper_triangular = false;		///< If true, only bits above the diagonal are stored.
+		std::vector<uint64_t> bits;			///< Packed bits of every row of the matrix.
+
+		/*! \brief Get the index of the first word stored for row. */
+		size_t RowOffset(int row) const;
+
+		/*! \brief Get the index of the first column of the first word stored for row. */
+		inline int FirstStoredColumn(int row) const {
+			return upper_triangular ? row - (row % 64) : 0;
+		}
+
+		/*!
+			\brief Write every bit of a row, including those in the lower half of an upper triangular matrix,
+			into out_row.
+		*/
+		void FullRow(int row, std::vector<uint64_t>& out_row) const;
+
+	public:
+		/*! \brief Construct an empty matrix with no nodes. */
+		VisibilityMatrix() {};
+
+		/*!
+			\brief Construct a matrix for num_nodes nodes where no node can see any other node.
+
+			\param num_nodes Number of nodes in the matrix.
+			\param upper_triangular Only store bits above the diagonal, treating visibility as symmetric.
+		*/
+		VisibilityMatrix(int num_nodes, bool upper_triangular = false);
+
+		/*!
+			\brief Mark whether node b is visible from node a.
+
+			\param a Row of the matrix.
+			\param b Column of the matrix.
+			\param visible Whether or not b should be visible from a.
+
+			\remarks
+			If the matrix is upper triangular, a and b are swapped if a is greater than b.
+			Bits along the diagonal are never stored, and setting them has no effect.
+		*/
+		void Set(int a, int b, bool visible = true);
+
+		/*! \brief Determine if node b is visible from node a. */
+		bool IsVisible(int a, int b) const;
+
+		/*!
+			\brief Count the number of nodes visible from node.
+
+			\returns The number of set bits in node's row of the matrix.
+		*/
+		int Degree(int node) const;
+
+		/*! \brief Calculate the degree of every node in the matrix in parallel. */
+		std::vector<int> Degrees() const;
+
+		/*!
+			\brief Count the nodes that are visible from both a and b.
+
+			\returns The number of bits set in the intersection of rows a and b.
+		*/
+		int CoVisibleCount(int a, int b) const;
+
+		/*! \brief Get the ids of the nodes that are visible from both a and b in ascending order. */
+		std::vector<int> CoVisible(int a, int b) const;
+
+		/*!
+			\brief Create a graph containing an edge for every set bit in this matrix.
+
+			\param nodes Positions of the nodes this matrix was generated from. The cost of every edge
+			will be the distance between its nodes.
+
+			\returns A graph equivalent to the one returned by AllToAll for the same nodes. If the
+			matrix is upper triangular, each pair of visible nodes will have an edge in both directions.
+
+			\throws std::invalid_argument if the number of nodes doesn't match the size of the matrix.
+		*/
+		HF::SpatialStructures::Graph ToGraph(const std::vector<HF::SpatialStructures::Node>& nodes) const;
+
+		/*! \brief Number of nodes in the matrix. */
+		inline int size() const { return num_nodes; }
+
+		/*! \brief Whether only the upper half of this matrix is stored. */
+		inline bool IsUpperTriangular() const { return upper_triangular; }
+
+		/*! \brief Get the number of bytes used to store the bits of this matrix. */
+		inline size_t MemoryUsage() const { return bits.size() * sizeof(uint64_t); }
+	};
+
+	/// <summary> Generate a packed bit matrix of the visibility between every node in a set of nodes. </summary>
+	/*!
+		\param ert A Raytracer containing the geometry to use as obstacles for occlusion checks.
+		\param nodes X,Y,Z locations of nodes to check visibility between.
+		\param height Height to offset nodes in the z-direction before checking for occlusions.
+		\param upper_triangular If true, treat visibility as symmetric and only check each pair of
+		nodes once, storing the result in the upper half of the matrix.
+
+		\returns A VisibilityMatrix with a bit set for every pair of nodes with a clear line of sight.
+
+		\details
+		Performs the same checks as AllToAll, but every result is a single bit in a row owned by the
+		thread that checked it. When upper_triangular is set, only half as many rays are cast, similar
+		to AllToAllUndirected.
+
+		\see VisibilityMatrix::ToGraph to convert the result to a Graph.
+	*/
+	VisibilityMatrix AllToAllMatrix(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		const std::vector<HF::SpatialStructures::Node>& nodes,
+		float height = 1.7f,
+		bool upper_triangular = false
+	);
+}
@@ -0,0 +1,149 @@
+""" Compare the results of HFBenchmarks to a baseline, and fail if any case regressed.
+
+Both files are the JSON written by Google Benchmark's --benchmark_out option. If
+the benchmarks were run with --benchmark_repetitions, the median of every case
+is compared. Otherwise the mean of every run of a case is compared.
+
+Timings only compare between runs on the same machine with the same build type, so
+record the baseline there before making a change.
+
+Example:
+    HFBenchmarks --benchmark_repetitions=5 --benchmark_report_aggregates_only=true \\
+        --benchmark_out=results.json --benchmark_out_format=json
+    python compare_benchmarks.py baseline.json results.json --threshold 0.15
+
+    # Merge the new results into the baseline, keeping any cases that weren't run
+    python compare_benchmarks.py baseline.json results.json --update
+"""
+
+import argparse
+import json
+import os
+import sys
+from typing import Dict
+
+# Nanoseconds in each of Google Benchmark's time units
+NANOSECONDS_PER_UNIT = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def case_name(case: dict) -> str:
+    """ Get the name of a case, shared by every repetition and aggregate of it """
+    return case.get("run_name", case["name"])
+
+
+def load_times(path: str, metric: str) -> Dict[str, float]:
+    """ Get the time of every case in a Google Benchmark JSON file
+
+    Args:
+        path: Path to the JSON file
+        metric: Either real_time or cpu_time
+
+    Returns:
+        Dict[str, float]: The time of each case in nanoseconds, by the case's name
+    """
+    with open(path) as file:
+        benchmarks = json.load(file)["benchmarks"]
+
+    medians = {}
+    runs = {}
+    for case in benchmarks:
+        time = case[metric] * NANOSECONDS_PER_UNIT[case.get("time_unit", "ns")]
+        name = case_name(case)
+
+        if case.get("run_type") == "aggregate":
+            if case.get("aggregate_name") == "median":
+                medians[name] = time
+        else:
+            runs.setdefault(name, []).append(time)
+
+    # Prefer the median of repetitions when it was reported
+    times = {name: sum(values) / len(values) for name, values in runs.items()}
+    times.update(medians)
+    return times
+
+
+def merge_into_baseline(baseline_path: str, results_path: str) -> None:
+    """ Replace the cases of the baseline that were run in the results, keeping the rest
+
+    Args:
+        baseline_path: Path to the baseline. Created if it doesn't exist
+        results_path: Path to the results to merge into it
+
+    The context of the merged file, such as the machine and build type, is taken from
+    the results.
+    """
+    with open(results_path) as file:
+        merged = json.load(file)
+
+    kept = []
+    if os.path.exists(baseline_path):
+        with open(baseline_path) as file:
+            updated = {case_name(case) for case in merged["benchmarks"]}
+            kept = [case for case in json.load(file)["benchmarks"] if case_name(case) not in updated]
+
+    merged["benchmarks"] = kept + merged["benchmarks"]
+    with open(baseline_path, "w") as file:
+        json.dump(merged, file, indent=2)
+
+
+def format_time(nanoseconds: float) -> str:
+    """ Format a time in the largest unit that keeps it above 1 """
+    for unit in ("s", "ms", "us"):
+        if nanoseconds >= NANOSECONDS_PER_UNIT[unit]:
+            return f"{nanoseconds / NANOSECONDS_PER_UNIT[unit]:.3f}{unit}"
+    return f"{nanoseconds:.1f}ns"
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Compare HFBenchmarks results to a baseline.")
+    parser.add_argument("baseline", help="JSON results to compare against")
+    parser.add_argument("results", help="JSON results of the current build")
+    parser.add_argument("--threshold", type=float, default=0.15,
+                        help="Fraction a case may slow down by before it counts as a regression. Default 0.15")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"), default="real_time",
+                        help="Time to compare. Default real_time")
+    parser.add_argument("--update", action="store_true",
+                        help="Merge the results into the baseline after comparing them")
+    args = parser.parse_args()
+
+    # The first --update creates the baseline
+    if args.update and not os.path.exists(args.baseline):
+        baseline = {}
+    else:
+        baseline = load_times(args.baseline, args.metric)
+    results = load_times(args.results, args.metric)
+
+    regressions = []
+    print(f"{'Case':<40} {'Baseline':>12} {'Current':>12} {'Change':>9}")
+    for name, time in results.items():
+        if name not in baseline:
+            print(f"{name:<40} {'-':>12} {format_time(time):>12} {'new':>9}")
+            continue
+
+        change = time / baseline[name] - 1.0
+        regressed = change > args.threshold
+        if regressed:
+            regressions.append(name)
+
+        print(f"{name:<40} {format_time(baseline[name]):>12} {format_time(time):>12} {change:>+8.1%}"
+              + (" REGRESSED" if regressed else ""))
+
+    # Cases can be skipped with --benchmark_filter, so this is only a warning
+    for name in baseline.keys() - results.keys():
+        print(f"{name:<40} {format_time(baseline[name]):>12} {'-':>12} {'missing':>9}")
+
+    if args.update:
+        merge_into_baseline(args.baseline, args.results)
+        print(f"Updated {args.baseline}")
+        return 0
+
+    if regressions:
+        print(f"\n{len(regressions)} case(s) regressed by more than {args.threshold:.0%}: {', '.join(regressions)}")
+        return 1
+
+    print(f"\nNo case regressed by more than {args.threshold:.0%}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
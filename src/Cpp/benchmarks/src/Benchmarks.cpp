@@ -0,0 +1,359 @@
+/*!
+	\brief Microbenchmarks for the hot paths of every module.
+
+	\details
+	Each case builds its inputs outside of the timed loop, so only the function being measured is
+	timed. Graphs and meshes are generated procedurally and sized by the benchmark's argument,
+	except for BM_LoadOBJ, which loads sponza.obj from the example models copied next to
+	HFBenchmarks. The building cases sweep the size of a building generated by
+	HF::Geometry::GenerateBuilding, and report its triangles and the nodes of its graph as counters,
+	to show where each stage stops scaling. Run with
+	`HFBenchmarks --benchmark_format=json --benchmark_out=results.json` then compare the results to
+	a baseline recorded on the same machine with compare_benchmarks.py.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <graph.h>
+#include <node.h>
+#include <path.h>
+#include <path_finder.h>
+#include <meshinfo.h>
+#include <objloader.h>
+#include <embree_raytracer.h>
+#include <graph_generator.h>
+#include <cost_algorithms.h>
+#include <scene_generator.h>
+
+using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::Node;
+using HF::SpatialStructures::COST_AGGREGATE;
+using HF::SpatialStructures::Direction;
+using HF::Geometry::MeshInfo;
+using HF::RayTracer::EmbreeRayTracer;
+using HF::RayTracer::HitStruct;
+using HF::Geometry::BuildingParameters;
+using std::vector;
+using std::array;
+
+/*!
+	\brief Create an uncompressed graph of a size x size grid where every node is connected to its 8 neighbors.
+
+	\details Nodes are added by position rather than ID so building the graph exercises the ID map.
+*/
+static Graph CreateGridGraph(int size) {
+	Graph g;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			const Node parent(static_cast<float>(x), static_cast<float>(y), 0.0f);
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					const int cx = x + dx, cy = y + dy;
+					if ((dx == 0 && dy == 0) || cx < 0 || cy < 0 || cx >= size || cy >= size) continue;
+
+					const Node child(static_cast<float>(cx), static_cast<float>(cy), 0.0f);
+					g.addEdge(parent, child, std::sqrt(static_cast<float>(dx * dx + dy * dy)));
+				}
+			}
+		}
+	}
+	return g;
+}
+
+/*! \brief Create a compressed grid graph. See CreateGridGraph. */
+static Graph CreateCompressedGridGraph(int size) {
+	Graph g = CreateGridGraph(size);
+	g.Compress();
+	return g;
+}
+
+/*!
+	\brief Create the unindexed vertices of a size x size heightfield, with three vertices for every
+	triangle and two triangles for every cell.
+
+	\details The heights form gentle hills so rays cast down at the terrain hit at different distances.
+*/
+static vector<array<float, 3>> CreateTerrainVertices(int size) {
+	auto vertex = [](int x, int y) {
+		const float height = std::sin(x * 0.3f) * std::cos(y * 0.2f);
+		return array<float, 3>{ static_cast<float>(x), static_cast<float>(y), height };
+	};
+
+	vector<array<float, 3>> vertices;
+	vertices.reserve(static_cast<size_t>(size) * size * 6);
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			vertices.push_back(vertex(x, y));
+			vertices.push_back(vertex(x + 1, y));
+			vertices.push_back(vertex(x + 1, y + 1));
+
+			vertices.push_back(vertex(x, y));
+			vertices.push_back(vertex(x + 1, y + 1));
+			vertices.push_back(vertex(x, y + 1));
+		}
+	}
+	return vertices;
+}
+
+/*! \brief Create a raytracer containing a 256 x 256 heightfield. */
+static EmbreeRayTracer CreateTerrainRayTracer() {
+	MeshInfo<float> terrain(CreateTerrainVertices(256), 0, "terrain");
+	return EmbreeRayTracer(terrain);
+}
+
+/*! \brief Create count origins spread over the terrain 10 meters above it, and a downward direction for each. */
+static void CreateRays(int count, vector<array<float, 3>>& origins, vector<array<float, 3>>& directions) {
+	const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+	const float spacing = 250.0f / side;
+
+	origins.resize(count);
+	directions.assign(count, array<float, 3>{ 0.0f, 0.0f, -1.0f });
+	for (int i = 0; i < count; i++)
+		origins[i] = { 2.0f + (i % side) * spacing, 2.0f + (i / side) * spacing, 10.0f };
+}
+
+/*!
+	\brief Get the parameters of a building with the given number of floors and rooms per floor.
+
+	\details The footprint grows with the number of rooms so every room stays the same size.
+*/
+static BuildingParameters CreateBuildingParameters(int floors, int rooms) {
+	BuildingParameters params;
+	params.floors = floors;
+	params.rooms_per_floor = rooms;
+	params.width = 10.0f + 5.0f * rooms;
+	params.depth = 12.0f;
+	params.obstacle_density = 0.2f;
+	return params;
+}
+
+static void BM_GraphCompress(benchmark::State& state) {
+	const int size = state.range(0);
+	for (auto _ : state) {
+		state.PauseTiming();
+		Graph g = CreateGridGraph(size);
+		state.ResumeTiming();
+
+		g.Compress();
+		benchmark::DoNotOptimize(g);
+	}
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_GraphCompress)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void BM_GraphGetEdges(benchmark::State& state) {
+	const int size = state.range(0);
+	const Graph g = CreateCompressedGridGraph(size);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(g.GetEdges());
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_GraphGetEdges)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void BM_GraphAggregateGraph(benchmark::State& state) {
+	const int size = state.range(0);
+	const Graph g = CreateCompressedGridGraph(size);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(g.AggregateGraph(COST_AGGREGATE::AVERAGE, false));
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_GraphAggregateGraph)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void BM_GraphAttrToCost(benchmark::State& state) {
+	const int size = state.range(0);
+	Graph g = CreateCompressedGridGraph(size);
+
+	const int num_nodes = g.size();
+	vector<int> ids(num_nodes);
+	vector<std::string> scores(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		ids[i] = i;
+		scores[i] = std::to_string(i % 10);
+	}
+	g.AddNodeAttributes(ids, "score", scores);
+
+	for (auto _ : state)
+		g.AttrToCost("score", "score_cost", Direction::BOTH);
+
+	state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+BENCHMARK(BM_GraphAttrToCost)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void BM_CreateBoostGraph(benchmark::State& state) {
+	const int size = state.range(0);
+	const Graph g = CreateCompressedGridGraph(size);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(HF::Pathfinding::CreateBoostGraph(g));
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_CreateBoostGraph)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void BM_Dijkstra(benchmark::State& state) {
+	const int size = state.range(0);
+	const Graph g = CreateCompressedGridGraph(size);
+	auto bg = HF::Pathfinding::CreateBoostGraph(g);
+
+	// Corner to corner, so the search has to visit every node
+	for (auto _ : state)
+		benchmark::DoNotOptimize(HF::Pathfinding::FindPath(bg.get(), 0, g.size() - 1));
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_Dijkstra)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void BM_IndexRawVertices(benchmark::State& state) {
+	const auto vertices = CreateTerrainVertices(state.range(0));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(MeshInfo<float>(vertices, 0, "terrain"));
+
+	state.SetItemsProcessed(state.iterations() * vertices.size());
+}
+BENCHMARK(BM_IndexRawVertices)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadOBJ(benchmark::State& state) {
+	for (auto _ : state)
+		benchmark::DoNotOptimize(HF::Geometry::LoadMeshObjects("sponza.obj", HF::Geometry::ONLY_FILE, true));
+}
+BENCHMARK(BM_LoadOBJ)->Unit(benchmark::kMillisecond);
+
+static void BM_GenerateBuilding(benchmark::State& state) {
+	const auto params = CreateBuildingParameters(state.range(0), state.range(1));
+	int triangles = 0;
+	for (auto _ : state) {
+		auto building = HF::Geometry::GenerateBuilding(params);
+		triangles = building.NumTris();
+		benchmark::DoNotOptimize(building);
+	}
+	state.counters["triangles"] = triangles;
+}
+BENCHMARK(BM_GenerateBuilding)->Args({ 1, 4 })->Args({ 4, 16 })->Args({ 16, 16 })->Unit(benchmark::kMillisecond);
+
+static void BM_BuildingGraph(benchmark::State& state) {
+	const auto params = CreateBuildingParameters(state.range(0), state.range(1));
+	auto building = HF::Geometry::GenerateBuilding(params);
+	EmbreeRayTracer ert(building);
+	HF::GraphGenerator::GraphGenerator generator(ert);
+
+	// Start in the middle of the ground floor's corridor. Nodes 0.5m apart span up to two steps of the
+	// stairs, so allow steps just high enough to climb them but not onto the obstacles.
+	const array<float, 3> start{ params.width / 2.0f, 2.0f, 0.5f };
+	const array<float, 3> spacing{ 0.5f, 0.5f, 0.5f };
+	int nodes = 0;
+	for (auto _ : state) {
+		Graph g = generator.BuildNetwork(start, spacing, -1, 0.36f, 40.0f, 0.36f, 40.0f, 1);
+		nodes = g.size();
+		benchmark::DoNotOptimize(g);
+	}
+	state.counters["triangles"] = building.NumTris();
+	state.counters["nodes"] = nodes;
+	state.SetItemsProcessed(state.iterations() * nodes);
+}
+BENCHMARK(BM_BuildingGraph)->Args({ 1, 4 })->Args({ 2, 4 })->Args({ 2, 16 })->Args({ 4, 16 })->Unit(benchmark::kMillisecond);
+
+// Generate a graph with energy expenditure and cross slope costs, either calculated
+// by the graph generator (inline = 1) or from the compressed graph afterwards (inline = 0)
+static void BM_BuildingGraphCosts(benchmark::State& state) {
+	using namespace HF::GraphGenerator;
+	using namespace HF::SpatialStructures::CostAlgorithms;
+
+	const auto params = CreateBuildingParameters(state.range(0), state.range(1));
+	const bool inline_costs = state.range(2) != 0;
+	auto building = HF::Geometry::GenerateBuilding(params);
+	EmbreeRayTracer ert(building);
+	GraphGenerator generator(ert);
+
+	const array<float, 3> start{ params.width / 2.0f, 2.0f, 0.5f };
+	const array<float, 3> spacing{ 0.5f, 0.5f, 0.5f };
+	const int costs = inline_costs ? (INLINE_ENERGY_EXPENDITURE | INLINE_CROSS_SLOPE) : INLINE_NONE;
+	for (auto _ : state) {
+		Graph g = generator.BuildNetwork(
+			start, spacing, -1, 0.36f, 40.0f, 0.36f, 40.0f, 1, 1, -1,
+			default_z_precision, default_spacing_precision, default_ground_offset, costs
+		);
+		if (!inline_costs) {
+			g.Compress();
+			g.AddEdges(CalculateEnergyExpenditure(g), InlineCostName(INLINE_ENERGY_EXPENDITURE));
+			g.AddEdges(CalculateCrossSlope(g), InlineCostName(INLINE_CROSS_SLOPE));
+		}
+		benchmark::DoNotOptimize(g);
+	}
+}
+BENCHMARK(BM_BuildingGraphCosts)->Args({ 2, 4, 0 })->Args({ 2, 4, 1 })->Unit(benchmark::kMillisecond);
+
+static void BM_RaycastIntersections(benchmark::State& state) {
+	EmbreeRayTracer ert = CreateTerrainRayTracer();
+	vector<array<float, 3>> origins, directions;
+	CreateRays(state.range(0), origins, directions);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ert.Intersections<float>(origins, directions, -1.0f, true));
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+}
+BENCHMARK(BM_RaycastIntersections)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_RaycastOcclusions(benchmark::State& state) {
+	EmbreeRayTracer ert = CreateTerrainRayTracer();
+	vector<array<float, 3>> origins, directions;
+	CreateRays(state.range(0), origins, directions);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ert.Occlusions(origins, directions, -1.0f, true));
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+}
+BENCHMARK(BM_RaycastOcclusions)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_RaycastPointIntersections(benchmark::State& state) {
+	EmbreeRayTracer ert = CreateTerrainRayTracer();
+	vector<array<float, 3>> origins, directions;
+	CreateRays(state.range(0), origins, directions);
+
+	for (auto _ : state) {
+		// PointIntersections moves the origins to the hit points, so start from a fresh copy each time
+		state.PauseTiming();
+		auto points = origins;
+		auto point_directions = directions;
+		state.ResumeTiming();
+
+		benchmark::DoNotOptimize(ert.PointIntersections(points, point_directions, true));
+	}
+	state.SetItemsProcessed(state.iterations() * origins.size());
+}
+BENCHMARK(BM_RaycastPointIntersections)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_RaycastSingleIntersect(benchmark::State& state) {
+	EmbreeRayTracer ert = CreateTerrainRayTracer();
+	vector<array<float, 3>> origins, directions;
+	CreateRays(state.range(0), origins, directions);
+
+	for (auto _ : state)
+		for (const auto& origin : origins)
+			benchmark::DoNotOptimize(ert.Intersect<float>(origin, directions[0]));
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+}
+BENCHMARK(BM_RaycastSingleIntersect)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_RaycastSingleOccluded(benchmark::State& state) {
+	EmbreeRayTracer ert = CreateTerrainRayTracer();
+	vector<array<float, 3>> origins, directions;
+	CreateRays(state.range(0), origins, directions);
+
+	for (auto _ : state)
+		for (const auto& origin : origins)
+			benchmark::DoNotOptimize(ert.Occluded(origin, directions[0]));
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+}
+BENCHMARK(BM_RaycastSingleOccluded)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
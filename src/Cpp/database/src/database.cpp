@@ -1,62 +1,653 @@
-#include "pch.h"
-#include <iostream>
+///
+///	\file		database.cpp
+/// \brief		Contains implementation for the <see cref="HF::DB::ResultStore">ResultStore</see> and its sqlite wrappers
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <database.h>
+
 #include <sqlite3.h>
-#include <string>
-
-namespace HF {
-	namespace DB {
-		
-		/// <summary>
-		/// A wrapper for a sqlite database. Automatically closes upon being destroyed. 
-		/// </summary>
-		class Connection {
-			
-			/// <summary>
-			/// Opens a connection via the string specified by path
-			/// </summary>
-			/// <param name="path">The name of connection to open</param>
-			void OpenConnection(std::string path);
-		public:
-			sqlite3* conn; ///< Current connection to the database ///<
-			
-			/// <summary>
-			/// Create a new database connection
-			/// </summary>
-			/// <param name="path"> Path to the database</param>
-			Connection(std::string path);
-
-			/// <summary>
-			/// Close the existing connection
-			/// </summary>
-			void Close();
-
-			/// <summary>
-			/// Close the existing connection for the database
-			/// </summary>
-			~Connection();
-
-		};
-		/// <summary>
-		/// Mantains state for connecting to, storing information in, and reading information from sqlite
-		/// </summary>
-		class Database {
-
-		private:
-			std::string database_path; // Path to the sqlite database
-
-			/// <summary>
-			/// Create a new database connection.
-			/// </summary>
-			Connection openDB();
-
-		public:
-			/// <summary>
-			/// Create a new db instance from absolute path to a database.
-			/// If one doesn't exist already, then one will be created
-			/// </summary>
-			/// <param name="path"></param>
-			Database(std::string path);
-		};
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include <graph.h>
+#include <path.h>
+#include <node.h>
+#include <Edge.h>
+#include <HFExceptions.h>
+
+using namespace HF::SpatialStructures;
+using HF::Exceptions::MalformedDatabase;
+using HF::Exceptions::DatabaseBusy;
+using std::string;
+using std::vector;
+
+namespace HF::DB {
+
+	/// Kinds of result stored in the results table.
+	const string graph_nodes_kind = "graph_nodes";
+	const string graph_csr_kind = "graph_csr";
+	const string graph_cost_kind = "graph_cost";
+	const string graph_attr_kind = "graph_attr";
+	const string scores_kind = "scores";
+	const string paths_kind = "paths";
+
+	/*!
+		\brief Throw the exception that matches a sqlite error code.
+
+		\exception HF::Exceptions::DatabaseBusy code is SQLITE_BUSY or SQLITE_LOCKED.
+		\exception HF::Exceptions::MalformedDatabase code is any other error.
+	*/
+	[[noreturn]] void ThrowSQLiteError(sqlite3* conn, int code) {
+		const string message = conn ? sqlite3_errmsg(conn) : sqlite3_errstr(code);
+		const int primary_code = code & 0xFF;
+		if (primary_code == SQLITE_BUSY || primary_code == SQLITE_LOCKED)
+			throw DatabaseBusy(message);
+		else
+			throw MalformedDatabase(message);
 	}
-}
 
+	/// <summary> Appends values to a blob in the byte order of this machine. </summary>
+	class BlobWriter {
+	public:
+		vector<char> data; ///< Bytes written so far.
+
+		/// <summary> Append a single value. </summary>
+		template <typename T>
+		inline void Write(const T& value) {
+			const char* bytes = reinterpret_cast<const char*>(&value);
+			data.insert(data.end(), bytes, bytes + sizeof(T));
+		}
+
+		/// <summary> Append count values from an array. </summary>
+		template <typename T>
+		inline void Write(const T* values, size_t count) {
+			const char* bytes = reinterpret_cast<const char*>(values);
+			data.insert(data.end(), bytes, bytes + sizeof(T) * count);
+		}
+
+		/// <summary> Append a string, prefixed by its length. </summary>
+		inline void Write(const string& text) {
+			Write<uint32_t>(static_cast<uint32_t>(text.size()));
+			Write(text.data(), text.size());
+		}
+	};
+
+	/// <summary> Reads values from a blob written by a BlobWriter. </summary>
+	/*!
+		\exception HF::Exceptions::MalformedDatabase Every read throws if it would read past the
+		end of the blob.
+	*/
+	class BlobReader {
+		const vector<char>& data;	///< Blob being read.
+		size_t offset = 0;			///< Index of the next byte to read.
+
+		/// <summary> Ensure size bytes can be read. </summary>
+		inline void Require(size_t size) const {
+			if (size > data.size() - offset)
+				throw MalformedDatabase("A stored result was truncated");
+		}
+
+	public:
+		BlobReader(const vector<char>& data) : data(data) {}
+
+		/// <summary> Read a single value. </summary>
+		template <typename T>
+		inline T Read() {
+			Require(sizeof(T));
+			T value;
+			std::memcpy(&value, data.data() + offset, sizeof(T));
+			offset += sizeof(T);
+			return value;
+		}
+
+		/// <summary> Read count values into out_values. </summary>
+		template <typename T>
+		inline void Read(vector<T>& out_values, size_t count) {
+			if (count > (data.size() - offset) / sizeof(T))
+				throw MalformedDatabase("A stored result was truncated");
+			out_values.resize(count);
+			if (count > 0)
+				std::memcpy(out_values.data(), data.data() + offset, sizeof(T) * count);
+			offset += sizeof(T) * count;
+		}
+
+		/// <summary> Read a string written by BlobWriter::Write(const string&). </summary>
+		inline string ReadString() {
+			const size_t size = Read<uint32_t>();
+			Require(size);
+			string text(data.data() + offset, size);
+			offset += size;
+			return text;
+		}
+
+		/// <summary> Throw if any bytes haven't been read. </summary>
+		inline void Finish() const {
+			if (offset != data.size())
+				throw MalformedDatabase("A stored result has trailing data");
+		}
+	};
+
+	void Connection::OpenConnection(const string& path) {
+		const int result = sqlite3_open_v2(
+			path.c_str(), &conn,
+			SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
+			nullptr
+		);
+
+		if (result != SQLITE_OK) {
+			const string message = conn ? sqlite3_errmsg(conn) : sqlite3_errstr(result);
+			Close();
+			throw MalformedDatabase(message);
+		}
+
+		// Wait on locks held by other connections instead of failing immediately
+		sqlite3_busy_timeout(conn, 5000);
+	}
+
+	Connection::Connection(const string& path) {
+		OpenConnection(path);
+
+		// Write-ahead logging lets readers continue while results are being written, and only
+		// requires the log to be synced at checkpoints instead of on every commit
+		try {
+			Execute("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;");
+		}
+		catch (...) {
+			Close();
+			throw;
+		}
+	}
+
+	void Connection::Execute(const string& sql) {
+		char* error = nullptr;
+		const int result = sqlite3_exec(conn, sql.c_str(), nullptr, nullptr, &error);
+		sqlite3_free(error);
+
+		if (result != SQLITE_OK)
+			ThrowSQLiteError(conn, result);
+	}
+
+	Statement Connection::Prepare(const string& sql) {
+		sqlite3_stmt* stmt = nullptr;
+		const int result = sqlite3_prepare_v3(
+			conn, sql.c_str(), static_cast<int>(sql.size() + 1),
+			SQLITE_PREPARE_PERSISTENT, &stmt, nullptr
+		);
+
+		if (result != SQLITE_OK)
+			ThrowSQLiteError(conn, result);
+
+		return Statement(conn, stmt);
+	}
+
+	void Connection::Close() {
+		if (conn) {
+			sqlite3_close_v2(conn);
+			conn = nullptr;
+		}
+	}
+
+	Connection::~Connection() { Close(); }
+
+	Statement::Statement(sqlite3* conn, sqlite3_stmt* stmt) : conn(conn), stmt(stmt) {}
+
+	Statement::Statement(Statement&& other) noexcept : conn(other.conn), stmt(other.stmt) {
+		other.conn = nullptr;
+		other.stmt = nullptr;
+	}
+
+	void Statement::Bind(int index, const string& text) {
+		const int result = sqlite3_bind_text(stmt, index, text.c_str(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+		if (result != SQLITE_OK)
+			ThrowSQLiteError(conn, result);
+	}
+
+	void Statement::Bind(int index, int64_t value) {
+		const int result = sqlite3_bind_int64(stmt, index, value);
+		if (result != SQLITE_OK)
+			ThrowSQLiteError(conn, result);
+	}
+
+	void Statement::BindBlob(int index, const void* data, size_t size) {
+		// Report blobs sqlite can't store here instead of as a generic error from sqlite
+		const int max_size = sqlite3_limit(conn, SQLITE_LIMIT_LENGTH, -1);
+		if (size > static_cast<size_t>(max_size))
+			throw std::length_error(
+				"A result of " + std::to_string(size) + " bytes is larger than the limit of "
+				+ std::to_string(max_size) + " bytes sqlite can store in one blob"
+			);
+
+		// sqlite treats a null pointer as NULL instead of an empty blob
+		const int result = (size > 0)
+			? sqlite3_bind_blob(stmt, index, data, static_cast<int>(size), SQLITE_TRANSIENT)
+			: sqlite3_bind_zeroblob(stmt, index, 0);
+
+		if (result != SQLITE_OK)
+			ThrowSQLiteError(conn, result);
+	}
+
+	bool Statement::Step() {
+		const int result = sqlite3_step(stmt);
+		if (result == SQLITE_ROW)
+			return true;
+		else if (result == SQLITE_DONE)
+			return false;
+
+		// Reset so the statement can be used again after the error
+		sqlite3_reset(stmt);
+		ThrowSQLiteError(conn, result);
+	}
+
+	void Statement::Reset() {
+		sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+	}
+
+	int64_t Statement::ColumnInt(int index) const { return sqlite3_column_int64(stmt, index); }
+
+	string Statement::ColumnText(int index) const {
+		const unsigned char* text = sqlite3_column_text(stmt, index);
+		const int size = sqlite3_column_bytes(stmt, index);
+		return text ? string(reinterpret_cast<const char*>(text), size) : string();
+	}
+
+	vector<char> Statement::ColumnBlob(int index) const {
+		const char* blob = static_cast<const char*>(sqlite3_column_blob(stmt, index));
+		const int size = sqlite3_column_bytes(stmt, index);
+		return blob ? vector<char>(blob, blob + size) : vector<char>();
+	}
+
+	Statement::~Statement() {
+		if (stmt)
+			sqlite3_finalize(stmt);
+	}
+
+	Transaction::Transaction(Connection& connection, bool write) : connection(&connection) {
+		// Take the write lock immediately so a busy database is reported here and not
+		// halfway through the writes. Reads only need a deferred transaction.
+		connection.Execute(write ? "BEGIN IMMEDIATE" : "BEGIN");
+	}
+
+	Transaction::Transaction(Transaction&& other) noexcept : connection(other.connection), finished(other.finished) {
+		other.finished = true;
+	}
+
+	void Transaction::Commit() {
+		if (!finished) {
+			connection->Execute("COMMIT");
+			finished = true;
+		}
+	}
+
+	Transaction::~Transaction() {
+		if (!finished)
+			sqlite3_exec(connection->conn, "ROLLBACK", nullptr, nullptr, nullptr);
+	}
+
+	string HashFile(const string& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.good())
+			throw HF::Exceptions::FileNotFound();
+
+		// 64-bit FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+		uint64_t size = 0;
+		vector<char> buffer(1 << 16);
+		while (file) {
+			file.read(buffer.data(), buffer.size());
+			const std::streamsize read = file.gcount();
+			for (std::streamsize i = 0; i < read; i++) {
+				hash ^= static_cast<unsigned char>(buffer[i]);
+				hash *= 1099511628211ULL;
+			}
+			size += static_cast<uint64_t>(read);
+		}
+
+		std::ostringstream out;
+		out << std::hex << std::setfill('0') << std::setw(16) << hash << "-" << size;
+		return out.str();
+	}
+
+	/// <summary> Create the results table if it doesn't exist yet. </summary>
+	Connection& CreateTables(Connection& connection) {
+		connection.Execute(
+			"CREATE TABLE IF NOT EXISTS results("
+				"model_hash TEXT NOT NULL, "
+				"parameters TEXT NOT NULL, "
+				"kind TEXT NOT NULL, "
+				"name TEXT NOT NULL, "
+				"data BLOB NOT NULL, "
+				"PRIMARY KEY(model_hash, parameters, kind, name)"
+			") WITHOUT ROWID;"
+		);
+		return connection;
+	}
+
+	ResultStore::ResultStore(const string& path) :
+		connection(path),
+		insert(CreateTables(connection).Prepare(
+			"INSERT OR REPLACE INTO results(model_hash, parameters, kind, name, data) VALUES(?1, ?2, ?3, ?4, ?5)"
+		)),
+		select(connection.Prepare(
+			"SELECT data FROM results WHERE model_hash = ?1 AND parameters = ?2 AND kind = ?3 AND name = ?4"
+		)),
+		erase_kind(connection.Prepare(
+			"DELETE FROM results WHERE model_hash = ?1 AND parameters = ?2 AND kind = ?3"
+		))
+	{}
+
+	void ResultStore::Put(const ResultKey& key, const string& kind, const string& name, const vector<char>& data) {
+		insert.Bind(1, key.model_hash);
+		insert.Bind(2, key.parameters);
+		insert.Bind(3, kind);
+		insert.Bind(4, name);
+		insert.BindBlob(5, data.data(), data.size());
+		insert.Step();
+		insert.Reset();
+	}
+
+	bool ResultStore::Get(const ResultKey& key, const string& kind, const string& name, vector<char>& out_data) {
+		select.Bind(1, key.model_hash);
+		select.Bind(2, key.parameters);
+		select.Bind(3, kind);
+		select.Bind(4, name);
+
+		const bool found = select.Step();
+		if (found)
+			out_data = select.ColumnBlob(0);
+
+		select.Reset();
+		return found;
+	}
+
+	void ResultStore::EraseKind(const ResultKey& key, const string& kind) {
+		erase_kind.Bind(1, key.model_hash);
+		erase_kind.Bind(2, key.parameters);
+		erase_kind.Bind(3, kind);
+		erase_kind.Step();
+		erase_kind.Reset();
+	}
+
+	Transaction ResultStore::BeginBatch() { return Transaction(connection); }
+
+	/*!
+		\brief Start a transaction unless a batch is already in progress.
+
+		\param connection Connection to start the transaction on.
+		\param write Whether the transaction will write. \see Transaction
+
+		\returns A transaction to commit, or nullptr if the writes belong to the current batch.
+	*/
+	std::unique_ptr<Transaction> BeginIfNeeded(Connection& connection, bool write = true) {
+		if (sqlite3_get_autocommit(connection.conn))
+			return std::make_unique<Transaction>(connection, write);
+		else
+			return nullptr;
+	}
+
+	void ResultStore::StoreGraph(const ResultKey& key, Graph& graph) {
+		const CSRPtrs csr = graph.GetCSRPointers();
+		const vector<Node> nodes = graph.Nodes();
+		const int nnz = csr.nnz;
+		const int num_nodes = static_cast<int>(nodes.size());
+
+		auto transaction = BeginIfNeeded(connection);
+
+		// Remove everything from the last graph so costs and attributes it had that this
+		// graph doesn't aren't loaded with it
+		EraseKind(key, graph_nodes_kind);
+		EraseKind(key, graph_csr_kind);
+		EraseKind(key, graph_cost_kind);
+		EraseKind(key, graph_attr_kind);
+
+		BlobWriter node_blob;
+		node_blob.Write<int32_t>(num_nodes);
+		for (const Node& node : nodes) {
+			node_blob.Write(node.x);
+			node_blob.Write(node.y);
+			node_blob.Write(node.z);
+			node_blob.Write<int16_t>(node.type);
+		}
+		Put(key, graph_nodes_kind, "", node_blob.data);
+
+		// The CSR may have fewer rows than there are nodes if the last nodes have no edges
+		BlobWriter csr_blob;
+		csr_blob.Write<int32_t>(csr.rows);
+		csr_blob.Write<int32_t>(nnz);
+		csr_blob.Write(csr.outer_indices, csr.rows + 1);
+		csr_blob.Write(csr.inner_indices, nnz);
+		csr_blob.Write(csr.data, nnz);
+		Put(key, graph_csr_kind, graph.GetDefaultCostName(), csr_blob.data);
+
+		// Alternate costs share the default cost's inner indices, so only their values are stored
+		for (const string& cost_type : graph.GetCostTypes()) {
+			const CSRPtrs cost_csr = graph.GetCSRPointers(cost_type);
+			BlobWriter cost_blob;
+			cost_blob.Write<int32_t>(nnz);
+			cost_blob.Write(cost_csr.data, nnz);
+			Put(key, graph_cost_kind, cost_type, cost_blob.data);
+		}
+
+		for (const string& attribute : graph.GetNodeAttributeTypes()) {
+			const vector<string> scores = graph.GetNodeAttributes(attribute);
+			BlobWriter attr_blob;
+			attr_blob.Write<int32_t>(static_cast<int32_t>(scores.size()));
+			for (const string& score : scores)
+				attr_blob.Write(score);
+			Put(key, graph_attr_kind, attribute, attr_blob.data);
+		}
+
+		if (transaction)
+			transaction->Commit();
+	}
+
+	/// <summary> Read every row of kind stored under key as (name, data) pairs. </summary>
+	vector<std::pair<string, vector<char>>> ReadAllOfKind(Connection& connection, const ResultKey& key, const string& kind) {
+		Statement query = connection.Prepare(
+			"SELECT name, data FROM results WHERE model_hash = ?1 AND parameters = ?2 AND kind = ?3"
+		);
+		query.Bind(1, key.model_hash);
+		query.Bind(2, key.parameters);
+		query.Bind(3, kind);
+
+		vector<std::pair<string, vector<char>>> rows;
+		while (query.Step())
+			rows.emplace_back(query.ColumnText(0), query.ColumnBlob(1));
+
+		return rows;
+	}
+
+	bool ResultStore::LoadGraph(const ResultKey& key, Graph& out_graph) {
+		// Read everything in one transaction so the graph can't be replaced partway through
+		auto transaction = BeginIfNeeded(connection, false);
+
+		vector<char> node_data;
+		if (!Get(key, graph_nodes_kind, "", node_data))
+			return false;
+
+		vector<std::pair<string, vector<char>>> csr_rows = ReadAllOfKind(connection, key, graph_csr_kind);
+		if (csr_rows.size() != 1)
+			throw MalformedDatabase("A stored graph is missing its edges");
+
+		// Read nodes
+		BlobReader node_reader(node_data);
+		const int num_nodes = node_reader.Read<int32_t>();
+		if (num_nodes < 0)
+			throw MalformedDatabase("A stored graph has a negative number of nodes");
+
+		vector<Node> nodes;
+		nodes.reserve(num_nodes);
+		for (int i = 0; i < num_nodes; i++) {
+			const float x = node_reader.Read<float>();
+			const float y = node_reader.Read<float>();
+			const float z = node_reader.Read<float>();
+			Node node(x, y, z, i);
+			node.type = node_reader.Read<int16_t>();
+			nodes.push_back(node);
+		}
+		node_reader.Finish();
+
+		// Read the CSR of the default cost
+		BlobReader csr_reader(csr_rows[0].second);
+		const int rows = csr_reader.Read<int32_t>();
+		const int nnz = csr_reader.Read<int32_t>();
+		if (rows < 0 || rows > num_nodes || nnz < 0)
+			throw MalformedDatabase("A stored graph has an invalid size");
+
+		vector<int> outer_indices, inner_indices;
+		vector<float> values;
+		csr_reader.Read(outer_indices, static_cast<size_t>(rows) + 1);
+		csr_reader.Read(inner_indices, nnz);
+		csr_reader.Read(values, nnz);
+		csr_reader.Finish();
+
+		if (outer_indices.front() != 0 || outer_indices.back() != nnz)
+			throw MalformedDatabase("A stored graph has invalid edges");
+		for (int i = 0; i < rows; i++)
+			if (outer_indices[i] > outer_indices[i + 1])
+				throw MalformedDatabase("A stored graph has invalid edges");
+		for (int child : inner_indices)
+			if (child < 0 || child >= num_nodes)
+				throw MalformedDatabase("A stored graph has an edge to a node that doesn't exist");
+
+		// Pad the outer indices so every node has a row
+		outer_indices.resize(static_cast<size_t>(num_nodes) + 1, nnz);
+
+		Graph graph(outer_indices, inner_indices, values, nodes, csr_rows[0].first);
+
+		// Read alternate costs. Edges that have no cost in the set are NaN.
+		for (auto& cost_row : ReadAllOfKind(connection, key, graph_cost_kind)) {
+			BlobReader cost_reader(cost_row.second);
+			if (cost_reader.Read<int32_t>() != nnz)
+				throw MalformedDatabase("A stored cost set doesn't match its graph");
+
+			vector<float> costs;
+			cost_reader.Read(costs, nnz);
+			cost_reader.Finish();
+
+			vector<EdgeSet> edge_sets;
+			for (int parent = 0; parent < num_nodes; parent++) {
+				EdgeSet edge_set;
+				edge_set.parent = parent;
+				for (int k = outer_indices[parent]; k < outer_indices[parent + 1]; k++)
+					if (!std::isnan(costs[k]))
+						edge_set.children.push_back(IntEdge{ inner_indices[k], costs[k] });
+
+				if (!edge_set.children.empty())
+					edge_sets.push_back(std::move(edge_set));
+			}
+			graph.AddEdges(edge_sets, cost_row.first);
+		}
+
+		// Read node attributes. Nodes without a value for an attribute are empty strings.
+		for (auto& attr_row : ReadAllOfKind(connection, key, graph_attr_kind)) {
+			BlobReader attr_reader(attr_row.second);
+			const int num_scores = attr_reader.Read<int32_t>();
+			if (num_scores != num_nodes)
+				throw MalformedDatabase("A stored node attribute doesn't match its graph");
+
+			vector<int> ids;
+			vector<string> scores;
+			for (int i = 0; i < num_scores; i++) {
+				string score = attr_reader.ReadString();
+				if (!score.empty()) {
+					ids.push_back(i);
+					scores.push_back(std::move(score));
+				}
+			}
+			attr_reader.Finish();
+
+			if (!ids.empty())
+				graph.AddNodeAttributes(ids, attr_row.first, scores);
+		}
+
+		if (transaction)
+			transaction->Commit();
+		out_graph = std::move(graph);
+		return true;
+	}
+
+	void ResultStore::StoreScores(const ResultKey& key, const string& name, const vector<float>& scores) {
+		BlobWriter blob;
+		blob.Write<int32_t>(static_cast<int32_t>(scores.size()));
+		blob.Write(scores.data(), scores.size());
+
+		auto transaction = BeginIfNeeded(connection);
+		Put(key, scores_kind, name, blob.data);
+		if (transaction)
+			transaction->Commit();
+	}
+
+	bool ResultStore::LoadScores(const ResultKey& key, const string& name, vector<float>& out_scores) {
+		vector<char> data;
+		if (!Get(key, scores_kind, name, data))
+			return false;
+
+		BlobReader reader(data);
+		const int num_scores = reader.Read<int32_t>();
+		if (num_scores < 0)
+			throw MalformedDatabase("A stored set of scores has a negative size");
+
+		reader.Read(out_scores, num_scores);
+		reader.Finish();
+		return true;
+	}
+
+	void ResultStore::StorePaths(const ResultKey& key, const string& name, const vector<Path>& paths) {
+		// Layout: number of paths, the size of every path, then the members of every path
+		BlobWriter blob;
+		blob.Write<int32_t>(static_cast<int32_t>(paths.size()));
+		for (const Path& path : paths)
+			blob.Write<int32_t>(static_cast<int32_t>(path.members.size()));
+		for (const Path& path : paths)
+			blob.Write(path.members.data(), path.members.size());
+
+		auto transaction = BeginIfNeeded(connection);
+		Put(key, paths_kind, name, blob.data);
+		if (transaction)
+			transaction->Commit();
+	}
+
+	bool ResultStore::LoadPaths(const ResultKey& key, const string& name, vector<Path>& out_paths) {
+		vector<char> data;
+		if (!Get(key, paths_kind, name, data))
+			return false;
+
+		BlobReader reader(data);
+		const int num_paths = reader.Read<int32_t>();
+		if (num_paths < 0)
+			throw MalformedDatabase("A stored batch of paths has a negative size");
+
+		vector<int32_t> sizes;
+		reader.Read(sizes, num_paths);
+
+		vector<Path> paths(num_paths);
+		for (int i = 0; i < num_paths; i++) {
+			if (sizes[i] < 0)
+				throw MalformedDatabase("A stored path has a negative size");
+			reader.Read(paths[i].members, sizes[i]);
+		}
+		reader.Finish();
+
+		out_paths = std::move(paths);
+		return true;
+	}
+
+	void ResultStore::Erase(const ResultKey& key) {
+		Statement erase = connection.Prepare("DELETE FROM results WHERE model_hash = ?1 AND parameters = ?2");
+		erase.Bind(1, key.model_hash);
+		erase.Bind(2, key.parameters);
+
+		auto transaction = BeginIfNeeded(connection);
+		erase.Step();
+		if (transaction)
+			transaction->Commit();
+	}
+}
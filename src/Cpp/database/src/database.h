@@ -1,7 +1,339 @@
+///
+///	\file		database.h
+/// \brief		Contains definitions for the <see cref="HF::DB::ResultStore">ResultStore</see> and its sqlite wrappers
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
 #pragma once
-#define _USE_MATH_DEFINES
-#include <Node.h>
-#include <Edge.h>
-#include <Graph.h>
-#include <set>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace HF::SpatialStructures {
+	class Graph;
+	struct Path;
+}
+
+/*!
+	\brief Persistent storage for the results of analysis.
+
+	\details
+	Graphs, cost sets, node attributes, scores from view analysis and batches of paths can all take a
+	long time to compute. The ResultStore saves them in a local sqlite database, keyed by the model
+	they were computed on and the parameters they were computed with, so a job that's run again can
+	read its results back instead of recomputing them.
+*/
+namespace HF::DB {
+
+	class Statement;
+
+	/*!
+		\brief A wrapper for a sqlite database. Automatically closes upon being destroyed.
+
+		\details
+		Connections are opened in write-ahead logging mode, so readers never block the writer,
+		and wait for up to 5 seconds when another connection holds a lock on the database.
+	*/
+	class Connection {
+		/*!
+			\brief Open a connection to the database at path, creating it if it doesn't exist.
+
+			\exception HF::Exceptions::MalformedDatabase The database couldn't be opened.
+		*/
+		void OpenConnection(const std::string& path);
+
+	public:
+		sqlite3* conn = nullptr; ///< Current connection to the database
+
+		/*!
+			\brief Create a new database connection.
+
+			\param path Path to the database. If no file exists at path, a new database is created.
+
+			\exception HF::Exceptions::MalformedDatabase The database couldn't be opened.
+		*/
+		Connection(const std::string& path);
+
+		Connection(const Connection&) = delete;
+		Connection& operator=(const Connection&) = delete;
+
+		/*!
+			\brief Execute one or more SQL statements that don't return any rows.
+
+			\exception HF::Exceptions::DatabaseBusy The database is locked by another connection.
+			\exception HF::Exceptions::MalformedDatabase The statement failed for any other reason.
+		*/
+		void Execute(const std::string& sql);
+
+		/*!
+			\brief Compile a single SQL statement so it can be bound and run many times.
+
+			\exception HF::Exceptions::MalformedDatabase sql isn't a valid statement.
+		*/
+		Statement Prepare(const std::string& sql);
+
+		/*! \brief Close the existing connection. */
+		void Close();
+
+		/*! \brief Close the existing connection for the database. */
+		~Connection();
+	};
+
+	/*!
+		\brief A compiled SQL statement. Automatically finalized upon being destroyed.
+
+		\details Parameters are numbered from 1 and columns from 0, the same as sqlite.
+	*/
+	class Statement {
+		sqlite3* conn = nullptr;			///< Connection this statement was prepared on.
+		sqlite3_stmt* stmt = nullptr;		///< The compiled statement.
+
+	public:
+		/*! \brief Take ownership of a statement prepared on conn. */
+		Statement(sqlite3* conn, sqlite3_stmt* stmt);
+
+		Statement(Statement&& other) noexcept;
+		Statement(const Statement&) = delete;
+		Statement& operator=(const Statement&) = delete;
+
+		/*! \brief Bind text to the parameter at index. The text is copied. */
+		void Bind(int index, const std::string& text);
+
+		/*! \brief Bind an integer to the parameter at index. */
+		void Bind(int index, int64_t value);
+
+		/*!
+			\brief Bind an array of bytes to the parameter at index. The array is copied.
+
+			\exception std::length_error size is larger than the longest blob sqlite allows,
+			which is about 1 GB by default.
+		*/
+		void BindBlob(int index, const void* data, size_t size);
+
+		/*!
+			\brief Run the statement until it produces a row or finishes.
+
+			\returns True if a row is ready to be read, false if the statement has finished.
+
+			\exception HF::Exceptions::DatabaseBusy The database is locked by another connection.
+			\exception HF::Exceptions::MalformedDatabase The statement failed for any other reason.
+		*/
+		bool Step();
+
+		/*! \brief Reset the statement so it can be run again, and clear all of its bindings. */
+		void Reset();
+
+		/*! \brief Get the integer in column index of the current row. */
+		int64_t ColumnInt(int index) const;
+
+		/*! \brief Get the text in column index of the current row. */
+		std::string ColumnText(int index) const;
+
+		/*! \brief Copy the bytes in column index of the current row. */
+		std::vector<char> ColumnBlob(int index) const;
+
+		/*! \brief Finalize the statement. */
+		~Statement();
+	};
+
+	/*!
+		\brief A transaction that's rolled back unless it's committed before being destroyed.
+
+		\details
+		Writes inside of a transaction are made in memory and written to disk all at once when it's
+		committed, which is much faster than committing each write individually. Transactions can't
+		be nested on the same connection.
+	*/
+	class Transaction {
+		Connection* connection;		///< Connection the transaction was started on.
+		bool finished = false;		///< Whether the transaction has been committed or rolled back.
+
+	public:
+		/*!
+			\brief Begin a transaction on connection.
+
+			\param connection Connection to begin the transaction on.
+			\param write If true, take the write lock immediately. If false, the transaction only
+			takes a lock when it first reads or writes, so read-only transactions don't block
+			each other or, in WAL mode, writers.
+
+			\exception HF::Exceptions::DatabaseBusy write is true and another connection is writing
+			to the database.
+		*/
+		Transaction(Connection& connection, bool write = true);
+
+		Transaction(Transaction&& other) noexcept;
+		Transaction(const Transaction&) = delete;
+		Transaction& operator=(const Transaction&) = delete;
+
+		/*! \brief Commit every change made since the transaction began. */
+		void Commit();
+
+		/*! \brief Roll back the transaction if it wasn't committed. */
+		~Transaction();
+	};
+
+	/*!
+		\brief Identifies the results of one job.
+
+		\details
+		Results are only reused if both the model and the parameters of a job match the key they were
+		stored under. The parameters can be any string that uniquely describes the settings of the job,
+		such as `"spacing=1,1,1;max_nodes=5000;up_step=0.2"`.
+	*/
+	struct ResultKey {
+		std::string model_hash;		///< Hash of the model the results were computed on. \see HashFile
+		std::string parameters;		///< Every parameter the results were computed with.
+	};
+
+	/*!
+		\brief Hash the contents of a file.
+
+		\param path Path to the file to hash.
+
+		\returns A 64-bit FNV-1a hash of the file and its size, as a string of hex digits.
+
+		\exception HF::Exceptions::FileNotFound No file exists at path.
+
+		\details Use this to create the model_hash of a ResultKey from the model file a job loads.
+	*/
+	std::string HashFile(const std::string& path);
+
+	/*!
+		\brief Stores the results of analysis in a sqlite database.
+
+		\details
+		Every result is stored under a ResultKey, a kind, and a name, and storing a result again
+		replaces the existing one. Results are serialized into compact binary blobs and written
+		with prepared statements. Each Store function writes all of its rows in a single transaction,
+		and BeginBatch can be used to group many calls into one transaction.
+
+		\remarks
+		Blobs are written in the byte order of the machine, so a database can only be read on
+		machines with the same byte order as the one that wrote it.
+
+		\code
+			// be sure to #include "database.h"
+
+			HF::DB::ResultStore store("results.db");
+			HF::DB::ResultKey key{ HF::DB::HashFile("plane.obj"), "spacing=1,1,1;max_nodes=5000" };
+
+			// Only generate the graph if it hasn't been generated before
+			HF::SpatialStructures::Graph graph;
+			if (!store.LoadGraph(key, graph)) {
+				graph = GenerateGraph();
+				store.StoreGraph(key, graph);
+			}
+		\endcode
+	*/
+	class ResultStore {
+		Connection connection;	///< Connection to the database.
+		Statement insert;		///< Inserts or replaces a single result.
+		Statement select;		///< Reads a single result.
+		Statement erase_kind;	///< Removes every result of a kind with a key.
+
+		/*! \brief Insert or replace a result. */
+		void Put(const ResultKey& key, const std::string& kind, const std::string& name, const std::vector<char>& data);
+
+		/*! \brief Read a result. Returns false if it doesn't exist. */
+		bool Get(const ResultKey& key, const std::string& kind, const std::string& name, std::vector<char>& out_data);
+
+		/*! \brief Remove every result of kind that was stored under key. */
+		void EraseKind(const ResultKey& key, const std::string& kind);
+
+	public:
+		/*!
+			\brief Open or create a result store.
+
+			\param path Path to the database file. If it doesn't exist, it's created.
+
+			\exception HF::Exceptions::MalformedDatabase The file exists, but isn't a sqlite database.
+		*/
+		ResultStore(const std::string& path);
+
+		/*!
+			\brief Begin a transaction that groups the writes of many calls.
+
+			\returns A transaction that must be committed for the writes to be kept.
+
+			\code
+				// be sure to #include "database.h"
+
+				auto batch = store.BeginBatch();
+				for (const auto& name : names)
+					store.StoreScores(key, name, scores[name]);
+				batch.Commit();
+			\endcode
+		*/
+		Transaction BeginBatch();
+
+		/*!
+			\brief Store a graph along with every cost type and node attribute it contains.
+
+			\param key Key to store the graph under.
+			\param graph Graph to store. It is compressed if it isn't already.
+
+			\details
+			Nodes, the CSR of the default cost type, every other cost type and every node attribute are
+			each stored as one row. Any graph previously stored under key is replaced.
+
+			\exception std::length_error One of the rows is larger than the longest blob sqlite allows.
+		*/
+		void StoreGraph(const ResultKey& key, HF::SpatialStructures::Graph& graph);
+
+		/*!
+			\brief Load a graph that was stored with StoreGraph.
+
+			\param key Key the graph was stored under.
+			\param out_graph Set to the stored graph, with all of its cost types and node attributes.
+
+			\returns True if a graph was stored under key, false otherwise.
+
+			\exception HF::Exceptions::MalformedDatabase The stored graph couldn't be read.
+		*/
+		bool LoadGraph(const ResultKey& key, HF::SpatialStructures::Graph& out_graph);
+
+		/*!
+			\brief Store an array of scores, such as the aggregated results of view analysis.
+
+			\param key Key to store the scores under.
+			\param name Name of this set of scores. Names only have to be unique for each key.
+			\param scores The scores to store.
+		*/
+		void StoreScores(const ResultKey& key, const std::string& name, const std::vector<float>& scores);
+
+		/*!
+			\brief Load an array of scores that was stored with StoreScores.
+
+			\returns True if scores were stored under key and name, false otherwise.
+
+			\exception HF::Exceptions::MalformedDatabase The stored scores couldn't be read.
+		*/
+		bool LoadScores(const ResultKey& key, const std::string& name, std::vector<float>& out_scores);
+
+		/*!
+			\brief Store a batch of paths, such as the result of a call to FindPaths.
+
+			\param key Key to store the paths under.
+			\param name Name of this batch of paths. Names only have to be unique for each key.
+			\param paths The paths to store. Empty paths are stored as empty paths.
+		*/
+		void StorePaths(const ResultKey& key, const std::string& name, const std::vector<HF::SpatialStructures::Path>& paths);
+
+		/*!
+			\brief Load a batch of paths that was stored with StorePaths.
+
+			\returns True if paths were stored under key and name, false otherwise.
+
+			\exception HF::Exceptions::MalformedDatabase The stored paths couldn't be read.
+		*/
+		bool LoadPaths(const ResultKey& key, const std::string& name, std::vector<HF::SpatialStructures::Path>& out_paths);
 
+		/*! \brief Remove every result stored under key. */
+		void Erase(const ResultKey& key);
+	};
+}
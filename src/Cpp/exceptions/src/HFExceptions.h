@@ -49,6 +49,8 @@ namespace HF::Exceptions{
 		NO_PATH = -11,			///< There is no path between the start and end points.
 		NO_COST = -12,			///< There is no cost with the given name in the given graph
 		NOT_COMPRESSED = -13,	///< Graph wasn't compressed!
+		CANCELLED = -14,		///< The operation was cancelled before it finished.
+		IN_PROGRESS = -15,		///< The operation hasn't finished yet.
 	};
 
 	/*! \brief Thrown when desired file is not found */
@@ -85,6 +87,27 @@ namespace HF::Exceptions{
 		NotImplemented() : std::logic_error("Function not yet implemented") { };
 	};
 
+	/*! \brief The database couldn't be opened, or contains data that couldn't be read. */
+	class MalformedDatabase : public std::runtime_error
+	{
+	public:
+		MalformedDatabase(const std::string& message) : std::runtime_error(message) { };
+	};
+
+	/*! \brief The database is locked by another connection. */
+	class DatabaseBusy : public std::runtime_error
+	{
+	public:
+		DatabaseBusy(const std::string& message) : std::runtime_error(message) { };
+	};
+
+	/*! \brief An operation was cancelled through its CancellationToken before it finished. */
+	class OperationCancelled : public std::runtime_error
+	{
+	public:
+		OperationCancelled() : std::runtime_error("The operation was cancelled") { };
+	};
+
 	/*! \brief Thrown when a dependency is missing such as Embree. */
 	struct NoCost : public std::exception
 	{
@@ -0,0 +1,85 @@
+///
+///	\file		cancellation.h
+/// \brief		Contains definitions for the <see cref="HF::Exceptions::CancellationToken">CancellationToken</see> class
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <HFExceptions.h>
+
+namespace HF::Exceptions {
+
+	/*!
+		\brief Lets one thread cancel a long running operation, and watch its progress, while another
+		thread runs it.
+
+		\details
+		Operations that accept a token check IsCancelled() between units of work, such as the nodes of
+		a parallel loop, and call Advance() after finishing each one. Once cancelled, an operation skips
+		its remaining work, frees anything it allocated for its results, then throws OperationCancelled.
+		Cancellation is cooperative, so a unit of work that has already started is always finished.
+
+		Every member may be called from any thread at any time.
+
+		\remarks
+		Operations that accept a pointer to a token treat nullptr as a token that is never cancelled.
+
+		\code
+			// be sure to #include "cancellation.h"
+
+			HF::Exceptions::CancellationToken token;
+			std::thread worker([&] {
+				try { auto graph = HF::VisibilityGraph::AllToAll(ert, nodes, 1.7f, -1, 90, 90, &token); }
+				catch (HF::Exceptions::OperationCancelled) { }
+			});
+
+			// From another thread
+			std::cout << token.Progress() << std::endl;
+			token.Cancel();
+			worker.join();
+		\endcode
+	*/
+	class CancellationToken {
+		std::atomic<bool> cancelled{ false };	///< Set once Cancel() is called.
+		std::atomic<int64_t> completed{ 0 };	///< Units of work finished so far.
+		std::atomic<int64_t> total{ 0 };		///< Units of work the operation will perform.
+
+	public:
+		/*! \brief Ask the operation using this token to stop as soon as possible. */
+		inline void Cancel() { cancelled.store(true); }
+
+		/*! \brief Check if Cancel() has been called. */
+		inline bool IsCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+		/*! \brief Throw OperationCancelled if Cancel() has been called. */
+		inline void ThrowIfCancelled() const { if (cancelled.load()) throw OperationCancelled(); }
+
+		/*!
+			\brief Add to the amount of work the operation will perform.
+
+			\param units Number of units of work to add. Operations made of several stages add the
+			units for each stage before starting the first one, so progress never moves backwards.
+		*/
+		inline void AddWork(int64_t units) { total.fetch_add(units, std::memory_order_relaxed); }
+
+		/*! \brief Record that units of work have finished. */
+		inline void Advance(int64_t units = 1) { completed.fetch_add(units, std::memory_order_relaxed); }
+
+		/*!
+			\brief Get the fraction of the operation's work that has finished.
+
+			\returns A value between 0 and 1, or 0 if the operation hasn't reported its work yet.
+		*/
+		inline float Progress() const {
+			const int64_t work = total.load(std::memory_order_relaxed);
+			if (work <= 0) return 0.0f;
+
+			const int64_t done = completed.load(std::memory_order_relaxed);
+			return done >= work ? 1.0f : static_cast<float>(done) / static_cast<float>(work);
+		}
+	};
+}
@@ -0,0 +1,399 @@
+///
+///	\file		gltf_loader.cpp
+/// \brief		Contains implementation for loading binary glTF (.glb) files into <see cref="HF::Geometry::MeshInfo">MeshInfo</see>
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <gltf_loader.h>
+#include <mapped_file.h>
+#include <HFExceptions.h>
+#include <parallelism.h>
+#include <Geometry>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <utility>
+#include <json.hpp>
+#include <omp.h>
+
+using std::vector;
+using std::string;
+using nlohmann::json;
+
+namespace HF::Geometry {
+
+	/*! \brief Magic number at the start of every .glb file. Spells glTF. */
+	const uint32_t GLB_MAGIC = 0x46546C67;
+
+	/*! \brief Type of the JSON chunk in a .glb file. */
+	const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+
+	/*! \brief Type of the binary chunk in a .glb file. */
+	const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+
+	/*! \brief Deepest nesting of arrays and objects allowed in the JSON chunk. */
+	const int MAX_JSON_DEPTH = 64;
+
+	/*! \brief Get the member of object at key, or nullptr if object has no such member. */
+	inline const json* Find(const json& object, const char* key) {
+		if (!object.is_object()) return nullptr;
+		const auto member = object.find(key);
+		return member != object.end() ? &*member : nullptr;
+	}
+
+	/*! \brief Read an integer, throwing HF::Exceptions::InvalidOBJ if value isn't one. */
+	inline long long ToInt(const json& value) {
+		if (!value.is_number_integer() || (value.is_number_unsigned() && value.get<unsigned long long>() > LLONG_MAX))
+			throw HF::Exceptions::InvalidOBJ();
+		return value.get<long long>();
+	}
+
+	/*! \brief Read a number, throwing HF::Exceptions::InvalidOBJ if value isn't one. */
+	inline double ToNumber(const json& value) {
+		if (!value.is_number()) throw HF::Exceptions::InvalidOBJ();
+		return value.get<double>();
+	}
+
+	/*! \brief Get the integer member at key, or default_value if there is no such member. */
+	inline long long GetInt(const json& object, const char* key, long long default_value) {
+		const json* value = Find(object, key);
+		return value ? ToInt(*value) : default_value;
+	}
+
+	/*! \brief Get the string member at key, or an empty string if there is no such member. */
+	inline string GetString(const json& object, const char* key) {
+		const json* value = Find(object, key);
+		if (!value) return string();
+		if (!value->is_string()) throw HF::Exceptions::InvalidOBJ();
+		return value->get<string>();
+	}
+
+	/*! \brief Get the array member at key, or nullptr if there is no such member. */
+	inline const json* FindArray(const json& object, const char* key) {
+		const json* value = Find(object, key);
+		if (value && !value->is_array()) throw HF::Exceptions::InvalidOBJ();
+		return value;
+	}
+
+	/*! \brief Get item i of the array member at key, or nullptr if it doesn't exist. */
+	inline const json* GetItem(const json& object, const char* key, long long i) {
+		const json* array = FindArray(object, key);
+		if (!array || i < 0 || i >= static_cast<long long>(array->size()))
+			return nullptr;
+		return &(*array)[static_cast<size_t>(i)];
+	}
+
+	/*! \brief A validated view of a glTF accessor inside of the binary chunk. */
+	struct AccessorView {
+		const char* data = nullptr;		///< First element of the accessor.
+		int count = 0;					///< Number of elements in the accessor.
+		int stride = 0;					///< Distance between elements in bytes.
+		int component_type = 0;			///< glTF component type of every element.
+	};
+
+	/*! \brief Get the size of a glTF component type in bytes, or 0 if it isn't supported. */
+	inline int ComponentSize(long long component_type) {
+		switch (component_type) {
+		case 5121: return 1;	// UNSIGNED_BYTE
+		case 5123: return 2;	// UNSIGNED_SHORT
+		case 5125: return 4;	// UNSIGNED_INT
+		case 5126: return 4;	// FLOAT
+		default: return 0;
+		}
+	}
+
+	/*!
+		\brief Find an accessor and check that all of its elements are inside of the binary chunk.
+
+		\param gltf The glTF document.
+		\param index Index of the accessor.
+		\param bin Start of the binary chunk.
+		\param bin_size Size of the binary chunk in bytes.
+		\param num_components Number of components every element must have. 3 for VEC3, 1 for SCALAR.
+
+		\exception HF::Exceptions::InvalidOBJ The accessor doesn't exist, has the wrong type, is sparse,
+		or refers to data outside of the binary chunk.
+	*/
+	AccessorView GetAccessor(const json& gltf, long long index, const char* bin, size_t bin_size, int num_components)
+	{
+		const json* accessor = GetItem(gltf, "accessors", index);
+		if (!accessor || Find(*accessor, "sparse")) throw HF::Exceptions::InvalidOBJ();
+
+		const string expected_type = num_components == 3 ? "VEC3" : "SCALAR";
+		const long long component_type = GetInt(*accessor, "componentType", 0);
+		const int component_size = ComponentSize(component_type);
+		if (GetString(*accessor, "type") != expected_type || component_size == 0)
+			throw HF::Exceptions::InvalidOBJ();
+
+		// Only views into the binary chunk, which is always the first buffer, are supported
+		const json* view = GetItem(gltf, "bufferViews", GetInt(*accessor, "bufferView", -1));
+		if (!view || GetInt(*view, "buffer", -1) != 0) throw HF::Exceptions::InvalidOBJ();
+		const json* buffer = GetItem(gltf, "buffers", 0);
+		if (!buffer || Find(*buffer, "uri") || bin == nullptr) throw HF::Exceptions::InvalidOBJ();
+
+		const long long element_size = static_cast<long long>(component_size) * num_components;
+		const long long view_offset = GetInt(*view, "byteOffset", 0);
+		const long long view_length = GetInt(*view, "byteLength", -1);
+		const long long stride = GetInt(*view, "byteStride", element_size);
+		const long long offset = GetInt(*accessor, "byteOffset", 0);
+		const long long count = GetInt(*accessor, "count", -1);
+
+		// Compare against the space that's left so huge values can't overflow
+		const long long bin_length = static_cast<long long>(bin_size);
+		if (view_offset < 0 || view_length < 0 || view_offset > bin_length || view_length > bin_length - view_offset
+			|| stride < element_size || stride > INT_MAX || offset < 0 || offset > view_length
+			|| count < 0 || count > INT_MAX
+			|| (count > 0 && (view_length - offset < element_size
+				|| count - 1 > (view_length - offset - element_size) / stride)))
+			throw HF::Exceptions::InvalidOBJ();
+
+		AccessorView out;
+		out.data = bin + view_offset + offset;
+		out.count = static_cast<int>(count);
+		out.stride = static_cast<int>(stride);
+		out.component_type = static_cast<int>(component_type);
+		return out;
+	}
+
+	/*! \brief Read the index at i from an index accessor. */
+	inline uint32_t ReadIndex(const AccessorView& indices, int i) {
+		const char* data = indices.data + static_cast<size_t>(i) * indices.stride;
+		switch (indices.component_type) {
+		case 5121: return static_cast<uint8_t>(*data);
+		case 5123: { uint16_t value; std::memcpy(&value, data, sizeof(value)); return value; }
+		default: { uint32_t value; std::memcpy(&value, data, sizeof(value)); return value; }
+		}
+	}
+
+	/*! \brief The triangles of one primitive in a glTF mesh. */
+	struct PrimitiveView {
+		AccessorView positions;		///< Position of every vertex.
+		AccessorView indices;		///< Indices of every triangle. Has a count of 0 if the primitive isn't indexed.
+		bool indexed = false;		///< Whether the primitive has an index accessor.
+
+		/*! \brief Get the number of triangles in this primitive. */
+		int NumTriangles() const { return (indexed ? indices.count : positions.count) / 3; }
+	};
+
+	/*! \brief One copy of a glTF mesh placed in the scene by a node. */
+	struct MeshInstance {
+		long long mesh;					///< Index of the glTF mesh.
+		Eigen::Affine3d transform;		///< World transform of the node.
+		string name;					///< Name of the node, or the mesh if the node has no name.
+	};
+
+	/*! \brief Get the local transform of a glTF node from its matrix or its translation, rotation and scale. */
+	Eigen::Affine3d NodeTransform(const json& node) {
+		Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+
+		// Read a fixed size array of numbers from key if it exists
+		auto read_numbers = [&](const char* key, int size, double* out) {
+			const json* value = FindArray(node, key);
+			if (!value) return false;
+			if (value->size() != size) throw HF::Exceptions::InvalidOBJ();
+			for (int i = 0; i < size; i++)
+				out[i] = ToNumber((*value)[i]);
+			return true;
+		};
+
+		double matrix[16];
+		if (read_numbers("matrix", 16, matrix)) {
+			// glTF matrices are column major, the same as Eigen's default
+			transform.matrix() = Eigen::Map<Eigen::Matrix4d>(matrix);
+			return transform;
+		}
+
+		double translation[3], rotation[4], scale[3];
+		if (read_numbers("translation", 3, translation))
+			transform.translate(Eigen::Vector3d(translation[0], translation[1], translation[2]));
+		if (read_numbers("rotation", 4, rotation))
+			transform.rotate(Eigen::Quaterniond(rotation[3], rotation[0], rotation[1], rotation[2]).normalized());
+		if (read_numbers("scale", 3, scale))
+			transform.scale(Eigen::Vector3d(scale[0], scale[1], scale[2]));
+		return transform;
+	}
+
+	/*!
+		\brief Add an instance for node and every descendant of node that references a mesh.
+
+		\param gltf The glTF document.
+		\param node_index Index of the node to visit.
+		\param parent World transform of the node's parent.
+		\param depth Number of ancestors of this node. Used to reject cyclic hierarchies.
+		\param out_instances Instances are appended to this vector.
+	*/
+	void CollectInstances(
+		const json& gltf,
+		long long node_index,
+		const Eigen::Affine3d& parent,
+		int depth,
+		vector<MeshInstance>& out_instances
+	) {
+		const json* node = GetItem(gltf, "nodes", node_index);
+		if (!node || depth > static_cast<int>(gltf["nodes"].size())) throw HF::Exceptions::InvalidOBJ();
+
+		const Eigen::Affine3d transform = parent * NodeTransform(*node);
+
+		const long long mesh = GetInt(*node, "mesh", -1);
+		if (mesh >= 0) {
+			const json* gltf_mesh = GetItem(gltf, "meshes", mesh);
+			if (!gltf_mesh) throw HF::Exceptions::InvalidOBJ();
+
+			string name = GetString(*node, "name");
+			if (name.empty()) name = GetString(*gltf_mesh, "name");
+			out_instances.push_back(MeshInstance{ mesh, transform, name });
+		}
+
+		if (const json* children = FindArray(*node, "children"))
+			for (const auto& child : *children)
+				CollectInstances(gltf, ToInt(child), transform, depth + 1, out_instances);
+	}
+
+	vector<MeshInfo<float>> LoadGLB(const string& path, bool change_coords)
+	{
+		MappedFile file(path);
+		const char* data = file.Data();
+		const size_t size = file.Size();
+
+		// Read the header
+		uint32_t header[3];
+		if (size < sizeof(header)) throw HF::Exceptions::InvalidOBJ();
+		std::memcpy(header, data, sizeof(header));
+		if (header[0] != GLB_MAGIC || header[1] != 2 || header[2] > size) throw HF::Exceptions::InvalidOBJ();
+
+		// Find the JSON and binary chunks
+		const char* json_chunk = nullptr; size_t json_size = 0;
+		const char* bin = nullptr; size_t bin_size = 0;
+		for (size_t offset = sizeof(header); offset + 8 <= header[2];) {
+			uint32_t chunk[2];
+			std::memcpy(chunk, data + offset, sizeof(chunk));
+			offset += sizeof(chunk);
+			if (chunk[0] > header[2] - offset) throw HF::Exceptions::InvalidOBJ();
+
+			if (chunk[1] == GLB_CHUNK_JSON && json_chunk == nullptr) { json_chunk = data + offset; json_size = chunk[0]; }
+			else if (chunk[1] == GLB_CHUNK_BIN && bin == nullptr) { bin = data + offset; bin_size = chunk[0]; }
+			offset += chunk[0];
+		}
+		if (json_chunk == nullptr) throw HF::Exceptions::InvalidOBJ();
+
+		// Parse the JSON chunk, refusing documents nested deeply enough to exhaust the stack
+		const auto limit_depth = [](int depth, json::parse_event_t, json&) {
+			if (depth > MAX_JSON_DEPTH) throw HF::Exceptions::InvalidOBJ();
+			return true;
+		};
+		const json gltf = json::parse(json_chunk, json_chunk + json_size, limit_depth, false);
+		if (!gltf.is_object()) throw HF::Exceptions::InvalidOBJ();
+
+		// Place every mesh referenced by the default scene, or every mesh once if there are no scenes
+		vector<MeshInstance> instances;
+		const json* meshes = FindArray(gltf, "meshes");
+		const json* scene = GetItem(gltf, "scenes", GetInt(gltf, "scene", 0));
+		if (scene) {
+			if (const json* roots = FindArray(*scene, "nodes"))
+				for (const auto& root : *roots)
+					CollectInstances(gltf, ToInt(root), Eigen::Affine3d::Identity(), 0, instances);
+		}
+		else if (meshes) {
+			for (int i = 0; i < meshes->size(); i++)
+				instances.push_back(MeshInstance{ i, Eigen::Affine3d::Identity(), GetString((*meshes)[i], "name") });
+		}
+
+		// Validate the triangle primitives of every mesh before copying anything
+		const int num_gltf_meshes = meshes ? static_cast<int>(meshes->size()) : 0;
+		vector<vector<PrimitiveView>> primitives_by_mesh(num_gltf_meshes);
+		for (int m = 0; m < num_gltf_meshes; m++) {
+			const json* primitives = FindArray((*meshes)[m], "primitives");
+			if (!primitives) continue;
+
+			for (const auto& primitive : *primitives) {
+				// Only plain triangle lists are supported
+				const json* attributes = Find(primitive, "attributes");
+				if (GetInt(primitive, "mode", 4) != 4 || !attributes || !Find(*attributes, "POSITION")) continue;
+				if (const json* extensions = Find(primitive, "extensions"))
+					if (Find(*extensions, "KHR_draco_mesh_compression")) throw HF::Exceptions::InvalidOBJ();
+
+				PrimitiveView view;
+				view.positions = GetAccessor(gltf, GetInt(*attributes, "POSITION", -1), bin, bin_size, 3);
+				if (view.positions.component_type != 5126) throw HF::Exceptions::InvalidOBJ();
+
+				const long long indices = GetInt(primitive, "indices", -1);
+				if (indices >= 0) {
+					view.indexed = true;
+					view.indices = GetAccessor(gltf, indices, bin, bin_size, 1);
+					if (view.indices.component_type == 5126) throw HF::Exceptions::InvalidOBJ();
+				}
+				if (view.NumTriangles() > 0)
+					primitives_by_mesh[m].push_back(view);
+			}
+		}
+
+		// Count the vertices and triangles of every instance, dropping instances without any
+		vector<MeshInstance> kept_instances;
+		vector<int> vertex_counts, triangle_counts;
+		for (auto& instance : instances) {
+			long long num_vertices = 0, num_triangles = 0;
+			for (const auto& primitive : primitives_by_mesh[instance.mesh]) {
+				num_vertices += primitive.positions.count;
+				num_triangles += primitive.NumTriangles();
+			}
+			if (num_triangles == 0) continue;
+			if (num_vertices > INT_MAX || num_triangles > INT_MAX) throw HF::Exceptions::InvalidOBJ();
+
+			kept_instances.push_back(std::move(instance));
+			vertex_counts.push_back(static_cast<int>(num_vertices));
+			triangle_counts.push_back(static_cast<int>(num_triangles));
+		}
+		if (kept_instances.empty()) throw HF::Exceptions::InvalidOBJ();
+
+		// Allocate every mesh, then copy all of them out of the binary chunk in parallel
+		const int num_meshes = kept_instances.size();
+		vector<MeshInfo<float>> out_meshes;
+		out_meshes.reserve(num_meshes);
+		for (int i = 0; i < num_meshes; i++)
+			out_meshes.emplace_back(vertex_counts[i], triangle_counts[i], i, kept_instances[i].name);
+
+		vector<char> index_out_of_range(num_meshes, false);
+		HF::Parallel::ThreadLease lease(-1, num_meshes);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(lease.size())
+		for (int i = 0; i < num_meshes; i++) {
+			const auto& transform = kept_instances[i].transform;
+			float* vertices = out_meshes[i].GetVertexPointer().data;
+			int* indices = out_meshes[i].GetIndexPointer().data;
+
+			int vertex_offset = 0;
+			for (const auto& primitive : primitives_by_mesh[kept_instances[i].mesh]) {
+				// Transform every position into world space
+				const auto& positions = primitive.positions;
+				for (int v = 0; v < positions.count; v++) {
+					float position[3];
+					std::memcpy(position, positions.data + static_cast<size_t>(v) * positions.stride, sizeof(position));
+					const Eigen::Vector3d world = transform * Eigen::Vector3d(position[0], position[1], position[2]);
+
+					float* out = vertices + 3 * static_cast<size_t>(vertex_offset + v);
+					out[0] = static_cast<float>(world.x());
+					out[1] = static_cast<float>(world.y());
+					out[2] = static_cast<float>(world.z());
+				}
+
+				// Offset indices by the number of vertices of previous primitives
+				const int num_indices = 3 * primitive.NumTriangles();
+				for (int k = 0; k < num_indices; k++) {
+					const uint32_t index = primitive.indexed ? ReadIndex(primitive.indices, k) : static_cast<uint32_t>(k);
+					if (index >= static_cast<uint32_t>(positions.count)) index_out_of_range[i] = true;
+					*indices++ = vertex_offset + static_cast<int>(index);
+				}
+				vertex_offset += positions.count;
+			}
+		}
+
+		for (char invalid : index_out_of_range)
+			if (invalid) throw HF::Exceptions::InvalidOBJ();
+
+		if (change_coords)
+			for (auto& mesh : out_meshes)
+				mesh.ConvertToRhinoCoordinates();
+
+		return out_meshes;
+	}
+}
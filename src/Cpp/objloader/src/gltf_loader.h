@@ -0,0 +1,47 @@
+///
+///	\file		gltf_loader.h
+/// \brief		Contains definitions for loading binary glTF (.glb) files into <see cref="HF::Geometry::MeshInfo">MeshInfo</see>
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+#pragma once
+
+#include <string>
+#include <vector>
+#include <meshinfo.h>
+
+namespace HF::Geometry {
+
+	/// <summary> Load every mesh in a binary glTF 2.0 file. </summary>
+	/// <param name="path"> Path to the .glb file to load. </param>
+	/// <param name="change_coords"> Rotate the meshes from Y-up (glTF's convention) to Z-up. </param>
+	/// <returns> One mesh for every node in the default scene that references a mesh. </returns>
+	/*!
+		\exception HF::Exceptions::FileNotFound No file exists at path.
+		\exception HF::Exceptions::InvalidOBJ The file isn't a valid glTF 2.0 binary, references data
+		outside of its binary chunk, uses compressed or sparse geometry, or contains no triangles.
+
+		\details
+		The file is mapped into memory and only its JSON chunk is parsed. Vertex positions and indices
+		are then copied straight out of the binary chunk into the buffers of each mesh in parallel.
+
+		Every node of the default scene that references a mesh produces one MeshInfo, with the node's
+		world transform applied to its vertices. The mesh is named after the node, or after the glTF
+		mesh if the node has no name, and its ID is its index in the returned vector. All triangle
+		primitives of a glTF mesh are combined into one MeshInfo. Primitives that aren't triangle
+		lists are skipped. If the file has no scenes, every mesh is loaded once without a transform.
+
+		\remarks
+		Only the binary chunk of the .glb file can be used as a buffer. Files that reference
+		external .bin files or data URIs aren't supported.
+
+		\code
+			// be sure to #include "gltf_loader.h"
+
+			std::vector<HF::Geometry::MeshInfo<float>> meshes = HF::Geometry::LoadGLB("building.glb", true);
+			for (const auto& mesh : meshes)
+				std::cout << mesh.GetMeshID() << ": " << mesh.name << std::endl;
+		\endcode
+	*/
+	std::vector<MeshInfo<float>> LoadGLB(const std::string& path, bool change_coords = false);
+}
@@ -0,0 +1,133 @@
+///
+///	\file		mapped_file.cpp
+/// \brief		Contains implementation for the <see cref="HF::Geometry::MappedFile">MappedFile</see> class
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <mapped_file.h>
+#include <HFExceptions.h>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace HF::Geometry {
+
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::string& path, bool sequential) {
+		// Open the file
+		HANDLE file = CreateFileA(
+			path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | (sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS), NULL
+		);
+		if (file == INVALID_HANDLE_VALUE)
+			throw HF::Exceptions::FileNotFound();
+		file_handle = file;
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size)) {
+			Close();
+			throw std::runtime_error("Couldn't get the size of " + path);
+		}
+		length = static_cast<size_t>(file_size.QuadPart);
+
+		// Files with no contents can't be mapped
+		if (length == 0) return;
+
+		// Map the entire file
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping == NULL) {
+			Close();
+			throw std::runtime_error("Couldn't map " + path + " into memory");
+		}
+		mapping_handle = mapping;
+
+		data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr) {
+			Close();
+			throw std::runtime_error("Couldn't map " + path + " into memory");
+		}
+	}
+
+	void MappedFile::Close() {
+		if (data) UnmapViewOfFile(data);
+		if (mapping_handle) CloseHandle(static_cast<HANDLE>(mapping_handle));
+		if (file_handle) CloseHandle(static_cast<HANDLE>(file_handle));
+
+		data = nullptr;
+		mapping_handle = nullptr;
+		file_handle = nullptr;
+		length = 0;
+	}
+#else
+	MappedFile::MappedFile(const std::string& path, bool sequential) {
+		// Open the file
+		file_descriptor = open(path.c_str(), O_RDONLY);
+		if (file_descriptor < 0)
+			throw HF::Exceptions::FileNotFound();
+
+		struct stat file_info;
+		if (fstat(file_descriptor, &file_info) != 0) {
+			Close();
+			throw std::runtime_error("Couldn't get the size of " + path);
+		}
+		length = static_cast<size_t>(file_info.st_size);
+
+		// Files with no contents can't be mapped
+		if (length == 0) return;
+
+		// Map the entire file
+		void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+		if (mapping == MAP_FAILED) {
+			Close();
+			throw std::runtime_error("Couldn't map " + path + " into memory");
+		}
+		data = static_cast<const char*>(mapping);
+		madvise(mapping, length, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+	}
+
+	void MappedFile::Close() {
+		if (data) munmap(const_cast<char*>(data), length);
+		if (file_descriptor >= 0) close(file_descriptor);
+
+		data = nullptr;
+		file_descriptor = -1;
+		length = 0;
+	}
+#endif
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this == &other) return *this;
+
+		// Release our mapping, then take ownership of other's
+		Close();
+		std::swap(data, other.data);
+		std::swap(length, other.length);
+#ifdef _WIN32
+		std::swap(file_handle, other.file_handle);
+		std::swap(mapping_handle, other.mapping_handle);
+#else
+		std::swap(file_descriptor, other.file_descriptor);
+#endif
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		Close();
+	}
+}
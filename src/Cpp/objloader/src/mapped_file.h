@@ -0,0 +1,69 @@
+///
+///	\file		mapped_file.h
+/// \brief		Contains definitions for the <see cref="HF::Geometry::MappedFile">MappedFile</see> class
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace HF::Geometry {
+
+	/*!
+		\brief A read-only view of a file mapped into memory.
+
+		\details
+		Maps the entire file into the address space of the process so it can be read like an array,
+		letting the operating system page it in on demand instead of copying it into a buffer.
+		The mapping is released when this object is destroyed. Uses CreateFileMapping on Windows
+		and mmap everywhere else.
+
+		\remarks
+		Can be moved but not copied, since only one object may own a mapping.
+	*/
+	class MappedFile {
+		const char* data = nullptr;		///< Start of the mapped file.
+		size_t length = 0;				///< Size of the mapped file in bytes.
+
+#ifdef _WIN32
+		void* file_handle = nullptr;	///< Handle to the open file.
+		void* mapping_handle = nullptr;	///< Handle to the file mapping object.
+#else
+		int file_descriptor = -1;		///< Descriptor of the open file.
+#endif
+
+		/*! \brief Unmap the file and close all handles. */
+		void Close();
+
+	public:
+		/*!
+			\brief Map the file at path into memory.
+
+			\param path Path to the file to map.
+			\param sequential Whether the file will be read from start to end. If false, the
+			operating system is told to expect random access instead, so it doesn't read ahead.
+
+			\exception HF::Exceptions::FileNotFound The file at path doesn't exist or couldn't be opened.
+			\exception std::runtime_error The file exists but couldn't be mapped.
+
+			\remarks Empty files are valid, but have a null Data() pointer.
+		*/
+		MappedFile(const std::string& path, bool sequential = true);
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		/*! \brief Unmap the file. */
+		~MappedFile();
+
+		/*! \brief Get a pointer to the first byte of the file. */
+		inline const char* Data() const { return data; }
+
+		/*! \brief Get the size of the file in bytes. */
+		inline size_t Size() const { return length; }
+	};
+}
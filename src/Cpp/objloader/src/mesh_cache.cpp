@@ -0,0 +1,256 @@
+///
+///	\file		mesh_cache.cpp
+/// \brief		Contains implementation for reading and writing binary mesh caches (.dhmesh files)
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <mesh_cache.h>
+#include <meshinfo.h>
+#include <HFExceptions.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+using std::vector;
+using std::string;
+
+namespace HF::Geometry {
+
+	/*! \brief Identifies mesh cache files. Spells DHMS. */
+	const char MESH_CACHE_MAGIC[4] = { 'D', 'H', 'M', 'S' };
+
+	/*! \brief Version of the mesh cache format written by SaveMeshCache. */
+	const int32_t MESH_CACHE_VERSION = 1;
+
+	/*! \brief Alignment of every vertex and index array in a mesh cache. */
+	const int64_t MESH_CACHE_ALIGNMENT = 16;
+
+	/*! \brief The header at the start of every mesh cache. */
+	struct MeshCacheHeader {
+		char magic[4];				///< Always MESH_CACHE_MAGIC.
+		int32_t version;			///< Version of the file format.
+		int32_t num_meshes;			///< Number of entries in the mesh table.
+		int32_t reserved;			///< Unused. Always zero.
+		MeshCacheSource source;		///< Settings the meshes were loaded with.
+	};
+
+	/*! \brief The entry for a single mesh in the mesh table that follows the header. */
+	struct MeshCacheEntry {
+		int32_t id;					///< ID of the mesh.
+		int32_t num_vertices;		///< Number of vertices in the mesh.
+		int32_t num_triangles;		///< Number of triangles in the mesh.
+		int32_t name_length;		///< Number of characters in the name of the mesh.
+		int64_t vertex_offset;		///< Offset of the vertex array from the start of the file.
+		int64_t index_offset;		///< Offset of the index array from the start of the file.
+		int64_t name_offset;		///< Offset of the name from the start of the file.
+	};
+
+	// Every byte written to a cache must belong to a field, otherwise uninitialized padding ends up in the file
+	static_assert(sizeof(MeshCacheSource) == 32, "MeshCacheSource must not contain padding");
+	static_assert(sizeof(MeshCacheHeader) == 48, "MeshCacheHeader must not contain padding");
+	static_assert(sizeof(MeshCacheEntry) == 40, "MeshCacheEntry must not contain padding");
+
+	/*! \brief Round offset up to the next multiple of MESH_CACHE_ALIGNMENT. */
+	inline int64_t Align(int64_t offset) {
+		return (offset + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+	}
+
+	/*!
+		\brief Check that an array of count elements of element_size bytes at offset fits in a file of file_size bytes.
+
+		\details Compares against the space left after offset so corrupt offsets and counts can't overflow.
+	*/
+	inline bool InBounds(int64_t offset, int64_t count, int64_t element_size, size_t file_size) {
+		const int64_t size = static_cast<int64_t>(file_size);
+		return offset >= 0 && count >= 0 && offset <= size && count <= (size - offset) / element_size;
+	}
+
+	MeshCache::MeshCache(const string& path) : file(path)
+	{
+		const char* data = file.Data();
+		const size_t size = file.Size();
+
+		// Read and validate the header
+		if (size < sizeof(MeshCacheHeader)) throw HF::Exceptions::InvalidOBJ();
+		MeshCacheHeader header;
+		std::memcpy(&header, data, sizeof(header));
+		if (std::memcmp(header.magic, MESH_CACHE_MAGIC, 4) != 0 || header.version != MESH_CACHE_VERSION)
+			throw HF::Exceptions::InvalidOBJ();
+		if (!InBounds(sizeof(MeshCacheHeader), header.num_meshes, sizeof(MeshCacheEntry), size))
+			throw HF::Exceptions::InvalidOBJ();
+		source = header.source;
+
+		// Read the table of meshes, checking that every array is entirely inside of the file
+		const char* table = data + sizeof(MeshCacheHeader);
+		meshes.resize(header.num_meshes);
+		for (int i = 0; i < header.num_meshes; i++) {
+			MeshCacheEntry entry;
+			std::memcpy(&entry, table + i * sizeof(MeshCacheEntry), sizeof(entry));
+
+			if (!InBounds(entry.vertex_offset, static_cast<int64_t>(entry.num_vertices) * 3, sizeof(float), size)
+				|| !InBounds(entry.index_offset, static_cast<int64_t>(entry.num_triangles) * 3, sizeof(int), size)
+				|| !InBounds(entry.name_offset, entry.name_length, sizeof(char), size))
+				throw HF::Exceptions::InvalidOBJ();
+
+			// The index array must come after the vertex array, so the vertices can be read past their end
+			const int64_t vertices_end = entry.vertex_offset + static_cast<int64_t>(entry.num_vertices) * 3 * sizeof(float);
+			if (entry.num_triangles > 0 && entry.index_offset < vertices_end)
+				throw HF::Exceptions::InvalidOBJ();
+
+			// Raytracers share these arrays directly, so they must be aligned for their element type
+			if (entry.vertex_offset % sizeof(float) != 0 || entry.index_offset % sizeof(int) != 0)
+				throw HF::Exceptions::InvalidOBJ();
+
+			// Every index must refer to a vertex of this mesh
+			const int* indices = reinterpret_cast<const int*>(data + entry.index_offset);
+			const int64_t num_indices = static_cast<int64_t>(entry.num_triangles) * 3;
+			for (int64_t k = 0; k < num_indices; k++)
+				if (indices[k] < 0 || indices[k] >= entry.num_vertices)
+					throw HF::Exceptions::InvalidOBJ();
+
+			auto& mesh = meshes[i];
+			mesh.id = entry.id;
+			mesh.name = string(data + entry.name_offset, entry.name_length);
+			mesh.vertices = reinterpret_cast<const float*>(data + entry.vertex_offset);
+			mesh.num_vertices = entry.num_vertices;
+			mesh.indices = indices;
+			mesh.num_triangles = entry.num_triangles;
+		}
+	}
+
+	vector<MeshInfo<float>> MeshCache::ToMeshInfo() const
+	{
+		vector<MeshInfo<float>> out_meshes;
+		out_meshes.reserve(meshes.size());
+
+		for (const auto& view : meshes) {
+			out_meshes.emplace_back(view.num_vertices, view.num_triangles, view.id, view.name);
+			auto& mesh = out_meshes.back();
+			std::copy(view.vertices, view.vertices + view.num_vertices * 3, mesh.GetVertexPointer().data);
+			std::copy(view.indices, view.indices + view.num_triangles * 3, mesh.GetIndexPointer().data);
+		}
+		return out_meshes;
+	}
+
+	void SaveMeshCache(const vector<MeshInfo<float>>& meshes, const string& path, const MeshCacheSource& source)
+	{
+		const int num_meshes = meshes.size();
+
+		// Lay out every array after the header and mesh table
+		vector<MeshCacheEntry> entries(num_meshes);
+		int64_t offset = sizeof(MeshCacheHeader) + num_meshes * sizeof(MeshCacheEntry);
+		for (int i = 0; i < num_meshes; i++) {
+			const auto& mesh = meshes[i];
+			auto& entry = entries[i];
+			entry.id = mesh.GetMeshID();
+			entry.num_vertices = mesh.NumVerts();
+			entry.num_triangles = mesh.NumTris();
+			entry.name_length = mesh.name.size();
+
+			entry.vertex_offset = Align(offset);
+			offset = entry.vertex_offset + static_cast<int64_t>(entry.num_vertices) * 3 * sizeof(float);
+			entry.index_offset = Align(offset);
+			offset = entry.index_offset + static_cast<int64_t>(entry.num_triangles) * 3 * sizeof(int);
+			entry.name_offset = offset;
+			offset += entry.name_length;
+		}
+
+		// Write to a temporary file so a partial cache is never left at path
+		const string temp_path = path + ".tmp";
+		{
+			std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+			if (!out.is_open())
+				throw std::runtime_error("Couldn't open " + temp_path + " for writing!");
+
+			MeshCacheHeader header{};
+			std::memcpy(header.magic, MESH_CACHE_MAGIC, 4);
+			header.version = MESH_CACHE_VERSION;
+			header.num_meshes = num_meshes;
+			header.source = source;
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(MeshCacheEntry));
+
+			// Write every array, padding up to its offset
+			const char padding[MESH_CACHE_ALIGNMENT] = {};
+			auto write_at = [&](int64_t array_offset, const char* array, int64_t num_bytes) {
+				const int64_t position = static_cast<int64_t>(out.tellp());
+				out.write(padding, array_offset - position);
+				out.write(array, num_bytes);
+			};
+			for (int i = 0; i < num_meshes; i++) {
+				const auto& entry = entries[i];
+				const auto vertices = meshes[i].GetVertexPointer();
+				const auto indices = meshes[i].GetIndexPointer();
+
+				// Write the mesh as it will be used, with any pending transform applied
+				const float* vertex_data = vertices.data;
+				vector<float> transformed;
+				if (meshes[i].HasPendingTransform()) {
+					transformed.resize(vertices.size);
+					TransformVertices(vertices.data, transformed.data(), entry.num_vertices, meshes[i].GetPendingTransform());
+					vertex_data = transformed.data();
+				}
+
+				write_at(entry.vertex_offset, reinterpret_cast<const char*>(vertex_data), vertices.size * sizeof(float));
+				write_at(entry.index_offset, reinterpret_cast<const char*>(indices.data), indices.size * sizeof(int));
+				write_at(entry.name_offset, meshes[i].name.data(), entry.name_length);
+			}
+
+			if (!out.good())
+				throw std::runtime_error("Failed to write mesh cache to " + temp_path);
+		}
+
+		// Replace the old cache
+		std::error_code error;
+		std::filesystem::rename(temp_path, path, error);
+		if (error) {
+			std::remove(temp_path.c_str());
+			throw std::runtime_error("Couldn't move mesh cache to " + path);
+		}
+	}
+
+	MeshCacheSource GetMeshCacheSource(const string& path, GROUP_METHOD gm, bool change_coords, int scale)
+	{
+		if (!std::filesystem::exists(path))
+			throw HF::Exceptions::FileNotFound();
+
+		MeshCacheSource source;
+		source.size = static_cast<int64_t>(std::filesystem::file_size(path));
+		source.modified_time = static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+		source.group_method = gm;
+		source.change_coords = change_coords;
+		source.scale = scale;
+		return source;
+	}
+
+	vector<MeshInfo<float>> LoadMeshObjectsCached(const string& path, GROUP_METHOD gm, bool change_coords, int scale)
+	{
+		const auto source = GetMeshCacheSource(path, gm, change_coords, scale);
+		const string cache_path = path + ".dhmesh";
+
+		// Use the cache if it exists and was created from this version of the file
+		if (std::filesystem::exists(cache_path)) {
+			try {
+				MeshCache cache(cache_path);
+				if (cache.Source() == source)
+					return cache.ToMeshInfo();
+			}
+			catch (const HF::Exceptions::InvalidOBJ&) {
+				std::cerr << "[C++] Ignoring invalid mesh cache " << cache_path << std::endl;
+			}
+		}
+
+		// Otherwise load the OBJ and cache it for next time
+		auto meshes = LoadMeshObjects(path, gm, change_coords, scale);
+		try {
+			SaveMeshCache(meshes, cache_path, source);
+		}
+		catch (const std::runtime_error& e) {
+			std::cerr << "[C++] " << e.what() << std::endl;
+		}
+		return meshes;
+	}
+}
@@ -0,0 +1,154 @@
+///
+///	\file		mesh_cache.h
+/// \brief		Contains definitions for reading and writing binary mesh caches (.dhmesh files)
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <mapped_file.h>
+#include <objloader.h>
+
+namespace HF::Geometry {
+
+	/*!
+		\brief A mesh stored in a MeshCache.
+
+		\details
+		vertices and indices point directly into the mapped cache file, and are only valid for as long
+		as the MeshCache that created this view. If the mesh has any triangles, indices starts after the
+		end of vertices, so it's always safe to read a few bytes past the last vertex.
+	*/
+	struct MeshView {
+		int id;						///< ID of the mesh.
+		std::string name;			///< Name of the mesh.
+		const float* vertices;		///< x, y, z coordinates of every vertex.
+		int num_vertices;			///< Number of vertices in vertices.
+		const int* indices;			///< Indices of the three vertices of every triangle.
+		int num_triangles;			///< Number of triangles in indices.
+	};
+
+	/*!
+		\brief Settings that were used to load the meshes in a cache from their source file.
+
+		\details
+		Used to determine if a cache still matches the file it was created from. If the source
+		file changed, or the meshes would be loaded with different settings, the cache is stale.
+	*/
+	struct MeshCacheSource {
+		int64_t size = 0;					///< Size of the source file in bytes.
+		int64_t modified_time = 0;			///< Last time the source file was written to.
+		int32_t group_method = ONLY_FILE;	///< GROUP_METHOD the meshes were loaded with.
+		int32_t change_coords = 0;			///< Whether the meshes were rotated to Z-up.
+		int32_t scale = 1;					///< Scale the meshes were loaded with.
+		int32_t reserved = 0;				///< Unused. Always zero so the struct has no padding.
+
+		/*! \brief Determine if two sources would produce the same meshes. */
+		inline bool operator==(const MeshCacheSource& other) const {
+			return size == other.size && modified_time == other.modified_time
+				&& group_method == other.group_method && change_coords == other.change_coords
+				&& scale == other.scale;
+		}
+	};
+
+	/*!
+		\brief A binary mesh cache (.dhmesh file) mapped into memory.
+
+		\details
+		A .dhmesh file stores the vertices, indices, IDs and names of a set of meshes exactly as they
+		are laid out in memory, so loading it requires no parsing at all. The file is mapped into memory,
+		and every mesh is exposed as a MeshView pointing directly into the mapping. Vertex and index
+		arrays start on 16 byte boundaries so they can be handed directly to a raytracer.
+
+		\par File Layout
+		1) A header containing the magic bytes `DHMS`, the format version, the number of meshes, and
+		the MeshCacheSource of the meshes.
+		2) A table with the ID, vertex count, triangle count, name length, and the offsets of the
+		vertices, indices and name of every mesh.
+		3) The vertex, index, and name arrays of every mesh.
+
+		\see SaveMeshCache to write a cache.
+		\see LoadMeshObjectsCached to automatically create and reuse caches for OBJ files.
+	*/
+	class MeshCache {
+		MappedFile file;					///< The mapped cache file.
+		std::vector<MeshView> meshes;		///< Every mesh in the file.
+		MeshCacheSource source;				///< Settings the meshes were loaded with.
+
+	public:
+		/*!
+			\brief Map the cache at path and read its table of meshes.
+
+			\param path Path to a .dhmesh file.
+
+			\exception HF::Exceptions::FileNotFound No file exists at path.
+			\exception HF::Exceptions::InvalidOBJ The file isn't a valid mesh cache, is from
+			a different version of the format, has a misaligned array, an array outside of the
+			file or an index array before its vertex array, or has an index that doesn't refer
+			to a vertex of its mesh.
+		*/
+		MeshCache(const std::string& path);
+
+		/*! \brief Get views of every mesh in the cache. */
+		inline const std::vector<MeshView>& Meshes() const { return meshes; }
+
+		/*! \brief Get the settings used to load the meshes in this cache. */
+		inline const MeshCacheSource& Source() const { return source; }
+
+		/*! \brief Copy every mesh in the cache into a new MeshInfo. */
+		std::vector<MeshInfo<float>> ToMeshInfo() const;
+	};
+
+	/*!
+		\brief Write meshes to a binary mesh cache.
+
+		\param meshes Meshes to write.
+		\param path Path to write the cache to. Will be overwritten if it already exists.
+		\param source Settings used to load meshes, to be checked against when the cache is reused.
+
+		\exception std::runtime_error The cache couldn't be written.
+
+		\details
+		The cache is first written to a temporary file next to path, then renamed to path. A
+		process that fails while writing the cache will never leave a partial cache behind.
+		Meshes with a pending transform are written with it applied, without changing meshes.
+	*/
+	void SaveMeshCache(
+		const std::vector<MeshInfo<float>>& meshes,
+		const std::string& path,
+		const MeshCacheSource& source = MeshCacheSource()
+	);
+
+	/*!
+		\brief Get the size and modification time of a file, alongside the settings it will be loaded with.
+
+		\exception HF::Exceptions::FileNotFound No file exists at path.
+	*/
+	MeshCacheSource GetMeshCacheSource(const std::string& path, GROUP_METHOD gm, bool change_coords, int scale);
+
+	/// <summary> Load the OBJ at path, using a binary cache of the result whenever possible. </summary>
+	/// <param name="path"> Path to the OBJ to load.</param>
+	/// <param name="gm"> Method for dividing the mesh into subobjects. </param>
+	/// <param name="change_coords"> Rotate the mesh from Y-up to Z-up. </param>
+	/// <param name="scale"> Scaling factor to use for the imported mesh </param>
+	/// <returns> The same meshes as LoadMeshObjects. </returns>
+	/*!
+		\exception HF::Exceptions::InvalidOBJ The file at path was not a valid OBJ file.
+		\exception HF::Exceptions::FileNotFound No file could be found at path.
+
+		\details
+		Looks for a cache at `path + ".dhmesh"`. If it exists, and was created from the current version
+		of the file at path with the same settings, the meshes are read straight from the cache.
+		Otherwise the OBJ is loaded with LoadMeshObjects and a new cache is written for the next run.
+		Failing to write the cache is not an error.
+	*/
+	std::vector<MeshInfo<float>> LoadMeshObjectsCached(
+		const std::string& path,
+		GROUP_METHOD gm = ONLY_FILE,
+		bool change_coords = false,
+		int scale = 1
+	);
+}
@@ -8,10 +8,17 @@
 #include <meshinfo.h>
 #include <Geometry>
 #include <HFExceptions.h>
+#include <parallelism.h>
 #include <math.h>
 #include <corecrt_math_defines.h>
 #include <iostream>
-#include <robin_hood.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <omp.h>
 
 
 #define _USE_MATH_DEFINES
@@ -20,14 +27,14 @@ using std::array;
 using std::vector;
 namespace HF::Geometry {
 	template <typename T>
-	MeshInfo<T>::MeshInfo(const vector<array<T, 3>>& vertices, int id, std::string name)
+	MeshInfo<T>::MeshInfo(const vector<array<T, 3>>& vertices, int id, std::string name, T weld_tolerance)
 	{
 		// Throw if the input array has no values in it. 
 		const size_t n = vertices.size();
 		if (vertices.size() < 1) throw HF::Exceptions::InvalidOBJ(); // Doesn't have any valid geometry
 
 		//AddVerts(vertices);
-		VectorsToBuffers(vertices);
+		VectorsToBuffers(vertices, weld_tolerance);
 
 		// Throw if a NAN was placed into the mesh. 
 		if (verts.hasNaN()) throw HF::Exceptions::InvalidOBJ();
@@ -39,6 +46,9 @@ namespace HF::Geometry {
 	template <typename T>
 	inline void MeshInfo<T>::SetVert(int index, T x, T y, T z)
 	{
+		// Set the vertex in the same space as the rest of the mesh
+		ApplyPendingTransform();
+
 		// the () operator is overloaded for eigen to index the array
 		// For example array(row, col) will index the value at row, col.
 		verts(0, index) = x;
@@ -47,19 +57,179 @@ namespace HF::Geometry {
 	}
 
 
+	/*!
+		\brief Sort values in parallel.
+
+		\param values Values to sort.
+		\param compare Strict weak ordering to sort values by.
+
+		\details
+		Splits values into one chunk per leased thread and sorts each chunk in parallel, then
+		merges neighbouring chunks in pairs until only one remains.
+	*/
+	template <typename V, typename Compare>
+	void ParallelSort(vector<V>& values, Compare compare) {
+		const int num_values = static_cast<int>(values.size());
+		HF::Parallel::ThreadLease lease(-1, num_values / 4096);
+		const int num_chunks = lease.size();
+		if (num_chunks <= 1) {
+			std::sort(values.begin(), values.end(), compare);
+			return;
+		}
+
+		// Sort every chunk independently
+		vector<int> bounds(num_chunks + 1);
+		for (int c = 0; c <= num_chunks; c++)
+			bounds[c] = static_cast<int>(static_cast<long long>(num_values) * c / num_chunks);
+
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int c = 0; c < num_chunks; c++)
+			std::sort(values.begin() + bounds[c], values.begin() + bounds[c + 1], compare);
+
+		// Merge pairs of sorted runs, doubling their width each pass
+		for (int width = 1; width < num_chunks; width *= 2) {
+#pragma omp parallel for schedule(dynamic, 1) num_threads(lease.size())
+			for (int c = 0; c < num_chunks - width; c += 2 * width) {
+				const int last = std::min(c + 2 * width, num_chunks);
+				std::inplace_merge(
+					values.begin() + bounds[c],
+					values.begin() + bounds[c + width],
+					values.begin() + bounds[last],
+					compare
+				);
+			}
+		}
+	}
+
+	/*! \brief A vertex snapped to the welding grid, alongside its index in the original array. */
+	struct WeldKey {
+		long long x, y, z;	///< Coordinates of the grid cell, or the bits of the exact coordinates.
+		int index;			///< Index of the vertex before welding.
+
+		/*! \brief Order by cell, then by index so the first vertex in every cell comes first. */
+		inline bool operator<(const WeldKey& other) const {
+			if (x != other.x) return x < other.x;
+			if (y != other.y) return y < other.y;
+			if (z != other.z) return z < other.z;
+			return index < other.index;
+		}
+
+		/*! \brief Check if two keys are in the same cell. */
+		inline bool SameCell(const WeldKey& other) const {
+			return x == other.x && y == other.y && z == other.z;
+		}
+	};
+
+	/*!
+		\brief Snap a coordinate to the welding grid.
+
+		\details
+		If tolerance is zero, the bits of the coordinate itself are used so only identical
+		coordinates match. Adding zero first turns -0.0 into 0.0.
+	*/
+	template <typename T>
+	inline long long QuantizeCoordinate(T value, T tolerance) {
+		value += static_cast<T>(0);
+		if (tolerance > 0)
+			return std::llround(value / tolerance);
+
+		if constexpr (sizeof(T) == sizeof(int32_t)) {
+			int32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+		else {
+			int64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+	}
+
+	/*!
+		\brief Find the vertices in a flat array that should be merged.
+
+		\param vertices x, y, z coordinates of every vertex.
+		\param num_vertices Number of vertices in vertices.
+		\param tolerance Size of the welding grid. If zero, only identical vertices are merged.
+		\param out_vertex_map Output parameter for the new index of every vertex in vertices.
+		\param out_unique Output parameter for the original index of every vertex that was kept,
+		in the order of their new indices.
+
+		\details
+		Every vertex is snapped to the welding grid and the results are sorted in parallel. Runs of
+		equal keys are the vertices to merge, and the first vertex of each run represents it. New
+		indices are assigned in the order representatives appear in vertices, so the output matches
+		assigning IDs to vertices the first time they're seen.
+	*/
+	template <typename T>
+	void WeldVertexArray(
+		const T* vertices,
+		int num_vertices,
+		T tolerance,
+		vector<int>& out_vertex_map,
+		vector<int>& out_unique
+	) {
+		HF::Parallel::ThreadLease lease(-1, num_vertices);
+
+		// Snap every vertex to the grid
+		vector<WeldKey> keys(num_vertices);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int i = 0; i < num_vertices; i++) {
+			const T* vertex = vertices + 3 * i;
+			keys[i] = WeldKey{
+				QuantizeCoordinate(vertex[0], tolerance),
+				QuantizeCoordinate(vertex[1], tolerance),
+				QuantizeCoordinate(vertex[2], tolerance),
+				i
+			};
+		}
+		ParallelSort(keys, std::less<WeldKey>());
+
+		// Find the start of every run of equal keys. The first key in every run has the lowest index.
+		vector<int> run_starts;
+		for (int i = 0; i < num_vertices; i++)
+			if (i == 0 || !keys[i].SameCell(keys[i - 1]))
+				run_starts.push_back(i);
+		const int num_runs = static_cast<int>(run_starts.size());
+
+		// Number runs in the order their representatives appear in vertices
+		vector<std::pair<int, int>> representatives(num_runs);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int r = 0; r < num_runs; r++)
+			representatives[r] = { keys[run_starts[r]].index, r };
+		ParallelSort(representatives, std::less<std::pair<int, int>>());
+
+		vector<int> run_ids(num_runs);
+		out_unique.resize(num_runs);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int new_id = 0; new_id < num_runs; new_id++) {
+			run_ids[representatives[new_id].second] = new_id;
+			out_unique[new_id] = representatives[new_id].first;
+		}
+
+		// Point every vertex at the new index of its run
+		out_vertex_map.resize(num_vertices);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int r = 0; r < num_runs; r++) {
+			const int run_end = (r + 1 < num_runs) ? run_starts[r + 1] : num_vertices;
+			for (int i = run_starts[r]; i < run_end; i++)
+				out_vertex_map[keys[i].index] = run_ids[r];
+		}
+	}
+
 	/*!
 		\brief Index an array of vertices.
 		\param vertices An array of vertices for a mesh organized so every 3 vertices
 		represents a triangle on the mesh.
 		\param mapped_indexes Output parameter for array of indicies
 		\param mapped_vertices Output parameter for vertex array.
+		\param tolerance Vertices in the same cell of a grid of this size are merged. If zero,
+		only identical vertices are merged.
 
 		\details 
-		Iterate through every array in vertices. If the x,y,z location in the array
-		hasn't been seen yet, add its coordinates to mapped_vertices, assign it a unique ID
-		in a an index hashmap, then add its id to mapped_indexes. IF it has been seen
-		add the existing ID in the index hashmap to mapped_indexes.
-
+		Merges vertices with WeldVertexArray, then copies the first vertex of every group of
+		merged vertices into mapped_vertices. Vertices are numbered in the order they first appear
+		in vertices. -0.0 and 0.0 are considered the same coordinate.
 
 		\pre mapped_indexes and mapped_vertices are empty vectors of integers and Ts respectively.
 
@@ -73,57 +243,29 @@ namespace HF::Geometry {
 	void IndexRawVertices(
 		const vector<array<T, 3>>& vertices,
 		vector<int>& mapped_indexes,
-		vector<T>& mapped_vertices
+		vector<T>& mapped_vertices,
+		T tolerance = 0
 	) {
-		// Create a hashmap to map vertices to indices.
-		robin_hood::unordered_map <array<T, 3>, int> index_map;
-		int next_id = 0;
-
-		int vertsize = vertices.size();
-		
-		// Iterate through every 3 vertexes in vertices
-		for (int i = 0; i < vertsize; i += 3) {
-			array<int, 3> ids;
-
-			// Iterate through every 3 vertexes in vertices. 
+		vector<int> unique;
+		WeldVertexArray(reinterpret_cast<const T*>(vertices.data()), static_cast<int>(vertices.size()), tolerance, mapped_indexes, unique);
+
+		const int num_unique = static_cast<int>(unique.size());
+		mapped_vertices.resize(3 * static_cast<size_t>(num_unique));
+		HF::Parallel::ThreadLease lease(-1, num_unique);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int i = 0; i < num_unique; i++) {
+			const auto& vert = vertices[unique[i]];
 			for (int k = 0; k < 3; k++)
-			{
-				// Get the vertex at this position
-				const auto& vert = vertices[i + k];
-				int current_id;
-
-				// Get ID from index map, or create a new ID if one doesn't exist
-				if (index_map.count(vert) > 0)
-					current_id = index_map[vert];
-				else {
-
-					// store the id in the hashmap for this vertex.
-					index_map[vert] = next_id;
-					current_id = next_id;
-
-					// If this is a new vertex, add it the mapped_vertices vector
-					mapped_vertices.push_back(vert[0]);
-					mapped_vertices.push_back(vert[1]);
-					mapped_vertices.push_back(vert[2]);
-					next_id++;
-				}
-				// Store this new ID in the array.
-				ids[k] = current_id;
-			}
-
-			// Push the indexes back into the triangle array
-			mapped_indexes.push_back(ids[0]);
-			mapped_indexes.push_back(ids[1]);
-			mapped_indexes.push_back(ids[2]);
+				mapped_vertices[3 * i + k] = vert[k] + static_cast<T>(0);
 		}
 	}
 
 	template <typename T>
-	void MeshInfo<T>::VectorsToBuffers(const vector<array<T, 3>>& vertices)
+	void MeshInfo<T>::VectorsToBuffers(const vector<array<T, 3>>& vertices, T weld_tolerance)
 	{
 		// Create and fill vectors
 		vector<int> mapped_indexes; vector<T> mapped_vertices;
-		IndexRawVertices(vertices, mapped_indexes, mapped_vertices);
+		IndexRawVertices(vertices, mapped_indexes, mapped_vertices, weld_tolerance);
 
 		// This OBJ isn't valid if the following doesn't hold
 		if (!(mapped_indexes.size() % 3 == 0))
@@ -158,10 +300,24 @@ namespace HF::Geometry {
 		this->name = name;
 	}
 
+	template <typename T>
+	MeshInfo<T>::MeshInfo(int num_vertices, int num_triangles, int id, std::string name)
+	{
+		if (num_vertices < 0 || num_triangles < 0)
+			throw HF::Exceptions::InvalidOBJ();
+
+		verts.resize(3, num_vertices);
+		indices.resize(3, num_triangles);
+
+		meshid = id;
+		this->name = name;
+	}
+
 	template <typename T>
 	void MeshInfo<T>::AddVerts(const vector<array<T, 3>>& in_vertices)
 	{
 		if (in_vertices.size() % 3 != 0) throw HF::Exceptions::InvalidOBJ(); // Incomplete triangle
+		ApplyPendingTransform();
 
 		verts.resize(3, (static_cast<size_t>(verts.cols()) + in_vertices.size()));
 
@@ -180,29 +336,123 @@ namespace HF::Geometry {
 	template <typename T>
 	int MeshInfo<T>::NumTris() const { return static_cast<int>(indices.cols()); }
 
+	/*! \brief Get the 4x4 identity matrix in row-major order. */
+	template <typename T>
+	inline array<T, 16> IdentityAffine() {
+		return array<T, 16>{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	}
+
+	/*! \brief Convert a 3x3 rotation matrix to a 4x4 row-major affine transform. */
+	template <typename T>
+	inline array<T, 16> RotationToAffine(const Eigen::Matrix3<T>& rotation) {
+		array<T, 16> out = IdentityAffine<T>();
+		for (int row = 0; row < 3; row++)
+			for (int col = 0; col < 3; col++)
+				out[row * 4 + col] = rotation(row, col);
+		return out;
+	}
+
+	/*! \brief Get the affine transform that applies second, then first. Both are row-major. */
+	template <typename T>
+	inline array<T, 16> MultiplyAffine(const array<T, 16>& first, const array<T, 16>& second) {
+		array<T, 16> out = IdentityAffine<T>();
+		for (int row = 0; row < 3; row++)
+			for (int col = 0; col < 4; col++) {
+				T sum = col == 3 ? first[row * 4 + 3] : 0;
+				for (int k = 0; k < 3; k++)
+					sum += first[row * 4 + k] * second[k * 4 + col];
+				out[row * 4 + col] = sum;
+			}
+		return out;
+	}
+
+	/*! \brief Throw std::invalid_argument if any element of an affine transform that's used isn't finite. */
+	template <typename T>
+	inline void CheckAffineIsFinite(const array<T, 16>& matrix) {
+		// The bottom row is ignored
+		for (int i = 0; i < 12; i++)
+			if (!std::isfinite(matrix[i]))
+				throw std::invalid_argument("Transform matrices must only contain finite values");
+	}
+
+	template <typename T>
+	bool TransformVertices(const T* in, T* out, int num_vertices, const array<T, 16>& m)
+	{
+		int non_finite = 0;
+		HF::Parallel::ThreadLease lease(-1, num_vertices);
+#pragma omp parallel for schedule(static) reduction(+:non_finite) num_threads(lease.size())
+		for (int v = 0; v < num_vertices; v++) {
+			// Read the whole vertex first so in and out can be the same array
+			const T x = in[3 * v], y = in[3 * v + 1], z = in[3 * v + 2];
+			const T tx = m[0] * x + m[1] * y + m[2] * z + m[3];
+			const T ty = m[4] * x + m[5] * y + m[6] * z + m[7];
+			const T tz = m[8] * x + m[9] * y + m[10] * z + m[11];
+			out[3 * v] = tx; out[3 * v + 1] = ty; out[3 * v + 2] = tz;
+
+			if (!std::isfinite(tx) || !std::isfinite(ty) || !std::isfinite(tz))
+				non_finite++;
+		}
+		return non_finite == 0;
+	}
+
+	template bool TransformVertices<float>(const float*, float*, int, const array<float, 16>&);
+	template bool TransformVertices<double>(const double*, double*, int, const array<double, 16>&);
+
+	template <typename T>
+	bool MeshInfo<T>::TransformInPlace(const array<T, 16>& matrix)
+	{
+		// Fold any pending transform into this one so the vertices are only touched once
+		const array<T, 16> combined = has_pending_transform ? MultiplyAffine(matrix, pending_transform) : matrix;
+		has_pending_transform = false;
+		return TransformVertices(verts.data(), verts.data(), NumVerts(), combined);
+	}
+
+	template <typename T>
+	void MeshInfo<T>::Transform(const array<T, 16>& matrix)
+	{
+		CheckAffineIsFinite(matrix);
+		const bool all_finite = TransformInPlace(matrix);
+		assert(all_finite);
+	}
+
+	template <typename T>
+	void MeshInfo<T>::QueueTransform(const array<T, 16>& matrix)
+	{
+		CheckAffineIsFinite(matrix);
+		pending_transform = has_pending_transform ? MultiplyAffine(matrix, pending_transform) : matrix;
+		has_pending_transform = true;
+	}
+
+	template <typename T>
+	void MeshInfo<T>::ApplyPendingTransform()
+	{
+		if (has_pending_transform)
+			Transform(IdentityAffine<T>());
+	}
+
+	template <typename T>
+	bool MeshInfo<T>::HasPendingTransform() const { return has_pending_transform; }
+
+	template <typename T>
+	array<T, 16> MeshInfo<T>::GetPendingTransform() const {
+		return has_pending_transform ? pending_transform : IdentityAffine<T>();
+	}
+
 	template <typename T>
 	void MeshInfo<T>::ConvertToRhinoCoordinates()
 	{
 		Eigen::AngleAxis<T> yrot(0.5f * static_cast<T>(M_PI), Eigen::Vector3<T>::UnitX());
-		Eigen::Quaternion<T> quat;
-		quat = yrot;
-		quat.normalize();
-		verts = yrot.toRotationMatrix() * verts;
-		//auto newer_matrix = new_matrix.eval();
-		if (!verts.allFinite()) throw std::exception("Verts has NAN");
+		if (!TransformInPlace(RotationToAffine<T>(yrot.toRotationMatrix()))) throw std::exception("Verts has NAN");
 	}
 
 	template <typename T>
 	void MeshInfo<T>::ConvertToOBJCoordinates()
 	{
 		Eigen::AngleAxis<T> yrot(-0.5f * static_cast<T>(M_PI), Eigen::Vector3<T>::UnitX());
-		Eigen::Quaternion<T> quat;
-		quat = yrot;
-		quat.normalize();
 		Eigen::Matrix3<T> rotation_matrix = yrot.toRotationMatrix();
 		assert(!rotation_matrix.hasNaN());
-		verts = (rotation_matrix * verts);
-		assert(!verts.hasNaN());
+		const bool all_finite = TransformInPlace(RotationToAffine<T>(rotation_matrix));
+		assert(all_finite);
 	}
 
 	template <typename T>
@@ -229,11 +479,10 @@ namespace HF::Geometry {
 		// Assert that we didn't create any NANS or infinite values
 		assert(rotation_matrix.allFinite());
 
-		// Apply the rotation matrix to verts
-		verts = (rotation_matrix * verts);
-
-		// Once again assert that we didn't create any nans or infinite numbers.
-		assert(verts.allFinite());
+		// Apply the rotation matrix to verts, and once again assert that we didn't
+		// create any nans or infinite numbers.
+		const bool all_finite = TransformInPlace(RotationToAffine<T>(rotation_matrix));
+		assert(all_finite);
 		//! [snippet_objloader_assert]
 	}
 
@@ -341,6 +590,219 @@ namespace HF::Geometry {
 
 		return ret_array;
 	}
+
+	template <typename T>
+	int MeshInfo<T>::WeldVertices(T tolerance)
+	{
+		ApplyPendingTransform();
+		const int num_vertices = NumVerts();
+		vector<int> vertex_map, unique;
+		WeldVertexArray(verts.data(), num_vertices, tolerance, vertex_map, unique);
+
+		// Copy the kept vertices into a new buffer
+		const int num_unique = static_cast<int>(unique.size());
+		VertMatrix welded_verts(3, num_unique);
+		HF::Parallel::ThreadLease lease(-1, num_vertices);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int i = 0; i < num_unique; i++)
+			welded_verts.col(i) = verts.col(unique[i]).array() + static_cast<T>(0);
+
+		// Remap every triangle, marking those that collapsed
+		const int num_triangles = NumTris();
+		vector<char> keep(num_triangles);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int t = 0; t < num_triangles; t++) {
+			for (int k = 0; k < 3; k++)
+				indices(k, t) = vertex_map[indices(k, t)];
+			keep[t] = indices(0, t) != indices(1, t) && indices(1, t) != indices(2, t) && indices(0, t) != indices(2, t);
+		}
+
+		// Compact the remaining triangles
+		int num_kept = 0;
+		for (int t = 0; t < num_triangles; t++)
+			if (keep[t]) indices.col(num_kept++) = indices.col(t);
+		indices.conservativeResize(3, num_kept);
+
+		verts = std::move(welded_verts);
+		return num_vertices - num_unique;
+	}
+
+	template <typename T>
+	int MeshInfo<T>::KeepTriangles(const vector<char>& keep)
+	{
+		ApplyPendingTransform();
+
+		// Compact the kept triangles
+		const int num_triangles = NumTris();
+		int num_kept = 0;
+		for (int t = 0; t < num_triangles; t++)
+			if (keep[t]) indices.col(num_kept++) = indices.col(t);
+		indices.conservativeResize(3, num_kept);
+
+		// Give every vertex that's still in use a new index
+		const int num_vertices = NumVerts();
+		vector<int> vertex_map(num_vertices, -1);
+		for (int t = 0; t < num_kept; t++)
+			for (int k = 0; k < 3; k++)
+				vertex_map[indices(k, t)] = 0;
+
+		int num_used = 0;
+		for (int v = 0; v < num_vertices; v++)
+			if (vertex_map[v] == 0) vertex_map[v] = num_used++;
+
+		// Move the used vertices into a new buffer and update the triangles to match
+		VertMatrix kept_verts(3, num_used);
+		HF::Parallel::ThreadLease lease(-1, num_vertices);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int v = 0; v < num_vertices; v++)
+			if (vertex_map[v] >= 0) kept_verts.col(vertex_map[v]) = verts.col(v);
+
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int t = 0; t < num_kept; t++)
+			for (int k = 0; k < 3; k++)
+				indices(k, t) = vertex_map[indices(k, t)];
+
+		verts = std::move(kept_verts);
+		return num_triangles - num_kept;
+	}
+
+	template <typename T>
+	int MeshInfo<T>::CropToBox(const array<T, 3>& min_point, const array<T, 3>& max_point, T margin)
+	{
+		ApplyPendingTransform();
+		const int num_triangles = NumTris();
+		vector<char> keep(num_triangles);
+
+		HF::Parallel::ThreadLease lease(-1, num_triangles);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int t = 0; t < num_triangles; t++) {
+			// Keep the triangle if its bounding box overlaps the grown box on every axis
+			bool overlaps = true;
+			for (int axis = 0; axis < 3; axis++) {
+				const T a = verts(axis, indices(0, t));
+				const T b = verts(axis, indices(1, t));
+				const T c = verts(axis, indices(2, t));
+				const T lowest = std::min(a, std::min(b, c));
+				const T highest = std::max(a, std::max(b, c));
+				overlaps = overlaps && highest >= min_point[axis] - margin && lowest <= max_point[axis] + margin;
+			}
+			keep[t] = overlaps;
+		}
+
+		return KeepTriangles(keep);
+	}
+
+	/*! \brief A point on the XY plane. */
+	using Point2D = array<double, 2>;
+
+	/*! \brief Get the squared distance between point and the segment from a to b. */
+	inline double SquaredDistanceToSegment(const Point2D& point, const Point2D& a, const Point2D& b) {
+		const double dx = b[0] - a[0], dy = b[1] - a[1];
+		const double length_squared = dx * dx + dy * dy;
+
+		double t = 0;
+		if (length_squared > 0)
+			t = std::clamp(((point[0] - a[0]) * dx + (point[1] - a[1]) * dy) / length_squared, 0.0, 1.0);
+
+		const double x = a[0] + t * dx - point[0], y = a[1] + t * dy - point[1];
+		return x * x + y * y;
+	}
+
+	/*! \brief Get twice the signed area of the triangle a, b, c. Positive if counter-clockwise. */
+	inline double Orientation(const Point2D& a, const Point2D& b, const Point2D& c) {
+		return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+	}
+
+	/*! \brief Get the squared distance between the segments a-b and c-d, which is zero if they cross. */
+	inline double SquaredSegmentDistance(const Point2D& a, const Point2D& b, const Point2D& c, const Point2D& d) {
+		const double o1 = Orientation(a, b, c), o2 = Orientation(a, b, d);
+		const double o3 = Orientation(c, d, a), o4 = Orientation(c, d, b);
+		if (((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) && ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0)))
+			return 0;
+
+		return std::min(
+			std::min(SquaredDistanceToSegment(a, c, d), SquaredDistanceToSegment(b, c, d)),
+			std::min(SquaredDistanceToSegment(c, a, b), SquaredDistanceToSegment(d, a, b))
+		);
+	}
+
+	/*! \brief Check if point is inside of polygon using the even-odd rule. */
+	inline bool PointInPolygon(const Point2D& point, const vector<Point2D>& polygon) {
+		bool inside = false;
+		const int n = static_cast<int>(polygon.size());
+		for (int i = 0, j = n - 1; i < n; j = i++) {
+			const auto& a = polygon[i];
+			const auto& b = polygon[j];
+			if ((a[1] > point[1]) != (b[1] > point[1])
+				&& point[0] < (b[0] - a[0]) * (point[1] - a[1]) / (b[1] - a[1]) + a[0])
+				inside = !inside;
+		}
+		return inside;
+	}
+
+	template <typename T>
+	int MeshInfo<T>::CropToPolygon(const vector<array<T, 2>>& polygon, T margin)
+	{
+		if (polygon.size() < 3)
+			throw std::invalid_argument("A polygon needs at least 3 vertices to crop a mesh");
+		ApplyPendingTransform();
+
+		// Convert the polygon to doubles and find its bounding box, grown by margin
+		const int num_points = static_cast<int>(polygon.size());
+		vector<Point2D> points(num_points);
+		Point2D lowest{ polygon[0][0], polygon[0][1] }, highest = lowest;
+		for (int i = 0; i < num_points; i++) {
+			points[i] = Point2D{ static_cast<double>(polygon[i][0]), static_cast<double>(polygon[i][1]) };
+			for (int axis = 0; axis < 2; axis++) {
+				lowest[axis] = std::min(lowest[axis], points[i][axis]);
+				highest[axis] = std::max(highest[axis], points[i][axis]);
+			}
+		}
+		const double grow = std::max(static_cast<double>(margin), 0.0);
+		const double margin_squared = grow * grow;
+
+		const int num_triangles = NumTris();
+		vector<char> keep(num_triangles);
+
+		HF::Parallel::ThreadLease lease(-1, num_triangles);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(lease.size())
+		for (int t = 0; t < num_triangles; t++) {
+			Point2D triangle[3];
+			for (int k = 0; k < 3; k++)
+				triangle[k] = Point2D{ static_cast<double>(verts(0, indices(k, t))), static_cast<double>(verts(1, indices(k, t))) };
+
+			// Skip the exact checks for triangles that are nowhere near the polygon
+			bool nearby = true;
+			for (int axis = 0; axis < 2; axis++) {
+				const double tri_low = std::min(triangle[0][axis], std::min(triangle[1][axis], triangle[2][axis]));
+				const double tri_high = std::max(triangle[0][axis], std::max(triangle[1][axis], triangle[2][axis]));
+				nearby = nearby && tri_high >= lowest[axis] - grow && tri_low <= highest[axis] + grow;
+			}
+			if (!nearby) { keep[t] = false; continue; }
+
+			// A vertex of the triangle is inside of the polygon
+			bool inside = PointInPolygon(triangle[0], points) || PointInPolygon(triangle[1], points) || PointInPolygon(triangle[2], points);
+
+			// The polygon is inside of the triangle
+			if (!inside) {
+				const double area = Orientation(triangle[0], triangle[1], triangle[2]);
+				const auto& p = points[0];
+				const double w0 = Orientation(triangle[1], triangle[2], p);
+				const double w1 = Orientation(triangle[2], triangle[0], p);
+				const double w2 = Orientation(triangle[0], triangle[1], p);
+				inside = area != 0 && (area > 0 ? (w0 >= 0 && w1 >= 0 && w2 >= 0) : (w0 <= 0 && w1 <= 0 && w2 <= 0));
+			}
+
+			// An edge of the triangle crosses or comes within margin of an edge of the polygon
+			for (int i = 0, j = num_points - 1; !inside && i < num_points; j = i++)
+				for (int k = 0; !inside && k < 3; k++)
+					inside = SquaredSegmentDistance(triangle[k], triangle[(k + 1) % 3], points[j], points[i]) <= margin_squared;
+
+			keep[t] = inside;
+		}
+
+		return KeepTriangles(keep);
+	}
 }
 template class HF::Geometry::MeshInfo<double>;
 
@@ -105,6 +105,24 @@ namespace HF::Geometry {
 		}
 	};
 
+	/*!
+		\brief Transform an array of vertices by an affine matrix.
+
+		\param in Vertices to transform. Every 3 values is a new vertex.
+		\param out Output array for the transformed vertices. May be the same array as in.
+		\param num_vertices Number of vertices in in and out.
+		\param matrix A 4x4 affine transform in row-major order. The bottom row is ignored, and assumed
+		to be 0, 0, 0, 1.
+
+		\returns True if every transformed coordinate is finite, false otherwise.
+
+		\details
+		Vertices are transformed in parallel in a single pass, which also checks that the results are
+		finite, so transforming an array in place never allocates a second copy of it.
+	*/
+	template <typename T>
+	bool TransformVertices(const T* in, T* out, int num_vertices, const std::array<T, 16>& matrix);
+
 	/*!
 		\brief A collection of vertices and indices representing geometry.
 		
@@ -130,6 +148,8 @@ namespace HF::Geometry {
 		using VertMatrix = Eigen::Matrix3X<numeric_type>;
 		VertMatrix verts;	///< 3 by X matrix of vertices
 		Eigen::Matrix3X<int> indices;	///< 3 by X matrix of indices for triangles.
+		std::array<numeric_type, 16> pending_transform;	///< Row-major transform that hasn't been applied to verts yet.
+		bool has_pending_transform = false;				///< Whether pending_transform should be applied to verts.
 
 
 		/// <summary> Change the position of the vertex at index. </summary>
@@ -162,7 +182,26 @@ namespace HF::Geometry {
 				// TODO: this is a private member function of MeshInfo, but it is not used by any other member function with MeshInfo.
 			\endcode
 		*/
-		void VectorsToBuffers(const std::vector<std::array<numeric_type, 3>>& vertices);
+		void VectorsToBuffers(const std::vector<std::array<numeric_type, 3>>& vertices, numeric_type weld_tolerance = 0);
+		/*!
+			\brief Remove every triangle that isn't marked in keep, along with any vertices no longer in use.
+
+			\param keep One value per triangle. Triangles with a value of zero are removed.
+
+			\returns The number of triangles that were removed.
+
+			\details The remaining triangles and vertices keep their relative order.
+		*/
+		int KeepTriangles(const std::vector<char>& keep);
+
+		/*!
+			\brief Transform every vertex of this mesh in place, including any pending transform.
+
+			\param matrix A 4x4 affine transform in row-major order.
+
+			\returns True if every transformed vertex is finite, false otherwise.
+		*/
+		bool TransformInPlace(const std::array<numeric_type, 16>& matrix);
 	public:
 
 		/// <summary> Construct an empty instance of MeshInfo. </summary>
@@ -184,6 +223,10 @@ namespace HF::Geometry {
 		/// </param>
 		/// <param name="id"> A unique identifier. </param>
 		/// <param name="name"> A human-readable title. </param>
+		/// <param name="weld_tolerance">
+		/// Vertices closer than this distance along every axis are merged into one. If zero, only
+		/// vertices with identical coordinates are merged.
+		/// </param>
 		/*!
 			\exception HF::Exceptions::InvalidOBJ the input vertices don't represent a valid mesh.
 			\exception std::exception the input array had one or more NAN values.
@@ -217,7 +260,8 @@ namespace HF::Geometry {
 		MeshInfo(
 			const std::vector<std::array<numeric_type, 3>>& vertices,
 			int id,
-			std::string name = ""
+			std::string name = "",
+			numeric_type weld_tolerance = 0
 		);
 
 		/// <summary> Construct a new MeshInfo object from an indexed vector of vertices. </summary>
@@ -269,6 +313,29 @@ namespace HF::Geometry {
 			std::string name = ""
 		);
 
+		/*!
+			\brief Allocate space for a mesh with a known number of vertices and triangles.
+
+			\param num_vertices Number of vertices to allocate space for.
+			\param num_triangles Number of triangles to allocate space for.
+			\param id A unique identifier.
+			\param name A human readable title.
+
+			\details
+			The contents of the vertex and index buffers are left uninitialized, and must be filled
+			in through the pointers returned by GetVertexPointer() and GetIndexPointer(). This allows
+			loaders that know the size of a mesh ahead of time to write directly into its final
+			buffers instead of building intermediate vectors. 
+
+			\exception HF::Exceptions::InvalidOBJ num_vertices or num_triangles is negative.
+		*/
+		MeshInfo(
+			int num_vertices,
+			int num_triangles,
+			int id,
+			std::string name = ""
+		);
+
 		/*!
 			\brief Add more vertices to this mesh. 
 			
@@ -821,6 +888,192 @@ namespace HF::Geometry {
 			\returns A pointer to the index array of this mesh, and the number of elements it contains
 		*/
 		const array_and_size<int> GetIndexPointer() const;
+
+		/*!
+			\brief Merge vertices of this mesh that are within tolerance of each other.
+
+			\param tolerance Size of the grid vertices are snapped to when comparing them. If zero,
+			only vertices with identical coordinates are merged.
+
+			\returns The number of vertices that were removed.
+
+			\details
+			Vertices are merged with a parallel sort instead of a hash map, so this scales to very large
+			triangle soups. Every vertex is quantized to a grid with cells of size tolerance, then all
+			vertices that fall in the same cell are replaced by the first of them. -0.0 and 0.0 are
+			treated as the same coordinate. The remaining vertices keep the order they first appeared
+			in, so welding a mesh is deterministic. Triangles that collapse into a line or a point after
+			welding are removed.
+
+			\remarks
+			Two vertices within tolerance of each other that lie on opposite sides of a cell
+			boundary will not be merged.
+
+			\code
+				// be sure to #include "meshinfo.h", and #include <vector>
+
+				// Two triangles that share an edge, but whose shared vertices differ slightly
+				std::vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0, 1.0001f,0,0, 0,1.0001f,0, 1,1,0 };
+				std::vector<int> indices{ 0,1,2, 3,5,4 };
+				HF::Geometry::MeshInfo<float> mesh(vertices, indices, 0, "My Mesh");
+
+				// Merge the shared vertices
+				int removed = mesh.WeldVertices(0.001f);
+
+				// Output is: 'Removed 2 vertices'
+				std::cout << "Removed " << removed << " vertices" << std::endl;
+			\endcode
+		*/
+		int WeldVertices(numeric_type tolerance = 0);
+
+		/*!
+			\brief Remove every triangle that doesn't overlap a box.
+
+			\param min_point Corner of the box with the smallest x, y and z coordinates.
+			\param max_point Corner of the box with the largest x, y and z coordinates.
+			\param margin Distance to grow the box by on every side.
+
+			\returns The number of triangles that were removed.
+
+			\details
+			Use this to limit a large model, such as a district, to the region under study before
+			building a raytracer from it, so the BVH only pays for geometry that can actually be hit.
+			A triangle is kept if its bounding box overlaps the grown box, so triangles that pass near a
+			corner of the box may be kept even though they don't touch it. Triangles are tested in
+			parallel, and vertices that are no longer used by any triangle are removed.
+
+			\remarks If every triangle is removed, the mesh is left empty.
+
+			\see HF::GraphGenerator::GraphGenerator::MaxExtent to get a box that contains every node a
+			graph could reach.
+
+			\code
+				// be sure to #include "meshinfo.h", and #include <vector>
+
+				// Two triangles, one near the origin and one far away from it
+				std::vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0, 100,0,0, 101,0,0, 100,1,0 };
+				std::vector<int> indices{ 0,1,2, 3,4,5 };
+				HF::Geometry::MeshInfo<float> mesh(vertices, indices, 0, "My Mesh");
+
+				// Only keep geometry within 2 meters of the origin
+				int removed = mesh.CropToBox({ 0, 0, 0 }, { 0, 0, 0 }, 2.0f);
+
+				// Output is: 'Removed 1 triangles'
+				std::cout << "Removed " << removed << " triangles" << std::endl;
+			\endcode
+		*/
+		int CropToBox(
+			const std::array<numeric_type, 3>& min_point,
+			const std::array<numeric_type, 3>& max_point,
+			numeric_type margin = 0
+		);
+
+		/*!
+			\brief Remove every triangle that isn't within margin of a polygon on the XY plane.
+
+			\param polygon X and Y coordinates of the polygon's vertices in order. The polygon is closed
+			automatically and may be concave, but must have at least 3 vertices.
+			\param margin Horizontal distance from the polygon at which triangles are still kept.
+
+			\returns The number of triangles that were removed.
+
+			\exception std::invalid_argument polygon has fewer than 3 vertices.
+
+			\details
+			Triangles are projected onto the XY plane, and kept if any part of them lies inside of the
+			polygon or within margin of its boundary. The height of the geometry is ignored, so walls and
+			roofs above the polygon are kept along with the ground. Triangles are tested in parallel,
+			and vertices that are no longer used by any triangle are removed.
+
+			\remarks If every triangle is removed, the mesh is left empty.
+
+			\code
+				// be sure to #include "meshinfo.h", and #include <vector>
+
+				std::vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0, 100,0,0, 101,0,0, 100,1,0 };
+				std::vector<int> indices{ 0,1,2, 3,4,5 };
+				HF::Geometry::MeshInfo<float> mesh(vertices, indices, 0, "My Mesh");
+
+				// Keep geometry within 5 meters of the footprint of a building
+				std::vector<std::array<float, 2>> footprint{ {-1, -1}, {3, -1}, {3, 3}, {-1, 3} };
+				int removed = mesh.CropToPolygon(footprint, 5.0f);
+
+				// Output is: 'Removed 1 triangles'
+				std::cout << "Removed " << removed << " triangles" << std::endl;
+			\endcode
+		*/
+		int CropToPolygon(const std::vector<std::array<numeric_type, 2>>& polygon, numeric_type margin = 0);
+
+		/*!
+			\brief Transform every vertex of this mesh by an affine matrix.
+
+			\param matrix A 4x4 affine transform in row-major order. The bottom row is ignored.
+
+			\throws std::invalid_argument matrix contains NaN or infinity outside of its bottom row.
+
+			\details
+			Vertices are transformed in place in a single parallel pass, so no copy of the vertex
+			buffer is made. If a transform is pending, it's combined with matrix and both are applied
+			in the same pass. PerformRotation, ConvertToRhinoCoordinates and ConvertToOBJCoordinates
+			are all implemented with this function.
+
+			\code
+				// be sure to #include "meshinfo.h", and #include <vector>
+
+				std::vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0 };
+				std::vector<int> indices{ 0,1,2 };
+				HF::Geometry::MeshInfo<float> mesh(vertices, indices, 0, "My Mesh");
+
+				// Double the size of the mesh, then move it 10 meters up
+				mesh.Transform({
+					2, 0, 0, 0,
+					0, 2, 0, 0,
+					0, 0, 2, 10,
+					0, 0, 0, 1
+				});
+			\endcode
+		*/
+		void Transform(const std::array<numeric_type, 16>& matrix);
+
+		/*!
+			\brief Queue a transform to be applied to this mesh later.
+
+			\param matrix A 4x4 affine transform in row-major order. The bottom row is ignored.
+
+			\throws std::invalid_argument matrix contains NaN or infinity outside of its bottom row.
+
+			\details
+			Transforms queued by multiple calls are combined into a single matrix, in the order they
+			were queued, and nothing is done to the vertices until the transform is applied.
+			The transform is applied by ApplyPendingTransform, by any other function that changes this
+			mesh such as SetVert, AddVerts, Transform, WeldVertices, KeepTriangles and the crop functions,
+			by SaveMeshCache when the mesh is written, and by HF::RayTracer::EmbreeRayTracer when the mesh
+			is added to it. This lets a mesh
+			that needs several transforms before its BVH is built be transformed with only one pass
+			over its vertices.
+
+			\warning
+			Functions that read this mesh's vertices, such as GetIndexedVertices, GetVertexPointer and
+			operator[], return the vertices without the pending transform.
+		*/
+		void QueueTransform(const std::array<numeric_type, 16>& matrix);
+
+		/*!
+			\brief Apply the pending transform of this mesh, if it has one.
+
+			\see QueueTransform to queue a transform.
+		*/
+		void ApplyPendingTransform();
+
+		/*! \brief Check if this mesh has a transform that hasn't been applied to its vertices yet. */
+		bool HasPendingTransform() const;
+
+		/*!
+			\brief Get the transform that hasn't been applied to this mesh's vertices yet.
+
+			\returns The pending transform in row-major order, or the identity matrix if there isn't one.
+		*/
+		std::array<numeric_type, 16> GetPendingTransform() const;
 	};
 
 	template <typename T> MeshInfo()->MeshInfo<float>;
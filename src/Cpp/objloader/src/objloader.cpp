@@ -8,14 +8,23 @@
 #include <objloader.h>
 #include <Dense>
 #include <meshinfo.h>
+#include <mapped_file.h>
 #define TINYOBJLOADER_IMPLEMENTATION ///< This MUST be defined before importing tiny_obj_loader.h
 #define TINYOBJLOADER_USE_DOUBLE
 #include <tiny_obj_loader.h>
 #include <robin_hood.h>
 #include <HFExceptions.h>
+#include <parallelism.h>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <filesystem>
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <limits>
+#include <thread>
+#include <omp.h>
 
 using std::vector;
 using std::array;
@@ -192,6 +201,101 @@ namespace HF::Geometry {
 		return out_obj;
 	}
 
+	/*! \brief The faces of an OBJ that belong to a single mesh. Each face points to the first of its three indices. */
+	using FaceBucket = vector<const tinyobj::index_t*>;
+
+	/*!
+		\brief Create a mesh from a bucket of faces, keeping only the vertices they use.
+
+		\param obj_vertices x, y, z coordinates of every vertex in the OBJ.
+		\param faces Faces to add to the mesh.
+		\param id ID of the new mesh.
+		\param name Name of the new mesh.
+		\param scale Value to multiply every coordinate by.
+		\param out_mesh Output parameter for a mesh containing faces, with its vertices in the
+		same order as they are in the OBJ.
+
+		\returns False if any of the mesh's vertices are NaN, true otherwise.
+
+		\details
+		The OBJ indices used by faces are sorted and deduplicated, then every index is translated to
+		its position in that list. This avoids building an unindexed copy of the mesh and hashing its
+		vertices, and only needs memory proportional to the size of the bucket rather than the OBJ.
+	*/
+	bool MeshFromFaceBucket(
+		const vector<tinyobj::real_t>& obj_vertices,
+		const FaceBucket& faces,
+		int id,
+		const string& name,
+		int scale,
+		MeshInfo<float>& out_mesh
+	) {
+		const int num_triangles = faces.size();
+
+		// Find every vertex used by this bucket
+		vector<int> used_vertices(3 * static_cast<size_t>(num_triangles));
+		for (int t = 0; t < num_triangles; t++)
+			for (int k = 0; k < 3; k++)
+				used_vertices[3 * t + k] = faces[t][k].vertex_index;
+		std::sort(used_vertices.begin(), used_vertices.end());
+		used_vertices.erase(std::unique(used_vertices.begin(), used_vertices.end()), used_vertices.end());
+
+		// Write the vertices and indices directly into the mesh's buffers
+		const int num_vertices = used_vertices.size();
+		out_mesh = MeshInfo<float>(num_vertices, num_triangles, id, name);
+		float* mesh_vertices = out_mesh.GetVertexPointer().data;
+		bool has_nan = false;
+		for (int i = 0; i < num_vertices; i++)
+			for (int k = 0; k < 3; k++) {
+				const float value = static_cast<float>(obj_vertices[3 * used_vertices[i] + k] * scale);
+				has_nan |= std::isnan(value);
+				mesh_vertices[3 * i + k] = value;
+			}
+
+		int* mesh_indices = out_mesh.GetIndexPointer().data;
+		for (int t = 0; t < num_triangles; t++)
+			for (int k = 0; k < 3; k++) {
+				const int vertex = faces[t][k].vertex_index;
+				mesh_indices[3 * t + k] = std::lower_bound(used_vertices.begin(), used_vertices.end(), vertex) - used_vertices.begin();
+			}
+
+		return !has_nan;
+	}
+
+	/*!
+		\brief Create a mesh for every bucket of faces in parallel.
+
+		\param obj_vertices x, y, z coordinates of every vertex in the OBJ.
+		\param buckets Faces of every mesh to create.
+		\param ids ID of the mesh for every bucket.
+		\param names Name of the mesh for every bucket.
+		\param scale Value to multiply every coordinate by.
+
+		\returns One mesh for every bucket, in the same order as buckets.
+
+		\exception HF::Exceptions::InvalidOBJ A vertex used by one of the buckets is NaN.
+	*/
+	vector<MeshInfo<float>> MeshesFromFaceBuckets(
+		const vector<tinyobj::real_t>& obj_vertices,
+		const vector<FaceBucket>& buckets,
+		const vector<int>& ids,
+		const vector<string>& names,
+		int scale
+	) {
+		const int num_buckets = buckets.size();
+		vector<MeshInfo<float>> meshes(num_buckets);
+
+		int num_invalid = 0;
+		HF::Parallel::ThreadLease lease(-1, num_buckets);
+#pragma omp parallel for schedule(dynamic, 1) reduction(+:num_invalid) num_threads(lease.size())
+		for (int b = 0; b < num_buckets; b++)
+			if (!MeshFromFaceBucket(obj_vertices, buckets[b], ids[b], names[b], scale, meshes[b]))
+				num_invalid++;
+
+		if (num_invalid > 0) throw HF::Exceptions::InvalidOBJ();
+		return meshes;
+	}
+
 	vector<MeshInfo<float>> LoadMeshObjects(std::string path, GROUP_METHOD gm, bool change_coords, int scale)
 	{
 		// First, attempt to load the obj
@@ -236,9 +340,9 @@ namespace HF::Geometry {
 			// assign the float vector to the scaled method
 
 			// Cast to float
-			vector<float> vertexes(vert_array.size());
-			for (int i = 0; i < vert_array.size(); i++)
-				vertexes[i] = static_cast<float>(vert_array[i]);
+			vector<float> vertexes(vert_scaled.size());
+			for (int i = 0; i < vert_scaled.size(); i++)
+				vertexes[i] = static_cast<float>(vert_scaled[i]);
 
 			vector<int> indices;
 
@@ -265,92 +369,60 @@ namespace HF::Geometry {
 		}
 
 		case GROUP_METHOD::BY_GROUP: {
-			// Each group represents a different mesh.
-
-			// Allocate a space for every shape in shapes.
-			// Note: Shapes are OBJ groups.
-			MI.resize(shapes.size());
-			vector<array<float, 3>> current_vertices;
-
-			// Iterate through every shape in shapes.
+			// Each group represents a different mesh. Note: Shapes are OBJ groups.
+			vector<FaceBucket> buckets; vector<int> ids; vector<string> names;
 			for (int k = 0; k < shapes.size(); k++) {
-				auto& shape = shapes[k];
-				// Set MeshInfo parameters for shape
-				std::string name = shape.name;
-				int id = k;
-				auto& indicies = shape.mesh.indices;
-
-				// Add vertices to shape's list of vertices.
-				for (int i = 0; i < indicies.size(); i++) {
-					tinyobj::index_t idx = indicies[i];
-
-					int vertex_index = 3 * idx.vertex_index;
-					float x = verts[vertex_index];
-					float y = verts[1 + vertex_index];
-					float z = verts[2 + vertex_index];
-
-					current_vertices.emplace_back(array<float, 3>{x, y, z});
-				}
+				const auto& indices = shapes[k].mesh.indices;
+				const int num_faces = indices.size() / 3;
+				if (num_faces == 0) continue; // Ignore groups without any faces
+
+				FaceBucket faces(num_faces);
+				for (int f = 0; f < num_faces; f++)
+					faces[f] = &indices[3 * f];
 
-				// Finally add this mesh to the list of meshes, then rotate it to Z-up if specified.
-				MI[k] = MeshInfo(current_vertices, id, name);
-				if (change_coords) MI[k].ConvertToRhinoCoordinates();
+				buckets.push_back(std::move(faces));
+				ids.push_back(k);
+				names.push_back(shapes[k].name);
 			}
+
+			MI = MeshesFromFaceBuckets(verts, buckets, ids, names, scale);
 			break;
 		}
 		case GROUP_METHOD::BY_MATERIAL: {
 			// If there are no materials, just put every vert into the same mesh
 			if (mats.empty()) {
 				std::cerr << "[C++] No materials found in model " << path << ". Grouping by obj group";
-				return LoadMeshObjects(path, BY_GROUP);
+				return LoadMeshObjects(path, BY_GROUP, change_coords, scale);
 			}
 
-			// Create a vector of [mesh_id:"material"] for every unique material
-			MI.resize(mats.size());
-			vector<vector< array<float, 3 >>> verts_by_mat_id(mats.size());
-
-			// Create and fill a vector of names for each material.
-			vector<std::string> names;
-			for (int i = 0; i < mats.size(); i++)
-				names.emplace_back(path + "/" + mats[i].name);
-
-			// Loop through every shape to fill the vector
-			for (int k = 0; k < shapes.size(); k++) {
-				auto& shape = shapes[k];
-				vector<int>& mat_ids = shape.mesh.material_ids;
-				vector<tinyobj::index_t>& indicies = shape.mesh.indices;
-
-				// Iterate through every index in indices.
-				for (int i = 0; i < indicies.size(); i++) {
-					tinyobj::index_t idx = indicies[i];
-
-					int vertex_index = 3 * idx.vertex_index;
+			// Sort every face into the bucket of its material. Faces without a material
+			// go into an extra bucket after the last material.
+			const int default_material = mats.size();
+			vector<FaceBucket> faces_by_material(mats.size() + 1);
+			for (const auto& shape : shapes) {
+				const auto& mat_ids = shape.mesh.material_ids;
+				const auto& indices = shape.mesh.indices;
+				const int num_faces = indices.size() / 3;
 
-					float x = verts[vertex_index];
-					float y = verts[1 + vertex_index];
-					float z = verts[2 + vertex_index];
+				for (int f = 0; f < num_faces; f++) {
+					int mat_index = f < mat_ids.size() ? mat_ids[f] : -1;
+					if (mat_index < 0 || mat_index >= default_material) mat_index = default_material;
 
-					// Get the index of this face (equal to i/3) since every 3 indices is a face
-					int face = static_cast<int>(floor(i / 3));
-
-					// Get the material index of face.
-					if (mats.size() > 0 && mat_ids.size() > face) {
-						int mat_index = mat_ids[face];
-
-						verts_by_mat_id[mat_index].emplace_back(array<float, 3>{x, y, z});
-					}
+					faces_by_material[mat_index].push_back(&indices[3 * f]);
 				}
 			}
 
-			// Reassign meshids and cull materials with no geometry.
-			for (int i = 0; i < names.size(); i++) {
-				auto& mesh = verts_by_mat_id[i];
-				if (mesh.empty()) continue; // Ignore unused materials
+			// Cull materials with no geometry, using the index of each material as its mesh's ID
+			vector<FaceBucket> buckets; vector<int> ids; vector<string> names;
+			for (int i = 0; i <= default_material; i++) {
+				if (faces_by_material[i].empty()) continue; // Ignore unused materials
 
-				// add to list;
-				MI.push_back(MeshInfo(mesh, i, names[i]));
-				if (change_coords) MI[i].ConvertToRhinoCoordinates();
+				buckets.push_back(std::move(faces_by_material[i]));
+				ids.push_back(i);
+				names.push_back(path + "/" + (i < default_material ? mats[i].name : string("default")));
 			}
+
+			MI = MeshesFromFaceBuckets(verts, buckets, ids, names, scale);
 			break;
 		}
 
@@ -365,6 +437,12 @@ namespace HF::Geometry {
 		if (MI.size() == 0) {
 			throw HF::Exceptions::InvalidOBJ();
 		}
+
+		// Change grouped meshes from Y-up to Z-up if specified. ONLY_FILE already did this.
+		if (change_coords && gm != GROUP_METHOD::ONLY_FILE)
+			for (auto& mesh : MI)
+				mesh.ConvertToRhinoCoordinates();
+
 		return MI;
 	}
 
@@ -428,4 +506,355 @@ namespace HF::Geometry {
 
 		return MI;
 	}
-}
\ No newline at end of file
+
+	/*! \brief Determine if c separates tokens on a line of an OBJ. */
+	inline bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+	/*! \brief Advance p past any blank characters before end. */
+	inline const char* SkipBlanks(const char* p, const char* end) {
+		while (p < end && IsBlank(*p)) p++;
+		return p;
+	}
+
+	/*! \brief Get a pointer to the end of the line starting at p, not including the newline. */
+	inline const char* FindLineEnd(const char* p, const char* end) {
+		const void* newline = memchr(p, '\n', end - p);
+		return newline ? static_cast<const char*>(newline) : end;
+	}
+
+	/*!
+		\brief Check if the text at p starts with word, ignoring case.
+
+		\param p Start of the text to check.
+		\param end End of the line containing the text.
+		\param word Lowercase word to look for.
+
+		\returns A pointer to the character after word, or nullptr if the text doesn't start with it.
+	*/
+	inline const char* MatchWord(const char* p, const char* end, const char* word) {
+		for (; *word; p++, word++)
+			if (p >= end || (*p | 0x20) != *word) return nullptr;
+		return p;
+	}
+
+	/*!
+		\brief Parse a decimal number in standard or scientific notation.
+
+		\param p Start of the number.
+		\param end End of the line containing the number.
+		\param out_value Output parameter for the parsed number.
+
+		\returns A pointer to the character after the number, or nullptr if no number could be parsed.
+
+		\details
+		Digits are accumulated into a 64 bit integer, and the decimal point and exponent are then
+		applied with a single multiplication or division by a power of ten. This is far faster than
+		strtod, and exact for any number with 15 or fewer significant digits, which more than covers
+		the precision of the floats meshes are stored in. Like strtod, `inf`, `infinity` and `nan` are
+		accepted in any case.
+	*/
+	inline const char* ParseNumber(const char* p, const char* end, double& out_value) {
+		static const double powers_of_ten[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+			1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negative = (*p == '-');
+			p++;
+		}
+
+		// Read infinity and NaN
+		if (p < end && (*p | 0x20) == 'i') {
+			if (!(p = MatchWord(p, end, "inf"))) return nullptr;
+			if (const char* word_end = MatchWord(p, end, "inity")) p = word_end;
+			out_value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+			return p;
+		}
+		if (p < end && (*p | 0x20) == 'n') {
+			if (!(p = MatchWord(p, end, "nan"))) return nullptr;
+			out_value = std::numeric_limits<double>::quiet_NaN();
+			return p;
+		}
+
+		// Read digits into the mantissa, only counting the digits that no longer fit
+		uint64_t mantissa = 0;
+		int exponent = 0;
+		int num_digits = 0;
+		for (; p < end && *p >= '0' && *p <= '9'; p++, num_digits++) {
+			if (mantissa < 100000000000000000ULL) mantissa = mantissa * 10 + (*p - '0');
+			else exponent++;
+		}
+		if (p < end && *p == '.') {
+			for (p++; p < end && *p >= '0' && *p <= '9'; p++, num_digits++) {
+				if (mantissa < 100000000000000000ULL) {
+					mantissa = mantissa * 10 + (*p - '0');
+					exponent--;
+				}
+			}
+		}
+		if (num_digits == 0) return nullptr;
+
+		// Read the exponent if this is in scientific notation
+		if (p < end && (*p == 'e' || *p == 'E')) {
+			p++;
+			bool negative_exponent = false;
+			if (p < end && (*p == '-' || *p == '+')) {
+				negative_exponent = (*p == '-');
+				p++;
+			}
+			int explicit_exponent = 0;
+			if (p >= end || *p < '0' || *p > '9') return nullptr;
+			for (; p < end && *p >= '0' && *p <= '9'; p++)
+				if (explicit_exponent < 10000) explicit_exponent = explicit_exponent * 10 + (*p - '0');
+			exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+		}
+
+		double value = static_cast<double>(mantissa);
+		if (exponent < 0)
+			value = (exponent >= -22) ? value / powers_of_ten[-exponent] : value * std::pow(10.0, exponent);
+		else if (exponent > 0)
+			value = (exponent <= 22) ? value * powers_of_ten[exponent] : value * std::pow(10.0, exponent);
+
+		out_value = negative ? -value : value;
+		return p;
+	}
+
+	/*!
+		\brief Parse the vertex index of a face element such as `1`, `1/2`, `1//3` or `1/2/3`.
+
+		\param p Start of the face element.
+		\param end End of the line containing the element.
+		\param out_index Output parameter for the index exactly as it appears in the file.
+
+		\returns A pointer to the character after the element, or nullptr if it isn't a valid index
+		or its magnitude is larger than INT_MAX.
+	*/
+	inline const char* ParseFaceIndex(const char* p, const char* end, long long& out_index) {
+		bool negative = false;
+		if (p < end && *p == '-') {
+			negative = true;
+			p++;
+		}
+
+		long long index = 0;
+		const char* start = p;
+		for (; p < end && *p >= '0' && *p <= '9'; p++) {
+			index = index * 10 + (*p - '0');
+
+			// Stop before the index can overflow, or wrap once it's cast to an int
+			if (index > INT_MAX) return nullptr;
+		}
+		if (p == start || index == 0) return nullptr;
+
+		// Skip the texture coordinate and normal indices
+		while (p < end && !IsBlank(*p)) p++;
+
+		out_index = negative ? -index : index;
+		return p;
+	}
+
+	/*! \brief Check if the line starting at p begins with the keyword c followed by a blank. */
+	inline bool IsKeyword(const char* p, const char* end, char c) {
+		return (end - p) >= 2 && p[0] == c && IsBlank(p[1]);
+	}
+
+	/*!
+		\brief Count the vertices and triangles in a range of lines of an OBJ.
+
+		\param begin First character of the range. Must be at the start of a line.
+		\param end One past the last character of the range.
+		\param out_vertices Output parameter for the number of `v` lines in the range.
+		\param out_triangles Output parameter for the number of triangles the faces in the range 
+		will be split into.
+	*/
+	void CountOBJChunk(const char* begin, const char* end, long long& out_vertices, long long& out_triangles) {
+		out_vertices = 0;
+		out_triangles = 0;
+
+		for (const char* line = begin; line < end;) {
+			const char* line_end = FindLineEnd(line, end);
+			const char* p = SkipBlanks(line, line_end);
+
+			if (IsKeyword(p, line_end, 'v'))
+				out_vertices++;
+			else if (IsKeyword(p, line_end, 'f')) {
+				// A face with n vertices is split into n - 2 triangles
+				int num_elements = 0;
+				for (p++; p < line_end && *p != '#';) {
+					p = SkipBlanks(p, line_end);
+					if (p >= line_end || *p == '#') break;
+					num_elements++;
+					while (p < line_end && !IsBlank(*p)) p++;
+				}
+				if (num_elements >= 3)
+					out_triangles += num_elements - 2;
+			}
+			line = (line_end < end) ? line_end + 1 : end;
+		}
+	}
+
+	/*!
+		\brief Parse the vertices and faces in a range of lines of an OBJ directly into a mesh's buffers.
+
+		\param begin First character of the range. Must be at the start of a line.
+		\param end One past the last character of the range.
+		\param vertices Pointer to where the first vertex of this range should be written.
+		\param indices Pointer to where the first index of this range should be written.
+		\param first_vertex Number of vertices in the file before this range. Used to resolve
+		relative indices.
+		\param scale Value to multiply every coordinate by.
+
+		\returns True if every line was valid, false otherwise.
+
+		\details
+		Faces with more than three vertices are split into a fan of triangles around their first vertex.
+		Indices are converted from the OBJ's 1-based or relative indices to 0-based indices into the
+		vertices of the entire file.
+	*/
+	bool ParseOBJChunk(
+		const char* begin,
+		const char* end,
+		float* vertices,
+		int* indices,
+		long long first_vertex,
+		int scale
+	) {
+		long long num_vertices = first_vertex;
+		vector<int> face;
+
+		for (const char* line = begin; line < end;) {
+			const char* line_end = FindLineEnd(line, end);
+			const char* p = SkipBlanks(line, line_end);
+
+			if (IsKeyword(p, line_end, 'v')) {
+				p++;
+				for (int axis = 0; axis < 3; axis++) {
+					double value;
+					p = ParseNumber(SkipBlanks(p, line_end), line_end, value);
+					if (!p) return false;
+					*(vertices++) = static_cast<float>(value * scale);
+				}
+				num_vertices++;
+			}
+			else if (IsKeyword(p, line_end, 'f')) {
+				face.clear();
+				for (p++; p < line_end;) {
+					p = SkipBlanks(p, line_end);
+					if (p >= line_end || *p == '#') break;
+
+					long long index;
+					p = ParseFaceIndex(p, line_end, index);
+					if (!p) return false;
+
+					// Convert to a 0-based index. Negative indices are relative to the last vertex read.
+					index = index > 0 ? index - 1 : num_vertices + index;
+					if (index < 0) return false;
+					face.push_back(static_cast<int>(index));
+				}
+
+				for (int k = 1; k + 1 < static_cast<int>(face.size()); k++) {
+					*(indices++) = face[0];
+					*(indices++) = face[k];
+					*(indices++) = face[k + 1];
+				}
+			}
+			line = (line_end < end) ? line_end + 1 : end;
+		}
+		return true;
+	}
+
+	/*!
+		\brief Split a file into ranges that each start at the beginning of a line.
+
+		\param data Start of the file.
+		\param size Size of the file in bytes.
+		\param num_chunks Number of ranges to split the file into.
+
+		\returns The start of every range followed by the end of the file. Ranges may be empty.
+	*/
+	vector<const char*> SplitIntoLines(const char* data, size_t size, int num_chunks) {
+		const char* end = data + size;
+		vector<const char*> bounds(num_chunks + 1);
+		bounds[0] = data;
+		bounds[num_chunks] = end;
+
+		// Move every boundary forward to the start of the next line
+		for (int i = 1; i < num_chunks; i++) {
+			const char* p = std::max(bounds[i - 1], data + (size / num_chunks) * i);
+			if (p > data && p < end && p[-1] != '\n') {
+				p = FindLineEnd(p, end);
+				if (p < end) p++;
+			}
+			bounds[i] = p;
+		}
+		return bounds;
+	}
+
+	MeshInfo<float> LoadMeshObjectsParallel(const std::string& path, bool change_coords, int scale)
+	{
+		// Map the file into memory
+		MappedFile file(path);
+		if (file.Size() == 0) throw HF::Exceptions::InvalidOBJ();
+
+		// Split the file into chunks of lines. Use several per thread so a
+		// few chunks full of large faces don't hold up the rest.
+		HF::Parallel::ThreadLease lease;
+		const int num_threads = lease.size();
+		const size_t min_chunk_size = 1 << 20;
+		const int num_chunks = static_cast<int>(std::max<size_t>(1, std::min<size_t>(num_threads * 4, file.Size() / min_chunk_size)));
+		const auto bounds = SplitIntoLines(file.Data(), file.Size(), num_chunks);
+
+		// Count the vertices and triangles in every chunk
+		vector<long long> vertex_counts(num_chunks), triangle_counts(num_chunks);
+#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
+		for (int i = 0; i < num_chunks; i++)
+			CountOBJChunk(bounds[i], bounds[i + 1], vertex_counts[i], triangle_counts[i]);
+
+		// Find where every chunk's vertices and triangles will start in the mesh
+		vector<long long> vertex_offsets(num_chunks + 1, 0), triangle_offsets(num_chunks + 1, 0);
+		for (int i = 0; i < num_chunks; i++) {
+			vertex_offsets[i + 1] = vertex_offsets[i] + vertex_counts[i];
+			triangle_offsets[i + 1] = triangle_offsets[i] + triangle_counts[i];
+		}
+		const long long num_vertices = vertex_offsets.back();
+		const long long num_triangles = triangle_offsets.back();
+		if (num_vertices == 0 || num_triangles == 0 || num_vertices * 3 > INT_MAX || num_triangles * 3 > INT_MAX) {
+			std::cerr << " The given file did not produce a valid mesh " << std::endl;
+			throw HF::Exceptions::InvalidOBJ();
+		}
+
+		// Parse every chunk directly into the mesh's buffers
+		MeshInfo<float> mesh(static_cast<int>(num_vertices), static_cast<int>(num_triangles), 0, "EntireFile");
+		float* vertices = mesh.GetVertexPointer().data;
+		int* indices = mesh.GetIndexPointer().data;
+
+		int num_failed = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+:num_failed) num_threads(lease.size())
+		for (int i = 0; i < num_chunks; i++) {
+			const bool parsed = ParseOBJChunk(
+				bounds[i], bounds[i + 1],
+				vertices + vertex_offsets[i] * 3,
+				indices + triangle_offsets[i] * 3,
+				vertex_offsets[i], scale
+			);
+			if (!parsed) num_failed++;
+		}
+
+		// Throw if any line was malformed or any face references a vertex that doesn't exist
+		const int num_indices = static_cast<int>(num_triangles * 3);
+		int num_out_of_range = 0;
+#pragma omp parallel for schedule(static) reduction(+:num_out_of_range) num_threads(lease.size())
+		for (int i = 0; i < num_indices; i++)
+			if (indices[i] < 0 || indices[i] >= num_vertices) num_out_of_range++;
+
+		if (num_failed > 0 || num_out_of_range > 0) {
+			std::cerr << " The given file did not produce a valid mesh " << std::endl;
+			throw HF::Exceptions::InvalidOBJ();
+		}
+
+		if (change_coords) mesh.ConvertToRhinoCoordinates();
+		return mesh;
+	}
+}
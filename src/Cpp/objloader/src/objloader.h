@@ -212,6 +212,41 @@ namespace HF::Geometry{
 		int scale = 1
 	);
 
+	/// <summary> Load all of the geometry in the OBJ at path as a single mesh, using every core. </summary>
+	/// <param name="path"> Path to the OBJ to load.</param>
+	/// <param name="change_coords"> Rotate the mesh from Y-up to Z-up. </param>
+	/// <param name="scale"> Scaling factor to use for the imported mesh. </param>
+	/// <returns> A single mesh containing every face in the file. </returns>
+	/*!
+		\exception HF::Exceptions::InvalidOBJ The file at path was not a valid OBJ file.
+		\exception HF::Exceptions::FileNotFound No file could be found at path.
+
+		\details
+		A faster alternative to LoadMeshObjects with GROUP_METHOD::ONLY_FILE for very large files.
+		The file is mapped into memory and split into chunks of lines that are parsed in parallel.
+		A first pass counts the vertices and triangles in each chunk so the final buffers of the mesh
+		can be allocated up front, then a second pass parses every chunk directly into its place in
+		those buffers. No copy of the file or of the geometry is ever made.
+
+		Only vertices (`v`) and faces (`f`) are read. Every other statement, including groups,
+		materials, normals and texture coordinates, is ignored.
+
+		\remarks
+		Faces with more than three vertices are triangulated as a fan around their first vertex.
+		This matches LoadMeshObjects for triangles and convex polygons, but may produce different
+		triangles for concave polygons.
+
+		\code
+			// be sure to #include "objloader.h"
+			HF::Geometry::MeshInfo<float> mesh = HF::Geometry::LoadMeshObjectsParallel("big_teapot.obj", true);
+		\endcode
+	*/
+	MeshInfo<float> LoadMeshObjectsParallel(
+		const std::string& path,
+		bool change_coords = false,
+		int scale = 1
+	);
+
 	/*!
 		\brief Load a list of vertices directly from an OBJ file.
 		
@@ -0,0 +1,336 @@
+///
+///	\file		ply_loader.cpp
+/// \brief		Contains implementation for loading binary PLY files into <see cref="HF::Geometry::MeshInfo">MeshInfo</see>
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <ply_loader.h>
+#include <mapped_file.h>
+#include <HFExceptions.h>
+#include <parallelism.h>
+#include <filesystem>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <omp.h>
+
+using std::vector;
+using std::string;
+
+namespace HF::Geometry {
+
+	/*! \brief Scalar types that properties in a PLY file can have. */
+	enum class PLY_TYPE { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+	/*! \brief A property of an element in a PLY file. */
+	struct PLYProperty {
+		string name;						///< Name of the property.
+		PLY_TYPE type;						///< Type of the property, or of each item if it's a list.
+		bool is_list = false;				///< Whether this property is a list of values.
+		PLY_TYPE count_type;				///< Type of the count before each list.
+	};
+
+	/*! \brief An element in a PLY file, such as vertex or face. */
+	struct PLYElement {
+		string name;						///< Name of the element.
+		long long count = 0;				///< Number of instances of this element in the file.
+		vector<PLYProperty> properties;		///< Properties of every instance, in order.
+	};
+
+	/*! \brief Get the PLY_TYPE for the name of a type in a PLY header. */
+	PLY_TYPE ParsePLYType(const string& name) {
+		if (name == "char" || name == "int8") return PLY_TYPE::INT8;
+		if (name == "uchar" || name == "uint8") return PLY_TYPE::UINT8;
+		if (name == "short" || name == "int16") return PLY_TYPE::INT16;
+		if (name == "ushort" || name == "uint16") return PLY_TYPE::UINT16;
+		if (name == "int" || name == "int32") return PLY_TYPE::INT32;
+		if (name == "uint" || name == "uint32") return PLY_TYPE::UINT32;
+		if (name == "float" || name == "float32") return PLY_TYPE::FLOAT32;
+		if (name == "double" || name == "float64") return PLY_TYPE::FLOAT64;
+		throw HF::Exceptions::InvalidOBJ();
+	}
+
+	/*! \brief Get the size of a PLY_TYPE in bytes. */
+	inline int SizeOf(PLY_TYPE type) {
+		switch (type) {
+		case PLY_TYPE::INT8: case PLY_TYPE::UINT8: return 1;
+		case PLY_TYPE::INT16: case PLY_TYPE::UINT16: return 2;
+		case PLY_TYPE::INT32: case PLY_TYPE::UINT32: case PLY_TYPE::FLOAT32: return 4;
+		default: return 8;
+		}
+	}
+
+	/*! \brief Read a value of type T from data, reversing its bytes if swap is true. */
+	template <typename T>
+	inline T ReadRaw(const char* data, bool swap) {
+		char bytes[sizeof(T)];
+		std::memcpy(bytes, data, sizeof(T));
+		if (swap) std::reverse(bytes, bytes + sizeof(T));
+
+		T value;
+		std::memcpy(&value, bytes, sizeof(T));
+		return value;
+	}
+
+	/*! \brief Read a value of any PLY_TYPE from data and convert it to a double. */
+	inline double ReadPLYValue(const char* data, PLY_TYPE type, bool swap) {
+		switch (type) {
+		case PLY_TYPE::INT8: return ReadRaw<int8_t>(data, swap);
+		case PLY_TYPE::UINT8: return ReadRaw<uint8_t>(data, swap);
+		case PLY_TYPE::INT16: return ReadRaw<int16_t>(data, swap);
+		case PLY_TYPE::UINT16: return ReadRaw<uint16_t>(data, swap);
+		case PLY_TYPE::INT32: return ReadRaw<int32_t>(data, swap);
+		case PLY_TYPE::UINT32: return ReadRaw<uint32_t>(data, swap);
+		case PLY_TYPE::FLOAT32: return ReadRaw<float>(data, swap);
+		default: return ReadRaw<double>(data, swap);
+		}
+	}
+
+	/*!
+		\brief Read the header of a PLY file.
+
+		\param data Start of the file.
+		\param size Size of the file in bytes.
+		\param out_elements Output parameter for every element declared in the header.
+		\param out_swap Output parameter set to true if the file's byte order is big endian.
+
+		\returns The offset of the first byte after the header.
+
+		\exception HF::Exceptions::InvalidOBJ The header is malformed, or the file isn't binary.
+	*/
+	size_t ReadPLYHeader(const char* data, size_t size, vector<PLYElement>& out_elements, bool& out_swap) {
+		// Find the end of the header
+		const char* end_marker = "end_header";
+		const char* header_end = std::search(data, data + size, end_marker, end_marker + std::strlen(end_marker));
+		if (header_end == data + size || size < 3 || std::strncmp(data, "ply", 3) != 0)
+			throw HF::Exceptions::InvalidOBJ();
+
+		const char* data_start = static_cast<const char*>(std::memchr(header_end, '\n', data + size - header_end));
+		if (data_start == nullptr) throw HF::Exceptions::InvalidOBJ();
+
+		// Read every line before end_header
+		std::istringstream header(string(data, header_end));
+		string line;
+		bool found_format = false;
+		while (std::getline(header, line)) {
+			std::istringstream tokens(line);
+			string keyword;
+			tokens >> keyword;
+
+			if (keyword == "format") {
+				string format;
+				tokens >> format;
+				// The host is little endian, so only big endian files need their bytes swapped
+				if (format == "binary_little_endian") out_swap = false;
+				else if (format == "binary_big_endian") out_swap = true;
+				else throw HF::Exceptions::InvalidOBJ();
+				found_format = true;
+			}
+			else if (keyword == "element") {
+				PLYElement element;
+				tokens >> element.name >> element.count;
+				if (tokens.fail() || element.count < 0) throw HF::Exceptions::InvalidOBJ();
+				out_elements.push_back(element);
+			}
+			else if (keyword == "property") {
+				if (out_elements.empty()) throw HF::Exceptions::InvalidOBJ();
+
+				PLYProperty property;
+				string type;
+				tokens >> type;
+				if (type == "list") {
+					string count_type;
+					tokens >> count_type >> type;
+					property.is_list = true;
+					property.count_type = ParsePLYType(count_type);
+				}
+				property.type = ParsePLYType(type);
+				tokens >> property.name;
+				out_elements.back().properties.push_back(property);
+			}
+		}
+
+		if (!found_format) throw HF::Exceptions::InvalidOBJ();
+		return data_start + 1 - data;
+	}
+
+	/*!
+		\brief Get the size of one instance of an element.
+
+		\returns The size in bytes, or -1 if the element contains a list and its size varies.
+	*/
+	int FixedElementSize(const PLYElement& element) {
+		int size = 0;
+		for (const auto& property : element.properties) {
+			if (property.is_list) return -1;
+			size += SizeOf(property.type);
+		}
+		return size;
+	}
+
+	/*!
+		\brief Find the end of one property of an element.
+
+		\param data Start of the property.
+		\param end End of the file.
+		\param property Property to read.
+		\param swap Whether to reverse the byte order of list counts.
+
+		\returns A pointer to the first byte after the property.
+
+		\exception HF::Exceptions::InvalidOBJ The property extends past the end of the file.
+	*/
+	inline const char* SkipProperty(const char* data, const char* end, const PLYProperty& property, bool swap) {
+		long long size = SizeOf(property.type);
+		if (property.is_list) {
+			if (end - data < SizeOf(property.count_type)) throw HF::Exceptions::InvalidOBJ();
+			const long long count = static_cast<long long>(ReadPLYValue(data, property.count_type, swap));
+			if (count < 0) throw HF::Exceptions::InvalidOBJ();
+			data += SizeOf(property.count_type);
+			size *= count;
+		}
+		if (end - data < size) throw HF::Exceptions::InvalidOBJ();
+		return data + size;
+	}
+
+	/*! \brief Find the end of one instance of an element. See SkipProperty. */
+	inline const char* SkipInstance(const char* data, const char* end, const PLYElement& element, bool swap) {
+		for (const auto& property : element.properties)
+			data = SkipProperty(data, end, property, swap);
+		return data;
+	}
+
+	MeshInfo<float> LoadPLY(const string& path, bool change_coords)
+	{
+		MappedFile file(path);
+		const char* data = file.Data();
+		const char* end = data + file.Size();
+		if (data == nullptr) throw HF::Exceptions::InvalidOBJ();
+
+		vector<PLYElement> elements;
+		bool swap = false;
+		const char* cursor = data + ReadPLYHeader(data, file.Size(), elements, swap);
+
+		const PLYElement* vertex_element = nullptr;
+		const char* vertex_data = nullptr;
+		const PLYElement* face_element = nullptr;
+		const char* face_data = nullptr;
+
+		// Find the start of the vertex and face elements, skipping over everything else
+		for (const auto& element : elements) {
+			const int fixed_size = FixedElementSize(element);
+
+			if (element.name == "vertex") {
+				vertex_element = &element;
+				vertex_data = cursor;
+			}
+			else if (element.name == "face") {
+				face_element = &element;
+				face_data = cursor;
+			}
+
+			if (fixed_size >= 0) {
+				if ((end - cursor) / std::max(fixed_size, 1) < element.count) throw HF::Exceptions::InvalidOBJ();
+				cursor += fixed_size * element.count;
+			}
+			else
+				for (long long i = 0; i < element.count; i++)
+					cursor = SkipInstance(cursor, end, element, swap);
+		}
+		if (vertex_element == nullptr || face_element == nullptr || face_element->count == 0)
+			throw HF::Exceptions::InvalidOBJ();
+
+		// Find the x, y and z coordinates of every vertex. Vertices must have a fixed size.
+		const int vertex_size = FixedElementSize(*vertex_element);
+		if (vertex_size < 0) throw HF::Exceptions::InvalidOBJ();
+
+		int coordinate_offsets[3] = { -1, -1, -1 };
+		PLY_TYPE coordinate_types[3];
+		int offset = 0;
+		for (const auto& property : vertex_element->properties) {
+			const int axis = property.name == "x" ? 0 : property.name == "y" ? 1 : property.name == "z" ? 2 : -1;
+			if (axis >= 0) {
+				coordinate_offsets[axis] = offset;
+				coordinate_types[axis] = property.type;
+			}
+			offset += SizeOf(property.type);
+		}
+		if (coordinate_offsets[0] < 0 || coordinate_offsets[1] < 0 || coordinate_offsets[2] < 0)
+			throw HF::Exceptions::InvalidOBJ();
+
+		// Find the list of vertex indices in every face
+		int index_property = -1;
+		for (int i = 0; i < face_element->properties.size(); i++) {
+			const auto& property = face_element->properties[i];
+			if (property.is_list && (property.name == "vertex_indices" || property.name == "vertex_index"))
+				index_property = i;
+		}
+		if (index_property < 0) throw HF::Exceptions::InvalidOBJ();
+		const PLYProperty& indices = face_element->properties[index_property];
+
+		// Call on_face with the number of indices and a pointer to the first index of every face
+		auto for_each_face = [&](auto on_face) {
+			const char* face = face_data;
+			for (long long f = 0; f < face_element->count; f++) {
+				const char* next = SkipInstance(face, end, *face_element, swap);
+
+				// Walk to the index list within this face
+				const char* property_data = face;
+				for (int p = 0; p < index_property; p++)
+					property_data = SkipProperty(property_data, end, face_element->properties[p], swap);
+				const int count = static_cast<int>(ReadPLYValue(property_data, indices.count_type, swap));
+				on_face(count, property_data + SizeOf(indices.count_type));
+
+				face = next;
+			}
+		};
+
+		// Count triangles so the mesh can be allocated once
+		long long num_triangles = 0;
+		for_each_face([&](int count, const char*) { if (count >= 3) num_triangles += count - 2; });
+
+		const long long num_vertices = vertex_element->count;
+		if (num_triangles == 0 || num_triangles > INT_MAX || num_vertices > INT_MAX)
+			throw HF::Exceptions::InvalidOBJ();
+
+		const string name = std::filesystem::path(path).stem().string();
+		MeshInfo<float> mesh(static_cast<int>(num_vertices), static_cast<int>(num_triangles), 0, name);
+
+		// Convert every vertex in parallel. Every vertex has the same size, so they can be read in any order.
+		float* out_vertices = mesh.GetVertexPointer().data;
+		const int vertex_count = static_cast<int>(num_vertices);
+		HF::Parallel::ThreadLease lease(-1, vertex_count);
+#pragma omp parallel for schedule(static) num_threads(lease.size())
+		for (int v = 0; v < vertex_count; v++) {
+			const char* vertex = vertex_data + static_cast<size_t>(v) * vertex_size;
+			for (int axis = 0; axis < 3; axis++)
+				out_vertices[3 * v + axis] = static_cast<float>(
+					ReadPLYValue(vertex + coordinate_offsets[axis], coordinate_types[axis], swap)
+				);
+		}
+
+		// Triangulate every face as a fan
+		int* out_indices = mesh.GetIndexPointer().data;
+		const int index_size = SizeOf(indices.type);
+		int cursor_index = 0;
+		for_each_face([&](int count, const char* face_indices) {
+			auto read_index = [&](int i) {
+				const long long index = static_cast<long long>(ReadPLYValue(face_indices + i * index_size, indices.type, swap));
+				if (index < 0 || index >= num_vertices) throw HF::Exceptions::InvalidOBJ();
+				return static_cast<int>(index);
+			};
+
+			for (int i = 1; i + 1 < count; i++) {
+				out_indices[cursor_index++] = read_index(0);
+				out_indices[cursor_index++] = read_index(i);
+				out_indices[cursor_index++] = read_index(i + 1);
+			}
+		});
+
+		if (change_coords) mesh.ConvertToRhinoCoordinates();
+		return mesh;
+	}
+}
@@ -0,0 +1,40 @@
+///
+///	\file		ply_loader.h
+/// \brief		Contains definitions for loading binary PLY files into <see cref="HF::Geometry::MeshInfo">MeshInfo</see>
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+#pragma once
+
+#include <string>
+#include <meshinfo.h>
+
+namespace HF::Geometry {
+
+	/// <summary> Load a binary PLY file into a single mesh. </summary>
+	/// <param name="path"> Path to the PLY file to load. </param>
+	/// <param name="change_coords"> Rotate the mesh from Y-up to Z-up. </param>
+	/// <returns> A mesh containing every face in the file, named after the file. </returns>
+	/*!
+		\exception HF::Exceptions::FileNotFound No file exists at path.
+		\exception HF::Exceptions::InvalidOBJ The file isn't a binary PLY file, is truncated, uses a
+		property type that doesn't exist, or contains no faces.
+
+		\details
+		The file is mapped into memory and its header is read to find the layout of the vertex and
+		face elements. Vertex coordinates are then converted straight from the file into the vertex
+		buffer of the mesh in parallel, and every face is triangulated as a fan directly into its
+		index buffer. Both `binary_little_endian` and `binary_big_endian` files are supported.
+		Properties other than the x, y and z coordinates of vertices and the vertex indices of faces
+		are skipped, as are any other elements.
+
+		\remarks ASCII PLY files aren't supported. Use an OBJ file instead.
+
+		\code
+			// be sure to #include "ply_loader.h"
+
+			HF::Geometry::MeshInfo<float> mesh = HF::Geometry::LoadPLY("model.ply");
+		\endcode
+	*/
+	MeshInfo<float> LoadPLY(const std::string& path, bool change_coords = false);
+}
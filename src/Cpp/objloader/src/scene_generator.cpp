@@ -0,0 +1,288 @@
+///
+///	\file		scene_generator.cpp
+/// \brief		Contains implementation for generating synthetic buildings as <see cref="HF::Geometry::MeshInfo">MeshInfo</see>
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <scene_generator.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using std::vector;
+
+namespace HF::Geometry {
+
+	constexpr float wall_thickness = 0.2f;		///< Thickness of every wall.
+	constexpr float slab_thickness = 0.2f;		///< Thickness of every floor and the roof.
+	constexpr float corridor_width = 3.0f;		///< Width of the corridor on every floor.
+	constexpr float door_width = 1.0f;			///< Width of every door.
+	constexpr float door_height = 2.1f;			///< Height of every door.
+	constexpr float stair_width = 1.2f;			///< Width of every flight of stairs.
+	constexpr float max_riser = 0.18f;			///< Maximum height of a single step.
+	constexpr float tread = 0.28f;				///< Depth of a single step.
+	constexpr float landing = 1.0f;				///< Clear floor between a flight of stairs and the end of the corridor.
+	constexpr float min_room_size = 3.0f;		///< Minimum width and depth of a room.
+	constexpr float clearance = 0.6f;			///< Minimum distance between an obstacle and the walls of its room.
+	constexpr float min_obstacle = 0.4f;		///< Minimum size of an obstacle on each axis.
+	constexpr float max_obstacle = 1.2f;		///< Maximum size of an obstacle on each axis.
+	constexpr float max_length = 10000.0f;		///< Maximum width, depth, and storey height, so step and room counts fit in an int.
+
+	/*! \brief Vertex and index buffers of a mesh being generated. */
+	struct MeshBuilder {
+		vector<float> vertices;		///< Every 3 floats is the x, y, and z of a vertex.
+		vector<int> indices;		///< Every 3 ints is a triangle.
+
+		/*! \brief Add a solid axis aligned box from min to max. Boxes with no volume are skipped. */
+		void AddBox(float x0, float y0, float z0, float x1, float y1, float z1) {
+			if (x1 <= x0 || y1 <= y0 || z1 <= z0) return;
+
+			// Corner i is at x1 if bit 0 is set, y1 if bit 1 is set, and z1 if bit 2 is set
+			const int first = static_cast<int>(vertices.size() / 3);
+			for (int i = 0; i < 8; i++) {
+				vertices.push_back(i & 1 ? x1 : x0);
+				vertices.push_back(i & 2 ? y1 : y0);
+				vertices.push_back(i & 4 ? z1 : z0);
+			}
+
+			// Two triangles per face, wound counter-clockwise when seen from outside of the box
+			constexpr int faces[36] = {
+				0, 2, 3, 0, 3, 1,	// -z
+				4, 5, 7, 4, 7, 6,	// +z
+				0, 1, 5, 0, 5, 4,	// -y
+				2, 6, 7, 2, 7, 3,	// +y
+				0, 4, 6, 0, 6, 2,	// -x
+				1, 3, 7, 1, 7, 5,	// +x
+			};
+			for (int corner : faces)
+				indices.push_back(first + corner);
+		}
+
+		/*!
+			\brief Add a wall from start to end along one axis, with a door centered on each of doors.
+
+			\param along_x True if the wall runs along the x axis, false if it runs along the y axis.
+			\param start Coordinate the wall starts at on the axis it runs along.
+			\param end Coordinate the wall ends at on the axis it runs along.
+			\param across Coordinate of the center of the wall on the other horizontal axis.
+			\param z0 Height of the bottom of the wall.
+			\param z1 Height of the top of the wall.
+			\param doors Centers of the doors along the wall, in ascending order.
+		*/
+		void AddWall(bool along_x, float start, float end, float across, float z0, float z1, const vector<float>& doors) {
+			auto add_section = [&](float a0, float a1, float bottom, float top) {
+				const float b0 = across - wall_thickness / 2.0f, b1 = across + wall_thickness / 2.0f;
+				if (along_x) AddBox(a0, b0, bottom, a1, b1, top);
+				else AddBox(b0, a0, bottom, b1, a1, top);
+			};
+
+			// Full height sections between doors, with a lintel above each door
+			float section_start = start;
+			for (float door : doors) {
+				add_section(section_start, door - door_width / 2.0f, z0, z1);
+				add_section(door - door_width / 2.0f, door + door_width / 2.0f, z0 + door_height, z1);
+				section_start = door + door_width / 2.0f;
+			}
+			add_section(section_start, end, z0, z1);
+		}
+
+		/*! \brief Add a slab covering x0 to x1 and y0 to y1, with an optional rectangular hole. */
+		void AddSlab(float x0, float y0, float x1, float y1, float z0, float z1, bool has_hole = false,
+			float hx0 = 0, float hy0 = 0, float hx1 = 0, float hy1 = 0)
+		{
+			if (!has_hole) {
+				AddBox(x0, y0, z0, x1, y1, z1);
+				return;
+			}
+
+			// Four strips around the hole
+			AddBox(x0, y0, z0, hx0, y1, z1);
+			AddBox(hx1, y0, z0, x1, y1, z1);
+			AddBox(hx0, y0, z0, hx1, hy0, z1);
+			AddBox(hx0, hy1, z0, hx1, y1, z1);
+		}
+	};
+
+	/*! \brief A rectangular room on a floor. */
+	struct Room {
+		float x0, y0, x1, y1;	///< Bounds of the room, measured to the centers of its walls.
+	};
+
+	/*!
+		\brief Get the number of steps in a flight of stairs climbing height.
+
+		\details Every step is the same height, and no higher than max_riser.
+	*/
+	static int NumSteps(float height) {
+		return static_cast<int>(std::ceil(height / max_riser - 1e-4f));
+	}
+
+	/*!
+		\brief Move a door centered at door until it's clear of every wall in walls, and keep it inside min to max.
+
+		\details
+		Used for doors between rows of rooms, since the rooms on one side of the wall may not line up
+		with the rooms on the other side.
+	*/
+	static float PlaceDoor(float door, const vector<float>& walls, float min, float max) {
+		const float clear = door_width / 2.0f + wall_thickness;
+		for (float wall : walls) {
+			if (std::abs(door - wall) >= clear) continue;
+			door = door >= wall ? wall + clear : wall - clear;
+		}
+		return std::clamp(door, min + clear, max - clear);
+	}
+
+	/*!
+		\brief Get a random number from 0 to 1 using generator.
+
+		\details
+		Unlike std::uniform_real_distribution, the result only depends on the output of the
+		generator, so buildings are the same on every platform.
+	*/
+	static float Random(std::mt19937& generator) {
+		return static_cast<float>(generator() >> 8) / 16777216.0f;
+	}
+
+	MeshInfo<float> GenerateBuilding(const BuildingParameters& params) {
+		if (params.floors < 1)
+			throw std::invalid_argument("A building needs at least 1 floor");
+		if (params.rooms_per_floor < 1)
+			throw std::invalid_argument("A building needs at least 1 room per floor");
+		if (!(params.obstacle_density >= 0.0f && params.obstacle_density <= 1.0f))
+			throw std::invalid_argument("Obstacle density must be between 0 and 1");
+
+		// Checked before any of the layout math, since NaN fails every comparison below it
+		for (float length : { params.width, params.depth, params.storey_height })
+			if (!std::isfinite(length) || length > max_length)
+				throw std::invalid_argument("Width, depth and storey height must be finite and no more than "
+					+ std::to_string(static_cast<int>(max_length)) + " meters");
+
+		if (params.storey_height - slab_thickness < door_height + 0.1f)
+			throw std::invalid_argument("Storeys are too short to fit a door");
+
+		const float W = params.width, D = params.depth, H = params.storey_height;
+		const bool has_stairs = params.stairs && params.floors > 1;
+
+		// Lay the rooms out in a grid of rows behind the corridor. Every row has the same number of
+		// rooms, except for the last row, which holds whatever is left over in wider rooms.
+		const float inner_x0 = wall_thickness, inner_x1 = W - wall_thickness;
+		const float rooms_y0 = wall_thickness + corridor_width, rooms_y1 = D - wall_thickness;
+		if (rooms_y1 - rooms_y0 < min_room_size || inner_x1 - inner_x0 < min_room_size)
+			throw std::invalid_argument("The building is too small to fit a corridor and rooms");
+
+		const int rooms = params.rooms_per_floor;
+		const float aspect = (inner_x1 - inner_x0) / (rooms_y1 - rooms_y0);
+		const int cols = std::clamp(static_cast<int>(std::lround(std::sqrt(rooms * aspect))), 1, rooms);
+		const int rows = (rooms + cols - 1) / cols;
+
+		const float room_width = (inner_x1 - inner_x0) / cols;
+		const float room_depth = (rooms_y1 - rooms_y0) / rows;
+		if (room_width < min_room_size || room_depth < min_room_size)
+			throw std::invalid_argument("The building is too small to fit " + std::to_string(rooms) + " rooms per floor");
+
+		vector<vector<Room>> grid(rows);
+		for (int r = 0; r < rows; r++) {
+			const int in_row = std::min(cols, rooms - r * cols);
+			const float width = (inner_x1 - inner_x0) / in_row;
+			for (int c = 0; c < in_row; c++) {
+				const float x0 = inner_x0 + c * width;
+				const float y0 = rooms_y0 + r * room_depth;
+				grid[r].push_back(Room{ x0, y0, x0 + width, y0 + room_depth });
+			}
+		}
+
+		// Stairs climb along the edge of the corridor, leaving the rest of it clear
+		const int steps = NumSteps(H);
+		const float run = steps * tread;
+		if (has_stairs && inner_x1 - inner_x0 < run + 2.0f * landing)
+			throw std::invalid_argument("The building is too narrow to fit a flight of stairs");
+
+		const float stair_y0 = wall_thickness, stair_y1 = wall_thickness + stair_width;
+		auto stair_start = [&](int floor) {
+			// Flights alternate between climbing towards +x and towards -x
+			return floor % 2 == 0 ? inner_x0 + landing : inner_x1 - landing - run;
+		};
+
+		MeshBuilder mesh;
+		std::mt19937 generator(params.seed);
+
+		// Every floor, then the roof. Each floor but the ground floor has a hole for the stairs below it.
+		for (int floor = 0; floor <= params.floors; floor++) {
+			const float top = floor * H;
+			const bool has_hole = has_stairs && floor > 0 && floor < params.floors;
+			const float hole_x0 = has_hole ? stair_start(floor - 1) : 0.0f;
+			mesh.AddSlab(0.0f, 0.0f, W, D, top - slab_thickness, top,
+				has_hole, hole_x0, stair_y0, hole_x0 + run, stair_y1);
+		}
+
+		for (int floor = 0; floor < params.floors; floor++) {
+			const float z0 = floor * H, z1 = (floor + 1) * H - slab_thickness;
+			const float half = wall_thickness / 2.0f;
+
+			// Exterior walls
+			mesh.AddWall(true, 0.0f, W, half, z0, z1, {});
+			mesh.AddWall(true, 0.0f, W, D - half, z0, z1, {});
+			mesh.AddWall(false, 0.0f, D, half, z0, z1, {});
+			mesh.AddWall(false, 0.0f, D, W - half, z0, z1, {});
+
+			for (int r = 0; r < rows; r++) {
+				const auto& row = grid[r];
+
+				// The wall in front of this row, with a door into each room. Doors are kept clear of
+				// the walls between the rooms of the row in front.
+				vector<float> front_walls;
+				if (r > 0)
+					for (size_t c = 1; c < grid[r - 1].size(); c++)
+						front_walls.push_back(grid[r - 1][c].x0);
+
+				vector<float> doors;
+				for (const auto& room : row)
+					doors.push_back(PlaceDoor((room.x0 + room.x1) / 2.0f, front_walls, room.x0, room.x1));
+				mesh.AddWall(true, inner_x0, inner_x1, row.front().y0, z0, z1, doors);
+
+				// Walls between neighboring rooms, each with a door in the middle
+				for (size_t c = 1; c < row.size(); c++) {
+					const auto& room = row[c];
+					mesh.AddWall(false, room.y0, room.y1, room.x0, z0, z1, { (room.y0 + room.y1) / 2.0f });
+				}
+
+				// Obstacles, kept clear of the walls
+				for (const auto& room : row) {
+					const float ox0 = room.x0 + half + clearance, ox1 = room.x1 - half - clearance;
+					const float oy0 = room.y0 + half + clearance, oy1 = room.y1 - half - clearance;
+					const float target = params.obstacle_density * (ox1 - ox0) * (oy1 - oy0);
+
+					float covered = 0.0f;
+					while (covered < target) {
+						const float sx = std::min(min_obstacle + Random(generator) * (max_obstacle - min_obstacle), ox1 - ox0);
+						const float sy = std::min(min_obstacle + Random(generator) * (max_obstacle - min_obstacle), oy1 - oy0);
+						const float sz = min_obstacle + Random(generator) * (max_obstacle - min_obstacle);
+						const float x = ox0 + Random(generator) * (ox1 - ox0 - sx);
+						const float y = oy0 + Random(generator) * (oy1 - oy0 - sy);
+
+						mesh.AddBox(x, y, z0, x + sx, y + sy, z0 + sz);
+						covered += sx * sy;
+					}
+				}
+			}
+
+			// A flight of stairs up to the next floor. Each step is solid down to the floor, and the
+			// top step is flush with the floor above.
+			if (has_stairs && floor < params.floors - 1) {
+				const float x0 = stair_start(floor);
+				const float riser = H / steps;
+				for (int i = 0; i < steps; i++) {
+					const int position = floor % 2 == 0 ? i : steps - 1 - i;
+					const float step_x = x0 + position * tread;
+					mesh.AddBox(step_x, stair_y0, z0, step_x + tread, stair_y1, z0 + (i + 1) * riser);
+				}
+			}
+		}
+
+		return MeshInfo<float>(mesh.vertices, mesh.indices, 0, "building");
+	}
+}
@@ -0,0 +1,69 @@
+///
+///	\file		scene_generator.h
+/// \brief		Contains definitions for generating synthetic buildings as <see cref="HF::Geometry::MeshInfo">MeshInfo</see>
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+#pragma once
+
+#include <cstdint>
+#include <meshinfo.h>
+
+namespace HF::Geometry {
+
+	/*!
+		\brief Parameters of a building created by GenerateBuilding.
+
+		\details All lengths are in meters.
+	*/
+	struct BuildingParameters {
+		int floors = 2;						///< Number of storeys. Must be at least 1.
+		float width = 20.0f;				///< Length of the building along the x axis.
+		float depth = 12.0f;				///< Length of the building along the y axis.
+		float storey_height = 3.0f;			///< Distance from the top of one floor to the top of the next.
+		int rooms_per_floor = 4;			///< Number of rooms on every floor. Must be at least 1.
+		bool stairs = true;					///< Connect every floor to the one above it with a flight of stairs.
+		float obstacle_density = 0.1f;		///< Fraction of each room's floor covered by obstacles, from 0 to 1.
+		uint32_t seed = 0;					///< Seed for the placement of obstacles.
+	};
+
+	/*!
+		\brief Generate a multi-storey building as a single mesh.
+
+		\param params Size and layout of the building.
+
+		\returns A z-up mesh of the building, named "building", with one corner of its ground floor at the origin.
+
+		\exception std::invalid_argument
+		floors or rooms_per_floor is less than 1, obstacle_density isn't between 0 and 1, width,
+		depth or storey_height isn't finite or is more than 10000 meters, storey_height is too short
+		for a door, or the building is too small to fit its corridor, rooms or stairs.
+
+		\details
+		Every floor has a 3 meter corridor along its y = 0 side, and the rest of the floor is divided
+		into a grid of rooms_per_floor rooms. Every room has a door to the corridor or to the room
+		between it and the corridor, and a door to each of its neighbors in the same row. If stairs is
+		true, a flight of stairs runs along the corridor of every floor but the top one, through a
+		hole in the floor above it, alternating ends of the corridor so the flights don't overlap.
+		Obstacles are boxes between 0.4 and 1.2 meters on each side, kept at least 0.6 meters from the
+		walls of their room so they never block a door.
+
+		Every part of the building is a solid box, so the mesh can be used with any analysis. The
+		same parameters always produce the same mesh, which makes buildings suitable for measuring
+		how the library scales with the size of a model.
+
+		\code
+			// be sure to #include "scene_generator.h"
+
+			HF::Geometry::BuildingParameters params;
+			params.floors = 5;
+			params.width = 60.0f;
+			params.depth = 30.0f;
+			params.rooms_per_floor = 24;
+			params.obstacle_density = 0.2f;
+
+			HF::Geometry::MeshInfo<float> building = HF::Geometry::GenerateBuilding(params);
+		\endcode
+	*/
+	MeshInfo<float> GenerateBuilding(const BuildingParameters& params);
+}
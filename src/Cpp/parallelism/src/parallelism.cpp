@@ -0,0 +1,96 @@
+///
+/// \file		parallelism.cpp
+/// \brief		Contains implementation for the <see cref="HF::Parallel">Parallel</see> namespace
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <parallelism.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace HF::Parallel {
+
+	/// Count set by SetThreadCount, or 0 if it hasn't been set.
+	static std::atomic<int> configured_threads{ 0 };
+
+	/// Number of threads currently reserved by every lease in the process.
+	static std::atomic<int> leased_threads{ 0 };
+
+	/// Number of leases currently taking threads from the budget.
+	static std::atomic<int> active_leases{ 0 };
+
+	/// Count set by the innermost ThreadCountOverride on this thread, or 0 if there isn't one.
+	static thread_local int override_threads = 0;
+
+	/// Size of the outermost lease held by this thread, or 0 if it doesn't hold one.
+	static thread_local int held_threads = 0;
+
+	void SetThreadCount(int threads) {
+		configured_threads.store(std::max(threads, 0));
+	}
+
+	int GetThreadCount() {
+		const int configured = configured_threads.load();
+		if (configured > 0) return configured;
+
+		// hardware_concurrency may return 0 if it can't be determined
+		return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+
+	std::string EmbreeDeviceConfig() {
+		const int configured = configured_threads.load();
+		return configured > 0 ? "threads=" + std::to_string(configured) : "";
+	}
+
+	ThreadCountOverride::ThreadCountOverride(int threads) : previous(override_threads) {
+		override_threads = std::max(threads, 0);
+	}
+
+	ThreadCountOverride::~ThreadCountOverride() {
+		override_threads = previous;
+	}
+
+	ThreadLease::ThreadLease(int requested, int64_t work_items) {
+		// Use the first source of a thread count that was set
+		int wanted = requested > 0 ? requested
+			: override_threads > 0 ? override_threads
+			: GetThreadCount();
+
+		// Never start more threads than there is work for
+		if (work_items >= 0)
+			wanted = static_cast<int>(std::min<int64_t>(wanted, std::max<int64_t>(work_items, 1)));
+
+		// Nested leases share the threads of the outer lease
+		if (held_threads > 0) {
+			count = std::max(1, std::min(wanted, held_threads));
+			return;
+		}
+
+		// Take as many of the wanted threads as are left in the budget, but never less than an
+		// even split of the budget between every active lease
+		const int budget = GetThreadCount();
+		const int sharers = active_leases.fetch_add(1) + 1;
+		const int fair_share = std::max(1, budget / sharers);
+
+		int leased = leased_threads.load();
+		int granted = 1;
+		do {
+			granted = std::min(wanted, std::max(fair_share, budget - leased));
+		} while (!leased_threads.compare_exchange_weak(leased, leased + granted));
+
+		count = granted;
+		owner = true;
+		held_threads = count;
+	}
+
+	ThreadLease::~ThreadLease() {
+		if (!owner) return;
+
+		leased_threads.fetch_sub(count);
+		active_leases.fetch_sub(1);
+		held_threads = 0;
+	}
+}
@@ -0,0 +1,138 @@
+///
+///	\file		parallelism.h
+/// \brief		Contains definitions for the <see cref="HF::Parallel">Parallel</see> namespace
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*!
+	\brief Control how many threads the library uses.
+
+	\details
+	Every OpenMP parallel region in DHARTAPI sizes itself through a ThreadLease instead of changing
+	OpenMP's thread count with omp_set_num_threads. That setting belongs to the calling thread and
+	was changed from several places, so one function could leave another running with the wrong
+	number of threads. A lease passes its size to the region's num_threads clause instead, and
+	nothing global is changed. Bundled third party code, such as nanort, is not covered.
+
+	The number of threads a region uses is the first of these that is set:
+	1) The cores argument of the function, for functions that have one.
+	2) A ThreadCountOverride on the calling thread.
+	3) The library-wide count from SetThreadCount().
+	4) The number of hardware threads on the machine.
+
+	Leases are taken from a budget of GetThreadCount() threads shared by every thread that calls into
+	the library, so analyses running side by side split the machine between them instead of each
+	starting a full set of threads. Embree builds its BVHs on its own TBB threads, so raytracers
+	created after SetThreadCount() is called limit Embree to the same number of threads.
+*/
+namespace HF::Parallel {
+
+	/*!
+		\brief Set the maximum number of threads the library may use at once.
+
+		\param threads Number of threads. If less than 1, every hardware thread is used.
+
+		\remarks Only affects parallel regions and raytracers started after this is called.
+	*/
+	void SetThreadCount(int threads);
+
+	/*!
+		\brief Get the maximum number of threads the library may use at once.
+
+		\returns The count set by SetThreadCount, or the number of hardware threads if it wasn't set.
+	*/
+	int GetThreadCount();
+
+	/*!
+		\brief Get the configuration string to create an Embree device with.
+
+		\returns "threads=N" if SetThreadCount was given a count, otherwise an empty string so Embree
+		uses every hardware thread.
+	*/
+	std::string EmbreeDeviceConfig();
+
+	/*!
+		\brief Change the number of threads used by calls made from the current thread while in scope.
+
+		\details
+		Useful for limiting functions that don't have a cores argument. Overrides can be nested, and
+		the previous count is restored when an override is destroyed.
+
+		\code
+			// be sure to #include "parallelism.h"
+
+			{
+				HF::Parallel::ThreadCountOverride limit(2);
+				auto results = HF::ViewAnalysis::SphericalViewAnalysis<RayResult>(ert, nodes, 1000);
+			}
+		\endcode
+	*/
+	class ThreadCountOverride {
+		int previous;	///< Override that was active before this one, or 0 if there wasn't one.
+
+	public:
+		/*! \brief Use threads threads for calls from this thread. Values less than 1 remove the override. */
+		ThreadCountOverride(int threads);
+
+		/*! \brief Restore the override that was active before this one. */
+		~ThreadCountOverride();
+
+		ThreadCountOverride(const ThreadCountOverride&) = delete;
+		ThreadCountOverride& operator=(const ThreadCountOverride&) = delete;
+	};
+
+	/*!
+		\brief Threads reserved from the library-wide budget for a single parallel region.
+
+		\details
+		A lease is sized from the sources listed in HF::Parallel, reduced so it never has more threads
+		than items of work, then reduced again to the threads left in the budget. When fewer threads
+		are left than an even split of the budget between every active lease, the lease takes its
+		even split instead, so an analysis started while another holds most of the budget isn't left
+		with a single thread. The process may then run more threads than the budget until the
+		earlier leases end. A lease always has at least one thread, so work is never blocked waiting
+		for another analysis to finish. The threads are returned to the budget when the lease is
+		destroyed.
+
+		A lease created on a thread that already holds one reuses the outer lease's threads, since
+		that thread's parallel regions can't run at the same time.
+
+		\code
+			// be sure to #include "parallelism.h"
+
+			HF::Parallel::ThreadLease lease(cores, nodes.size());
+			#pragma omp parallel for num_threads(lease.size())
+			for (int i = 0; i < nodes.size(); i++)
+				...
+		\endcode
+	*/
+	class ThreadLease {
+		int count = 1;			///< Number of threads reserved.
+		bool owner = false;		///< True if this lease took its threads from the budget.
+
+	public:
+		/*!
+			\brief Reserve threads for a parallel region.
+
+			\param requested Number of threads the caller asked for. Less than 1 uses the default.
+			\param work_items Number of items of work the region will split between its threads.
+			Less than 0 if unknown.
+		*/
+		ThreadLease(int requested = -1, int64_t work_items = -1);
+
+		/*! \brief Return the reserved threads to the budget. */
+		~ThreadLease();
+
+		ThreadLease(const ThreadLease&) = delete;
+		ThreadLease& operator=(const ThreadLease&) = delete;
+
+		/*! \brief Get the number of threads reserved for the region. */
+		inline int size() const { return count; }
+	};
+}
@@ -24,6 +24,9 @@
 
 #include <boost_graph.h>
 #include <path.h>
+#include <cancellation.h>
+#include <parallelism.h>
+#include <tracing.h>
 
 using namespace HF::SpatialStructures;
 using namespace HF::Pathfinding;
@@ -165,6 +168,8 @@ namespace HF::Pathfinding {
 
 	Path FindPath(BoostGraph* bg, int start_id, int end_id)
 	{
+		HF::Tracing::ScopedTimer timer(HF::Tracing::PATHFINDING);
+
 		// Get a reference to the graph contained by this boost graph
 		const graph_t& graph = bg->g;
 		
@@ -177,6 +182,8 @@ namespace HF::Pathfinding {
 
 	vector<Path> FindPaths( BoostGraph * bg, const vector<int> & start_points, const vector<int> & end_points)
 	{
+		HF::Tracing::ScopedTimer timer(HF::Tracing::PATHFINDING);
+
 		// Get the graph from bg
 		const graph_t& graph = bg->g;
 		vector<Path> paths(start_points.size());
@@ -204,16 +211,19 @@ namespace HF::Pathfinding {
 		const std::vector<int>& end_points,
 		HF::SpatialStructures::Path** out_paths,
 		HF::SpatialStructures::PathMember** out_path_members,
-		int* out_sizes
+		int* out_sizes,
+		HF::Exceptions::CancellationToken* token
 	) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::PATHFINDING);
+
 		// Get graph from boost graph
 		const graph_t& graph = bg->g;
 		robin_hood::unordered_map<int, DistPred> dpm;
 
-		// Use maximum number of cores for this machine
-		int core_count = std::thread::hardware_concurrency();
-		int cores_to_use = std::min(core_count-1, static_cast<int>(start_points.size()));
-		omp_set_num_threads(cores_to_use);
+		// Reserve threads for the paths. If only a few are available, running in parallel
+		// costs more than it saves, so both loops below run serially.
+		HF::Parallel::ThreadLease lease(-1, start_points.size());
+		const int cores_to_use = lease.size();
 
 		// Copy and sort the input array of starting points
 		std::vector<int> start_copy = start_points;
@@ -228,17 +238,31 @@ namespace HF::Pathfinding {
 		for (auto uc : unique_starts)
 			dpm.emplace(std::pair<int, DistPred>{uc, DistPred()});
 
+		if (token) token->AddWork(unique_starts.size() + start_points.size());
+
 		// Build predecessor and distance matrices for each unique start point in parallel
-	#pragma omp parallel for schedule(dynamic) if (unique_starts.size() > cores_to_use && cores_to_use > 4)
+	#pragma omp parallel for schedule(dynamic) if (unique_starts.size() > cores_to_use && cores_to_use > 4) num_threads(cores_to_use)
 		for (int i = 0; i < unique_starts.size(); i++) {
+			if (token && token->IsCancelled()) continue;
+
 			int start_point = unique_starts[i];
 			dpm[start_point] = BuildDistanceAndPredecessor(graph, start_point);
+
+			if (token) token->Advance();
 		}
 
 		// Create paths in parallel.
-#pragma omp parallel for schedule(dynamic) if (cores_to_use > 4)
+#pragma omp parallel for schedule(dynamic) if (cores_to_use > 4) num_threads(cores_to_use)
 		for (int i = 0; i < start_points.size(); i++) {
 
+			// Leave skipped paths empty once cancelled so they're safe to clean up below
+			if (token && token->IsCancelled()) {
+				out_paths[i] = nullptr;
+				out_path_members[i] = nullptr;
+				out_sizes[i] = 0;
+				continue;
+			}
+
 			// Get the start and end point for this path
 			int start = start_points[i];
 			int end = end_points[i];
@@ -261,20 +285,39 @@ namespace HF::Pathfinding {
 				delete (out_paths[i]);
 				out_paths[i] = nullptr;
 			}
+
+			if (token) token->Advance();
+		}
+
+		// The caller never receives the results of a cancelled search, so delete the paths
+		// that were finished before it was cancelled.
+		if (token && token->IsCancelled()) {
+			for (int i = 0; i < start_points.size(); i++) {
+				delete out_paths[i];
+				out_paths[i] = nullptr;
+				out_path_members[i] = nullptr;
+				out_sizes[i] = 0;
+			}
+			token->ThrowIfCancelled();
 		}
 	}
 
-	DistanceAndPredecessor GenerateDistanceAndPred(const BoostGraph& bg)
+	DistanceAndPredecessor GenerateDistanceAndPred(const BoostGraph& bg, HF::Exceptions::CancellationToken* token)
 	{
+		HF::Tracing::ScopedTimer timer(HF::Tracing::PATHFINDING);
+
 		const auto & g = bg.g;
 
 		// Generate distance and predecessor matricies
 		const int num_nodes = bg.p.size();
 		DistanceAndPredecessor out_distpred(num_nodes);
+		if (token) token->AddWork(num_nodes);
 		
 		// Iterate through every row in the array
-		#pragma omp parallel for schedule(dynamic)
+		HF::Parallel::ThreadLease lease(-1, num_nodes);
+		#pragma omp parallel for schedule(dynamic) num_threads(lease.size())
 		for (int row = 0; row < num_nodes; row++) {
+			if (token && token->IsCancelled()) continue;
 	
 			// Get pointers to the beginning of the row for both matricies
 			float* dist_row_start = out_distpred.GetRowOfDist(row);
@@ -311,6 +354,15 @@ namespace HF::Pathfinding {
 					dist_element = -1;
 				}
 			}
+
+			if (token) token->Advance();
+		}
+
+		// Nobody owns the matricies until they're returned, so delete them here if cancelled
+		if (token && token->IsCancelled()) {
+			delete out_distpred.dist;
+			delete out_distpred.pred;
+			token->ThrowIfCancelled();
 		}
 
 		return out_distpred;
@@ -326,7 +378,9 @@ namespace HF::Pathfinding {
 		delete bg;
 	}
 
-	void InsertAllToAllPathsIntoArray(BoostGraph* bg, Path** out_paths, PathMember** out_path_members, int* out_sizes) {
+	void InsertAllToAllPathsIntoArray(BoostGraph* bg, Path** out_paths, PathMember** out_path_members, int* out_sizes, HF::Exceptions::CancellationToken* token) {
+		HF::Tracing::ScopedTimer timer(HF::Tracing::PATHFINDING);
+
 		size_t node_count = bg->p.size();
 		size_t max_path = node_count * node_count;
 
@@ -368,6 +422,6 @@ namespace HF::Pathfinding {
 		*/
 
 		// Run InsertPathsIntoArray and mutate out_paths, out_path_members, and out_sizes
-		InsertPathsIntoArray(bg, start_points, end_points, out_paths, out_path_members, out_sizes);
+		InsertPathsIntoArray(bg, start_points, end_points, out_paths, out_path_members, out_sizes, token);
 	}
 }
@@ -19,6 +19,9 @@ namespace HF {
 		class Path;
 		class PathMember;
 	}
+	namespace Exceptions {
+		class CancellationToken;
+	}
 
 	/*! 
 		\brief Algorithms to find the shortest path between nodes in a HF::SpatialStructures::Graph. 
@@ -333,6 +336,11 @@ namespace HF {
 			be generated will be left as null pointers. 
 			\param out_sizes Output raw_array of integers that will contain the length of every path in path_members.
 			Paths that could not be generated will be left with a length of zero.
+			\param token Token to cancel the search and report its progress through. May be nullptr. Progress is
+			reported once for every unique start point, then once for every path.
+			
+			\exception HF::Exceptions::OperationCancelled token was cancelled before every path was generated. Every
+			path generated before then is deleted, and every element of the output arrays is set to nullptr or zero.
 			
 			\pre
 			The length of start_ids must match the length of end_ids.
@@ -394,7 +402,8 @@ namespace HF {
 			const std::vector<int>& end_points,
 			HF::SpatialStructures::Path** out_paths,
 			HF::SpatialStructures::PathMember** out_path_members,
-			int* out_sizes
+			int* out_sizes,
+			HF::Exceptions::CancellationToken* token = nullptr
 		);
 
 		/*! \brief Holds and maintains a distance and predecessor matrix
@@ -462,9 +471,14 @@ namespace HF {
 			\brief Generate the distance and predecessor matricies for a specific boost graph.
 
 			\param bg Boost graph to generate the matricies from
+			\param token Token to cancel the calculation and report its progress through. May be nullptr. Progress
+			is reported once for every row of the matricies.
 
 			\returns A DistanceAndPredecessor containing pointers to the new distance and predecessor matricies 
 
+			\exception HF::Exceptions::OperationCancelled token was cancelled before every row was calculated. Both
+			matricies are deleted before this is thrown.
+
 			\warning 
 			It is up to the caller to deallocate both arrays. This is mostly for the C_Interface, and as such ignores
 			the safety that most other functions adhere to. It is the caller's responsibility to deallocate both arrays
@@ -477,7 +491,7 @@ namespace HF {
 			`[0, 0, 0, 1, 1, 0, -1, -1, 2]`
 		
 		*/
-		DistanceAndPredecessor GenerateDistanceAndPred(const BoostGraph& bg);
+		DistanceAndPredecessor GenerateDistanceAndPred(const BoostGraph& bg, HF::Exceptions::CancellationToken* token = nullptr);
 			
 		/*!
 			\brief A special version of FindPaths optimized for the C_Interface, such that all paths possible
@@ -491,6 +505,9 @@ namespace HF {
 			be generated will be left as null pointers.
 			\param out_sizes Output raw_array of integers that will cntain the length of every path in path_members.
 			Paths that could not be generated will be left with a length of zero.
+			\param token Token to cancel the search and report its progress through. May be nullptr.
+
+			\exception HF::Exceptions::OperationCancelled token was cancelled. See InsertPathsIntoArray.
 
 			\pre
 			The length of start_ids must match the length of end_ids.
@@ -613,7 +630,13 @@ namespace HF {
 				}
 			\endcode
 		*/
-		void InsertAllToAllPathsIntoArray(BoostGraph* bg, HF::SpatialStructures::Path** out_paths, HF::SpatialStructures::PathMember** out_path_members, int* out_sizes);
+		void InsertAllToAllPathsIntoArray(
+			BoostGraph* bg,
+			HF::SpatialStructures::Path** out_paths,
+			HF::SpatialStructures::PathMember** out_path_members,
+			int* out_sizes,
+			HF::Exceptions::CancellationToken* token = nullptr
+		);
 	}
 }
 
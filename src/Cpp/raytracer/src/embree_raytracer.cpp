@@ -11,10 +11,15 @@
 #include <iostream>
 #include <thread>
 #include <robin_hood.h>
+#include <cstdint>
+#include <cstring>
 
 #include <meshinfo.h>
+#include <mesh_cache.h>
 #include <RayRequest.h>
 #include <HFExceptions.h>
+#include <parallelism.h>
+#include <tracing.h>
 
 using std::vector;
 
@@ -126,43 +131,6 @@ namespace HF::RayTracer {
 		}
 	}
 
-	/// <summary>
-	/// Package raw arrays of floats and indices in buffers to the required Embree types.
-	/// </summary>
-	/// <param name="in_vertices">
-	/// An array of floats in which every 3 floats represents a vertex.
-	/// </param>
-	/// <param name="in_indices">
-	/// An array of integers in which every 3 integers represents a triangle.
-	/// </param>
-	/// <param name="out_vertices"> Output array for vertexes.</param>
-	/// <param name="out_triangles"> Output array for triangles.</param>
-	/// \todo May be faster as a std::move or std::copy.
-	inline void buffersToStructs(
-		std::vector<float>& in_vertices,
-		std::vector<int>& in_indices,
-		std::vector<Vertex>& out_vertices,
-		std::vector<Triangle>& out_triangles
-	) {
-		out_vertices.resize(in_vertices.size() / 3);
-		for (int i = 0; i < in_vertices.size(); i += 3) {
-			out_vertices[i / 3] = Vertex{
-				in_vertices[i],
-				in_vertices[i + 1],
-				in_vertices[i + 2]
-			};
-		}
-
-		out_triangles.resize(in_indices.size() / 3);
-		for (int i = 0; i < in_indices.size(); i += 3) {
-			out_triangles[i / 3] = Triangle{
-				in_indices[i],
-				in_indices[i + 1],
-				in_indices[i + 2]
-			};
-		}
-	}
-
 	EmbreeRayTracer::EmbreeRayTracer(bool use_precise)
 	{
 		this->use_precise = false;
@@ -188,7 +156,8 @@ namespace HF::RayTracer {
 	}
 
 	void EmbreeRayTracer::SetupScene() {
-		device = rtcNewDevice("");
+		// Limit Embree's TBB threads to the library's thread count when one was set
+		device = rtcNewDevice(HF::Parallel::EmbreeDeviceConfig().c_str());
 		scene = rtcNewScene(device);
 		rtcSetSceneBuildQuality(scene, RTC_BUILD_QUALITY_HIGH);
 		rtcSetSceneFlags(scene, RTC_SCENE_FLAG_ROBUST);
@@ -203,6 +172,7 @@ namespace HF::RayTracer {
 		context = ERT2.context;
 		scene = ERT2.scene;
 		geometry = ERT2.geometry;
+		shared_buffers = ERT2.shared_buffers;
 
 		// Increment embree's internal refrence counter.
 		rtcRetainScene(scene);
@@ -372,18 +342,81 @@ namespace HF::RayTracer {
 		return geom;
 	}
 
+	/*!
+		\brief Check if the last vertex of an array can be read with a 16 byte load.
+
+		\details
+		A 16 byte load starting at the last vertex reads 4 bytes past the end of the array. If
+		the array doesn't end on a 16 byte boundary, those bytes are in the same 16 byte block as the
+		end of the array, and therefore in the same page, so reading them can't fault.
+	*/
+	inline bool CanReadPastLastVertex(const float* vertices, int num_vertices) {
+		const auto end = reinterpret_cast<std::uintptr_t>(vertices + 3 * static_cast<size_t>(num_vertices));
+		return end % 16 != 0;
+	}
+
+	RTCGeometry EmbreeRayTracer::ConstructGeometryFromArrays(
+		const float* vertices,
+		int num_vertices,
+		const int* indices,
+		int num_triangles,
+		bool share,
+		bool padded,
+		const std::array<float, 16>* transform
+	) {
+		RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+
+		// Hand the index buffer to embree directly, or copy it into a new one
+		if (share)
+			rtcSetSharedGeometryBuffer(
+				geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3,
+				indices, 0, sizeof(Triangle), num_triangles
+			);
+		else {
+			void* index_buffer = rtcSetNewGeometryBuffer(
+				geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3,
+				sizeof(Triangle), num_triangles + 1
+			);
+			std::memcpy(index_buffer, indices, num_triangles * sizeof(Triangle));
+		}
+
+		// Only share vertices if embree can safely read past the last one, and doesn't need to transform them
+		if (share && !transform && (padded || CanReadPastLastVertex(vertices, num_vertices)))
+			rtcSetSharedGeometryBuffer(
+				geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
+				vertices, 0, sizeof(Vertex), num_vertices
+			);
+		else {
+			void* vertex_buffer = rtcSetNewGeometryBuffer(
+				geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
+				sizeof(Vertex), num_vertices + 1
+			);
+			if (transform)
+				HF::Geometry::TransformVertices(vertices, static_cast<float*>(vertex_buffer), num_vertices, *transform);
+			else
+				std::memcpy(vertex_buffer, vertices, num_vertices * sizeof(Vertex));
+		}
+
+		// Add a reference to this geometry to internal array of geometry.
+		geometry.push_back(geom);
+
+		// Commit this geometry to finalize the process then return
+		rtcCommitGeometry(geom);
+
+		return geom;
+	}
+
 	bool EmbreeRayTracer::AddMesh(HF::Geometry::MeshInfo<float>& Mesh, bool Commit) {
 
 		if (Mesh.NumTris() < 1 || Mesh.NumVerts() < 1) 
 			throw HF::Exceptions::InvalidOBJ();
-		// Get vertex and triangle data from the mesh
 
-		std::vector<Triangle> tris;	std::vector<Vertex> verts;
-		auto indices = Mesh.getRawIndices(); auto vertices = Mesh.GetIndexedVertices();
-		buffersToStructs(vertices, indices, verts, tris);
-
-		// Construct geometry using embree
-		auto geom = ConstructGeometryFromBuffers(tris, verts);
+		// Apply any transforms that were deferred until now, then copy vertex and
+		// triangle data straight from the mesh's buffers into embree
+		Mesh.ApplyPendingTransform();
+		const auto vertices = Mesh.GetVertexPointer();
+		const auto indices = Mesh.GetIndexPointer();
+		auto geom = ConstructGeometryFromArrays(vertices.data, Mesh.NumVerts(), indices.data, Mesh.NumTris(), false);
 
 		// Add the Mesh to the scene and update it's ID
 		Mesh.meshid = InsertGeom(geom, Mesh.meshid);
@@ -395,6 +428,52 @@ namespace HF::RayTracer {
 		return true;
 	}
 
+	int EmbreeRayTracer::AddSharedMesh(std::shared_ptr<const HF::Geometry::MeshInfo<float>> Mesh, bool Commit) {
+
+		if (Mesh->NumTris() < 1 || Mesh->NumVerts() < 1)
+			throw HF::Exceptions::InvalidOBJ();
+
+		// Register the mesh's own buffers with embree, and keep the mesh alive for as long as they're in use
+		const auto vertices = Mesh->GetVertexPointer();
+		const auto indices = Mesh->GetIndexPointer();
+		const auto transform = Mesh->GetPendingTransform();
+		auto geom = ConstructGeometryFromArrays(
+			vertices.data, Mesh->NumVerts(), indices.data, Mesh->NumTris(), true, false,
+			Mesh->HasPendingTransform() ? &transform : nullptr
+		);
+		shared_buffers.push_back(Mesh);
+
+		int id = InsertGeom(geom, Mesh->GetMeshID());
+
+		if (Commit)
+			rtcCommitScene(scene);
+
+		return id;
+	}
+
+	vector<int> EmbreeRayTracer::AddSharedMeshes(std::shared_ptr<const HF::Geometry::MeshCache> Cache, bool Commit)
+	{
+		const auto& meshes = Cache->Meshes();
+		for (const auto& mesh : meshes)
+			if (mesh.num_triangles < 1 || mesh.num_vertices < 1)
+				throw HF::Exceptions::InvalidOBJ();
+
+		// Point embree directly into the mapped file. MeshCache ensures the index array of every
+		// mesh comes after its vertex array, so it's always safe to read past the end of one.
+		vector<int> ids;
+		ids.reserve(meshes.size());
+		for (const auto& mesh : meshes) {
+			auto geom = ConstructGeometryFromArrays(mesh.vertices, mesh.num_vertices, mesh.indices, mesh.num_triangles, true, true);
+			ids.push_back(InsertGeom(geom, mesh.id));
+		}
+		shared_buffers.push_back(Cache);
+
+		if (Commit)
+			rtcCommitScene(scene);
+
+		return ids;
+	}
+
 	bool EmbreeRayTracer::AddMesh(std::vector<HF::Geometry::MeshInfo<float>>& Meshes, bool Commit)
 	{
 		// Add every mesh in a loop
@@ -485,10 +564,11 @@ namespace HF::RayTracer {
 		int mesh_id
 	) {
 		std::vector<char> out_results(origins.size());
+		HF::Parallel::ThreadLease lease(use_parallel ? -1 : 1, max(origins.size(), directions.size()));
 
 		// Allow users to shoot multiple rays with a single direction or origin
 		if (origins.size() > 1 && directions.size() > 1) {
-#pragma omp parallel for if(use_parallel) schedule(dynamic)
+#pragma omp parallel for if(use_parallel) schedule(dynamic) num_threads(lease.size())
 			for (int i = 0; i < origins.size(); i++) {
 				auto& org = origins[i];
 				auto& dir = directions[i];
@@ -502,7 +582,7 @@ namespace HF::RayTracer {
 
 		else if (origins.size() > 1 && directions.size() == 1) {
 			const auto& dir = directions[0];
-#pragma omp parallel for if(use_parallel) schedule(dynamic)
+#pragma omp parallel for if(use_parallel) schedule(dynamic) num_threads(lease.size())
 			for (int i = 0; i < origins.size(); i++) {
 				auto& org = origins[i];
 				out_results[i] = PointIntersection(
@@ -515,7 +595,7 @@ namespace HF::RayTracer {
 
 		else if (origins.size() == 1 && directions.size() > 1) {
 			out_results.resize(directions.size());
-#pragma omp parallel for if(use_parallel) schedule(dynamic)
+#pragma omp parallel for if(use_parallel) schedule(dynamic) num_threads(lease.size())
 			for (int i = 0; i < directions.size(); i++) {
 				auto org = origins[0];
 				auto& dir = directions[i];
@@ -547,6 +627,7 @@ namespace HF::RayTracer {
 	{
 		RTCRayHit hit = ConstructHit(x, y, z, dx, dy, dz);
 
+		HF::Tracing::Count(HF::Tracing::INTERSECTION_RAYS);
 		rtcIntersect1(scene, &context, &hit);
 
 		return hit;
@@ -557,7 +638,7 @@ namespace HF::RayTracer {
 		const std::array<float, 3>& direction,
 		float max_dist
 	) {
-		return Occluded_IMPL(origin[0], origin[1], origin[2], direction[0], direction[1], direction[2]);
+		return Occluded_IMPL(origin[0], origin[1], origin[2], direction[0], direction[1], direction[2], max_dist);
 	}
 
 	std::vector<char> EmbreeRayTracer::Occlusions(
@@ -566,15 +647,13 @@ namespace HF::RayTracer {
 		float max_distance, bool use_parallel)
 	{
 		std::vector<char> out_array;
-		int cores = static_cast<int> (std::thread::hardware_concurrency());
-		if (origins.size() < cores || directions.size() < cores)
-			// Don't use more cores than there are rays. This caused a hard to find bug earlier.
-			// Doesn't seem to happen with the other ray types. (race condition?)
-			omp_set_num_threads(min(max(origins.size(), directions.size()), cores));
+
+		// Don't start more threads than there are rays
+		HF::Parallel::ThreadLease lease(use_parallel ? -1 : 1, max(origins.size(), directions.size()));
 
 		if (directions.size() > 1 && origins.size() > 1) {
 			out_array.resize(origins.size());
-#pragma omp parallel for if(use_parallel) schedule(dynamic, 128)
+#pragma omp parallel for if(use_parallel) schedule(dynamic, 128) num_threads(lease.size())
 			for (int i = 0; i < origins.size(); i++) {
 				out_array[i] = Occluded_IMPL(
 					origins[i][0], origins[i][1], origins[i][2],
@@ -587,7 +666,7 @@ namespace HF::RayTracer {
 			out_array.resize(directions.size());
 			const auto& origin = origins[0];
 			printf("Using multidirection, single origin\n");
-#pragma omp parallel for if(use_parallel) schedule(dynamic, 128)
+#pragma omp parallel for if(use_parallel) schedule(dynamic, 128) num_threads(lease.size())
 			for (int i = 0; i < directions.size(); i++) {
 				const auto& direction = directions[i];
 				out_array[i] = Occluded_IMPL(
@@ -606,7 +685,7 @@ namespace HF::RayTracer {
 			const auto& direction = directions[0];
 
 			// Use chunk size of 256 for reducing parallel overhead
-		#pragma omp parallel for if(use_parallel) schedule(dynamic, 256)
+		#pragma omp parallel for if(use_parallel) schedule(dynamic, 256) num_threads(lease.size())
 			for (int i = 0; i < origins.size(); i++) {
 				const auto& origin = origins[i];
 				out_array[i] = Occluded_IMPL(origin[0], origin[1], origin[2], 
@@ -624,6 +703,8 @@ namespace HF::RayTracer {
 	bool EmbreeRayTracer::Occluded_IMPL(float x, float y, float z, float dx, float dy, float dz, float distance, int mesh_id)
 	{
 		auto ray = ConstructRay(x, y, z, dx, dy, dz, distance);
+
+		HF::Tracing::Count(HF::Tracing::OCCLUSION_RAYS);
 		rtcOccluded1(scene, &context, &ray);
 		return ray.tfar == -INFINITY;
 	}
@@ -636,6 +717,7 @@ namespace HF::RayTracer {
 		context = ERT2.context;
 		scene = ERT2.scene;
 		geometry = ERT2.geometry;
+		shared_buffers = ERT2.shared_buffers;
 
 		rtcRetainScene(scene);
 		rtcRetainDevice(device);
@@ -15,11 +15,14 @@
 #include <corecrt_math_defines.h>
 #include <vector>
 #include <array>
+#include <memory>
 #include <HitStruct.h>
+#include <parallelism.h>
 #define _USE_MATH_DEFINES
 
 namespace HF::Geometry {
 	template <typename T> class MeshInfo;
+	class MeshCache;
 }
 
 /*!
@@ -93,6 +96,10 @@ namespace HF::RayTracer {
 
 		std::vector<RTCGeometry> geometry; //> A list of the geometry being used by RTCScene.
 
+		/// Owners of memory that Embree reads directly through shared geometry buffers. Kept alive until
+		/// every copy of this raytracer is destroyed.
+		std::vector<std::shared_ptr<const void>> shared_buffers;
+
 	private:
 		/*! \brief Performs all the necessary operations to set up the scene.
 
@@ -378,6 +385,39 @@ namespace HF::RayTracer {
 		*/
 		RTCGeometry ConstructGeometryFromBuffers(std::vector<Triangle>& tris, std::vector<Vertex>& verts);
 
+		/*!
+			\brief Create a new instance of RTCGeometry from flat vertex and index arrays.
+
+			\param vertices x, y, z coordinates of every vertex.
+			\param num_vertices Number of vertices in vertices.
+			\param indices Indices of the three vertices of every triangle.
+			\param num_triangles Number of triangles in indices.
+			\param share If true, Embree reads indices and vertices in place instead of copying them.
+			\param padded If true, vertices is known to be followed by at least 4 readable bytes.
+			\param transform If not null, a row-major affine transform to apply to vertices while they're
+			copied into Embree. Vertices are never shared if this is set.
+
+			\returns Committed Geometry containing the specified triangles and vertices.
+
+			\pre If share is true, indices and vertices must outlive the geometry. Add their
+			owner to shared_buffers.
+
+			\details
+			Embree reads every vertex with a 16 byte load, so the last vertex of a shared vertex array
+			must be followed by 4 readable bytes. If padded is false and this can't be guaranteed from
+			the address of the array, the vertices are copied into a padded buffer owned by Embree, and
+			only the indices are shared.
+		*/
+		RTCGeometry ConstructGeometryFromArrays(
+			const float* vertices,
+			int num_vertices,
+			const int* indices,
+			int num_triangles,
+			bool share,
+			bool padded = false,
+			const std::array<float, 16>* transform = nullptr
+		);
+
 	public:
 		/*!
 			\brief Construct an empty EmbreeRayTracer;
@@ -544,6 +584,9 @@ namespace HF::RayTracer {
 		/// </exception>
 
 		/*!
+			\details Any transform queued on Mesh with HF::Geometry::MeshInfo::QueueTransform is applied
+			to it before its vertices are copied.
+
 			\code
 				// Requires #include "embree_raytracer.h", #include "objloader.h"
 
@@ -642,6 +685,71 @@ namespace HF::RayTracer {
 */
 		bool AddMesh(std::vector<HF::Geometry::MeshInfo<float>>& Meshes, bool Commit = true);
 
+		/*!
+			\brief Add a mesh to the BVH without copying its vertices or indices.
+
+			\param Mesh Mesh to add. This raytracer keeps a reference to it until it's destroyed.
+			\param Commit Whether or not to commit changes to the scene after the mesh has been added.
+
+			\returns The ID assigned to the mesh. This is the ID of Mesh unless another mesh
+			in the BVH already has that ID.
+
+			\exception HF::Exceptions::InvalidOBJ Mesh has no vertices or triangles.
+
+			\details
+			The vertex and index buffers of Mesh are registered with Embree as shared buffers, so the
+			BVH is built directly from them, and the only copy of the mesh is the one in Mesh. This
+			raytracer and all of its copies share ownership of Mesh, so it's safe for the caller to
+			release its own reference.
+
+			\warning Mesh must not be modified after it's added, since Embree reads its buffers directly.
+
+			\remarks
+			If the vertex buffer of Mesh ends on a 16 byte boundary, Embree's vector loads could read
+			past the end of it, so its vertices are copied instead. Vertices are also copied if Mesh
+			has a pending transform, which is applied to the copy. Indices are always shared.
+
+			\code
+				// Requires #include "embree_raytracer.h", #include "objloader.h", #include <memory>
+
+				auto mesh = std::make_shared<const HF::Geometry::MeshInfo<float>>(
+					HF::Geometry::LoadMeshObjects("teapot.obj", HF::Geometry::ONLY_FILE)[0]
+				);
+
+				HF::RayTracer::EmbreeRayTracer ert;
+				int id = ert.AddSharedMesh(mesh, true);
+			\endcode
+		*/
+		int AddSharedMesh(std::shared_ptr<const HF::Geometry::MeshInfo<float>> Mesh, bool Commit = false);
+
+		/*!
+			\brief Add every mesh in a mapped mesh cache to the BVH without copying them.
+
+			\param Cache Mesh cache to add meshes from. This raytracer keeps a reference to it until
+			it's destroyed.
+			\param Commit Whether or not to commit changes to the scene after all meshes have been added.
+
+			\returns The ID assigned to every mesh in the cache, in the order of Cache->Meshes().
+
+			\exception HF::Exceptions::InvalidOBJ A mesh in the cache has no vertices or triangles.
+
+			\details
+			Every vertex and index array is handed to Embree as a shared buffer pointing directly
+			into the mapped file, so the meshes are never copied into memory at all. The operating
+			system pages them in as the BVH is built. Vertex arrays in a cache are always followed by
+			an index array, so they're always safe for Embree to read.
+
+			\code
+				// Requires #include "embree_raytracer.h", #include "mesh_cache.h", #include <memory>
+
+				auto cache = std::make_shared<const HF::Geometry::MeshCache>("teapot.obj.dhmesh");
+
+				HF::RayTracer::EmbreeRayTracer ert;
+				std::vector<int> ids = ert.AddSharedMeshes(cache);
+			\endcode
+		*/
+		std::vector<int> AddSharedMeshes(std::shared_ptr<const HF::Geometry::MeshCache> Cache, bool Commit = true);
+
 		/// <summary>
 		/// Cast a ray and overwrite the origin with the hitpoint if it intersects any geometry.
 		/// </summary>
@@ -1148,7 +1256,8 @@ namespace HF::RayTracer {
 
 			std::vector<HitStruct<return_type>> results (nodes.size());
 
-			#pragma omp parallel for schedule(dynamic, 256) if (use_parallel)
+			HF::Parallel::ThreadLease lease(use_parallel ? -1 : 1, n);
+			#pragma omp parallel for schedule(dynamic, 256) if (use_parallel) num_threads(lease.size())
 			for (int i = 0; i < n; i++) {// Use custom triangle intesection if required
 				const auto& node = nodes[i];
 				const auto& direction = directions[i];
@@ -31,7 +31,7 @@ namespace HF::SpatialStructures::CostAlgorithms {
 		return radians * (180 / M_PI);
 	}
 
-	double CalculateSlope(Node& parent, Node& child)
+	double CalculateSlope(const Node& parent, const Node& child)
 	{
 		// Calculates the Slope between two nodes as an angle in degrees.
 		// This could be split into two functions later since the first commented part is simply rise/run
@@ -93,6 +93,26 @@ namespace HF::SpatialStructures::CostAlgorithms {
 		
 	}
 
+	double CalculateEnergyExpenditure(const Node& parent, const Node& child) {
+		const auto magnitude = parent.distanceTo(child);
+		const double slope = CalculateSlope(parent, child);
+
+		const double g = std::clamp(std::tan(to_radians(slope)), -0.4, 0.4);
+
+		auto e = 280.5
+			* (std::pow(g, 5)) - 58.7
+			* (std::pow(g, 4)) - 76.8
+			* (std::pow(g, 3)) + 51.9
+			* (std::pow(g, 2)) + 19.6
+			* (g) + 2.5;
+
+		// You cannot gain energy. This indicates a programmer error. 
+		assert(e >= 0);
+
+		// Scale by the length of the edge
+		return e * magnitude;
+	}
+
 	EdgeSet CalculateEnergyExpenditure(const Subgraph& sg) {
 		// Energy expenditure data will be stored here and returned from this function.
 		std::vector<EdgeSet> edge_set;
@@ -107,44 +127,8 @@ namespace HF::SpatialStructures::CostAlgorithms {
 		auto it_children = children.begin();
 
 		for (Edge link_a : edge_list) {
-			// Retrieve vector components of the vector formed by
-			// parent_node and link_a
-
-			const auto dir = parent_node.directionTo(link_a.child);
-			const auto magnitude = parent_node.distanceTo(link_a.child);
-
-			//
-			//	Angle formula in R3 is:
-			//	acos(dot_product(vector_U, vector_V) / magnitude(vector_U) * magnitude(vector_V));
-			//
-			//	vector_V will be a unit vector i, j, or k for x, y, and z axes respectively.
-			//	Therefore, we simplify these angle formulas to:
-			//	acos(component_value / magnitude(vector_U))
-			//	component_value will be dir[0], dir[1], or dir[2] for x, y, or z components respectively.
-			//
-			//auto angle_x_axis = to_degrees(std::acos(dir[0] / magnitude));
-			//auto angle_y_axis = to_degrees(std::acos(dir[1] / magnitude));
-			//auto angle_z_axis = to_degrees(std::acos(dir[2] / magnitude));
-
-			//auto angle = angle_y_axis;
-			//auto slope = std::clamp(std::tanf(angle), -0.4f, -0.4f);
-
-			const double slope = CalculateSlope(parent_node, link_a.child);
-			
-			const double g = std::clamp(std::tan(to_radians(slope)), -0.4, 0.4);
-
-			auto e = 280.5
-				* (std::pow(g, 5)) - 58.7
-				* (std::pow(g, 4)) - 76.8
-				* (std::pow(g, 3)) + 51.9
-				* (std::pow(g, 2)) + 19.6
-				* (g) + 2.5;
-
-			// You cannot gain energy. This indicates a programmer error. 
-			assert(e >= 0);
-
 			// Calculate the new score/distance for the IntEdge
-			double expenditure = e * magnitude;
+			const double expenditure = CalculateEnergyExpenditure(parent_node, link_a.child);
 
 			// Create the resulting IntEdge from the current child ID and calculation
 			IntEdge ie = { link_a.child.id, static_cast<float>(expenditure) }; 
@@ -456,7 +456,30 @@ namespace HF::SpatialStructures::CostAlgorithms {
 		\param child A Node
 		\returns A double of the Angle
 	*/
-	double CalculateSlope(Node& parent, Node& child);
+	double CalculateSlope(const Node& parent, const Node& child);
+
+	/*!
+		\summary Calculates the energy expended traversing a single edge from parent to child
+		\param parent The node the edge starts at
+		\param child The node the edge ends at
+		\returns The energy expenditure of the edge
+
+		\details
+		This is the cost of every edge produced by CalculateEnergyExpenditure. It's exposed separately so
+		edges can be costed as soon as they're created, such as by the GraphGenerator, without building
+		a Subgraph for every node afterwards.
+
+		\code
+			// For brevity
+			using HF::SpatialStructures::CostAlgorithms::CalculateEnergyExpenditure;
+
+			Node parent(0, 0, 0);
+			Node child(1, 0, 0.1);
+
+			double energy = CalculateEnergyExpenditure(parent, child);
+		\endcode
+	*/
+	double CalculateEnergyExpenditure(const Node& parent, const Node& child);
 }
 
 #endif /// COST_ALGORITHMS_H
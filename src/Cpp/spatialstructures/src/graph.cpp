@@ -13,6 +13,7 @@
 #include <Constants.h>
 #include <cassert>
 #include <HFExceptions.h>
+#include <tracing.h>
 #include <numeric>
 #include <iostream>
 #include <charconv>
@@ -118,6 +119,45 @@ namespace HF::SpatialStructures {
 			return GetCostForSet(this->GetCostArray(cost_type), parent_id, child_id);
 	}
 
+	bool Graph::HasStepTypes() const {
+		return !this->step_types.empty() || !this->triplet_steps.empty();
+	}
+
+	STEP Graph::GetStepType(int parent_id, int child_id) const {
+		if (this->needs_compression || !this->new_step_edges.empty())
+			throw std::logic_error("Graph must be compressed to read step types");
+
+		if (this->step_types.empty()) return STEP::NOT_CONNECTED;
+
+		const int index = FindValueArrayIndex(parent_id, child_id);
+		if (index < 0) return STEP::NOT_CONNECTED;
+		else return static_cast<STEP>(this->step_types[index]);
+	}
+
+	const std::vector<uint8_t>& Graph::GetStepTypes() {
+		Compress();
+		return this->step_types;
+	}
+
+	void Graph::CreateStepCost(const std::string& cost_type, const std::array<float, 5>& step_multipliers) {
+		if (IsDefaultName(cost_type))
+			throw std::logic_error("Tried to create cost array with the graph's default name");
+
+		Compress();
+		if (this->step_types.empty())
+			throw std::logic_error("Tried to create a step cost for a graph without step types");
+
+		// Replace any existing cost array with this name
+		if (HasCostArray(cost_type))
+			ClearCostArrays(cost_type);
+
+		// Step types are in the same order as the default costs, so this doesn't need to look up any edges
+		auto& cost_set = CreateCostArray(cost_type);
+		const float* values = edge_matrix.valuePtr();
+		for (int i = 0; i < this->step_types.size(); i++)
+			cost_set[i] = values[i] * step_multipliers[this->step_types[i]];
+	}
+
 	void Graph::ClearCostArrays(const std::string& cost_name)
 	{
 		// Delete them all if this is the default name
@@ -837,6 +877,48 @@ namespace HF::SpatialStructures {
 		// ![GetOrAssignID_Node]
 	}
 
+	void Graph::addEdge(const Node& parent, const Node& child, float score, STEP step)
+	{
+		const int parent_id = getOrAssignID(parent);
+		const int child_id = getOrAssignID(child);
+
+		InsertOrUpdateEdge(parent_id, child_id, score, "");
+		SetStepType(parent_id, child_id, step);
+	}
+
+	void Graph::addEdge(int parent_id, int child_id, float score, STEP step)
+	{
+		getOrAssignID(child_id);
+		getOrAssignID(parent_id);
+
+		InsertOrUpdateEdge(parent_id, child_id, score, "");
+		SetStepType(parent_id, child_id, step);
+	}
+
+	void Graph::SetStepType(int parent_id, int child_id, STEP step) {
+		if (this->needs_compression) {
+			// Edges added without a step are padded with NOT_CONNECTED
+			triplet_steps.resize(triplets.size(), STEP::NOT_CONNECTED);
+			triplet_steps.back() = step;
+		}
+		else if (!new_step_edges.empty())
+			// The indices of step_types are out of date until the next Compress()
+			step_changes.emplace_back(parent_id, child_id, step);
+		else {
+			// Indices into step_types only match the CSR's values when it has no gaps
+			if (!edge_matrix.isCompressed())
+				edge_matrix.makeCompressed();
+
+			const int nnz = edge_matrix.nonZeros();
+			if (step_types.size() != nnz)
+				step_types.assign(nnz, STEP::NOT_CONNECTED);
+
+			const int index = FindValueArrayIndex(parent_id, child_id);
+			if (index >= 0 && index < nnz)
+				step_types[index] = step;
+		}
+	}
+
 	void Graph::addEdge(int parent_id, int child_id, float score, const string & cost_type)
 	{
 		// ![GetOrAssignID_int]
@@ -884,6 +966,11 @@ namespace HF::SpatialStructures {
 			// Reallocate if we must, then insert. 
 			ResizeIfNeeded();
 			edge_matrix.insert(parent_index, child_index) = cost;
+
+			// The new edge shifts the CSR's values, so its step is kept aside until the next
+			// Compress() instead of moving every other step now
+			if (!step_types.empty())
+				new_step_edges.emplace_back(parent_index, child_index);
 		}
 	}
 
@@ -975,6 +1062,8 @@ namespace HF::SpatialStructures {
 
 	inline int Graph::getOrAssignID(const Node& input_node)
 	{
+		HF::Tracing::Count(HF::Tracing::HASH_PROBES);
+
 		// If it's already in the hashmap, then just return the existing ID
 		if (hasKey(input_node))
 			return getID(input_node);
@@ -1060,6 +1149,36 @@ namespace HF::SpatialStructures {
 		needs_compression = false;
 	}
 
+	Graph::Graph(
+		const vector<int>& outer_indices,
+		const vector<int>& inner_indices,
+		const vector<float>& values,
+		const vector<Node>& Nodes,
+		const std::string& default_cost
+	) {
+		this->default_cost = default_cost;
+
+		const int n = Nodes.size();
+		assert(outer_indices.size() == n + 1);
+		assert(inner_indices.size() == values.size());
+
+		// Add every node to our dictionary/ordered_node list
+		for (const auto& node : Nodes)
+			getOrAssignID(node);
+
+		// Map the input arrays, then copy them straight into the edge matrix
+		const TempMatrix input_csr(
+			n, n,
+			static_cast<int>(values.size()),
+			outer_indices.data(),
+			inner_indices.data(),
+			values.data()
+		);
+		edge_matrix = input_csr;
+
+		needs_compression = false;
+	}
+
 	Graph::Graph(const std::string & default_cost_name)
 	{
 		// Assign default cost type, and create an edge matrix.
@@ -1098,6 +1217,7 @@ namespace HF::SpatialStructures {
 
 		// Only do this if the graph needs compression.
 		if (needs_compression) {
+			HF::Tracing::ScopedTimer timer(HF::Tracing::COMPRESS_GRAPH);
 
 			// If this has cost arrays then we never should have come here
 			assert(!this->has_cost_arrays); 
@@ -1111,9 +1231,96 @@ namespace HF::SpatialStructures {
 			// Set the edge matrix from triplets.
 			edge_matrix.setFromTriplets(triplets.begin(), triplets.end());
 
+			// Move the step of every triplet to its edge's index in the CSR. Triplets added
+			// without a step don't overwrite the step of an earlier triplet for the same edge.
+			if (!triplet_steps.empty()) {
+				triplet_steps.resize(triplets.size(), STEP::NOT_CONNECTED);
+				step_types.assign(edge_matrix.nonZeros(), STEP::NOT_CONNECTED);
+
+				for (int i = 0; i < triplets.size(); i++)
+					if (triplet_steps[i] != STEP::NOT_CONNECTED)
+						step_types[FindValueArrayIndex(triplets[i].row(), triplets[i].col())] = triplet_steps[i];
+
+				std::vector<uint8_t>().swap(triplet_steps);
+			}
+
 			// Mark this graph as not requiring compression
 			needs_compression = false;
 		}
+
+		LayOutNewEdgeSteps();
+	}
+
+	void Graph::LayOutNewEdgeSteps() {
+		if (new_step_edges.empty()) return;
+
+		// Inserting leaves gaps in the CSR, which step_types can't have
+		edge_matrix.makeCompressed();
+
+		// Order the new edges the same way as the CSR
+		std::sort(new_step_edges.begin(), new_step_edges.end());
+
+		// Walk the CSR in order, taking each step from the old step types unless the edge is new
+		std::vector<uint8_t> merged_steps(edge_matrix.nonZeros(), STEP::NOT_CONNECTED);
+		const int* outer_index_ptr = edge_matrix.outerIndexPtr();
+		const int* inner_index_ptr = edge_matrix.innerIndexPtr();
+		int old_index = 0;
+		int new_index = 0;
+		for (int row = 0; row < edge_matrix.outerSize(); row++) {
+			for (int i = outer_index_ptr[row]; i < outer_index_ptr[row + 1]; i++) {
+				if (new_index < new_step_edges.size() && new_step_edges[new_index] == std::make_pair(row, inner_index_ptr[i]))
+					new_index++;
+				else
+					merged_steps[i] = step_types[old_index++];
+			}
+		}
+
+		step_types.swap(merged_steps);
+		std::vector<std::pair<int, int>>().swap(new_step_edges);
+
+		// Apply every step set since the edges were added, in the order they were set
+		for (const auto& change : step_changes)
+			step_types[FindValueArrayIndex(change.row(), change.col())] = change.value();
+		std::vector<Eigen::Triplet<uint8_t>>().swap(step_changes);
+	}
+
+	void Graph::CompressWithCosts(const vector<string>& cost_types, const vector<vector<float>>& costs) {
+		if (!needs_compression)
+			throw std::logic_error("Tried to compress a graph with costs that was already compressed");
+		if (cost_types.size() != costs.size())
+			throw std::invalid_argument("Every cost type needs a cost array");
+		for (const auto& cost_type : cost_types)
+			if (IsDefaultName(cost_type))
+				throw std::logic_error("Tried to create cost array with the graph's default name");
+		for (const auto& cost_array : costs)
+			if (cost_array.size() != triplets.size())
+				throw std::invalid_argument("Every cost array needs a cost for every edge in the graph");
+
+		Compress();
+		if (this->size() < 1) return;
+
+		vector<Eigen::Triplet<float>> cost_triplets(triplets.size());
+		for (int i = 0; i < cost_types.size(); i++) {
+			// Copy the default cost's edges with this cost's values
+			const auto& cost_array = costs[i];
+			for (int j = 0; j < triplets.size(); j++)
+				cost_triplets[j] = Eigen::Triplet<float>(triplets[j].row(), triplets[j].col(), cost_array[j]);
+
+			// The same edges in the same order produce the same CSR, so the values of
+			// this matrix are at the same indices as the default cost's.
+			EdgeMatrix cost_matrix(edge_matrix.rows(), edge_matrix.cols());
+			cost_matrix.setFromTriplets(cost_triplets.begin(), cost_triplets.end());
+			assert(cost_matrix.nonZeros() == edge_matrix.nonZeros());
+
+			// Replace any existing cost array with this name
+			if (HasCostArray(cost_types[i]))
+				ClearCostArrays(cost_types[i]);
+
+			auto& cost_set = CreateCostArray(cost_types[i]);
+			const float* values = cost_matrix.valuePtr();
+			for (int j = 0; j < cost_matrix.nonZeros(); j++)
+				cost_set[j] = values[j];
+		}
 	}
 
 	void Graph::Clear() {
@@ -1121,6 +1328,10 @@ namespace HF::SpatialStructures {
 		edge_matrix.data().squeeze();
 		triplets.clear();
 		needs_compression = true;
+		triplet_steps.clear();
+		step_types.clear();
+		new_step_edges.clear();
+		step_changes.clear();
 
 		// Other graph representations should be cleared too
 		ordered_nodes.clear();
@@ -1206,6 +1417,8 @@ namespace HF::SpatialStructures {
 		return cost_types;
 	}
 
+	const std::string& Graph::GetDefaultCostName() const { return this->default_cost; }
+
 	std::vector<Node> Graph::GetChildren(const Node& n) const {
 		std::vector<Node> children;
 
@@ -1361,6 +1574,15 @@ namespace HF::SpatialStructures {
 		return out_attributes;
 	}
 
+	vector<string> Graph::GetNodeAttributeTypes() const
+	{
+		vector<string> attribute_types;
+		for (const auto& it : this->node_attr_map)
+			attribute_types.push_back(it.first);
+
+		return attribute_types;
+	}
+
 	void Graph::ClearNodeAttributes(std::string name) {
 		/* // requires #include <algorithm>, but not working?
 		std::string lower_cased =
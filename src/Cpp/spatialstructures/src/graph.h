@@ -8,6 +8,8 @@
 #pragma once
 
 #include <robin_hood.h>
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <Edge.h>
 #include <Node.h>
@@ -496,6 +498,11 @@ namespace HF::SpatialStructures {
 		std::vector<Eigen::Triplet<float>> triplets;	///< Edges to be converted to a CSR when Graph::Compress() is called.
 		bool needs_compression = true;					///< If true, the CSR is inaccurate and requires compression.
 
+		std::vector<uint8_t> triplet_steps;				///< STEP of each triplet. Empty unless an edge was added with a STEP.
+		std::vector<uint8_t> step_types;				///< STEP of every edge, in the same order as the CSR's values. Empty unless an edge was added with a STEP.
+		std::vector<std::pair<int, int>> new_step_edges;	///< Parent and child of each edge added to the CSR since step_types was laid out. Merged into step_types by Graph::Compress().
+		std::vector<Eigen::Triplet<uint8_t>> step_changes;	///< Steps set while new_step_edges wasn't empty. Applied in order by Graph::Compress().
+
 		robin_hood::unordered_map<std::string, NodeAttributeValueMap> node_attr_map; ///< Node attribute type : Map of node id to node attribute
 
 		std::string active_cost_type;								///< The active edge matrix to use for the graph
@@ -773,6 +780,32 @@ namespace HF::SpatialStructures {
 		*/
 		void InsertOrUpdateEdge(int parent_id, int child_id, float score, const std::string& cost_type);
 
+		/*!
+			\brief Record the step type of an edge that was just added or updated.
+
+			\param parent_id ID of the edge's parent.
+			\param child_id ID of the edge's child.
+			\param step Step type of the edge.
+
+			\details
+			If the graph isn't compressed, the step is stored beside the edge's triplet and laid out by
+			Compress(). If edges were added to the CSR since step_types was laid out, the step is
+			stored in step_changes until the next Compress(). Otherwise it's written to step_types directly.
+
+			\pre The edge from parent_id to child_id was the last edge added to the graph.
+		*/
+		void SetStepType(int parent_id, int child_id, STEP step);
+
+		/*!
+			\brief Lay out step_types again after edges were added to the CSR, then apply step_changes.
+
+			\details
+			New edges are inserted into the CSR in order, so every other step keeps its place relative
+			to the others. This walks the CSR once, giving each edge in new_step_edges a step of
+			STEP::NOT_CONNECTED and taking the step of every other edge from the old step_types.
+		*/
+		void LayOutNewEdgeSteps();
+
 		/*!
 			\brief Get the cost of traversing the edge between parent and child using set
 
@@ -883,6 +916,48 @@ namespace HF::SpatialStructures {
 			const std::string& default_cost = "Distance"
 		);
 
+		/*! \brief Construct a graph from the arrays of a CSR.
+
+			\param outer_indices For every node, the index of its first edge in inner_indices and values,
+			followed by the total number of edges. Must have a size of `nodes.size() + 1`.
+			\param inner_indices The ID of the child node of every edge, grouped by parent.
+			\param values The cost of every edge in inner_indices.
+			\param Nodes Ordered list of nodes. The ID of each node will be its index in this array.
+			\param default_cost Name of the cost type that values will be stored under.
+
+			\pre 1) `outer_indices.size() == Nodes.size() + 1`
+			\pre 2) `inner_indices.size() == values.size() == outer_indices.back()`
+			\pre 3) The child IDs for each parent in inner_indices must be in ascending order.
+
+			\remarks
+			This avoids the intermediate jagged arrays required by the other constructor, since the
+			arrays are copied directly into the graph's CSR. This is useful for algorithms that can
+			produce their edges in order, such as HF::VisibilityGraph::AllToAllBlocked.
+
+			\code
+				// be sure to #include "graph.h"
+				std::vector<HF::SpatialStructures::Node> nodes = {
+					HF::SpatialStructures::Node(1.0f, 1.0f, 2.0f),
+					HF::SpatialStructures::Node(2.0f, 3.0f, 4.0f),
+					HF::SpatialStructures::Node(11.0f, 22.0f, 140.0f)
+				};
+
+				// Same edges as { { 1, 2 }, { 2 }, { 1 } }
+				std::vector<int> outer_indices = { 0, 2, 3, 4 };
+				std::vector<int> inner_indices = { 1, 2, 2, 1 };
+				std::vector<float> values = { 1.0f, 2.5f, 54.0f, 39.0f };
+
+				HF::SpatialStructures::Graph graph(outer_indices, inner_indices, values, nodes);
+			\endcode
+		*/
+		Graph(
+			const std::vector<int>& outer_indices,
+			const std::vector<int>& inner_indices,
+			const std::vector<float>& values,
+			const std::vector<Node>& Nodes,
+			const std::string& default_cost = "Distance"
+		);
+
 		/*! \brief Construct an empty graph.
 
 			\remarks This can be used to create a new graph to later be filled with edges/nodes
@@ -1367,6 +1442,53 @@ namespace HF::SpatialStructures {
 		*/
 		void addEdge(int parent_id, int child_id, float score, const std::string& cost_type = "");
 
+		/*!
+			\brief Add a new edge to the graph and record the step required to traverse it.
+
+			\param parent The starting node for the edge.
+			\param child The ending node for the edge.
+			\param score The cost of traversing from parent to child in the graph's default cost.
+			\param step Step type of the edge, such as the one GetChildren() found for it.
+
+			\details
+			Step types are stored as one byte per edge, alongside the graph's default cost, so routes that
+			need to avoid stairs can tell which edges are steps without casting any rays. Edges added
+			with the other overloads of addEdge() have a step type of STEP::NOT_CONNECTED, unless they
+			already had one. Steps of new edges added after the graph was compressed are kept aside
+			until the next call to Compress(), so adding many edges doesn't move every step each time.
+			Call Compress() before reading them with GetStepType().
+
+			\see GetStepType() and GetStepTypes() to read the step types back.
+
+			\code
+				// be sure to #include "graph.h"
+
+				HF::SpatialStructures::Node floor(0.0f, 0.0f, 0.0f);
+				HF::SpatialStructures::Node stair(1.0f, 0.0f, 0.18f);
+
+				HF::SpatialStructures::Graph graph;
+				graph.addEdge(floor, stair, 1.02f, HF::SpatialStructures::STEP::UP);
+				graph.addEdge(stair, floor, 1.02f, HF::SpatialStructures::STEP::DOWN);
+				graph.Compress();
+
+				// step == HF::SpatialStructures::STEP::UP
+				auto step = graph.GetStepType(graph.getID(floor), graph.getID(stair));
+			\endcode
+		*/
+		void addEdge(const Node& parent, const Node& child, float score, STEP step);
+
+		/*!
+			\brief Add a new edge to the graph by ID and record the step required to traverse it.
+
+			\param parent_id The starting node for the edge.
+			\param child_id The ending node for the edge.
+			\param score The cost of traversing from parent to child in the graph's default cost.
+			\param step Step type of the edge.
+
+			\see addEdge(const Node&, const Node&, float, STEP) for details.
+		*/
+		void addEdge(int parent_id, int child_id, float score, STEP step);
+
 		/// <summary>
 		/// Determine if n exists in the graph.
 		/// </summary>
@@ -1565,9 +1687,9 @@ namespace HF::SpatialStructures {
 			\brief Compress the graph to a CSR and enable the usage of several functions.
 
 			\details
-			This won't do anything if called on an already compressed graph. The graph is "compressed"
-			by resizing the edge matrix to the maximum ID of any node in triplets, then calling
-			setFromTriplets().
+			This won't do anything if called on an already compressed graph, other than laying out the
+			step types of edges added since it was compressed. The graph is "compressed" by resizing
+			the edge matrix to the maximum ID of any node in triplets, then calling setFromTriplets().
 
 			\note
 			This function actually doesn't actually reduce memory usage since it keeps the edge list
@@ -1609,6 +1731,41 @@ namespace HF::SpatialStructures {
 		*/
 		void Compress();
 
+		/*!
+			\brief Compress the graph, then create alternate cost arrays from a cost for every edge in the order it was added.
+
+			\param cost_types Names of the cost arrays to create. None can be the graph's default cost.
+			\param costs `costs[i][j]` is the cost of type `cost_types[i]` for the jth edge added to the graph.
+
+			\pre The graph hasn't been compressed since it was created or last cleared.
+
+			\throws std::logic_error The graph was already compressed, or a cost type is the default cost.
+			\throws std::invalid_argument There isn't a cost array for every name in cost_types, or one
+			of the cost arrays doesn't have a cost for every edge in the graph.
+
+			\details
+			Use this to store alternate costs that were calculated while the graph was being built, such as
+			by the GraphGenerator. Each cost array is laid out by the same setFromTriplets() call that lays
+			out the default cost, so its values line up with the CSR directly, instead of every edge being
+			looked up in the CSR as addEdge() does for alternate costs. Costs for duplicate edges are summed,
+			just like their default costs. Existing cost arrays with the same names are replaced.
+
+			\code
+				// be sure to #include "graph.h"
+
+				HF::SpatialStructures::Node node_0(0.0f, 0.0f, 0.0f);
+				HF::SpatialStructures::Node node_1(1.0f, 0.0f, 1.0f);
+
+				HF::SpatialStructures::Graph graph;
+				graph.addEdge(node_0, node_1, 1.41f);
+				graph.addEdge(node_1, node_0, 1.41f);
+
+				// One cost per edge, in the order the edges were added
+				graph.CompressWithCosts({ "Climb" }, { { 1.0f, -1.0f } });
+			\endcode
+		*/
+		void CompressWithCosts(const std::vector<std::string>& cost_types, const std::vector<std::vector<float>>& costs);
+
 		/// <summary>
 		/// Obtain the size of and pointers to the 3 arrays that comprise this graph's CSR. graph if
 		/// it isn't compressed already
@@ -1849,6 +2006,12 @@ namespace HF::SpatialStructures {
 		*/
 		std::vector<std::string> GetNodeAttributes(std::string attribute) const;
 
+		/*! \brief Get the name of every node attribute in this graph.
+
+			\returns A list of all node attributes that exist within this graph, in no particular order.
+		*/
+		std::vector<std::string> GetNodeAttributeTypes() const;
+
 		/// <summary>
 		/// Clears the attribute at name and all of its contents from the internal hashmap
 		/// </summary>
@@ -1906,6 +2069,12 @@ namespace HF::SpatialStructures {
 			the default cost array).
 		*/
 		std::vector<std::string> GetCostTypes() const;
+
+		/*! \brief Get the name of the default cost type of this graph.
+
+			\returns The name that the costs of the CSR are stored under.
+		*/
+		const std::string& GetDefaultCostName() const;
 		
 		/*! 
 		
@@ -1923,6 +2092,52 @@ namespace HF::SpatialStructures {
 		*/
 		float GetCost(int parent_id, int child_id, const std::string& cost_type = "") const;
 
+		/*! 
+			\brief Check if any edge in the graph was added with a step type.
+		*/
+		bool HasStepTypes() const;
+
+		/*!
+			\brief Get the step required to traverse from parent_id to child_id.
+
+			\param parent_id Node that's being traversed from.
+			\param child_id Node that's being traversed to.
+
+			\returns The step type the edge was added with, or STEP::NOT_CONNECTED if the edge doesn't
+			exist or wasn't added with a step type.
+
+			\throws std::logic_error The graph isn't compressed, or edges with step types were added
+			since it was last compressed.
+		*/
+		STEP GetStepType(int parent_id, int child_id) const;
+
+		/*!
+			\brief Get the step type of every edge in the graph, compressing it if it isn't already.
+
+			\returns One STEP per edge, in the same order as the values of the CSR from GetCSRPointers(),
+			or an empty array if no edge was added with a step type.
+		*/
+		const std::vector<uint8_t>& GetStepTypes();
+
+		/*!
+			\brief Create a cost array that scales the graph's default cost by the step of each edge.
+
+			\param cost_type Name of the cost array to create. Replaces any existing cost array with this name.
+			\param step_multipliers Multiplier for the default cost of edges of each STEP, indexed by STEP.
+
+			\throws std::logic_error The graph doesn't have step types, or cost_type is the graph's default cost.
+
+			\details
+			Use this to route around stairs without recalculating anything: multiply the cost of UP and
+			DOWN edges by a large number, or by infinity to forbid them entirely.
+
+			\code
+				// Make stairs ten times as expensive as flat ground
+				graph.CreateStepCost("AvoidStairs", { 1.0f, 1.0f, 10.0f, 10.0f, 1.0f });
+			\endcode
+		*/
+		void CreateStepCost(const std::string& cost_type, const std::array<float, 5>& step_multipliers);
+
 		/*! \brief Add a set of intedges to the graph.
 		
 			\param edges An ordered vector of vectors in which each outer vector holds
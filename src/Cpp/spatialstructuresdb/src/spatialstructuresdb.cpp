@@ -1,13 +1,448 @@
 ///
-/// \file		spatialstructuresdb.h
-/// \brief		Contains implementation for the spatialstructuresdb
+/// \file		spatialstructuresdb.cpp
+/// \brief		Contains implementation for the <see cref="HF::SpatialStructures::SpatialIndex">SpatialIndex</see>
 ///
 ///	\author		TBA
 ///	\date		26 Jun 2020
 
-#include "pch.h"
-#include <graph_generator.h>
-#include <graph_generator_private.h>
-#include <charconv>
-#include <iostream>
+#include <spatialstructuresdb.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include <graph.h>
+#include <node.h>
+#include <HFExceptions.h>
+
+using HF::Exceptions::MalformedDatabase;
+using std::array;
+using std::string;
+using std::vector;
+
+namespace HF::SpatialStructures {
+
+	/// <summary> Layout of the header at the start of every index file. </summary>
+	/*!
+		\details
+		The header is followed by the length prefixed names of every score, then the tile table at
+		tile_table_offset, then the records of every node at records_offset. Each record is the x, y
+		and z coordinates of a node, its ID, then its scores, all 4 bytes each.
+	*/
+	struct IndexHeader {
+		char magic[4];				///< Always "DHSI".
+		uint32_t version;			///< Version of the file format.
+		int32_t num_nodes;			///< Number of records in the file.
+		int32_t num_scores;			///< Number of scores in every record.
+		int32_t tiles_x;			///< Number of tiles along the X axis.
+		int32_t tiles_y;			///< Number of tiles along the Y axis.
+		float min_x;				///< X coordinate of the corner of the first tile.
+		float min_y;				///< Y coordinate of the corner of the first tile.
+		float tile_size;			///< Width and length of every tile.
+		uint32_t names_size;		///< Size of the score names in bytes.
+		uint64_t tile_table_offset;	///< Offset of the first entry of the tile table.
+		uint64_t records_offset;	///< Offset of the first record.
+	};
+	static_assert(sizeof(IndexHeader) == 56, "The layout of the index header must not change");
+
+	const char index_magic[4] = { 'D', 'H', 'S', 'I' };
+	const uint32_t index_version = 1;
+
+	/// Records are aligned to pages so reading a tile touches as few pages as possible.
+	const uint64_t page_size = 4096;
+
+	/// <summary> Round offset up to the next multiple of alignment. </summary>
+	inline uint64_t AlignTo(uint64_t offset, uint64_t alignment) {
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	/// <summary> Get the tile of a coordinate along one axis. </summary>
+	inline int TileCoordinate(float value, float min_value, float tile_size, int num_tiles) {
+		const float tile = std::floor((value - min_value) / tile_size);
+
+		// Compare as floats first, so values far outside of the grid can't overflow an int
+		if (!(tile > 0)) return 0;
+		if (tile >= static_cast<float>(num_tiles - 1)) return num_tiles - 1;
+		return static_cast<int>(tile);
+	}
+
+	void WriteSpatialIndex(
+		const string& path,
+		const vector<Node>& nodes,
+		const vector<string>& score_names,
+		const vector<vector<float>>& scores,
+		int nodes_per_tile
+	) {
+		if (score_names.size() != scores.size())
+			throw std::invalid_argument("Every set of scores must have a name");
+		for (const auto& score_set : scores)
+			if (score_set.size() != nodes.size())
+				throw std::invalid_argument("Every set of scores must have one score per node");
+		if (nodes_per_tile < 1)
+			throw std::invalid_argument("Tiles must hold at least one node");
+
+		const int num_nodes = static_cast<int>(nodes.size());
+		const int num_scores = static_cast<int>(scores.size());
+
+		// Find the XY bounding box of the nodes
+		float min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+		if (num_nodes > 0) {
+			min_x = max_x = nodes[0].x;
+			min_y = max_y = nodes[0].y;
+		}
+		for (const Node& node : nodes) {
+			min_x = std::min(min_x, node.x); max_x = std::max(max_x, node.x);
+			min_y = std::min(min_y, node.y); max_y = std::max(max_y, node.y);
+		}
+
+		// Size tiles so they average nodes_per_tile nodes. Using the larger of the two sizes keeps
+		// the number of tiles close to the target when the nodes are all in a line.
+		const double width = static_cast<double>(max_x) - min_x;
+		const double length = static_cast<double>(max_y) - min_y;
+		const double target_tiles = std::max(1.0, std::ceil(static_cast<double>(num_nodes) / nodes_per_tile));
+		double tile_size = std::max(std::sqrt(width * length / target_tiles), std::max(width, length) / target_tiles);
+		if (!(tile_size > 0) || !std::isfinite(tile_size))
+			tile_size = 1.0;
+
+		IndexHeader header;
+		std::memcpy(header.magic, index_magic, sizeof(index_magic));
+		header.version = index_version;
+		header.num_nodes = num_nodes;
+		header.num_scores = num_scores;
+		header.tiles_x = static_cast<int32_t>(std::floor(width / tile_size)) + 1;
+		header.tiles_y = static_cast<int32_t>(std::floor(length / tile_size)) + 1;
+		header.min_x = min_x;
+		header.min_y = min_y;
+		header.tile_size = static_cast<float>(tile_size);
+
+		header.names_size = 0;
+		for (const string& name : score_names)
+			header.names_size += static_cast<uint32_t>(sizeof(uint32_t) + name.size());
+
+		const int num_tiles = header.tiles_x * header.tiles_y;
+		header.tile_table_offset = AlignTo(sizeof(IndexHeader) + header.names_size, sizeof(uint32_t));
+		header.records_offset = AlignTo(header.tile_table_offset + sizeof(uint32_t) * (num_tiles + 1), page_size);
+
+		// Sort nodes by tile with a counting sort
+		vector<int> tile_of_node(num_nodes);
+		vector<uint32_t> tile_starts(num_tiles + 1, 0);
+		for (int i = 0; i < num_nodes; i++) {
+			const int tx = TileCoordinate(nodes[i].x, header.min_x, header.tile_size, header.tiles_x);
+			const int ty = TileCoordinate(nodes[i].y, header.min_y, header.tile_size, header.tiles_y);
+			tile_of_node[i] = ty * header.tiles_x + tx;
+			tile_starts[tile_of_node[i] + 1]++;
+		}
+		for (int t = 0; t < num_tiles; t++)
+			tile_starts[t + 1] += tile_starts[t];
+
+		const size_t floats_per_record = 4 + num_scores;
+		vector<float> records(floats_per_record * num_nodes);
+		vector<uint32_t> next_record(tile_starts.begin(), tile_starts.end() - 1);
+		for (int i = 0; i < num_nodes; i++) {
+			float* record = records.data() + floats_per_record * next_record[tile_of_node[i]]++;
+			record[0] = nodes[i].x;
+			record[1] = nodes[i].y;
+			record[2] = nodes[i].z;
+			const int32_t id = i;
+			std::memcpy(record + 3, &id, sizeof(id));
+			for (int s = 0; s < num_scores; s++)
+				record[4 + s] = scores[s][i];
+		}
+
+		// Write everything
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.good())
+			throw std::runtime_error("Couldn't open " + path + " for writing");
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		for (const string& name : score_names) {
+			const uint32_t name_size = static_cast<uint32_t>(name.size());
+			out.write(reinterpret_cast<const char*>(&name_size), sizeof(name_size));
+			out.write(name.data(), name.size());
+		}
+
+		const vector<char> table_padding(header.tile_table_offset - sizeof(IndexHeader) - header.names_size, 0);
+		out.write(table_padding.data(), table_padding.size());
+		out.write(reinterpret_cast<const char*>(tile_starts.data()), sizeof(uint32_t) * tile_starts.size());
+
+		const vector<char> record_padding(header.records_offset - header.tile_table_offset - sizeof(uint32_t) * tile_starts.size(), 0);
+		out.write(record_padding.data(), record_padding.size());
+		out.write(reinterpret_cast<const char*>(records.data()), sizeof(float) * records.size());
+
+		if (!out.good())
+			throw std::runtime_error("Couldn't write the spatial index to " + path);
+	}
+
+	void WriteSpatialIndex(
+		const string& path,
+		const Graph& graph,
+		const vector<string>& attributes,
+		int nodes_per_tile
+	) {
+		const vector<Node> nodes = graph.Nodes();
+
+		// Convert each attribute to numbers
+		vector<vector<float>> scores(attributes.size());
+		for (size_t a = 0; a < attributes.size(); a++) {
+			const vector<string> strings = graph.GetNodeAttributes(attributes[a]);
+			scores[a].resize(nodes.size(), std::numeric_limits<float>::quiet_NaN());
+			for (size_t i = 0; i < strings.size() && i < nodes.size(); i++) {
+				char* end = nullptr;
+				const float value = std::strtof(strings[i].c_str(), &end);
+				if (!strings[i].empty() && end != strings[i].c_str())
+					scores[a][i] = value;
+			}
+		}
+
+		WriteSpatialIndex(path, nodes, attributes, scores, nodes_per_tile);
+	}
+
+	SpatialIndex::SpatialIndex(const string& path) : file(path, false) {
+		const char* data = file.Data();
+		const uint64_t size = file.Size();
+
+		IndexHeader header;
+		if (size < sizeof(header))
+			throw MalformedDatabase(path + " is too small to be a spatial index");
+		std::memcpy(&header, data, sizeof(header));
+
+		if (std::memcmp(header.magic, index_magic, sizeof(index_magic)) != 0)
+			throw MalformedDatabase(path + " isn't a spatial index");
+		if (header.version != index_version)
+			throw MalformedDatabase(path + " uses an unsupported version of the spatial index format");
+
+		if (header.num_nodes < 0 || header.num_scores < 0 || header.tiles_x < 1 || header.tiles_y < 1
+			|| !(header.tile_size > 0) || !std::isfinite(header.tile_size))
+			throw MalformedDatabase(path + " has an invalid header");
+
+		const uint64_t num_tiles = static_cast<uint64_t>(header.tiles_x) * static_cast<uint64_t>(header.tiles_y);
+		const uint64_t record_stride = sizeof(float) * (4 + static_cast<uint64_t>(header.num_scores));
+		if (num_tiles >= std::numeric_limits<int32_t>::max()
+			|| header.tile_table_offset % sizeof(uint32_t) != 0
+			|| header.tile_table_offset < sizeof(header) + header.names_size
+			|| header.tile_table_offset > size
+			|| (size - header.tile_table_offset) / sizeof(uint32_t) < num_tiles + 1
+			|| header.records_offset > size
+			|| (size - header.records_offset) / record_stride < static_cast<uint64_t>(header.num_nodes))
+			throw MalformedDatabase(path + " is truncated");
+
+		// Read the names of the scores
+		const char* names = data + sizeof(header);
+		const char* names_end = names + header.names_size;
+		for (int s = 0; s < header.num_scores; s++) {
+			uint32_t name_size;
+			if (names_end - names < static_cast<ptrdiff_t>(sizeof(name_size)))
+				throw MalformedDatabase(path + " has invalid score names");
+			std::memcpy(&name_size, names, sizeof(name_size));
+			names += sizeof(name_size);
+
+			if (static_cast<uint64_t>(names_end - names) < name_size)
+				throw MalformedDatabase(path + " has invalid score names");
+			score_names.emplace_back(names, name_size);
+			names += name_size;
+		}
+
+		// Every tile must start where the last one ended
+		tile_starts = reinterpret_cast<const uint32_t*>(data + header.tile_table_offset);
+		if (tile_starts[0] != 0 || tile_starts[num_tiles] != static_cast<uint32_t>(header.num_nodes))
+			throw MalformedDatabase(path + " has an invalid tile table");
+		for (uint64_t t = 0; t < num_tiles; t++)
+			if (tile_starts[t] > tile_starts[t + 1])
+				throw MalformedDatabase(path + " has an invalid tile table");
+
+		num_nodes = header.num_nodes;
+		num_scores = header.num_scores;
+		tiles_x = header.tiles_x;
+		tiles_y = header.tiles_y;
+		min_x = header.min_x;
+		min_y = header.min_y;
+		tile_size = header.tile_size;
+		stride = static_cast<size_t>(record_stride);
+		records = data + header.records_offset;
+	}
+
+	array<int, 2> SpatialIndex::TileOf(float x, float y) const {
+		return {
+			TileCoordinate(x, min_x, tile_size, tiles_x),
+			TileCoordinate(y, min_y, tile_size, tiles_y)
+		};
+	}
+
+	Node SpatialIndex::ReadNode(uint32_t record) const {
+		float position[3];
+		int32_t id;
+		const char* start = records + stride * record;
+		std::memcpy(position, start, sizeof(position));
+		std::memcpy(&id, start + sizeof(position), sizeof(id));
+
+		return Node(position[0], position[1], position[2], id);
+	}
+
+	void SpatialIndex::ReadScores(uint32_t record, vector<float>& out_scores) const {
+		if (num_scores == 0) return;
+
+		const char* start = records + stride * record + sizeof(float) * 4;
+		const size_t offset = out_scores.size();
+		out_scores.resize(offset + num_scores);
+		std::memcpy(out_scores.data() + offset, start, sizeof(float) * num_scores);
+	}
+
+	vector<uint32_t> SpatialIndex::FindInBox(const array<float, 3>& min_point, const array<float, 3>& max_point) const {
+		vector<uint32_t> found;
+		if (num_nodes == 0 || min_point[0] > max_point[0] || min_point[1] > max_point[1] || min_point[2] > max_point[2])
+			return found;
+
+		const auto first_tile = TileOf(min_point[0], min_point[1]);
+		const auto last_tile = TileOf(max_point[0], max_point[1]);
+
+		for (int ty = first_tile[1]; ty <= last_tile[1]; ty++) {
+			for (int tx = first_tile[0]; tx <= last_tile[0]; tx++) {
+				const int tile = TileIndex(tx, ty);
+				for (uint32_t r = tile_starts[tile]; r < tile_starts[tile + 1]; r++) {
+					float position[3];
+					std::memcpy(position, records + stride * r, sizeof(position));
+
+					if (position[0] >= min_point[0] && position[0] <= max_point[0]
+						&& position[1] >= min_point[1] && position[1] <= max_point[1]
+						&& position[2] >= min_point[2] && position[2] <= max_point[2])
+						found.push_back(r);
+				}
+			}
+		}
+		return found;
+	}
+
+	vector<uint32_t> SpatialIndex::FindNearest(const array<float, 3>& point, int k) const {
+		if (k < 1 || num_nodes == 0) return vector<uint32_t>();
+
+		// Max heap of the closest records found so far, by squared distance
+		using Candidate = std::pair<float, uint32_t>;
+		std::priority_queue<Candidate> closest;
+
+		// Squared XY distance from point to a tile. Tiles on the edge of the grid hold every
+		// node past that edge, so they extend out to infinity.
+		auto distance_to_tile = [&](int tx, int ty) {
+			const float low_x = (tx == 0) ? -std::numeric_limits<float>::infinity() : min_x + tx * tile_size;
+			const float high_x = (tx == tiles_x - 1) ? std::numeric_limits<float>::infinity() : min_x + (tx + 1) * tile_size;
+			const float low_y = (ty == 0) ? -std::numeric_limits<float>::infinity() : min_y + ty * tile_size;
+			const float high_y = (ty == tiles_y - 1) ? std::numeric_limits<float>::infinity() : min_y + (ty + 1) * tile_size;
+
+			const float dx = std::max({ low_x - point[0], 0.0f, point[0] - high_x });
+			const float dy = std::max({ low_y - point[1], 0.0f, point[1] - high_y });
+			return dx * dx + dy * dy;
+		};
+
+		auto search_tile = [&](int tx, int ty) {
+			const int tile = TileIndex(tx, ty);
+			for (uint32_t r = tile_starts[tile]; r < tile_starts[tile + 1]; r++) {
+				float position[3];
+				std::memcpy(position, records + stride * r, sizeof(position));
+
+				const float dx = position[0] - point[0];
+				const float dy = position[1] - point[1];
+				const float dz = position[2] - point[2];
+				const float distance = dx * dx + dy * dy + dz * dz;
+
+				if (closest.size() < static_cast<size_t>(k))
+					closest.emplace(distance, r);
+				else if (distance < closest.top().first) {
+					closest.pop();
+					closest.emplace(distance, r);
+				}
+			}
+		};
+
+		// Search rings of tiles around the tile containing point. The XY distance to a tile is never
+		// more than the distance to any node in it, so once every tile in a ring is farther than the
+		// kth closest node, no node in that ring or any ring after it can be closer.
+		const auto center = TileOf(point[0], point[1]);
+		const int max_ring = std::max({ center[0], tiles_x - 1 - center[0], center[1], tiles_y - 1 - center[1] });
+		for (int ring = 0; ring <= max_ring; ring++) {
+			const bool full = closest.size() == static_cast<size_t>(k);
+			float ring_distance = std::numeric_limits<float>::infinity();
+
+			for (int ty = center[1] - ring; ty <= center[1] + ring; ty++) {
+				if (ty < 0 || ty >= tiles_y) continue;
+
+				// Only the first and last rows of a ring have every tile in them
+				const bool edge_row = (ty == center[1] - ring || ty == center[1] + ring);
+				const int step = edge_row ? 1 : std::max(1, 2 * ring);
+
+				for (int tx = center[0] - ring; tx <= center[0] + ring; tx += step) {
+					if (tx < 0 || tx >= tiles_x) continue;
+
+					const float distance = distance_to_tile(tx, ty);
+					ring_distance = std::min(ring_distance, distance);
+					if (!full || distance <= closest.top().first)
+						search_tile(tx, ty);
+				}
+			}
+
+			if (full && ring_distance > closest.top().first)
+				break;
+		}
+
+		vector<uint32_t> found(closest.size());
+		for (int i = static_cast<int>(found.size()) - 1; i >= 0; i--) {
+			found[i] = closest.top().second;
+			closest.pop();
+		}
+		return found;
+	}
+
+	vector<Node> SpatialIndex::QueryBox(const array<float, 3>& min_point, const array<float, 3>& max_point) const {
+		const auto found = FindInBox(min_point, max_point);
+
+		vector<Node> nodes;
+		nodes.reserve(found.size());
+		for (uint32_t record : found)
+			nodes.push_back(ReadNode(record));
+		return nodes;
+	}
+
+	vector<Node> SpatialIndex::QueryBox(
+		const array<float, 3>& min_point,
+		const array<float, 3>& max_point,
+		vector<float>& out_scores
+	) const {
+		const auto found = FindInBox(min_point, max_point);
+
+		vector<Node> nodes;
+		nodes.reserve(found.size());
+		out_scores.clear();
+		out_scores.reserve(found.size() * num_scores);
+		for (uint32_t record : found) {
+			nodes.push_back(ReadNode(record));
+			ReadScores(record, out_scores);
+		}
+		return nodes;
+	}
+
+	vector<Node> SpatialIndex::Nearest(const array<float, 3>& point, int k) const {
+		const auto found = FindNearest(point, k);
+
+		vector<Node> nodes;
+		nodes.reserve(found.size());
+		for (uint32_t record : found)
+			nodes.push_back(ReadNode(record));
+		return nodes;
+	}
+
+	vector<Node> SpatialIndex::Nearest(const array<float, 3>& point, int k, vector<float>& out_scores) const {
+		const auto found = FindNearest(point, k);
+
+		vector<Node> nodes;
+		nodes.reserve(found.size());
+		out_scores.clear();
+		out_scores.reserve(found.size() * num_scores);
+		for (uint32_t record : found) {
+			nodes.push_back(ReadNode(record));
+			ReadScores(record, out_scores);
+		}
+		return nodes;
+	}
+}
@@ -1,15 +1,192 @@
 ///
 /// \file		spatialstructuresdb.h
-/// \brief		Contains definitions for the spatialstructuresdb
+/// \brief		Contains definitions for the <see cref="HF::SpatialStructures::SpatialIndex">SpatialIndex</see>
 ///
 ///	\author		TBA
 ///	\date		26 Jun 2020
 
 #pragma once
-#define _USE_MATH_DEFINES
-#include <Node.h>
-#include <Edge.h>
-#include <Graph.h>
-#include <set>
-#include <embree_raytracer.h>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
 
+#include <mapped_file.h>
+
+namespace HF::SpatialStructures {
+	struct Node;
+	class Graph;
+
+	/*!
+		\brief Write the nodes of a graph and their scores to a spatial index file.
+
+		\param path Path of the file to write. If a file already exists at path, it is overwritten.
+		\param nodes Nodes to index. The ID of each node in the index is its position in this array.
+		\param score_names Name of each set of scores to store with the nodes.
+		\param scores One array of scores for every name in score_names. Each must have one score for
+		every node in nodes.
+		\param nodes_per_tile Average number of nodes to store in each tile of the index. The default
+		fits the nodes of a tile into a single 4KB page when no scores are stored.
+
+		\exception std::invalid_argument score_names and scores have different sizes, an array of
+		scores doesn't have one score per node, or nodes_per_tile is less than 1.
+		\exception std::runtime_error The file couldn't be written.
+
+		\details
+		The XY bounding box of the nodes is split into a grid of square tiles, and nodes are
+		written to the file grouped by tile. Every node is stored next to its scores, so reading
+		the nodes of a tile reads their scores from the same pages.
+
+		\see SpatialIndex for reading the index.
+	*/
+	void WriteSpatialIndex(
+		const std::string& path,
+		const std::vector<Node>& nodes,
+		const std::vector<std::string>& score_names = {},
+		const std::vector<std::vector<float>>& scores = {},
+		int nodes_per_tile = 256
+	);
+
+	/*!
+		\brief Write the nodes of a graph and some of its node attributes to a spatial index file.
+
+		\param path Path of the file to write. If a file already exists at path, it is overwritten.
+		\param graph Graph to index.
+		\param attributes Names of the node attributes of graph to store as scores. Scores that
+		can't be read as numbers, or that are missing, are stored as NaN.
+		\param nodes_per_tile Average number of nodes to store in each tile of the index.
+
+		\exception std::runtime_error The file couldn't be written.
+	*/
+	void WriteSpatialIndex(
+		const std::string& path,
+		const Graph& graph,
+		const std::vector<std::string>& attributes = {},
+		int nodes_per_tile = 256
+	);
+
+	/*!
+		\brief A read-only spatial index of nodes and their scores, stored on disk.
+
+		\details
+		The index file is mapped into memory instead of being read, so opening an index only reads
+		its header and tile table. A query then only touches the pages of the tiles that overlap it,
+		letting huge precomputed graphs be queried with very little memory. The operating system
+		keeps recently used pages cached and can discard them whenever it needs memory.
+
+		Queries return nodes with their ID set to their index in the graph the index was written
+		from. Queries that return scores return them in row-major order, with one row per node
+		containing a score for every name in ScoreNames().
+
+		\remarks
+		Indexes are written in the byte order of the machine, so they can only be read on machines
+		with the same byte order as the one that wrote them.
+
+		\see WriteSpatialIndex for creating an index.
+
+		\code
+			// be sure to #include "spatialstructuresdb.h"
+
+			HF::SpatialStructures::WriteSpatialIndex("graph.idx", graph, { "view" });
+
+			HF::SpatialStructures::SpatialIndex index("graph.idx");
+			std::vector<float> view_scores;
+			auto nodes = index.QueryBox({ 0, 0, -10 }, { 5, 5, 10 }, view_scores);
+		\endcode
+	*/
+	class SpatialIndex {
+		HF::Geometry::MappedFile file;		///< The mapped index file.
+
+		int num_nodes = 0;					///< Number of nodes in the index.
+		int num_scores = 0;					///< Number of scores stored for every node.
+		int tiles_x = 0;					///< Number of tiles along the X axis.
+		int tiles_y = 0;					///< Number of tiles along the Y axis.
+		float min_x = 0;					///< X coordinate of the corner of the first tile.
+		float min_y = 0;					///< Y coordinate of the corner of the first tile.
+		float tile_size = 1;				///< Width and length of every tile.
+		size_t stride = 0;					///< Size of a single node and its scores in bytes.
+
+		const uint32_t* tile_starts = nullptr;	///< Index of the first record of every tile, then num_nodes.
+		const char* records = nullptr;			///< The first node in the file.
+		std::vector<std::string> score_names;	///< Name of every score stored for each node.
+
+		/*! \brief Get the tile containing the coordinates, clamped to the grid. */
+		std::array<int, 2> TileOf(float x, float y) const;
+
+		/*! \brief Get the index of the tile at column x and row y. */
+		inline int TileIndex(int x, int y) const { return y * tiles_x + x; }
+
+		/*! \brief Read the node stored in record. */
+		Node ReadNode(uint32_t record) const;
+
+		/*! \brief Append the scores of record to out_scores. */
+		void ReadScores(uint32_t record, std::vector<float>& out_scores) const;
+
+		/*! \brief Find the records of the nodes in a box. */
+		std::vector<uint32_t> FindInBox(const std::array<float, 3>& min_point, const std::array<float, 3>& max_point) const;
+
+		/*! \brief Find the records of the k nodes closest to point, ordered from closest to farthest. */
+		std::vector<uint32_t> FindNearest(const std::array<float, 3>& point, int k) const;
+
+	public:
+		/*!
+			\brief Open an index written by WriteSpatialIndex.
+
+			\param path Path to the index file.
+
+			\exception HF::Exceptions::FileNotFound No file exists at path.
+			\exception HF::Exceptions::MalformedDatabase The file isn't a spatial index, or is truncated.
+		*/
+		SpatialIndex(const std::string& path);
+
+		/*! \brief Get the number of nodes in the index. */
+		inline int size() const { return num_nodes; }
+
+		/*! \brief Get the names of the scores stored with each node. */
+		inline const std::vector<std::string>& ScoreNames() const { return score_names; }
+
+		/*!
+			\brief Get every node within a box.
+
+			\param min_point Corner of the box with the smallest coordinates.
+			\param max_point Corner of the box with the largest coordinates.
+
+			\returns Every node whose coordinates are between min_point and max_point, inclusive,
+			in no particular order.
+		*/
+		std::vector<Node> QueryBox(const std::array<float, 3>& min_point, const std::array<float, 3>& max_point) const;
+
+		/*!
+			\brief Get every node within a box along with its scores.
+
+			\param out_scores Set to the scores of every returned node, in the same order as the nodes.
+		*/
+		std::vector<Node> QueryBox(
+			const std::array<float, 3>& min_point,
+			const std::array<float, 3>& max_point,
+			std::vector<float>& out_scores
+		) const;
+
+		/*!
+			\brief Get the nodes closest to a point.
+
+			\param point Point to find the closest nodes to.
+			\param k Maximum number of nodes to return.
+
+			\returns The k nodes closest to point, sorted from closest to farthest. If the index has
+			fewer than k nodes, every node is returned.
+
+			\details
+			Tiles are searched in rings around the tile containing point, and the search stops once
+			no unsearched tile could contain a node closer than the k closest found so far.
+		*/
+		std::vector<Node> Nearest(const std::array<float, 3>& point, int k = 1) const;
+
+		/*!
+			\brief Get the nodes closest to a point along with their scores.
+
+			\param out_scores Set to the scores of every returned node, in the same order as the nodes.
+		*/
+		std::vector<Node> Nearest(const std::array<float, 3>& point, int k, std::vector<float>& out_scores) const;
+	};
+}
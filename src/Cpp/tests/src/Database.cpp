@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <database.h>
+#include <graph.h>
+#include <path.h>
+#include <node.h>
+#include <HFExceptions.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <fstream>
+#include <cmath>
+
+using HF::DB::ResultStore;
+using HF::DB::ResultKey;
+using namespace HF::SpatialStructures;
+using std::string;
+using std::vector;
+
+/// <summary> Delete a database and its write-ahead log so each test starts from nothing. </summary>
+void DeleteDatabase(const string& path) {
+	std::remove(path.c_str());
+	std::remove((path + "-wal").c_str());
+	std::remove((path + "-shm").c_str());
+}
+
+TEST(_ResultStore, GraphRoundTripsWithCostsAndAttributes) {
+	const string path = "result_store_graph.db";
+	DeleteDatabase(path);
+
+	vector<Node> nodes = { Node(0, 0, 0), Node(1, 0, 0), Node(1, 1, 0), Node(0, 1, 2) };
+	vector<vector<int>> edges = { { 1, 2 }, { 2 }, { 3 }, {} };
+	vector<vector<float>> distances = { { 1.0f, 1.5f }, { 1.0f }, { 2.2f }, {} };
+	Graph graph(edges, distances, nodes);
+	graph.addEdge(0, 1, 7.0f, "Energy");
+	graph.addEdge(2, 3, 9.0f, "Energy");
+	graph.AddNodeAttributes({ 1, 3 }, "View", { "0.5", "12" });
+
+	const ResultKey key{ "model", "spacing=1" };
+	{
+		ResultStore store(path);
+		store.StoreGraph(key, graph);
+	}
+
+	// Load from a new connection so nothing is cached in memory
+	ResultStore store(path);
+	Graph loaded;
+	ASSERT_TRUE(store.LoadGraph(key, loaded));
+
+	auto loaded_nodes = loaded.Nodes();
+	ASSERT_EQ(loaded_nodes.size(), 4);
+	EXPECT_EQ(loaded_nodes[3].z, 2.0f);
+
+	EXPECT_EQ(loaded.GetCost(0, 2), 1.5f);
+	EXPECT_EQ(loaded.GetCost(2, 3), 2.2f);
+	EXPECT_EQ(loaded.GetCost(0, 1, "Energy"), 7.0f);
+	EXPECT_EQ(loaded.GetCost(2, 3, "Energy"), 9.0f);
+	EXPECT_TRUE(std::isnan(loaded.GetCost(1, 2, "Energy")));
+
+	auto view = loaded.GetNodeAttributes("View");
+	vector<string> expected_view = { "", "0.5", "", "12" };
+	EXPECT_EQ(view, expected_view);
+
+	// A different key must miss
+	Graph missing;
+	EXPECT_FALSE(store.LoadGraph({ "model", "spacing=2" }, missing));
+}
+
+TEST(_ResultStore, ScoresAndPathsRoundTripInABatch) {
+	const string path = "result_store_batch.db";
+	DeleteDatabase(path);
+
+	ResultStore store(path);
+	const ResultKey key{ "model", "height=1.7" };
+
+	vector<Path> paths(3);
+	paths[0].members = { PathMember{ 1.0f, 0 }, PathMember{ 0.0f, 4 } };
+	paths[2].members = { PathMember{ 2.5f, 3 }, PathMember{ 3.5f, 1 }, PathMember{ 0.0f, 2 } };
+
+	auto batch = store.BeginBatch();
+	store.StoreScores(key, "average", { 1.0f, 2.0f, 3.0f });
+	store.StoreScores(key, "max", { 4.0f });
+	store.StorePaths(key, "shortest", paths);
+	batch.Commit();
+
+	vector<float> scores;
+	ASSERT_TRUE(store.LoadScores(key, "average", scores));
+	EXPECT_EQ(scores, vector<float>({ 1.0f, 2.0f, 3.0f }));
+
+	vector<Path> loaded_paths;
+	ASSERT_TRUE(store.LoadPaths(key, "shortest", loaded_paths));
+	ASSERT_EQ(loaded_paths.size(), 3);
+	EXPECT_EQ(loaded_paths[0], paths[0]);
+	EXPECT_TRUE(loaded_paths[1].members.empty());
+	EXPECT_EQ(loaded_paths[2], paths[2]);
+
+	// Erasing a key removes everything stored under it
+	store.Erase(key);
+	EXPECT_FALSE(store.LoadScores(key, "max", scores));
+	EXPECT_FALSE(store.LoadPaths(key, "shortest", loaded_paths));
+}
+
+TEST(_ResultStore, UncommittedBatchIsRolledBack) {
+	const string path = "result_store_rollback.db";
+	DeleteDatabase(path);
+
+	ResultStore store(path);
+	const ResultKey key{ "model", "" };
+	{
+		auto batch = store.BeginBatch();
+		store.StoreScores(key, "scores", { 1.0f });
+	}
+
+	vector<float> scores;
+	EXPECT_FALSE(store.LoadScores(key, "scores", scores));
+}
+
+// Loading a graph only reads, so it shouldn't wait for another connection that's writing
+TEST(_ResultStore, LoadGraphDoesntTakeTheWriteLock) {
+	const string path = "result_store_read_lock.db";
+	DeleteDatabase(path);
+
+	Graph graph({ { 1 }, {} }, { { 1.0f }, {} }, { Node(0, 0, 0), Node(1, 0, 0) });
+	const ResultKey key{ "model", "" };
+	ResultStore writer(path);
+	writer.StoreGraph(key, graph);
+
+	ResultStore reader(path);
+	auto batch = writer.BeginBatch();
+	writer.StoreScores(key, "scores", { 1.0f });
+
+	Graph loaded;
+	ASSERT_TRUE(reader.LoadGraph(key, loaded));
+	EXPECT_EQ(loaded.GetCost(0, 1), 1.0f);
+}
+
+TEST(_ResultStore, HashFileChangesWithContents) {
+	const string path = "result_store_hash.txt";
+	{ std::ofstream("result_store_hash.txt") << "v 0 0 0"; }
+	const string first = HF::DB::HashFile(path);
+	{ std::ofstream("result_store_hash.txt") << "v 0 0 1"; }
+	const string second = HF::DB::HashFile(path);
+
+	EXPECT_NE(first, second);
+	EXPECT_EQ(second, HF::DB::HashFile(path));
+	EXPECT_THROW(HF::DB::HashFile("does_not_exist.obj"), HF::Exceptions::FileNotFound);
+}
@@ -14,6 +14,7 @@
 #include <unique_queue.h>
 
 #include <MultiRT.h>
+#include <cost_algorithms.h>
 
 using HF::SpatialStructures::Graph;
 using HF::GraphGenerator::GraphGenerator;
@@ -132,6 +133,104 @@ TEST(_GraphGenerator, BuildNetwork) {
 }
 
 
+// Cropping a mesh to the extent of a graph shouldn't change the graph
+TEST(_GraphGenerator, MaxExtentContainsGraph) {
+	auto mesh = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+	HF::GraphGenerator::real3 start{ 0, 0, 1 }, spacing{ 1, 1, 1 };
+	const int max_nodes = 20;
+
+	EmbreeRayTracer full_rt(mesh);
+	GraphGenerator full_gg(full_rt);
+	auto expected = full_gg.BuildNetwork(start, spacing, max_nodes, 1, 45, 1, 45, 1, 1, 0).Nodes();
+
+	auto extent = GraphGenerator::MaxExtent(start, spacing, max_nodes, 1);
+	ASSERT_EQ(-20, extent[0][0]);
+	ASSERT_EQ(20, extent[1][1]);
+	ASSERT_TRUE(std::isinf(extent[1][2]));
+
+	mesh[0].CropToBox(
+		{ static_cast<float>(extent[0][0]), static_cast<float>(extent[0][1]), static_cast<float>(extent[0][2]) },
+		{ static_cast<float>(extent[1][0]), static_cast<float>(extent[1][1]), static_cast<float>(extent[1][2]) }
+	);
+	EmbreeRayTracer cropped_rt(mesh);
+	GraphGenerator cropped_gg(cropped_rt);
+	ASSERT_EQ(expected, cropped_gg.BuildNetwork(start, spacing, max_nodes, 1, 45, 1, 45, 1, 1, 0).Nodes());
+}
+
+// Costs calculated while generating the graph should match the costs calculated from the finished graph
+TEST(_GraphGenerator, InlineCostsMatchCostAlgorithms) {
+	using namespace HF::GraphGenerator;
+	using namespace HF::SpatialStructures::CostAlgorithms;
+	using HF::SpatialStructures::STEP;
+
+	auto mesh = HF::Geometry::LoadMeshObjects("energy_blob_zup.obj");
+	EmbreeRayTracer rt(mesh);
+
+	const int inline_costs = INLINE_ENERGY_EXPENDITURE | INLINE_CROSS_SLOPE | INLINE_SLOPE;
+
+	// Check both the serial and parallel versions of the graph generator
+	for (int cores : { 0, -1 }) {
+		GraphGenerator GG(rt);
+		auto g = GG.BuildNetwork(
+			std::array<float, 3>{-30, 0, 20},
+			std::array<double, 3>{2, 2, 180},
+			5000,
+			30, 60,
+			70, 60,
+			2, 1, cores,
+			default_z_precision, default_spacing_precision, default_ground_offset,
+			inline_costs
+		);
+		ASSERT_GT(g.size(), 1);
+
+		for (const auto& edge_set : CalculateEnergyExpenditure(g))
+			for (const auto& edge : edge_set.children)
+				EXPECT_NEAR(edge.weight, g.GetCost(edge_set.parent, edge.child, InlineCostName(INLINE_ENERGY_EXPENDITURE)), 0.0001);
+
+		const auto cross_slopes = CalculateCrossSlope(g);
+		for (int parent = 0; parent < cross_slopes.size(); parent++)
+			for (const auto& edge : cross_slopes[parent])
+				EXPECT_NEAR(edge.weight, g.GetCost(parent, edge.child, InlineCostName(INLINE_CROSS_SLOPE)), 0.0001);
+
+		const auto nodes = g.Nodes();
+		int num_up = 0, num_down = 0;
+		for (const auto& edge_set : g.GetEdges()) {
+			for (const auto& edge : edge_set.children) {
+				const auto& parent = nodes[edge_set.parent];
+				const auto& child = nodes[edge.child];
+				const double slope = CalculateSlope(parent, child);
+				EXPECT_NEAR(slope, g.GetCost(edge_set.parent, edge.child, InlineCostName(INLINE_SLOPE)), 0.0001);
+
+				// Step types are kept alongside the inline costs, and match the heights of the nodes
+				const STEP step = g.GetStepType(edge_set.parent, edge.child);
+				ASSERT_NE(STEP::NOT_CONNECTED, step);
+				if (step == STEP::UP) {
+					EXPECT_GT(child.z, parent.z);
+					num_up++;
+				}
+				else if (step == STEP::DOWN) {
+					EXPECT_LT(child.z, parent.z);
+					num_down++;
+				}
+				else if (step == STEP::OVER)
+					EXPECT_EQ(child.z, parent.z);
+
+				// Going back the other way takes the opposite step
+				if (g.HasEdge(edge.child, edge_set.parent)) {
+					const STEP back_step = g.GetStepType(edge.child, edge_set.parent);
+					if (step == STEP::UP) EXPECT_EQ(STEP::DOWN, back_step);
+					else if (step == STEP::DOWN) EXPECT_EQ(STEP::UP, back_step);
+					else EXPECT_EQ(step, back_step);
+				}
+			}
+		}
+
+		// The blob has steps in both directions
+		EXPECT_GT(num_up, 0);
+		EXPECT_GT(num_down, 0);
+	}
+}
+
 TEST(_GraphGenerator, OutDegree) {
 	// Load an OBJ containing a simple plane
 	auto mesh = HF::Geometry::LoadMeshObjects("energy_blob_zup.obj", HF::Geometry::ONLY_FILE, false);
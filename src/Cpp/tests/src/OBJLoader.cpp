@@ -1,8 +1,18 @@
 #include <gtest/gtest.h>
 #include <objloader.h>
+#include <mesh_cache.h>
+#include <ply_loader.h>
+#include <gltf_loader.h>
+#include <scene_generator.h>
 #include <meshinfo.h>
 #include <HFExceptions.h>
 #include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
 
 #include "objloader_C.h"
 #include "performance_testing.h"
@@ -169,6 +179,450 @@ TEST(_OBJLoader, By_Material) {
 	EXPECT_TRUE(MI[0].GetMeshID() == 0);
 }
 
+// Every face should end up in exactly one group or material, without duplicating earlier groups
+TEST(_OBJLoader, GroupsContainEveryFaceOnce) {
+	auto whole_file = HF::Geometry::LoadMeshObjects("sponza.obj", HF::Geometry::ONLY_FILE, false);
+
+	for (auto gm : { HF::Geometry::BY_GROUP, HF::Geometry::BY_MATERIAL }) {
+		auto groups = HF::Geometry::LoadMeshObjects("sponza.obj", gm, false);
+		ASSERT_GT(groups.size(), 1);
+
+		int total_tris = 0;
+		for (const auto& group : groups) {
+			ASSERT_GT(group.NumTris(), 0);
+			ASSERT_LE(group.NumVerts(), 3 * group.NumTris());
+			total_tris += group.NumTris();
+		}
+		ASSERT_EQ(whole_file[0].NumTris(), total_tris);
+	}
+}
+
+// Every group method should apply the scale
+TEST(_OBJLoader, GroupsApplyScale) {
+	for (auto gm : { HF::Geometry::ONLY_FILE, HF::Geometry::BY_GROUP, HF::Geometry::BY_MATERIAL }) {
+		auto meshes = HF::Geometry::LoadMeshObjects("sponza.obj", gm, false, 1);
+		auto scaled = HF::Geometry::LoadMeshObjects("sponza.obj", gm, false, 2);
+		ASSERT_EQ(meshes.size(), scaled.size());
+
+		for (int i = 0; i < meshes.size(); i++) {
+			auto vertices = meshes[i].GetIndexedVertices();
+			auto scaled_vertices = scaled[i].GetIndexedVertices();
+			ASSERT_EQ(vertices.size(), scaled_vertices.size());
+			for (int k = 0; k < vertices.size(); k++)
+				ASSERT_FLOAT_EQ(vertices[k] * 2, scaled_vertices[k]);
+		}
+	}
+}
+
+// The parallel loader should produce the exact same mesh as the tinyobj path for triangulated models
+TEST(_OBJLoader, ParallelMatchesTinyOBJ) {
+	for (std::string path : { "big_teapot.obj", "plane.obj" }) {
+		auto expected = HF::Geometry::LoadMeshObjects(path, HF::Geometry::ONLY_FILE, true);
+		auto mesh = HF::Geometry::LoadMeshObjectsParallel(path, true);
+
+		ASSERT_EQ(expected[0].NumVerts(), mesh.NumVerts());
+		ASSERT_EQ(expected[0].NumTris(), mesh.NumTris());
+		ASSERT_EQ(expected[0].getRawIndices(), mesh.getRawIndices());
+		ASSERT_TRUE(expected[0] == mesh);
+	}
+}
+
+// The parallel loader should read infinity and NaN like strtod, even on a last line with no newline
+TEST(_OBJLoader, ParallelReadsNonFiniteNumbers) {
+	{
+		std::ofstream file("nonfinite.obj", std::ios::binary);
+		file << "v inf 0 0\nv 0 -Infinity 0\nv 0 0 NaN\nf 1 2 3";
+	}
+
+	auto mesh = HF::Geometry::LoadMeshObjectsParallel("nonfinite.obj", false);
+	auto vertices = mesh.GetIndexedVertices();
+	ASSERT_EQ(3, mesh.NumVerts());
+	ASSERT_TRUE(std::isinf(vertices[0]) && vertices[0] > 0);
+	ASSERT_TRUE(std::isinf(vertices[4]) && vertices[4] < 0);
+	ASSERT_TRUE(std::isnan(vertices[8]));
+	ASSERT_EQ(1, mesh.NumTris());
+	std::remove("nonfinite.obj");
+}
+
+// Face indices too large for an int should be rejected instead of wrapping to a negative index
+TEST(_OBJLoader, ParallelThrowsOnOversizedIndices) {
+	for (std::string face : { "f 1 2 4294967297", "f 1 2 99999999999999999999999", "f 1 2 -4294967296" }) {
+		{
+			std::ofstream file("oversized.obj", std::ios::binary);
+			file << "v 0 0 0\nv 1 0 0\nv 0 1 0\n" << face << "\n";
+		}
+		ASSERT_THROW(HF::Geometry::LoadMeshObjectsParallel("oversized.obj", false), HF::Exceptions::InvalidOBJ);
+	}
+	std::remove("oversized.obj");
+}
+
+TEST(_OBJLoader, ParallelThrowsOnMissingFile) {
+	ASSERT_THROW(HF::Geometry::LoadMeshObjectsParallel("ThisMeshDoesn'tExist"), HF::Exceptions::FileNotFound);
+}
+
+TEST(C_OBJLoader, LoadOBJParallel) {
+	MeshInfo* mesh = nullptr;
+	auto status = LoadOBJParallel("big_teapot.obj", 90, 0, 0, &mesh);
+
+	ASSERT_EQ(HF_STATUS::OK, status);
+	ASSERT_GT(mesh->NumTris(), 0);
+	DestroyMeshInfo(mesh);
+}
+
+// Meshes read back from a cache should be identical to the ones written to it
+TEST(_MeshCache, RoundTrip) {
+	auto meshes = HF::Geometry::LoadMeshObjects("teapot.obj", HF::Geometry::ONLY_FILE, true);
+	meshes[0].name = "Teapot";
+	meshes[0].SetMeshID(7);
+
+	HF::Geometry::SaveMeshCache(meshes, "teapot_roundtrip.dhmesh");
+	{
+		HF::Geometry::MeshCache cache("teapot_roundtrip.dhmesh");
+		ASSERT_EQ(1, cache.Meshes().size());
+
+		// Views should point directly into the file with aligned arrays
+		const auto& view = cache.Meshes()[0];
+		ASSERT_EQ(0, reinterpret_cast<uintptr_t>(view.vertices) % 16);
+		ASSERT_EQ(meshes[0].NumTris(), view.num_triangles);
+
+		auto loaded = cache.ToMeshInfo();
+		ASSERT_EQ("Teapot", loaded[0].name);
+		ASSERT_EQ(7, loaded[0].GetMeshID());
+		ASSERT_EQ(meshes[0].getRawIndices(), loaded[0].getRawIndices());
+		ASSERT_EQ(meshes[0].GetIndexedVertices(), loaded[0].GetIndexedVertices());
+	}
+	std::remove("teapot_roundtrip.dhmesh");
+}
+
+// Caches with offsets that point outside of the file should be rejected, even if the offset would overflow
+TEST(_MeshCache, ThrowsOnCorruptOffsets) {
+	auto meshes = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+	HF::Geometry::SaveMeshCache(meshes, "corrupt.dhmesh");
+
+	// Overwrite the vertex offset of the first mesh, which follows its four counts in the table
+	{
+		std::fstream file("corrupt.dhmesh", std::ios::binary | std::ios::in | std::ios::out);
+		const int64_t offset = INT64_MAX - 8;
+		file.seekp(48 + 16);
+		file.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+	}
+
+	ASSERT_THROW(HF::Geometry::MeshCache("corrupt.dhmesh"), HF::Exceptions::InvalidOBJ);
+	std::remove("corrupt.dhmesh");
+}
+
+// Caches with an index array before the end of its vertex array should be rejected, since
+// raytracers read past the end of the vertices
+TEST(_MeshCache, ThrowsOnIndicesBeforeVertices) {
+	auto meshes = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+	HF::Geometry::SaveMeshCache(meshes, "overlapping.dhmesh");
+
+	// Point the index array of the first mesh at its vertex array
+	{
+		std::fstream file("overlapping.dhmesh", std::ios::binary | std::ios::in | std::ios::out);
+		int64_t vertex_offset;
+		file.seekg(48 + 16);
+		file.read(reinterpret_cast<char*>(&vertex_offset), sizeof(vertex_offset));
+		file.seekp(48 + 24);
+		file.write(reinterpret_cast<const char*>(&vertex_offset), sizeof(vertex_offset));
+	}
+
+	ASSERT_THROW(HF::Geometry::MeshCache("overlapping.dhmesh"), HF::Exceptions::InvalidOBJ);
+	std::remove("overlapping.dhmesh");
+}
+
+// Caches with an index that doesn't refer to a vertex of its mesh should be rejected
+TEST(_MeshCache, ThrowsOnOutOfRangeIndices) {
+	auto meshes = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+	HF::Geometry::SaveMeshCache(meshes, "bad_index.dhmesh");
+
+	// Overwrite the first index of the first mesh with one past its last vertex
+	{
+		std::fstream file("bad_index.dhmesh", std::ios::binary | std::ios::in | std::ios::out);
+		int64_t index_offset;
+		file.seekg(48 + 24);
+		file.read(reinterpret_cast<char*>(&index_offset), sizeof(index_offset));
+		const int32_t index = meshes[0].NumVerts();
+		file.seekp(index_offset);
+		file.write(reinterpret_cast<const char*>(&index), sizeof(index));
+	}
+
+	ASSERT_THROW(HF::Geometry::MeshCache("bad_index.dhmesh"), HF::Exceptions::InvalidOBJ);
+	std::remove("bad_index.dhmesh");
+}
+
+// Caches with an array that isn't aligned for its element type should be rejected
+TEST(_MeshCache, ThrowsOnMisalignedOffsets) {
+	auto meshes = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+	HF::Geometry::SaveMeshCache(meshes, "misaligned.dhmesh");
+
+	// Move the vertex array of the first mesh back a single byte, so it still ends before the indices
+	{
+		std::fstream file("misaligned.dhmesh", std::ios::binary | std::ios::in | std::ios::out);
+		int64_t vertex_offset;
+		file.seekg(48 + 16);
+		file.read(reinterpret_cast<char*>(&vertex_offset), sizeof(vertex_offset));
+		vertex_offset -= 1;
+		file.seekp(48 + 16);
+		file.write(reinterpret_cast<const char*>(&vertex_offset), sizeof(vertex_offset));
+	}
+
+	ASSERT_THROW(HF::Geometry::MeshCache("misaligned.dhmesh"), HF::Exceptions::InvalidOBJ);
+	std::remove("misaligned.dhmesh");
+}
+
+// Caches should contain meshes with their pending transforms applied
+TEST(_MeshCache, AppliesPendingTransform) {
+	auto meshes = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+	auto expected = meshes[0];
+	expected.Transform({ 1, 0, 0, 5, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 });
+	meshes[0].QueueTransform({ 1, 0, 0, 5, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 });
+
+	HF::Geometry::SaveMeshCache(meshes, "transformed.dhmesh");
+	{
+		auto loaded = HF::Geometry::MeshCache("transformed.dhmesh").ToMeshInfo();
+		ASSERT_EQ(expected.GetIndexedVertices(), loaded[0].GetIndexedVertices());
+	}
+	std::remove("transformed.dhmesh");
+}
+
+// Loading through the cache should match loading the OBJ, both when the cache is created and reused
+TEST(_MeshCache, CachedLoadMatchesOBJ) {
+	std::remove("plane.obj.dhmesh");
+	auto expected = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+
+	for (int run = 0; run < 2; run++) {
+		auto meshes = HF::Geometry::LoadMeshObjectsCached("plane.obj", HF::Geometry::ONLY_FILE, true);
+		ASSERT_EQ(expected.size(), meshes.size());
+		ASSERT_EQ(expected[0].getRawIndices(), meshes[0].getRawIndices());
+		ASSERT_EQ(expected[0].GetIndexedVertices(), meshes[0].GetIndexedVertices());
+	}
+	std::remove("plane.obj.dhmesh");
+}
+
+// Append the bytes of value to out, reversing them if big_endian is set
+template <typename T>
+void AppendBytes(std::string& out, T value, bool big_endian = false) {
+	char bytes[sizeof(T)];
+	std::memcpy(bytes, &value, sizeof(T));
+	if (big_endian) std::reverse(bytes, bytes + sizeof(T));
+	out.append(bytes, sizeof(T));
+}
+
+// Write a unit square with one quad face to a binary PLY file. Vertices have an extra
+// property and there's an extra element, both of which the loader has to skip.
+void WriteSquarePLY(const std::string& path, bool big_endian) {
+	std::string file = std::string("ply\nformat ") + (big_endian ? "binary_big_endian" : "binary_little_endian") + " 1.0\n"
+		"comment written by OBJLoader tests\n"
+		"element vertex 4\nproperty float x\nproperty float y\nproperty float z\nproperty uchar red\n"
+		"element face 1\nproperty list uchar int vertex_indices\n"
+		"element edge 1\nproperty int vertex1\nproperty int vertex2\n"
+		"end_header\n";
+
+	const float square[4][3] = { {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0} };
+	for (const auto& vertex : square) {
+		for (float coordinate : vertex) AppendBytes(file, coordinate, big_endian);
+		AppendBytes<uint8_t>(file, 255);
+	}
+	AppendBytes<uint8_t>(file, 4);
+	for (int index = 0; index < 4; index++) AppendBytes(file, index, big_endian);
+	AppendBytes(file, 0, big_endian);
+	AppendBytes(file, 1, big_endian);
+
+	std::ofstream(path, std::ios::binary).write(file.data(), file.size());
+}
+
+// Quads should be split into two triangles, and both byte orders should give the same mesh
+TEST(_PLYLoader, LoadsBinaryPLY) {
+	for (bool big_endian : { false, true }) {
+		WriteSquarePLY("square.ply", big_endian);
+		auto mesh = HF::Geometry::LoadPLY("square.ply");
+		std::remove("square.ply");
+
+		ASSERT_EQ("square", mesh.name);
+		ASSERT_EQ(4, mesh.NumVerts());
+		ASSERT_EQ(2, mesh.NumTris());
+		ASSERT_EQ(vector<int>({ 0, 1, 2, 0, 2, 3 }), mesh.getRawIndices());
+		ASSERT_EQ(vector<float>({ 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 }), mesh.GetIndexedVertices());
+	}
+}
+
+TEST(_PLYLoader, ThrowsOnMissingFile) {
+	ASSERT_THROW(HF::Geometry::LoadPLY("ThisMeshDoesn'tExist.ply"), HF::Exceptions::FileNotFound);
+}
+
+// Write a GLB file containing one triangle mesh placed by two named nodes. The second node
+// is a child of the first, so its world transform is the combination of both translations.
+// The translation and children of the first node can be replaced to write malformed files.
+void WriteTriangleGLB(const std::string& path, const std::string& translation = "[1,0,0]", const std::string& children = "[1]") {
+	std::string json =
+		"{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+		"\"nodes\":[{\"name\":\"First\",\"mesh\":0,\"translation\":" + translation + ",\"children\":" + children + "},"
+		"{\"name\":\"Second\",\"mesh\":0,\"translation\":[0,0,2]}],"
+		"\"meshes\":[{\"name\":\"Triangle\",\"primitives\":[{\"attributes\":{\"POSITION\":0},\"indices\":1}]}],"
+		"\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\"},"
+		"{\"bufferView\":1,\"componentType\":5123,\"count\":3,\"type\":\"SCALAR\"}],"
+		"\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":36},{\"buffer\":0,\"byteOffset\":36,\"byteLength\":6}],"
+		"\"buffers\":[{\"byteLength\":44}]}";
+	while (json.size() % 4 != 0) json += ' ';
+
+	std::string bin;
+	for (float coordinate : { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f })
+		AppendBytes(bin, coordinate);
+	for (uint16_t index : { 0, 1, 2 })
+		AppendBytes(bin, index);
+	bin.append(2, '\0');
+
+	std::string file;
+	AppendBytes<uint32_t>(file, 0x46546C67);
+	AppendBytes<uint32_t>(file, 2);
+	AppendBytes<uint32_t>(file, 12 + 8 + json.size() + 8 + bin.size());
+	AppendBytes<uint32_t>(file, json.size());
+	AppendBytes<uint32_t>(file, 0x4E4F534A);
+	file += json;
+	AppendBytes<uint32_t>(file, bin.size());
+	AppendBytes<uint32_t>(file, 0x004E4942);
+	file += bin;
+
+	std::ofstream(path, std::ios::binary).write(file.data(), file.size());
+}
+
+// Every node should produce its own mesh with its world transform applied
+TEST(_GLTFLoader, LoadsNodesAsMeshes) {
+	WriteTriangleGLB("triangle.glb");
+	auto meshes = HF::Geometry::LoadGLB("triangle.glb");
+	std::remove("triangle.glb");
+
+	ASSERT_EQ(2, meshes.size());
+	ASSERT_EQ("First", meshes[0].name);
+	ASSERT_EQ("Second", meshes[1].name);
+	ASSERT_EQ(1, meshes[1].GetMeshID());
+	ASSERT_EQ(vector<int>({ 0, 1, 2 }), meshes[0].getRawIndices());
+	ASSERT_EQ(vector<float>({ 1, 0, 0, 2, 0, 0, 1, 1, 0 }), meshes[0].GetIndexedVertices());
+	ASSERT_EQ(vector<float>({ 1, 0, 2, 2, 0, 2, 1, 1, 2 }), meshes[1].GetIndexedVertices());
+}
+
+// Nodes with values of the wrong type should be rejected instead of read as garbage
+TEST(_GLTFLoader, ThrowsOnMalformedNodes) {
+	for (auto node : { std::make_pair("[1,\"x\",0]", "[1]"), std::make_pair("[1,0,0]", "[\"1\"]"), std::make_pair("[1,0,0]", "[0.5]") }) {
+		WriteTriangleGLB("malformed.glb", node.first, node.second);
+		ASSERT_THROW(HF::Geometry::LoadGLB("malformed.glb"), HF::Exceptions::InvalidOBJ);
+	}
+	std::remove("malformed.glb");
+}
+
+TEST(C_GLTFLoader, LoadGLBFile) {
+	WriteTriangleGLB("triangle_c.glb");
+	MeshInfo** meshes = nullptr;
+	int num_meshes = 0;
+	auto status = LoadGLBFile("triangle_c.glb", 0, 0, 0, &meshes, &num_meshes);
+	std::remove("triangle_c.glb");
+
+	ASSERT_EQ(HF_STATUS::OK, status);
+	ASSERT_EQ(2, num_meshes);
+	ASSERT_EQ(1, meshes[0]->NumTris());
+	for (int i = 0; i < num_meshes; i++)
+		DestroyMeshInfo(meshes[i]);
+	DestroyMeshInfoPtrArray(meshes);
+}
+
+// The same parameters should always produce the same building, and the seed should only move obstacles
+TEST(_SceneGenerator, IsDeterministic) {
+	HF::Geometry::BuildingParameters params;
+	params.obstacle_density = 0.3f;
+	params.seed = 12;
+
+	auto first = HF::Geometry::GenerateBuilding(params);
+	auto second = HF::Geometry::GenerateBuilding(params);
+	ASSERT_EQ(first.getRawIndices(), second.getRawIndices());
+	ASSERT_EQ(first.GetIndexedVertices(), second.GetIndexedVertices());
+
+	params.seed = 13;
+	auto reseeded = HF::Geometry::GenerateBuilding(params);
+	ASSERT_NE(first.GetIndexedVertices(), reseeded.GetIndexedVertices());
+}
+
+// Adding floors, rooms, or obstacles should add triangles, and the building should fill its footprint
+TEST(_SceneGenerator, ScalesWithParameters) {
+	HF::Geometry::BuildingParameters params;
+	params.obstacle_density = 0.0f;
+	const int base = HF::Geometry::GenerateBuilding(params).NumTris();
+
+	auto more_floors = params;
+	more_floors.floors = 4;
+	auto tall = HF::Geometry::GenerateBuilding(more_floors);
+	ASSERT_GT(tall.NumTris(), base);
+
+	auto more_rooms = params;
+	more_rooms.rooms_per_floor = 8;
+	ASSERT_GT(HF::Geometry::GenerateBuilding(more_rooms).NumTris(), base);
+
+	auto more_obstacles = params;
+	more_obstacles.obstacle_density = 0.5f;
+	ASSERT_GT(HF::Geometry::GenerateBuilding(more_obstacles).NumTris(), base);
+
+	auto no_stairs = more_floors;
+	no_stairs.stairs = false;
+	ASSERT_LT(HF::Geometry::GenerateBuilding(no_stairs).NumTris(), tall.NumTris());
+
+	// From the bottom of the ground floor to the top of the roof
+	const auto vertices = tall.GetIndexedVertices();
+	std::array<float, 3> min{ vertices[0], vertices[1], vertices[2] }, max = min;
+	for (size_t i = 0; i < vertices.size(); i++) {
+		min[i % 3] = std::min(min[i % 3], vertices[i]);
+		max[i % 3] = std::max(max[i % 3], vertices[i]);
+	}
+	ASSERT_NEAR(0.0f, min[0], 1e-4f);
+	ASSERT_NEAR(0.0f, min[1], 1e-4f);
+	ASSERT_NEAR(-0.2f, min[2], 1e-4f);
+	ASSERT_NEAR(params.width, max[0], 1e-4f);
+	ASSERT_NEAR(params.depth, max[1], 1e-4f);
+	ASSERT_NEAR(4 * params.storey_height, max[2], 1e-4f);
+}
+
+TEST(_SceneGenerator, ThrowsOnInvalidParameters) {
+	HF::Geometry::BuildingParameters params;
+
+	auto no_floors = params;
+	no_floors.floors = 0;
+	EXPECT_THROW(HF::Geometry::GenerateBuilding(no_floors), std::invalid_argument);
+
+	auto too_many_rooms = params;
+	too_many_rooms.rooms_per_floor = 1000;
+	EXPECT_THROW(HF::Geometry::GenerateBuilding(too_many_rooms), std::invalid_argument);
+
+	auto too_dense = params;
+	too_dense.obstacle_density = 1.5f;
+	EXPECT_THROW(HF::Geometry::GenerateBuilding(too_dense), std::invalid_argument);
+
+	// Lengths that aren't finite or would overflow the number of steps
+	for (float length : { NAN, INFINITY, 1e30f }) {
+		auto bad_width = params;
+		bad_width.width = length;
+		EXPECT_THROW(HF::Geometry::GenerateBuilding(bad_width), std::invalid_argument);
+
+		auto bad_depth = params;
+		bad_depth.depth = length;
+		EXPECT_THROW(HF::Geometry::GenerateBuilding(bad_depth), std::invalid_argument);
+
+		auto bad_height = params;
+		bad_height.storey_height = length;
+		EXPECT_THROW(HF::Geometry::GenerateBuilding(bad_height), std::invalid_argument);
+	}
+}
+
+TEST(C_SceneGenerator, GenerateBuildingMesh) {
+	MeshInfo* mesh = nullptr;
+	auto status = GenerateBuildingMesh(3, 30.0f, 15.0f, 3.0f, 6, true, 0.2f, 1, &mesh);
+
+	ASSERT_EQ(HF_STATUS::OK, status);
+	ASSERT_GT(mesh->NumTris(), 0);
+	DestroyMeshInfo(mesh);
+
+	status = GenerateBuildingMesh(0, 30.0f, 15.0f, 3.0f, 6, true, 0.2f, 1, &mesh);
+	ASSERT_EQ(HF_STATUS::OUT_OF_RANGE, status);
+}
+
 TEST(_OBJLoader, Doubles) {
 	std::string path = "teapot.obj"; // This is located in the folder where the EXE is
 	auto MI = HF::Geometry::LoadTMPMeshObjects<double>(path);
@@ -255,6 +709,133 @@ TEST(_MeshInfo, CanReproduceInputArray) {
 }
 
 
+TEST(_MeshInfo, IndexingMergesNegativeZero) {
+	// Two triangles whose shared vertices only differ by the sign of zero
+	std::vector<std::array<float, 3>> vertices{
+		{ 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+		{ -0.0f, 1.0f, -0.0f }, { 1.0f, -0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }
+	};
+	MeshInfo mesh(vertices, 0, "Quad");
+
+	ASSERT_EQ(4, mesh.NumVerts());
+	ASSERT_EQ(2, mesh.NumTris());
+
+	// Vertices keep the order they first appeared in
+	const std::vector<int> expected_indices{ 0, 1, 2, 2, 1, 3 };
+	ASSERT_EQ(expected_indices, mesh.getRawIndices());
+}
+
+TEST(_MeshInfo, WeldVerticesWithTolerance) {
+	// Two triangles sharing an edge whose vertices are slightly apart, and one that
+	// collapses into a line once welded
+	std::vector<float> vertices{
+		0,0,0, 1,0,0, 0,1,0,
+		1.0001f,0,0, 0,1.0001f,0, 1,1,0,
+		0.0001f,0,0, 2,2,0
+	};
+	std::vector<int> indices{ 0,1,2, 3,5,4, 0,6,7 };
+	MeshInfo mesh(vertices, indices, 0, "Quad");
+
+	ASSERT_EQ(3, mesh.WeldVertices(0.001f));
+	ASSERT_EQ(5, mesh.NumVerts());
+	ASSERT_EQ(2, mesh.NumTris());
+
+	const std::vector<int> expected_indices{ 0, 1, 2, 1, 3, 2 };
+	ASSERT_EQ(expected_indices, mesh.getRawIndices());
+
+	// Welding again with the same tolerance changes nothing
+	ASSERT_EQ(0, mesh.WeldVertices(0.001f));
+}
+
+TEST(_MeshInfo, WeldingIndexedMeshRemovesNothing) {
+	// Indexing with the default tolerance should find every duplicate vertex, so welding
+	// the mesh again shouldn't remove any more
+	auto raw_verts = HF::Geometry::LoadRawVertices("big_teapot.obj"); // This is located in the folder where the EXE is
+	MeshInfo mesh(raw_verts, 0, "Teapot");
+	const int num_verts = mesh.NumVerts();
+
+	ASSERT_EQ(0, mesh.WeldVertices());
+	ASSERT_EQ(num_verts, mesh.NumVerts());
+}
+
+// Transforming should scale, rotate and translate every vertex in place
+TEST(_MeshInfo, TransformAppliesAffineMatrix) {
+	vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0 };
+	vector<int> indices{ 0,1,2 };
+	MeshInfo mesh(vertices, indices, 0, "Transform");
+	const float* buffer = mesh.GetVertexPointer().data;
+
+	// Scale by 2, rotate 90 degrees about z, then move up by 5
+	mesh.Transform({
+		0, -2, 0, 0,
+		2, 0, 0, 0,
+		0, 0, 2, 5,
+		0, 0, 0, 1
+	});
+	ASSERT_EQ(buffer, mesh.GetVertexPointer().data);
+	ASSERT_EQ(vector<float>({ 0, 0, 5, 0, 2, 5, -2, 0, 5 }), mesh.GetIndexedVertices());
+}
+
+// Queued transforms should be combined in order and only applied once requested
+TEST(_MeshInfo, QueuedTransformsCombineInOrder) {
+	vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0 };
+	vector<int> indices{ 0,1,2 };
+	MeshInfo mesh(vertices, indices, 0, "Transform");
+
+	const std::array<float, 16> translate{ 1,0,0,1, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+	const std::array<float, 16> scale{ 3,0,0,0, 0,3,0,0, 0,0,3,0, 0,0,0,1 };
+	mesh.QueueTransform(translate);
+	mesh.QueueTransform(scale);
+	ASSERT_TRUE(mesh.HasPendingTransform());
+	ASSERT_EQ(vertices, mesh.GetIndexedVertices());
+
+	mesh.ApplyPendingTransform();
+	ASSERT_FALSE(mesh.HasPendingTransform());
+	ASSERT_EQ(vector<float>({ 3, 0, 0, 6, 0, 0, 3, 3, 0 }), mesh.GetIndexedVertices());
+}
+
+// Matrices with NaN or infinity should be rejected without changing the mesh
+TEST(_MeshInfo, TransformThrowsOnNonFiniteMatrix) {
+	vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0 };
+	vector<int> indices{ 0,1,2 };
+	MeshInfo mesh(vertices, indices, 0, "Transform");
+
+	for (float value : { NAN, INFINITY, -INFINITY }) {
+		std::array<float, 16> matrix{ 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+		matrix[3] = value;
+		ASSERT_THROW(mesh.Transform(matrix), std::invalid_argument);
+		ASSERT_THROW(mesh.QueueTransform(matrix), std::invalid_argument);
+	}
+	ASSERT_FALSE(mesh.HasPendingTransform());
+	ASSERT_EQ(vertices, mesh.GetIndexedVertices());
+}
+
+// Only the triangle within the margin of the box should remain, along with its vertices
+TEST(_MeshInfo, CropToBoxRemovesDistantTriangles) {
+	vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0, 100,0,0, 101,0,0, 100,1,0 };
+	vector<int> indices{ 0,1,2, 3,4,5 };
+	MeshInfo mesh(vertices, indices, 0, "Crop");
+
+	ASSERT_EQ(1, mesh.CropToBox({ -1, -1, -1 }, { -0.5f, -0.5f, 1 }, 0.5f));
+	ASSERT_EQ(vector<int>({ 0, 1, 2 }), mesh.getRawIndices());
+	ASSERT_EQ(vector<float>({ 0, 0, 0, 1, 0, 0, 0, 1, 0 }), mesh.GetIndexedVertices());
+}
+
+// Triangles in the notch of a concave polygon should only be kept once they're within the margin
+TEST(_MeshInfo, CropToPolygonUsesMargin) {
+	vector<float> vertices{ 0,0,0, 1,0,0, 0,1,0, 5,5,0, 6,5,0, 5,6,0, 100,0,0, 101,0,0, 100,1,0 };
+	vector<int> indices{ 0,1,2, 3,4,5, 6,7,8 };
+	vector<std::array<float, 2>> polygon{ {-1,-1}, {10,-1}, {10,2}, {2,2}, {2,10}, {-1,10} };
+
+	MeshInfo no_margin(vertices, indices, 0, "Crop");
+	ASSERT_EQ(2, no_margin.CropToPolygon(polygon));
+	ASSERT_EQ(3, no_margin.NumVerts());
+
+	MeshInfo with_margin(vertices, indices, 0, "Crop");
+	ASSERT_EQ(1, with_margin.CropToPolygon(polygon, 3.5f));
+	ASSERT_EQ(2, with_margin.NumTris());
+}
+
 ///
 ///	The following are tests for the code samples for HF::Geometry
 ///
@@ -864,6 +1445,24 @@ namespace CInterfaceTests {
 		DestroyMeshInfo(info);
 	}
 
+	// Invalid pointers and matrices with NaN or infinity should be rejected
+	TEST(C_OBJLoader, TransformMeshRejectsInvalidInput) {
+		MeshInfo * info = NULL;
+		auto res = StoreMesh(&info, mesh_indices, mesh_num_indices, mesh_vertices, mesh_num_vertices, mesh_name.c_str(), mesh_id);
+		ASSERT_EQ(HF_STATUS::OK, res);
+
+		float matrix[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+		ASSERT_EQ(HF_STATUS::INVALID_PTR, TransformMesh(nullptr, matrix, false));
+		ASSERT_EQ(HF_STATUS::INVALID_PTR, TransformMesh(info, nullptr, false));
+
+		matrix[5] = NAN;
+		ASSERT_EQ(HF_STATUS::OUT_OF_RANGE, TransformMesh(info, matrix, false));
+		ASSERT_EQ(HF_STATUS::OUT_OF_RANGE, TransformMesh(info, matrix, true));
+		ASSERT_FALSE(info->HasPendingTransform());
+
+		DestroyMeshInfo(info);
+	}
+
 	TEST(C_OBJLoader, GetVertsAndTris) {
 		// Requires #include "objloader_C.h", #include "meshinfo.h"
 
@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <thread>
+
+#include <parallelism.h>
+
+// Leases split the budget between analyses running at the same time
+TEST(_Parallel, ThreadLeaseSharesBudget) {
+	HF::Parallel::SetThreadCount(4);
+
+	{
+		// The first lease takes 3 of the 4 threads
+		HF::Parallel::ThreadLease first(3);
+		ASSERT_EQ(3, first.size());
+
+		std::thread([] {
+			// Only 1 thread is left, but the second lease still gets its half of the budget
+			HF::Parallel::ThreadLease second(3);
+			EXPECT_EQ(2, second.size());
+
+			std::thread([] {
+				// Once the budget is empty, leases still get one thread
+				HF::Parallel::ThreadLease third;
+				EXPECT_EQ(1, third.size());
+			}).join();
+		}).join();
+	}
+
+	// Every thread is returned once the leases are destroyed
+	HF::Parallel::ThreadLease all;
+	EXPECT_EQ(4, all.size());
+
+	HF::Parallel::SetThreadCount(-1);
+}
+
+// Leases are sized by the caller, then the override, then the library-wide count
+TEST(_Parallel, ThreadLeaseSize) {
+	HF::Parallel::SetThreadCount(8);
+
+	// Never more threads than items of work
+	{
+		HF::Parallel::ThreadLease lease(-1, 2);
+		EXPECT_EQ(2, lease.size());
+	}
+
+	// An override is used when the caller doesn't ask for a count
+	{
+		HF::Parallel::ThreadCountOverride limit(3);
+		{
+			HF::Parallel::ThreadLease lease;
+			EXPECT_EQ(3, lease.size());
+		}
+
+		// but the caller's count comes first
+		HF::Parallel::ThreadLease lease(5);
+		EXPECT_EQ(5, lease.size());
+	}
+
+	// Nested leases reuse the threads of the outer lease instead of taking more
+	{
+		HF::Parallel::ThreadLease outer(2);
+		HF::Parallel::ThreadLease inner(6);
+		EXPECT_EQ(2, inner.size());
+	}
+
+	HF::Parallel::SetThreadCount(-1);
+	EXPECT_EQ(std::max(1u, std::thread::hardware_concurrency()), HF::Parallel::GetThreadCount());
+}
@@ -14,8 +14,10 @@
 #include <edge.h>
 #include <path.h>
 #include <HFExceptions.h>
+#include <cancellation.h>
 
 #include "pathfinder_C.h"
+#include "jobs_C.h"
 #include "cost_algorithms.h"
 #include "spatialstructures_C.h"
 
@@ -693,6 +695,59 @@ TEST(_pathFinding, InsertPathsIntoArray) {
 }
 */
 
+/// <summary> Create a compressed graph of a size x size grid with edges to the right and up. </summary>
+Graph CreateGridGraph(int size) {
+	Graph g;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			const int id = y * size + x;
+			if (x + 1 < size) g.addEdge(id, id + 1, 1);
+			if (y + 1 < size) g.addEdge(id, id + size, 1);
+		}
+	}
+	g.Compress();
+	return g;
+}
+
+TEST(_pathFinding, CancelledTokenStopsDistanceAndPredecessor) {
+	Graph g = CreateGridGraph(10);
+	auto bg = CreateBoostGraph(g);
+
+	HF::Exceptions::CancellationToken token;
+	token.Cancel();
+	EXPECT_THROW(GenerateDistanceAndPred(*bg, &token), HF::Exceptions::OperationCancelled);
+
+	// An uncancelled token reports every row as finished
+	HF::Exceptions::CancellationToken progress_token;
+	auto matricies = GenerateDistanceAndPred(*bg, &progress_token);
+	EXPECT_EQ(progress_token.Progress(), 1.0f);
+	delete matricies.dist;
+	delete matricies.pred;
+}
+
+TEST(_pathFinding, CancelledTokenClearsAllToAllPaths) {
+	Graph g = CreateGridGraph(5);
+	auto bg = CreateBoostGraph(g);
+
+	const int path_count = g.size() * g.size();
+	vector<Path*> out_paths(path_count, nullptr);
+	vector<PathMember*> out_members(path_count, nullptr);
+	vector<int> out_sizes(path_count, -1);
+
+	HF::Exceptions::CancellationToken token;
+	token.Cancel();
+	EXPECT_THROW(
+		InsertAllToAllPathsIntoArray(bg.get(), out_paths.data(), out_members.data(), out_sizes.data(), &token),
+		HF::Exceptions::OperationCancelled
+	);
+
+	// Nothing may be left for the caller to free
+	for (int i = 0; i < path_count; i++) {
+		EXPECT_EQ(out_paths[i], nullptr);
+		EXPECT_EQ(out_sizes[i], 0);
+	}
+}
+
 namespace CInterfaceTests {
 	TEST(C_Pathfinder, CreatePath) {
 		// Requires #include "pathfinder_C.h", #include "graph.h", #include "path.h", #include "path_finder.h"
@@ -1151,4 +1206,74 @@ namespace CInterfaceTests {
 		--------------------------
 		[snippet_pathfinder_C_CreateAllToAllPaths_output] */
 	}
+
+	TEST(C_Pathfinder, DistanceAndPredecessorJob) {
+		Graph g = CreateGridGraph(10);
+
+		// Start the job, then wait for it to finish
+		HF::Jobs::Job* job = nullptr;
+		std::vector<float>* dist_vector = nullptr; std::vector<int>* pred_vector = nullptr;
+		float* dist_data = nullptr; int* pred_data = nullptr;
+		ASSERT_EQ(HF::Exceptions::OK, StartDistanceAndPredecessorJob(&g, "", &dist_vector, &dist_data, &pred_vector, &pred_data, &job));
+
+		int status = HF::Exceptions::IN_PROGRESS;
+		WaitForJob(job, &status);
+		ASSERT_EQ(HF::Exceptions::OK, status);
+
+		float progress = 0;
+		PollJob(job, &status, &progress);
+		EXPECT_EQ(HF::Exceptions::OK, status);
+		EXPECT_EQ(1.0f, progress);
+		DestroyJob(job);
+
+		// Compare to the synchronous C++ function
+		auto bg = CreateBoostGraph(g);
+		auto matricies = GenerateDistanceAndPred(*bg);
+		EXPECT_EQ(*matricies.dist, *dist_vector);
+		EXPECT_EQ(*matricies.pred, *pred_vector);
+		EXPECT_EQ(dist_vector->data(), dist_data);
+
+		delete matricies.dist; delete matricies.pred;
+		DestroyFloatVector(dist_vector); DestroyIntVector(pred_vector);
+	}
+
+	TEST(C_Pathfinder, CancelledAllToAllPathsJob) {
+		Graph g = CreateGridGraph(20);
+		const int path_count = g.size() * g.size();
+		vector<Path*> out_paths(path_count, nullptr);
+		vector<PathMember*> out_members(path_count, nullptr);
+		vector<int> out_sizes(path_count, -1);
+
+		HF::Jobs::Job* job = nullptr;
+		StartAllToAllPathsJob(&g, "", out_paths.data(), out_members.data(), out_sizes.data(), path_count, &job);
+		CancelJob(job);
+
+		// The job may have finished before it was cancelled, but if not it must leave nothing behind
+		int status = HF::Exceptions::IN_PROGRESS;
+		WaitForJob(job, &status);
+		DestroyJob(job);
+		ASSERT_TRUE(status == HF::Exceptions::CANCELLED || status == HF::Exceptions::OK);
+
+		for (int i = 0; i < path_count; i++) {
+			if (status == HF::Exceptions::CANCELLED)
+				EXPECT_EQ(out_paths[i], nullptr);
+			delete out_paths[i];
+		}
+	}
+
+	TEST(C_Pathfinder, JobReportsMissingCost) {
+		Graph g = CreateGridGraph(3);
+		std::vector<float>* dist_vector = nullptr; std::vector<int>* pred_vector = nullptr;
+		float* dist_data = nullptr; int* pred_data = nullptr;
+
+		HF::Jobs::Job* job = nullptr;
+		StartDistanceAndPredecessorJob(&g, "not a cost", &dist_vector, &dist_data, &pred_vector, &pred_data, &job);
+
+		int status = HF::Exceptions::IN_PROGRESS;
+		WaitForJob(job, &status);
+		DestroyJob(job);
+
+		EXPECT_EQ(HF::Exceptions::NO_COST, status);
+		EXPECT_EQ(dist_vector, nullptr);
+	}
 }
\ No newline at end of file
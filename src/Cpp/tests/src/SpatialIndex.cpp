@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <spatialstructuresdb.h>
+#include <graph.h>
+#include <node.h>
+#include <HFExceptions.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using HF::SpatialStructures::SpatialIndex;
+using HF::SpatialStructures::WriteSpatialIndex;
+using HF::SpatialStructures::Node;
+using std::string;
+using std::vector;
+
+/// <summary> Create a cloud of random nodes with a score equal to each node's index. </summary>
+vector<Node> RandomNodes(int count, vector<float>& out_scores) {
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> xy(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> z(0.0f, 5.0f);
+
+	vector<Node> nodes;
+	for (int i = 0; i < count; i++) {
+		nodes.emplace_back(xy(generator), xy(generator), z(generator), i);
+		out_scores.push_back(static_cast<float>(i));
+	}
+	return nodes;
+}
+
+TEST(_SpatialIndex, QueryBoxMatchesBruteForce) {
+	const string path = "spatial_index_box.idx";
+	vector<float> scores;
+	const auto nodes = RandomNodes(20000, scores);
+	WriteSpatialIndex(path, nodes, { "index" }, { scores }, 64);
+
+	SpatialIndex index(path);
+	ASSERT_EQ(index.size(), nodes.size());
+	ASSERT_EQ(index.ScoreNames(), vector<string>({ "index" }));
+
+	const std::array<float, 3> min_point = { -20.0f, 10.0f, 1.0f };
+	const std::array<float, 3> max_point = { 35.0f, 60.0f, 4.0f };
+
+	vector<float> found_scores;
+	auto found = index.QueryBox(min_point, max_point, found_scores);
+	ASSERT_EQ(found_scores.size(), found.size());
+
+	vector<int> found_ids;
+	for (size_t i = 0; i < found.size(); i++) {
+		found_ids.push_back(found[i].id);
+		EXPECT_EQ(found_scores[i], static_cast<float>(found[i].id));
+		EXPECT_EQ(found[i].x, nodes[found[i].id].x);
+	}
+
+	vector<int> expected_ids;
+	for (const auto& node : nodes)
+		if (node.x >= min_point[0] && node.x <= max_point[0]
+			&& node.y >= min_point[1] && node.y <= max_point[1]
+			&& node.z >= min_point[2] && node.z <= max_point[2])
+			expected_ids.push_back(node.id);
+
+	std::sort(found_ids.begin(), found_ids.end());
+	EXPECT_EQ(found_ids, expected_ids);
+}
+
+TEST(_SpatialIndex, NearestMatchesBruteForce) {
+	const string path = "spatial_index_nearest.idx";
+	vector<float> scores;
+	const auto nodes = RandomNodes(5000, scores);
+	WriteSpatialIndex(path, nodes, {}, {}, 32);
+
+	SpatialIndex index(path);
+
+	// Include points outside of the grid, which start their search from an edge tile
+	const vector<std::array<float, 3>> points = { { 0, 0, 0 }, { 99, -99, 2 }, { 500, 20, 0 }, { -300, -300, 50 } };
+	for (const auto& point : points) {
+		auto found = index.Nearest(point, 10);
+		ASSERT_EQ(found.size(), 10);
+
+		auto sorted = nodes;
+		std::sort(sorted.begin(), sorted.end(), [&](const Node& a, const Node& b) {
+			return a.distanceTo(Node(point[0], point[1], point[2])) < b.distanceTo(Node(point[0], point[1], point[2]));
+		});
+
+		for (int i = 0; i < 10; i++)
+			EXPECT_EQ(found[i].id, sorted[i].id);
+	}
+
+	// Asking for more nodes than exist returns all of them
+	EXPECT_EQ(index.Nearest({ 0, 0, 0 }, 100000).size(), nodes.size());
+}
+
+TEST(_SpatialIndex, StoresNumericNodeAttributesOfGraph) {
+	const string path = "spatial_index_graph.idx";
+
+	vector<Node> nodes = { Node(0, 0, 0), Node(1, 0, 0), Node(2, 0, 0) };
+	HF::SpatialStructures::Graph graph({ { 1 }, { 2 }, {} }, { { 1.0f }, { 1.0f }, {} }, nodes);
+	graph.AddNodeAttributes({ 0, 2 }, "view", { "0.25", "4" });
+
+	WriteSpatialIndex(path, graph, { "view" });
+	SpatialIndex index(path);
+
+	vector<float> view;
+	auto found = index.Nearest({ 1.9f, 0, 0 }, 3, view);
+	ASSERT_EQ(found.size(), 3);
+	EXPECT_EQ(found[0].id, 2);
+	EXPECT_EQ(view[0], 4.0f);
+	EXPECT_TRUE(std::isnan(view[1]));
+	EXPECT_EQ(view[2], 0.25f);
+}
+
+TEST(_SpatialIndex, RejectsFilesThatArentIndexes) {
+	const string path = "spatial_index_invalid.idx";
+	{ std::ofstream(path) << "this is not a spatial index, but is long enough to have a header"; }
+
+	EXPECT_THROW(SpatialIndex index(path), HF::Exceptions::MalformedDatabase);
+	EXPECT_THROW(SpatialIndex index("does_not_exist.idx"), HF::Exceptions::FileNotFound);
+}
@@ -372,6 +372,25 @@ TEST(_Graph, AddEdgeToNewCost) {
 	ASSERT_EQ(testcost_edges[0].children[0].weight, 0.54f);
 }
 
+// Assert that a graph constructed from a CSR contains exactly the edges of that CSR
+TEST(_Graph, ConstructFromCSR) {
+	std::vector<HF::SpatialStructures::Node> nodes{ {0, 0, 0}, {1, 0, 0}, {2, 0, 0} };
+
+	// 0 -> 1, 0 -> 2, 2 -> 1
+	std::vector<int> outer_indices{ 0, 2, 2, 3 };
+	std::vector<int> inner_indices{ 1, 2, 1 };
+	std::vector<float> values{ 1.0f, 2.0f, 3.0f };
+
+	Graph g(outer_indices, inner_indices, values, nodes);
+
+	ASSERT_EQ(g.size(), 3);
+	ASSERT_EQ(g[nodes[0]].size(), 2);
+	ASSERT_EQ(g[nodes[1]].size(), 0);
+	ASSERT_EQ(g[nodes[2]].size(), 1);
+	ASSERT_EQ(g[nodes[2]][0].score, 3.0f);
+	ASSERT_TRUE(g.HasEdge(0, 2));
+}
+
 // Assert that the above test holds for adding multiple edges.
 TEST(_Graph, MultipleNewCostDoesntAffectDefault) {
 	
@@ -671,6 +690,86 @@ TEST(C_Graph, AttrToParams) {
 	ASSERT_EQ(scores[ids[2]] + scores[ids[1]], G.GetCost(ids[2], ids[1], "output_str"));
 }
 
+// Step types should follow their edges into the CSR, regardless of the order the edges were added in
+TEST(_Graph, StepTypes) {
+	Graph g;
+	g.addEdge(2, 0, 1.0f, STEP::DOWN);
+	g.addEdge(0, 2, 1.0f, STEP::UP);
+	g.addEdge(0, 1, 1.0f);
+	g.addEdge(1, 0, 1.0f, STEP::NONE);
+	ASSERT_TRUE(g.HasStepTypes());
+
+	ASSERT_THROW(g.GetStepType(0, 2), std::logic_error);
+	g.Compress();
+
+	EXPECT_EQ(STEP::UP, g.GetStepType(0, 2));
+	EXPECT_EQ(STEP::DOWN, g.GetStepType(2, 0));
+	EXPECT_EQ(STEP::NONE, g.GetStepType(1, 0));
+	EXPECT_EQ(STEP::NOT_CONNECTED, g.GetStepType(0, 1));
+	EXPECT_EQ(STEP::NOT_CONNECTED, g.GetStepType(1, 2));
+	EXPECT_EQ(4, g.GetStepTypes().size());
+
+	// Updating an edge after compression changes its step
+	g.addEdge(0, 1, 2.0f, STEP::OVER);
+	EXPECT_EQ(STEP::OVER, g.GetStepType(0, 1));
+
+	// Adding new edges after compression keeps the steps of the existing ones once the graph is compressed again
+	g.addEdge(1, 2, 1.0f);
+	g.addEdge(2, 1, 1.0f, STEP::OVER);
+	ASSERT_THROW(g.GetStepType(2, 1), std::logic_error);
+	g.Compress();
+	EXPECT_EQ(STEP::NOT_CONNECTED, g.GetStepType(1, 2));
+	EXPECT_EQ(STEP::OVER, g.GetStepType(2, 1));
+	EXPECT_EQ(STEP::UP, g.GetStepType(0, 2));
+	EXPECT_EQ(STEP::DOWN, g.GetStepType(2, 0));
+	EXPECT_EQ(STEP::NONE, g.GetStepType(1, 0));
+	EXPECT_EQ(STEP::OVER, g.GetStepType(0, 1));
+	EXPECT_EQ(6, g.GetStepTypes().size());
+
+	// Updating an edge that was just added keeps the steps of the other new edges
+	g.addEdge(3, 0, 1.0f, STEP::DOWN);
+	g.addEdge(0, 3, 1.0f, STEP::UP);
+	g.addEdge(0, 3, 1.0f, STEP::OVER);
+	g.Compress();
+	EXPECT_EQ(STEP::DOWN, g.GetStepType(3, 0));
+	EXPECT_EQ(STEP::OVER, g.GetStepType(0, 3));
+	EXPECT_EQ(STEP::UP, g.GetStepType(0, 2));
+	EXPECT_EQ(8, g.GetStepTypes().size());
+
+	// Stairs cost 10 times as much as flat ground
+	g.CreateStepCost("AvoidStairs", { 1.0f, 1.0f, 10.0f, 10.0f, 1.0f });
+	EXPECT_EQ(10.0f, g.GetCost(0, 2, "AvoidStairs"));
+	EXPECT_EQ(10.0f, g.GetCost(2, 0, "AvoidStairs"));
+	EXPECT_EQ(2.0f, g.GetCost(0, 1, "AvoidStairs"));
+
+	g.Clear();
+	EXPECT_FALSE(g.HasStepTypes());
+}
+
+TEST(C_Graph, StepTypes) {
+	Graph g;
+	g.addEdge(0, 1, 2.0f, STEP::UP);
+	g.addEdge(1, 0, 2.0f, STEP::DOWN);
+
+	int nnz = 0;
+	const unsigned char* step_types = nullptr;
+	ASSERT_EQ(HF_STATUS::OK, GetStepTypes(&g, &nnz, &step_types));
+	ASSERT_EQ(2, nnz);
+	EXPECT_EQ(STEP::UP, step_types[0]);
+	EXPECT_EQ(STEP::DOWN, step_types[1]);
+
+	const float multipliers[5] = { 1.0f, 1.0f, 5.0f, 1.0f, 1.0f };
+	ASSERT_EQ(HF_STATUS::OK, CreateStepCost(&g, multipliers, "AvoidUp"));
+	EXPECT_EQ(10.0f, g.GetCost(0, 1, "AvoidUp"));
+	EXPECT_EQ(2.0f, g.GetCost(1, 0, "AvoidUp"));
+	EXPECT_EQ(HF_STATUS::INVALID_COST, CreateStepCost(&g, multipliers, g.GetDefaultCostName().c_str()));
+
+	Graph no_steps;
+	no_steps.addEdge(0, 1, 1.0f);
+	EXPECT_EQ(HF_STATUS::NOT_FOUND, GetStepTypes(&no_steps, &nnz, &step_types));
+	EXPECT_EQ(HF_STATUS::NOT_FOUND, CreateStepCost(&no_steps, multipliers, "AvoidUp"));
+}
+
 TEST(_Rounding, addition_error)
 {
 	// define values as floats
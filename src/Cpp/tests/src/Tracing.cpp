@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <tracing.h>
+#include <graph.h>
+#include <path.h>
+#include <path_finder.h>
+#include <boost_graph.h>
+#include <graph_generator.h>
+#include <embree_raytracer.h>
+#include <HFExceptions.h>
+
+#include "tracing_C.h"
+
+using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::Path;
+using HF::SpatialStructures::PathMember;
+using HF::RayTracer::EmbreeRayTracer;
+using namespace HF::Pathfinding;
+using std::vector;
+
+// Stages are timed once per outermost call and counters from every thread are added together
+TEST(_Tracing, RecordsStages) {
+	HF::Tracing::Reset();
+	HF::Tracing::Enable();
+
+	// Create a 5x5 grid with edges to the right and up
+	const int size = 5;
+	Graph g;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			const int id = y * size + x;
+			if (x + 1 < size) g.addEdge(id, id + 1, 1);
+			if (y + 1 < size) g.addEdge(id, id + size, 1);
+		}
+	}
+	g.Compress();
+	auto bg = CreateBoostGraph(g);
+
+	const int path_count = g.size() * g.size();
+	vector<Path*> out_paths(path_count, nullptr);
+	vector<PathMember*> out_members(path_count, nullptr);
+	vector<int> out_sizes(path_count, -1);
+	InsertAllToAllPathsIntoArray(bg.get(), out_paths.data(), out_members.data(), out_sizes.data());
+
+	// Counts of threads that already exited are kept
+	std::thread([] { HF::Tracing::Count(HF::Tracing::HASH_PROBES, 2); }).join();
+	std::thread([] { HF::Tracing::Count(HF::Tracing::HASH_PROBES, 1); }).join();
+	HF::Tracing::Count(HF::Tracing::HASH_PROBES, 2);
+
+	HF::Tracing::Enable(false);
+
+	// Nothing is recorded while tracing is disabled
+	HF::Tracing::Count(HF::Tracing::HASH_PROBES, 100);
+	FindPath(bg.get(), 0, g.size() - 1);
+
+	EXPECT_EQ(5, HF::Tracing::GetCount(HF::Tracing::HASH_PROBES));
+	EXPECT_EQ(1, HF::Tracing::GetStageCalls(HF::Tracing::COMPRESS_GRAPH));
+
+	// InsertAllToAllPathsIntoArray calls InsertPathsIntoArray, but the stage is only counted once
+	EXPECT_EQ(1, HF::Tracing::GetStageCalls(HF::Tracing::PATHFINDING));
+	EXPECT_GE(HF::Tracing::GetStageMilliseconds(HF::Tracing::PATHFINDING), 0.0);
+
+	const std::string trace = HF::Tracing::ChromeTraceJSON();
+	EXPECT_NE(trace.find("\"name\":\"Pathfinding\",\"cat\":\"dhart\",\"ph\":\"X\""), std::string::npos);
+	EXPECT_NE(trace.find("\"hash_probes\":5"), std::string::npos);
+
+	HF::Tracing::Reset();
+	EXPECT_EQ(0, HF::Tracing::GetCount(HF::Tracing::HASH_PROBES));
+	EXPECT_EQ(0, HF::Tracing::GetStageCalls(HF::Tracing::PATHFINDING));
+
+	for (auto path : out_paths)
+		delete path;
+}
+
+// The graph generator counts every edge it adds to the graph
+TEST(_Tracing, CountsGraphGeneratorEdges) {
+	// Two triangles forming a 20x20 plane. Built directly, since meshinfo.h and boost_graph.h
+	// can't be included together.
+	const vector<std::array<float, 3>> plane{
+		{ -10, -10, 0 }, { 10, -10, 0 }, { 10, 10, 0 },
+		{ -10, -10, 0 }, { 10, 10, 0 }, { -10, 10, 0 }
+	};
+	EmbreeRayTracer ray_tracer(plane);
+	HF::GraphGenerator::GraphGenerator GG(ray_tracer);
+
+	HF::Tracing::Reset();
+	HF::Tracing::Enable();
+
+	Graph g = GG.BuildNetwork(std::array<float, 3>{0, 0, 0.25}, std::array<float, 3>{1, 1, 1}, 10, 1, 45, 1, 45, 1, 1, -1);
+
+	HF::Tracing::Enable(false);
+	g.Compress();
+
+	int num_edges = 0;
+	for (const auto& edge_set : g.GetEdges())
+		num_edges += edge_set.children.size();
+
+	ASSERT_GT(num_edges, 0);
+	EXPECT_EQ(num_edges, HF::Tracing::GetCount(HF::Tracing::EDGES_ADDED));
+	EXPECT_GT(HF::Tracing::GetCount(HF::Tracing::NODES_POPPED), 0);
+	EXPECT_GT(HF::Tracing::GetCount(HF::Tracing::INTERSECTION_RAYS), 0);
+	EXPECT_EQ(1, HF::Tracing::GetStageCalls(HF::Tracing::GENERATE_GRAPH));
+
+	HF::Tracing::Reset();
+}
+
+namespace CInterfaceTests {
+	// Null arguments are rejected instead of dereferenced
+	TEST(C_Tracing, RejectsNullPointers) {
+		EXPECT_EQ(HF::Exceptions::HF_STATUS::INVALID_PTR, GetTraceStats(nullptr));
+		EXPECT_EQ(HF::Exceptions::HF_STATUS::INVALID_PTR, WriteChromeTrace(nullptr));
+
+		TraceStats stats;
+		EXPECT_EQ(HF::Exceptions::HF_STATUS::OK, GetTraceStats(&stats));
+	}
+}
@@ -8,9 +8,15 @@
 #include <edge.h>
 #include <node.h>
 #include <visibility_graph.h>
+#include <visibility_matrix.h>
 #include <string>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <array>
 #include <visibility_graph_C.h>
+#include <HFExceptions.h>
 
 using namespace HF::VisibilityGraph;
 using HF::SpatialStructures::Graph;
@@ -80,6 +86,345 @@ TEST(_VisibilityGraph, NodesOnFlatPlaneWithWallDontConnect) {
 }
 
 
+// Nodes below the plane fail the height check and should never be connected, regardless
+// of where they fall in the batch of height checks. 
+TEST(_VisibilityGraph, HeightCheckFiltersNodesBelowGeometry) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> nodes;
+	for (int i = 0; i < 100; i++)
+		nodes.emplace_back(Node(i % 10 - 5, i / 10 - 5, (i % 3 == 0) ? -1 : 0));
+
+	const int num_below = 34;
+	auto graph = AllToAll(plane_tracer, nodes);
+	auto counts = graph.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT);
+
+	for (int i = 0; i < nodes.size(); i++) {
+		if (i % 3 == 0)
+			ASSERT_EQ(0, counts[i]);
+		else
+			ASSERT_EQ(nodes.size() - num_below - 1, counts[i]);
+	}
+}
+
+// Nodes in a line 1 meter apart should only connect to nodes within max_distance
+TEST(_VisibilityGraph, MaxDistanceLimitsEdges) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> nodes;
+	for (int i = 0; i < 10; i++)
+		nodes.emplace_back(Node(i, 0, 0));
+
+	auto graph = AllToAll(plane_tracer, nodes, 1.7f, 2.5f);
+
+	// The ends only have two nodes in range, everything else has four
+	ASSERT_EQ(graph[nodes[0]].size(), 2);
+	ASSERT_EQ(graph[nodes[9]].size(), 2);
+	for (int i = 2; i < 8; i++)
+		ASSERT_EQ(graph[nodes[i]].size(), 4);
+
+	// Every edge should be within range
+	for (const auto& node : nodes)
+		for (const auto& edge : graph[node])
+			ASSERT_LE(edge.score, 2.5f);
+}
+
+// Limiting the range to something larger than the set of nodes shouldn't change the result
+TEST(_VisibilityGraph, MaxDistanceMatchesUnlimited) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> nodes;
+	for (int i = -5; i < 5; i++)
+		for (int k = -5; k < 5; k++)
+			nodes.emplace_back(Node(i, k, 0));
+
+	auto unlimited = AllToAll(plane_tracer, nodes);
+	auto limited = AllToAll(plane_tracer, nodes, 1.7f, 100.0f);
+
+	for (const auto& node : nodes)
+		ASSERT_EQ(unlimited[node].size(), limited[node].size());
+}
+
+// A node far above another should be outside of its upward field of view
+TEST(_VisibilityGraph, UpwardLimitBlocksSteepSightlines) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> nodes{ Node(0, 0, 0), Node(1, 0, 5) };
+
+	auto graph = AllToAll(plane_tracer, nodes, 1.7f, -1.0f, 50.0f, 90.0f);
+
+	// Node 0 can't look up far enough to see node 1, but node 1 can look down at node 0
+	ASSERT_EQ(graph[nodes[0]].size(), 0);
+	ASSERT_EQ(graph[nodes[1]].size(), 1);
+}
+
+// Only nodes in group b within range of nodes in group a should be connected
+TEST(_VisibilityGraph, GroupToGroupMaxDistance) {
+	auto plane_tracer = CreatePlaneTracer();
+	vector<Node> group_a{ Node(0, 0, 0) };
+	vector<Node> group_b{ Node(1, 0, 0), Node(2, 0, 0), Node(5, 0, 0) };
+
+	auto graph = GroupToGroup(plane_tracer, group_a, group_b, 1.7f, 3.0f);
+	auto counts = graph.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT);
+
+	ASSERT_EQ(2, counts[0]);
+}
+
+// Splitting the work into small blocks and tiles should produce the same graph as AllToAll
+TEST(_VisibilityGraph, BlockedMatchesAllToAll) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> nodes;
+	for (int i = -5; i < 5; i++)
+		for (int k = -5; k < 5; k++)
+			nodes.emplace_back(Node(i, k, 0));
+	nodes.emplace_back(Node(0, 0, -10)); // Fails the height check
+
+	auto expected = AllToAll(plane_tracer, nodes);
+	auto blocked = AllToAllBlocked(plane_tracer, nodes, 1.7f, 7, 13);
+
+	auto expected_costs = expected.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+	auto blocked_costs = blocked.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+	for (int i = 0; i < nodes.size(); i++) {
+		ASSERT_EQ(expected[nodes[i]].size(), blocked[nodes[i]].size());
+		ASSERT_NEAR(expected_costs[i], blocked_costs[i], 0.001f);
+	}
+}
+
+// A graph written to a file should be identical when it's loaded, for both storage types
+TEST(_VisibilityGraph, FileRoundTrip) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> nodes;
+	for (int i = 0; i < 6; i++)
+		for (int k = 0; k < 6; k++)
+			nodes.emplace_back(Node(i, k, 0));
+
+	auto expected = AllToAll(plane_tracer, nodes);
+	auto expected_costs = expected.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+
+	for (auto storage : { VG_STORAGE::DISTANCES, VG_STORAGE::VISIBILITY_ONLY }) {
+		const std::string path = "vg_roundtrip.dhvg";
+		long long num_edges = AllToAllToFile(plane_tracer, nodes, path, 1.7f, storage, 5, 4);
+		ASSERT_EQ(nodes.size() * (nodes.size() - 1), num_edges);
+
+		auto loaded = LoadVisibilityGraph(path);
+		auto loaded_costs = loaded.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+		for (int i = 0; i < nodes.size(); i++) {
+			ASSERT_EQ(expected[nodes[i]].size(), loaded[nodes[i]].size());
+			ASSERT_NEAR(expected_costs[i], loaded_costs[i], 0.001f);
+		}
+		std::remove(path.c_str());
+	}
+}
+
+// Loading a file that doesn't exist should throw
+TEST(_VisibilityGraph, LoadMissingFileThrows) {
+	ASSERT_THROW(LoadVisibilityGraph("this_file_does_not_exist.dhvg"), HF::Exceptions::FileNotFound);
+}
+
+// Truncated or corrupt files should throw instead of reading out of bounds
+TEST(_VisibilityGraph, LoadCorruptFileThrows) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> nodes;
+	for (int i = 0; i < 4; i++)
+		nodes.emplace_back(Node(i, 0, 0));
+
+	const std::string path = "vg_corrupt.dhvg";
+	AllToAllToFile(plane_tracer, nodes, path, 1.7f, VG_STORAGE::VISIBILITY_ONLY);
+
+	std::ifstream in(path, std::ios::binary);
+	const std::vector<char> original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+
+	// Offsets of the arrays after the 24 byte header
+	const size_t num_nodes_offset = 8;
+	const size_t outer_offset = 24 + nodes.size() * 3 * sizeof(float);
+	const size_t inner_offset = outer_offset + (nodes.size() + 1) * sizeof(int64_t);
+
+	auto write_and_load = [&](const std::vector<char>& bytes) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(bytes.data(), bytes.size());
+		out.close();
+		LoadVisibilityGraph(path);
+	};
+
+	// Truncated
+	EXPECT_THROW(write_and_load(std::vector<char>(original.begin(), original.end() - 4)), std::invalid_argument);
+
+	// Negative number of nodes
+	auto bad_nodes = original;
+	const int32_t negative = -1;
+	std::memcpy(&bad_nodes[num_nodes_offset], &negative, sizeof(negative));
+	EXPECT_THROW(write_and_load(bad_nodes), std::invalid_argument);
+
+	// Outer indices that go backwards
+	auto bad_outer = original;
+	const int64_t backwards = 1000;
+	std::memcpy(&bad_outer[outer_offset + sizeof(int64_t)], &backwards, sizeof(backwards));
+	EXPECT_THROW(write_and_load(bad_outer), std::invalid_argument);
+
+	// An edge to a node past the end of the nodes array
+	auto bad_inner = original;
+	const int32_t missing_node = static_cast<int32_t>(nodes.size());
+	std::memcpy(&bad_inner[inner_offset], &missing_node, sizeof(missing_node));
+	EXPECT_THROW(write_and_load(bad_inner), std::invalid_argument);
+
+	// The original file still loads
+	EXPECT_NO_THROW(write_and_load(original));
+	std::remove(path.c_str());
+}
+
+// The degrees of every node should match the summary of the graph generated by AllToAll
+TEST(_VisibilityGraph, DegreesMatchAllToAll) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> nodes;
+	for (int i = -4; i < 4; i++)
+		for (int k = -4; k < 4; k++)
+			nodes.emplace_back(Node(i, k, 0));
+	nodes.emplace_back(Node(0, 0, -10)); // Fails the height check
+
+	auto graph = AllToAll(plane_tracer, nodes, 1.7f, 3.0f);
+	auto degrees = AllToAllDegrees(plane_tracer, nodes, 1.7f, 3.0f);
+
+	auto sums = graph.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+	for (int i = 0; i < nodes.size(); i++) {
+		const auto edges = graph[nodes[i]];
+		ASSERT_EQ(edges.size(), degrees.counts[i]);
+		ASSERT_NEAR(sums[i], degrees.sum_distance[i], 0.001f);
+
+		float furthest = 0;
+		for (const auto& edge : edges)
+			furthest = std::max(furthest, edge.score);
+		ASSERT_NEAR(furthest, degrees.max_distance[i], 0.001f);
+	}
+	ASSERT_EQ(0, degrees.counts.back());
+}
+
+// Setting bits should be reflected in every query, in both storage modes
+TEST(_VisibilityMatrix, QueriesMatchSetBits) {
+	for (bool upper_triangular : { false, true }) {
+		VisibilityMatrix matrix(130, upper_triangular);
+		matrix.Set(0, 1);
+		matrix.Set(0, 129);
+		matrix.Set(2, 1);
+		matrix.Set(2, 129);
+		matrix.Set(70, 65);
+
+		ASSERT_TRUE(matrix.IsVisible(0, 129));
+		ASSERT_EQ(upper_triangular, matrix.IsVisible(1, 2));
+		ASSERT_EQ(2, matrix.Degree(0));
+		ASSERT_EQ(2, matrix.CoVisibleCount(0, 2));
+
+		auto covisible = matrix.CoVisible(0, 2);
+		ASSERT_EQ(2, covisible.size());
+		ASSERT_EQ(1, covisible[0]);
+		ASSERT_EQ(129, covisible[1]);
+
+		// Upper triangular matrices are symmetric
+		ASSERT_EQ(upper_triangular, matrix.IsVisible(65, 70));
+		ASSERT_EQ(upper_triangular ? 2 : 0, matrix.Degree(129));
+	}
+}
+
+// The matrix should contain the same edges as AllToAll, and export to an equivalent graph
+TEST(_VisibilityGraph, MatrixMatchesAllToAll) {
+	EmbreeRayTracer plane_tracer(LoadMeshObjects(walled_plane_path, HF::Geometry::ONLY_FILE, true));
+	std::vector<Node> nodes;
+	for (int i = -5; i < 5; i++)
+		for (int k = -5; k < 5; k++)
+			nodes.emplace_back(Node(i * 2, k * 2, 0));
+
+	auto expected = AllToAll(plane_tracer, nodes);
+	auto expected_costs = expected.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+
+	for (bool upper_triangular : { false, true }) {
+		auto matrix = AllToAllMatrix(plane_tracer, nodes, 1.7f, upper_triangular);
+		auto graph = matrix.ToGraph(nodes);
+		auto costs = graph.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+
+		for (int i = 0; i < nodes.size(); i++) {
+			ASSERT_EQ(expected[nodes[i]].size(), matrix.Degree(i));
+			ASSERT_EQ(expected[nodes[i]].size(), graph[nodes[i]].size());
+			ASSERT_NEAR(expected_costs[i], costs[i], 0.001f);
+		}
+	}
+}
+
+// When no cluster straddles the wall, every pair of clusters is either fully visible or fully
+// blocked, so the approximation should match AllToAll exactly
+TEST(_VisibilityGraph, ApproximateMatchesAllToAll) {
+	EmbreeRayTracer plane_tracer(LoadMeshObjects(walled_plane_path, HF::Geometry::ONLY_FILE, true));
+	std::vector<Node> nodes;
+	for (int i = -4; i < 4; i++)
+		for (int k : { -4, -3, -2, 2, 3, 4 })
+			nodes.emplace_back(Node(i, k, 0));
+
+	auto expected = AllToAll(plane_tracer, nodes);
+	auto approximate = AllToAllApproximate(plane_tracer, nodes, 1.7f, 2.0f, 0.0f);
+
+	auto expected_costs = expected.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+	auto approximate_costs = approximate.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+	for (int i = 0; i < nodes.size(); i++) {
+		ASSERT_EQ(expected[nodes[i]].size(), approximate[nodes[i]].size());
+		ASSERT_NEAR(expected_costs[i], approximate_costs[i], 0.001f);
+	}
+}
+
+// Adding nodes to a graph should produce the same graph as generating it from every node at once
+TEST(_VisibilityGraph, AddNodesMatchesAllToAll) {
+	EmbreeRayTracer plane_tracer(LoadMeshObjects(walled_plane_path, HF::Geometry::ONLY_FILE, true));
+	std::vector<Node> old_nodes, new_nodes;
+	for (int i = -3; i < 3; i++)
+		for (int k = -3; k < 3; k++)
+			(k % 2 == 0 ? old_nodes : new_nodes).emplace_back(Node(i, k, 0));
+
+	auto all_nodes = old_nodes;
+	all_nodes.insert(all_nodes.end(), new_nodes.begin(), new_nodes.end());
+	auto expected = AllToAll(plane_tracer, all_nodes);
+
+	auto graph = AllToAll(plane_tracer, old_nodes);
+	AddNodes(plane_tracer, graph, new_nodes);
+
+	ASSERT_EQ(all_nodes.size(), graph.size());
+	auto expected_costs = expected.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+	auto costs = graph.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::SUM);
+	for (int i = 0; i < all_nodes.size(); i++) {
+		ASSERT_EQ(expected[all_nodes[i]].size(), graph[all_nodes[i]].size());
+		ASSERT_NEAR(expected_costs[i], costs[i], 0.001f);
+	}
+}
+
+// Nodes repeated in the nodes to add should only be added once
+TEST(_VisibilityGraph, AddNodesIgnoresRepeatedNodes) {
+	auto plane_tracer = CreatePlaneTracer();
+	std::vector<Node> old_nodes{ Node(0, 0, 0), Node(1, 0, 0) };
+	std::vector<Node> new_nodes{ Node(2, 0, 0), Node(0, 0, 0), Node(2, 0, 0), Node(3, 0, 0) };
+
+	auto expected = AllToAll(plane_tracer, { Node(0, 0, 0), Node(1, 0, 0), Node(2, 0, 0), Node(3, 0, 0) });
+	auto graph = AllToAll(plane_tracer, old_nodes);
+	AddNodes(plane_tracer, graph, new_nodes);
+
+	ASSERT_EQ(4, graph.size());
+	for (const auto& node : expected.Nodes())
+		ASSERT_EQ(3, graph[node].size());
+}
+
+// Updating the region around a new wall should produce the same graph as generating it with the wall
+TEST(_VisibilityGraph, UpdateRegionMatchesAllToAll) {
+	auto plane_tracer = CreatePlaneTracer();
+	EmbreeRayTracer walled_tracer(LoadMeshObjects(walled_plane_path, HF::Geometry::ONLY_FILE, true));
+	std::vector<Node> nodes;
+	for (int i = -3; i < 3; i++)
+		for (int k : { -3, -2, -1, 1, 2, 3 })
+			nodes.emplace_back(Node(i, k, 0));
+
+	auto expected = AllToAll(walled_tracer, nodes);
+	auto graph = AllToAll(plane_tracer, nodes);
+
+	// The wall lies along the x axis
+	int num_rechecked = UpdateRegion(walled_tracer, graph, { -21.0f, -0.1f, -19.0f }, { 21.0f, 0.1f, 19.0f });
+
+	// Only pairs on opposite sides of the wall should have been checked
+	ASSERT_EQ(2 * 18 * 18, num_rechecked);
+	for (const auto& node : nodes)
+		ASSERT_EQ(expected[node].size(), graph[node].size());
+}
+
 // This is testing whether or not the group to group algorithm
 // Produces a valid graph
 TEST(_VisibilityGraph, GroupConstructsValidGraph) {
@@ -175,6 +520,108 @@ TEST(C_VisibilityGraph, GroupConstructsValidGraph) {
 	}
 }
 
+// Tests that the range limited C interface only connects nodes in range
+TEST(C_VisibilityGraph, AllToAllInRange) {
+	auto raytracer = CreatePlaneTracer();
+
+	vector<float> nodes = {
+		0, 0, 0,
+		1, 0, 0,
+		5, 0, 0,
+	};
+
+	Graph* G;
+	auto res = CreateVisibilityGraphAllToAllInRange(
+		&raytracer, nodes.data(), nodes.size() / 3, &G, 1.7f, 2.0f, 90.0f, 90.0f
+	);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OK, res);
+
+	auto counts = G->AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT);
+	ASSERT_EQ(1, counts[0]);
+	ASSERT_EQ(1, counts[1]);
+	ASSERT_EQ(0, counts[2]);
+
+	delete G;
+}
+
+// The C interface should count the visible nodes within range of every node
+TEST(C_VisibilityGraph, DegreesAllToAll) {
+	auto raytracer = CreatePlaneTracer();
+	vector<float> nodes{ 0, 0, 0, 1, 0, 0, 5, 0, 0 };
+	vector<int> counts(3);
+	vector<float> sums(3);
+	vector<float> furthest(3);
+
+	auto status = CalculateVisibilityDegreesAllToAll(
+		&raytracer, nodes.data(), 3, 1.7f, 4.5f, 90.0f, 90.0f,
+		counts.data(), sums.data(), furthest.data()
+	);
+
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OK, status);
+	ASSERT_EQ(1, counts[0]);
+	ASSERT_EQ(2, counts[1]);
+	ASSERT_NEAR(5.0f, sums[1], 0.001f);
+	ASSERT_NEAR(4.0f, furthest[2], 0.001f);
+}
+
+// The approximate C interface should connect every node on a flat plane
+TEST(C_VisibilityGraph, AllToAllApproximate) {
+	auto raytracer = CreatePlaneTracer();
+	vector<float> nodes;
+	for (int i = 0; i < 6; i++)
+		for (int k = 0; k < 6; k++) {
+			nodes.push_back(i); nodes.push_back(k); nodes.push_back(0);
+		}
+	Graph* graph = nullptr;
+
+	auto status = CreateVisibilityGraphAllToAllApproximate(&raytracer, nodes.data(), 36, &graph, 1.7f, 2.0f, 0.0f);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OK, status);
+
+	// Everything on a flat plane is visible
+	auto counts = graph->AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT);
+	for (auto count : counts)
+		ASSERT_EQ(35, count);
+
+	delete graph;
+}
+
+// The approximate C interface should reject clusters that aren't larger than zero
+TEST(C_VisibilityGraph, AllToAllApproximateInvalidClusterSize) {
+	auto raytracer = CreatePlaneTracer();
+	vector<float> nodes{ 0, 0, 0, 1, 0, 0 };
+	Graph* graph = nullptr;
+
+	for (float cluster_size : { 0.0f, -1.0f, std::nanf("") }) {
+		auto status = CreateVisibilityGraphAllToAllApproximate(&raytracer, nodes.data(), 2, &graph, 1.7f, cluster_size, 0.0f);
+		ASSERT_EQ(HF::Exceptions::HF_STATUS::OUT_OF_RANGE, status);
+		ASSERT_EQ(nullptr, graph);
+	}
+}
+
+// The file C interface should write graphs that can be loaded, and reject storage it can't load
+TEST(C_VisibilityGraph, AllToAllToFile) {
+	auto raytracer = CreatePlaneTracer();
+	vector<float> nodes{ 0, 0, 0, 1, 0, 0, 5, 0, 0 };
+	const char* path = "c_all_to_all.dhvg";
+	long long num_edges = -1;
+
+	auto status = CreateVisibilityGraphAllToAllToFile(&raytracer, nodes.data(), 3, path, 1.7f, 1, 2, &num_edges);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OK, status);
+	ASSERT_EQ(6, num_edges);
+
+	Graph* graph = nullptr;
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OK, LoadVisibilityGraphFromFile(path, &graph));
+	delete graph;
+
+	for (int storage : { -1, 2 }) {
+		num_edges = -1;
+		status = CreateVisibilityGraphAllToAllToFile(&raytracer, nodes.data(), 3, path, 1.7f, storage, 2, &num_edges);
+		ASSERT_EQ(HF::Exceptions::HF_STATUS::OUT_OF_RANGE, status);
+		ASSERT_EQ(-1, num_edges);
+	}
+	std::remove(path);
+}
+
 ///
 ///	The following are tests for the code samples for HF::VisibilityGraph
 ///
@@ -4,7 +4,9 @@
 #include <objloader.h>
 #include <meshinfo.h>
 #include <embree_raytracer.h>
+#include <mesh_cache.h>
 #include <robin_hood.h>
+#include <memory>
 #include <cmath>
 #include <iostream>
 #include <fstream>
@@ -905,6 +907,78 @@ TEST(_EmbreeRayTracer, OperatorAssignment) {
 	ert_1 = ert_0;
 }
 
+// A raytracer that shares a mesh's buffers should give the same results as one that copies them,
+// even after every other reference to the mesh is gone
+TEST(_EmbreeRayTracer, SharedMeshMatchesCopiedMesh) {
+	auto teapot = HF::Geometry::LoadMeshObjects("teapot.obj", HF::Geometry::ONLY_FILE, true)[0];
+	EmbreeRayTracer copied_ert(teapot);
+
+	EmbreeRayTracer shared_ert;
+	{
+		auto shared_teapot = std::make_shared<const MeshInfo<float>>(teapot);
+		ASSERT_EQ(teapot.GetMeshID(), shared_ert.AddSharedMesh(shared_teapot, true));
+	}
+
+	// Copies of the raytracer share ownership of the mesh as well
+	EmbreeRayTracer copied_shared_ert(shared_ert);
+
+	for (float x = -2.0f; x <= 2.0f; x += 0.25f) {
+		auto expected = copied_ert.Intersect(x, 0.0f, 10.0f, 0.0f, 0.0f, -1.0f);
+		auto actual = copied_shared_ert.Intersect(x, 0.0f, 10.0f, 0.0f, 0.0f, -1.0f);
+
+		ASSERT_EQ(expected.DidHit(), actual.DidHit());
+		if (expected.DidHit()) ASSERT_NEAR(expected.distance, actual.distance, 0.0001f);
+	}
+}
+
+// Transforms queued on a mesh should be applied when it's added, whether it's copied or shared
+TEST(_EmbreeRayTracer, AddMeshAppliesQueuedTransform) {
+	vector<float> plane_vertices{ -10, -10, 0, 10, -10, 0, 10, 10, 0, -10, 10, 0 };
+	vector<int> plane_indices{ 0, 1, 2, 0, 2, 3 };
+	const std::array<float, 16> raise{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 2, 0, 0, 0, 1 };
+
+	MeshInfo<float> plane(plane_vertices, plane_indices, 0, "Plane");
+	plane.QueueTransform(raise);
+	plane.QueueTransform(raise);
+	auto shared_plane = std::make_shared<const MeshInfo<float>>(plane);
+
+	EmbreeRayTracer copied_ert(plane);
+	ASSERT_FALSE(plane.HasPendingTransform());
+	ASSERT_EQ(4, plane[0][2]);
+
+	EmbreeRayTracer shared_ert;
+	shared_ert.AddSharedMesh(shared_plane, true);
+	ASSERT_TRUE(shared_plane->HasPendingTransform());
+
+	for (auto* ert : { &copied_ert, &shared_ert }) {
+		auto hit = ert->Intersect(0.0f, 0.0f, 10.0f, 0.0f, 0.0f, -1.0f);
+		ASSERT_TRUE(hit.DidHit());
+		ASSERT_NEAR(6.0f, hit.distance, 0.0001f);
+	}
+}
+
+// Meshes added straight from a mapped cache should be intersected the same as the originals
+TEST(_EmbreeRayTracer, SharedMeshCacheMatchesMeshes) {
+	auto meshes = HF::Geometry::LoadMeshObjects("sponza.obj", HF::Geometry::BY_GROUP, true);
+	HF::Geometry::SaveMeshCache(meshes, "sponza_shared.dhmesh");
+	EmbreeRayTracer copied_ert(meshes);
+
+	{
+		EmbreeRayTracer shared_ert;
+		auto ids = shared_ert.AddSharedMeshes(std::make_shared<const HF::Geometry::MeshCache>("sponza_shared.dhmesh"));
+		ASSERT_EQ(meshes.size(), ids.size());
+
+		for (float x = -10.0f; x <= 10.0f; x += 1.0f) {
+			auto expected = copied_ert.Intersect(x, 0.0f, 1.0f, 0.0f, 0.0f, -1.0f);
+			auto actual = shared_ert.Intersect(x, 0.0f, 1.0f, 0.0f, 0.0f, -1.0f);
+
+			ASSERT_EQ(expected.DidHit(), actual.DidHit());
+			if (expected.DidHit()) ASSERT_NEAR(expected.distance, actual.distance, 0.0001f);
+		}
+	}
+	std::remove("sponza_shared.dhmesh");
+}
+
 TEST(_FullRayRequest, ConstructorArgs) {
 	// Requires #include "RayRequest.h"
 
@@ -1155,4 +1229,25 @@ namespace C_Interface{
 			DestroyMeshInfo(MI[i]);
 		DestroyRayTracer(ERT);
 	}
+
+	TEST(C_EmbreeRayTracer, CreateRaytracerFromMeshCache) {
+		// Write a cache of the plane
+		auto meshes = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+		HF::Geometry::SaveMeshCache(meshes, "plane_shared.dhmesh");
+
+		EmbreeRayTracer* ERT = nullptr;
+		ASSERT_EQ(HF_STATUS::OK, CreateRaytracerFromMeshCache("plane_shared.dhmesh", &ERT, false));
+
+		// Cast a ray at the ground and ensure it connects
+		float x = 0; float y = 0; float z = 1;
+		bool res = false;
+		CastRay(ERT, x, y, z, 0, 0, -1, -1, res);
+		ASSERT_TRUE(res);
+
+		DestroyRayTracer(ERT);
+		std::remove("plane_shared.dhmesh");
+
+		// Missing caches should be reported
+		ASSERT_EQ(HF_STATUS::NOT_FOUND, CreateRaytracerFromMeshCache("missing.dhmesh", &ERT, false));
+	}
 }
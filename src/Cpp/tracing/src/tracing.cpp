@@ -0,0 +1,229 @@
+///
+/// \file		tracing.cpp
+/// \brief		Contains implementation for the <see cref="HF::Tracing">Tracing</see> namespace
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#include <tracing.h>
+
+#include <HFExceptions.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace HF::Tracing {
+
+	/// Counters of a single thread. Only written by that thread, but read by any.
+	struct ThreadCounters {
+		std::array<std::atomic<int64_t>, NUM_COUNTERS> counts;	///< Total of each counter.
+		int tid;												///< ID of the thread in the trace.
+
+		ThreadCounters(int tid) : tid(tid) {
+			for (auto& count : counts) count.store(0);
+		}
+	};
+
+	/// A single run of a stage.
+	struct StageEvent {
+		Stage stage;	///< Stage that was run.
+		int tid;		///< ID of the thread that ran it.
+		int64_t start;	///< Nanoseconds from the last reset to when it started.
+		int64_t end;	///< Nanoseconds from the last reset to when it ended.
+	};
+
+	/// Maximum number of events kept for the trace.
+	constexpr size_t max_events = 1000000;
+
+	const char* counter_names[NUM_COUNTERS] = {
+		"occlusion_rays", "intersection_rays", "nodes_popped", "edges_added", "hash_probes"
+	};
+	const char* stage_names[NUM_STAGES] = {
+		"GenerateGraph", "CompressGraph", "VisibilityGraph", "ViewAnalysis", "Pathfinding"
+	};
+
+	std::atomic<bool> Internal::enabled{ false };
+
+	/// Counters of every running thread that has counted something, and counters left behind by
+	/// threads that exited. Only grows when more threads are counting at once than ever before.
+	static std::vector<std::unique_ptr<ThreadCounters>> thread_counters;
+
+	/// Counters in thread_counters whose thread exited, ready to be given to the next new thread.
+	static std::vector<ThreadCounters*> free_counters;
+
+	/// Totals of threads that exited since the last reset.
+	static std::array<int64_t, NUM_COUNTERS> retired_counts{};
+
+	/// Every stage recorded since the last reset, up to max_events.
+	static std::vector<StageEvent> events;
+
+	/// Guards thread_counters, free_counters, retired_counts, and events.
+	static std::mutex trace_mutex;
+
+	/// Total nanoseconds spent in each stage.
+	static std::array<std::atomic<int64_t>, NUM_STAGES> stage_nanoseconds;
+
+	/// Number of times each stage was run.
+	static std::array<std::atomic<int64_t>, NUM_STAGES> stage_calls;
+
+	/// Time of the last reset.
+	static std::atomic<std::chrono::steady_clock::rep> epoch{ std::chrono::steady_clock::now().time_since_epoch().count() };
+
+	/// Stages the calling thread is currently inside.
+	static thread_local std::array<bool, NUM_STAGES> active_stages{};
+
+	/*! \brief Counters held by a thread, which are released for reuse when the thread exits. */
+	struct CountersHandle {
+		ThreadCounters* counters = nullptr;	///< Counters of the thread, or null until it first counts.
+
+		/*! \brief Add the thread's counts to the retired totals and release its counters. */
+		~CountersHandle() {
+			if (!counters) return;
+
+			std::lock_guard<std::mutex> lock(trace_mutex);
+			for (int i = 0; i < NUM_COUNTERS; i++)
+				retired_counts[i] += counters->counts[i].exchange(0);
+			free_counters.push_back(counters);
+		}
+	};
+
+	/*! \brief Get the counters of the calling thread, taking unused ones or creating them on first use. */
+	static ThreadCounters& LocalCounters() {
+		thread_local CountersHandle local;
+		if (!local.counters) {
+			std::lock_guard<std::mutex> lock(trace_mutex);
+			if (!free_counters.empty()) {
+				local.counters = free_counters.back();
+				free_counters.pop_back();
+			}
+			else {
+				const int tid = static_cast<int>(thread_counters.size()) + 1;
+				thread_counters.push_back(std::make_unique<ThreadCounters>(tid));
+				local.counters = thread_counters.back().get();
+			}
+		}
+		return *local.counters;
+	}
+
+	void Internal::AddCount(Counter counter, int64_t units) {
+		// Only this thread writes to its counters, so a relaxed load and store is enough
+		auto& count = LocalCounters().counts[counter];
+		count.store(count.load(std::memory_order_relaxed) + units, std::memory_order_relaxed);
+	}
+
+	int64_t Internal::Now() {
+		const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+		const auto elapsed = std::chrono::steady_clock::duration(now - epoch.load());
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	}
+
+	bool Internal::EnterStage(Stage stage) {
+		if (active_stages[stage]) return false;
+
+		active_stages[stage] = true;
+		return true;
+	}
+
+	void Internal::LeaveStage(Stage stage) {
+		active_stages[stage] = false;
+	}
+
+	void Internal::RecordStage(Stage stage, int64_t start, int64_t end) {
+		stage_nanoseconds[stage].fetch_add(end - start);
+		stage_calls[stage].fetch_add(1);
+
+		const int tid = LocalCounters().tid;
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		if (events.size() < max_events)
+			events.push_back(StageEvent{ stage, tid, start, end });
+	}
+
+	void Enable(bool enable) {
+		Internal::enabled.store(enable);
+	}
+
+	void Reset() {
+		std::lock_guard<std::mutex> lock(trace_mutex);
+
+		for (auto& counters : thread_counters)
+			for (auto& count : counters->counts)
+				count.store(0);
+		retired_counts.fill(0);
+
+		for (int i = 0; i < NUM_STAGES; i++) {
+			stage_nanoseconds[i].store(0);
+			stage_calls[i].store(0);
+		}
+
+		events.clear();
+		epoch.store(std::chrono::steady_clock::now().time_since_epoch().count());
+	}
+
+	int64_t GetCount(Counter counter) {
+		std::lock_guard<std::mutex> lock(trace_mutex);
+
+		int64_t total = retired_counts[counter];
+		for (const auto& counters : thread_counters)
+			total += counters->counts[counter].load(std::memory_order_relaxed);
+
+		return total;
+	}
+
+	double GetStageMilliseconds(Stage stage) {
+		return static_cast<double>(stage_nanoseconds[stage].load()) / 1000000.0;
+	}
+
+	int64_t GetStageCalls(Stage stage) {
+		return stage_calls[stage].load();
+	}
+
+	const char* CounterName(Counter counter) { return counter_names[counter]; }
+
+	const char* StageName(Stage stage) { return stage_names[stage]; }
+
+	std::string ChromeTraceJSON() {
+		// Read the counters before locking, since GetCount locks too
+		std::array<int64_t, NUM_COUNTERS> totals;
+		for (int i = 0; i < NUM_COUNTERS; i++)
+			totals[i] = GetCount(static_cast<Counter>(i));
+
+		std::ostringstream json;
+		json.precision(3);
+		json << std::fixed << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		// Trace event timestamps are in microseconds
+		int64_t last_end = 0;
+		{
+			std::lock_guard<std::mutex> lock(trace_mutex);
+			for (const auto& e : events) {
+				json << "{\"name\":\"" << stage_names[e.stage] << "\",\"cat\":\"dhart\",\"ph\":\"X\",\"pid\":1"
+					<< ",\"tid\":" << e.tid
+					<< ",\"ts\":" << e.start / 1000.0
+					<< ",\"dur\":" << (e.end - e.start) / 1000.0 << "},";
+
+				last_end = std::max(last_end, e.end);
+			}
+		}
+
+		json << "{\"name\":\"counters\",\"cat\":\"dhart\",\"ph\":\"C\",\"pid\":1,\"tid\":0"
+			<< ",\"ts\":" << last_end / 1000.0 << ",\"args\":{";
+		for (int i = 0; i < NUM_COUNTERS; i++)
+			json << (i > 0 ? "," : "") << "\"" << counter_names[i] << "\":" << totals[i];
+		json << "}}]}";
+
+		return json.str();
+	}
+
+	void WriteChromeTrace(const std::string& path) {
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) throw HF::Exceptions::FileNotFound();
+
+		file << ChromeTraceJSON();
+	}
+}
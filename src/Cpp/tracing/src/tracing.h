@@ -0,0 +1,190 @@
+///
+///	\file		tracing.h
+/// \brief		Contains definitions for the <see cref="HF::Tracing">Tracing</see> namespace
+///
+///	\author		TBA
+///	\date		18 Oct 2026
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*!
+	\brief Measure where time goes inside the library's analyses.
+
+	\details
+	Tracing is off by default. While it's off, every counter and timer in the library costs a single
+	relaxed load of a flag, so leaving the instrumentation in hot loops such as raycasting is free in
+	practice. Call Enable() to start recording, run the analyses to measure, then read the totals with
+	GetCount() and GetStageMilliseconds(), or export every timed stage as a Chrome trace with
+	ChromeTraceJSON() to view it in chrome://tracing or Perfetto.
+
+	Counters are kept separately for every thread and summed when read, so threads never contend with
+	each other while counting. When a thread exits, its counts are added to a shared total and its
+	counters are given to the next thread that starts counting, so short lived threads such as the
+	ones running background jobs don't use more memory the longer the library is loaded.
+
+	\code
+		// be sure to #include "tracing.h"
+
+		HF::Tracing::Enable();
+		auto graph = generator.BuildNetwork(start, spacing, 5000, 0.2, 20, 0.2, 20, 1, 1, -1);
+		graph.Compress();
+		HF::Tracing::Enable(false);
+
+		std::cout << HF::Tracing::GetCount(HF::Tracing::OCCLUSION_RAYS) << " occlusion rays in "
+			<< HF::Tracing::GetStageMilliseconds(HF::Tracing::GENERATE_GRAPH) << "ms" << std::endl;
+		HF::Tracing::WriteChromeTrace("graph_generator.json");
+	\endcode
+*/
+namespace HF::Tracing {
+
+	/*! \brief Events counted while tracing is enabled. */
+	enum Counter {
+		OCCLUSION_RAYS = 0,		///< Occlusion rays cast by an EmbreeRayTracer.
+		INTERSECTION_RAYS,		///< Intersection rays cast by an EmbreeRayTracer.
+		NODES_POPPED,			///< Nodes taken from the GraphGenerator's queue to be evaluated.
+		EDGES_ADDED,			///< Edges added to a graph by the GraphGenerator or VisibilityGraph.
+		HASH_PROBES,			///< Lookups of a node in a hash table, such as a graph's ID map.
+		NUM_COUNTERS			///< Number of counters. Not a counter.
+	};
+
+	/*! \brief Stages of the library that are timed while tracing is enabled. */
+	enum Stage {
+		GENERATE_GRAPH = 0,		///< GraphGenerator::BuildNetwork.
+		COMPRESS_GRAPH,			///< Graph::Compress.
+		VISIBILITY_GRAPH,		///< Generating a visibility graph.
+		VIEW_ANALYSIS,			///< Spherical view analysis.
+		PATHFINDING,			///< Finding shortest paths, or the distance and predecessor matrices.
+		NUM_STAGES				///< Number of stages. Not a stage.
+	};
+
+	namespace Internal {
+		/// Set while tracing is enabled.
+		extern std::atomic<bool> enabled;
+
+		/*! \brief Add units to counter for the calling thread. */
+		void AddCount(Counter counter, int64_t units);
+
+		/*! \brief Get the number of nanoseconds since tracing was last reset. */
+		int64_t Now();
+
+		/*! \brief Record that stage ran from start to end on the calling thread. */
+		void RecordStage(Stage stage, int64_t start, int64_t end);
+
+		/*!
+			\brief Mark stage as entered on the calling thread.
+
+			\returns True if the calling thread wasn't already in stage.
+		*/
+		bool EnterStage(Stage stage);
+
+		/*! \brief Mark stage as left on the calling thread. */
+		void LeaveStage(Stage stage);
+	}
+
+	/*!
+		\brief Start or stop recording.
+
+		\param enable True to start recording, false to stop.
+
+		\remarks Counts and events recorded before tracing is stopped are kept until Reset() is called.
+	*/
+	void Enable(bool enable = true);
+
+	/*! \brief Check if tracing is enabled. */
+	inline bool IsEnabled() { return Internal::enabled.load(std::memory_order_relaxed); }
+
+	/*!
+		\brief Clear every count, stage time, and trace event recorded so far.
+
+		\pre No analysis is running on any thread. Counts added while a reset is in progress may be
+		kept or lost, and stages started before the reset are recorded with a start time before
+		zero.
+	*/
+	void Reset();
+
+	/*! \brief Add units to counter if tracing is enabled. */
+	inline void Count(Counter counter, int64_t units = 1) {
+		if (IsEnabled()) Internal::AddCount(counter, units);
+	}
+
+	/*! \brief Get the total of counter across every thread. */
+	int64_t GetCount(Counter counter);
+
+	/*! \brief Get the total time spent in stage in milliseconds. */
+	double GetStageMilliseconds(Stage stage);
+
+	/*! \brief Get the number of times stage was run. */
+	int64_t GetStageCalls(Stage stage);
+
+	/*! \brief Get the name of counter as it appears in the trace. */
+	const char* CounterName(Counter counter);
+
+	/*! \brief Get the name of stage as it appears in the trace. */
+	const char* StageName(Stage stage);
+
+	/*!
+		\brief Export every stage recorded since the last reset as Chrome trace event JSON.
+
+		\returns
+		A JSON object with a complete ("X") event for every time a stage was run, and a counter ("C")
+		event with the total of every counter.
+
+		\remarks
+		Only the first million stages are kept as events. Stages run after that are still added to
+		GetStageMilliseconds() and GetStageCalls().
+	*/
+	std::string ChromeTraceJSON();
+
+	/*!
+		\brief Write ChromeTraceJSON() to a file.
+
+		\param path Path of the file to write. Overwritten if it already exists.
+
+		\exception HF::Exceptions::FileNotFound The file couldn't be opened for writing.
+	*/
+	void WriteChromeTrace(const std::string& path);
+
+	/*!
+		\brief Time a stage from construction until destruction.
+
+		\details
+		Does nothing if tracing was disabled when the timer was created. If the calling thread is
+		already inside the same stage, such as when one pathfinding function calls another, only the
+		outermost timer is recorded so the stage isn't counted twice.
+
+		\code
+			// be sure to #include "tracing.h"
+
+			void Graph::Compress() {
+				HF::Tracing::ScopedTimer timer(HF::Tracing::COMPRESS_GRAPH);
+				...
+			}
+		\endcode
+	*/
+	class ScopedTimer {
+		Stage stage;		///< Stage being timed.
+		int64_t start = -1;	///< Time the timer was created, or -1 if it isn't recording.
+
+	public:
+		/*! \brief Start timing stage if tracing is enabled. */
+		inline ScopedTimer(Stage stage) : stage(stage) {
+			if (IsEnabled() && Internal::EnterStage(stage))
+				start = Internal::Now();
+		}
+
+		/*! \brief Record the stage if the timer was started. */
+		inline ~ScopedTimer() {
+			if (start < 0) return;
+
+			Internal::RecordStage(stage, start, Internal::Now());
+			Internal::LeaveStage(stage);
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+}
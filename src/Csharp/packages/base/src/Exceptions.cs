@@ -93,7 +93,13 @@ namespace DHARTAPI.Exceptions
 		NO_COST = -12,
 
 		/*! \brief The graph has not been compressed! */
-		NOT_COMPRESSED = -13
+		NOT_COMPRESSED = -13,
+
+		/*! \brief The operation was cancelled before it finished. */
+		CANCELLED = -14,
+
+		/*! \brief The operation hasn't finished yet. */
+		IN_PROGRESS = -15
 
 
 	};
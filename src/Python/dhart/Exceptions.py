@@ -22,6 +22,8 @@ class HF_STATUS(Enum):
     NO_PATH = -11  # No path was returned from the pathfinding ooperation
     NO_COST = -12  # The given cost could not be found.
     NOT_COMPRESSED = -13  # The graph needed to be compressed and it wasn't
+    CANCELLED = -14  # The operation was cancelled before it finished
+    IN_PROGRESS = -15  # The operation hasn't finished yet
 
 
 class HFException(Exception):
@@ -2,7 +2,7 @@ import os
 import sys 
 from os.path import dirname as up
 
-__all__ = ['get_sample_model']
+__all__ = ['get_sample_model', 'set_thread_count', 'get_thread_count']
 
 # This should be in a function
 directory = os.path.join(os.path.dirname(os.path.realpath(__file__)) ,"bin" )
@@ -41,3 +41,35 @@ def get_sample_model(name=""):
     model_path = os.path.join(model_dir, name)
 
     return model_path
+
+
+def set_thread_count(threads: int):
+    """ Set the maximum number of threads dhart may use at once.
+
+    Analyses running at the same time, such as on different Python threads,
+    share this many threads instead of each using every core. Raytracers
+    created after this is called also build their BVH with this many threads.
+
+    Parameters
+    ----------
+
+    threads : int
+        Number of threads to use. If less than 1, every core is used.
+
+    """
+    from dhart.common_native_functions import SetThreadCount
+    SetThreadCount(threads)
+
+def get_thread_count() -> int:
+    """ Returns the maximum number of threads dhart may use at once.
+
+    Returns
+    -------
+
+    threads : int
+        The count given to set_thread_count, or the number of cores if it
+        wasn't called.
+
+    """
+    from dhart.common_native_functions import GetThreadCount
+    return GetThreadCount()
@@ -3,6 +3,8 @@ from typing import *
 import os
 import sys
 import numbers
+import numpy
+from numpy.lib.recfunctions import structured_to_unstructured
 from dhart.Exceptions import *
 from dhart.utils import *
 
@@ -46,53 +48,104 @@ def GetStringPtr(string: str) -> c_char_p:
     return strptr
 
 
-def ConvertPointsToArray(
-    points: Union[Tuple[float, float, float], Iterable[Tuple[float, float, float]]]
-    ) -> c_float:
-    """ Convert a list of floats to a flat c-style array """
+def ConvertNumpyToArray(array: numpy.ndarray, c_type) -> Array:
+    """ Get a flat ctypes array that shares memory with a numpy array
+
+    Args:
+        array: A C-contiguous, writeable numpy array with the same item size as c_type
+        c_type: The ctypes type of each element
+
+    Returns:
+        Array: A ctypes array of array.size elements. It keeps array alive for as
+        long as it exists, and writes to it are visible in array.
+    """
+    return (c_type * array.size).from_buffer(array)
 
-    # # If it's a tuple or list of floats, just do the one
-    # if (
-    #         isinstance(points, (tuple))
-    #     ) or (  # IF this is a list, we need a little more proof
-    #             # that this shouldn't go in the else clause
-    #         isinstance(points, list)  # Must be a list
-    #         and isinstance(points[0], numbers.Number)  # Must hold numbers
-    #         and len(points) == 3  # Must be a length of 3
-    #     ):
 
-    # Using the ispoint method
-    if (is_point(points) and len(points)==3):
-        point_arr_type = c_float * 3
-        point_arr = point_arr_type()
-        point_arr[0] = points[0]
-        point_arr[1] = points[1]
-        point_arr[2] = points[2]
-    else:
-        point_arr_type = c_float * (len(points) * 3)
-        point_arr = point_arr_type()
-        for i in range(0, len(points) * 3):
-            point_arr[i] = points[int(i / 3)][i % 3]
+def ConvertToNumpy(values, dtype, copy: bool = False) -> numpy.ndarray:
+    """ Get values as a C-contiguous, writeable numpy array of dtype
 
-    return point_arr
+    Args:
+        values: A numpy array, anything that implements the buffer or array
+            protocol, or a (nested) sequence of numbers
+        dtype: The type of each element in the output
+        copy: Always copy values instead of returning a view of them. Use this
+            when C++ will write into the returned array, so the caller's data
+            isn't overwritten.
 
+    Returns:
+        numpy.ndarray: values itself if it already meets these requirements,
+        otherwise a copy of values
+    """
+    # Only arrays owned by the caller need to be protected by copy
+    caller_owns = isinstance(values, numpy.ndarray) or hasattr(values, "__array__")
+    source = numpy.asarray(values)
 
-def ConvertFloatsToArray(floats: Iterable[float]) -> c_float:
-    float_type = c_float * len(floats)
-    float_arr = float_type()
-    for i in range(0, len(floats)):
-        float_arr[i] = floats[i]
+    # Structured arrays like NodeStruct hold the coordinates in their first
+    # three fields
+    if source.dtype.names:
+        source = structured_to_unstructured(source[list(source.dtype.names[:3])])
 
-    return float_arr
+    array = numpy.require(source, dtype=dtype, requirements=["C", "W"])
 
+    # require returns the caller's array as is if it already meets the requirements
+    if copy and caller_owns and numpy.may_share_memory(array, source):
+        array = array.copy()
 
-def ConvertIntsToArray(ints: Iterable[int]) -> c_int:
-    int_type = c_int * len(ints)
-    int_arr = int_type()
-    for i in range(0, len(ints)):
-        int_arr[i] = ints[i]
+    return array
 
-    return int_arr
+
+def ConvertPointsToNumpy(
+    points: Union[Tuple[float, float, float], Iterable[Tuple[float, float, float]], numpy.ndarray],
+    copy: bool = False
+    ) -> numpy.ndarray:
+    """ Get points as an (n, 3) numpy array of float32, without copying them if possible
+
+    Args:
+        points: A single point, a list of points, or a numpy array of shape (n, 3),
+            (3,) or (3n,). Arrays of NodeStructs are also accepted.
+        copy: Always copy the points. See ConvertToNumpy.
+
+    Raises:
+        ValueError: The number of coordinates in points isn't a multiple of 3
+    """
+    array = ConvertToNumpy(points, numpy.float32, copy)
+    if array.size % 3 != 0:
+        raise ValueError(f"Points must have 3 coordinates each, but {array.size} coordinates were given")
+
+    return array.reshape(-1, 3)
+
+
+def ConvertPointsToArray(
+    points: Union[Tuple[float, float, float], Iterable[Tuple[float, float, float]], numpy.ndarray],
+    copy: bool = False
+    ) -> c_float:
+    """ Convert one or more points to a flat c-style array of floats
+
+    If points is already a contiguous float32 numpy array, the returned
+    array shares its memory instead of copying it.
+
+    Args:
+        points: A single point, a list of points, or a numpy array of points
+        copy: Always copy the points. Set this when C++ writes its results into
+            the array, so the caller's points aren't overwritten.
+
+    Returns:
+        c_float: A flat array of every coordinate of every point
+    """
+    return ConvertNumpyToArray(ConvertPointsToNumpy(points, copy), c_float)
+
+
+def ConvertFloatsToArray(floats: Union[Iterable[float], numpy.ndarray], copy: bool = False) -> c_float:
+    """ Convert floats to a c-style array, without copying them if they're already
+    a contiguous float32 numpy array """
+    return ConvertNumpyToArray(ConvertToNumpy(floats, numpy.float32, copy).reshape(-1), c_float)
+
+
+def ConvertIntsToArray(ints: Union[Iterable[int], numpy.ndarray], copy: bool = False) -> c_int:
+    """ Convert ints to a c-style array, without copying them if they're already
+    a contiguous int32 numpy array """
+    return ConvertNumpyToArray(ConvertToNumpy(ints, numpy.intc, copy).reshape(-1), c_int)
 
 
 def convert_strings_to_array(strings: List[str]) -> c_char_p:
@@ -116,3 +169,19 @@ def convert_strings_to_array(strings: List[str]) -> c_char_p:
         string_arr[i] = GetStringPtr(strings[i])
     
     return string_arr
+
+
+def SetThreadCount(threads: int):
+    """ Set the maximum number of threads DHART_API may use at once
+
+    Args:
+        threads: Number of threads. If less than 1, every hardware thread is used.
+    """
+    getDLLHandle().SetThreadCount(c_int(threads))
+
+
+def GetThreadCount() -> int:
+    """ Get the maximum number of threads DHART_API may use at once """
+    threads = c_int(0)
+    getDLLHandle().GetThreadCount(byref(threads))
+    return threads.value
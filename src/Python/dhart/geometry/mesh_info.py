@@ -64,13 +64,8 @@ class MeshInfo(object):
                 indices_or_pointer
             )
         else:
-            # Flatten list of tuples/floats if necessary
-            if isinstance(indices_or_pointer[0], (tuple, list)):
-                indices_or_pointer = Flatten(indices_or_pointer)
-            if isinstance(vertices[0], (tuple, list)):
-                vertices = Flatten(vertices)
-
-            # Call out to the CreateMesh function
+            # Call out to the CreateMesh function. Lists of tuples and numpy
+            # arrays are flattened by it
             self.__internal_ptr = meshinfo_native_functions.CreateMesh(
                 indices_or_pointer, vertices, name, id
             )
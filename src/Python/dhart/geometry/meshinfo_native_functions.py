@@ -4,6 +4,8 @@ from dhart.Exceptions import *
 from dhart.common_native_functions import (
     getDLLHandle,
     ConvertPointsToArray,
+    ConvertFloatsToArray,
+    ConvertIntsToArray,
     GetStringPtr,
 )
 from typing import *
@@ -69,20 +71,20 @@ def CreateMesh(
     """ Pass mesh data to C++ as a list of indices and vertices
     
     Args:
-        indices: A list of indices with each 3 representing a triangle. Must be a multiple of 3
-        vertices: A list of vertices, with each 3 floats representing a unique vertex
+        indices: A list of indices with each 3 representing a triangle. Must be a multiple of 3.
+            Nested lists and numpy arrays of any shape are flattened.
+        vertices: A list of vertices, with each 3 floats representing a unique vertex.
+            Contiguous numpy arrays of float32 are passed to C++ without being copied.
         name: The name of the mesh internally
         id: The mesh's ID
 
     Returns:
         A pointer to a valid MeshInfo object in c++
     """
-    num_indices = len(indices)
-    num_vertices = len(vertices)
-    index_array_type = c_int * num_indices
-    vertex_array_type = c_float * num_vertices
-    index_array = index_array_type(*indices)
-    vertex_array = vertex_array_type(*vertices)
+    index_array = ConvertIntsToArray(indices)
+    vertex_array = ConvertFloatsToArray(vertices)
+    num_indices = len(index_array)
+    num_vertices = len(vertex_array)
 
     mesh_info_ptr = c_void_p(0)
     error_code = HFPython.StoreMesh(
@@ -50,6 +50,19 @@ class NativeNumpyLike(object):
         """
         return (self.vector_pointer, self.data_pointer)
 
+    def __array__(self, dtype=None, copy=None):
+        """ Let numpy functions use this as an array without copying it.
+
+        Note:
+            Arrays created this way still point to memory owned by C++, so they
+            must not outlive this object.
+        """
+        if copy:
+            return numpy.array(self.array, dtype=dtype, copy=True)
+        if dtype is None:
+            return self.array
+        return self.array.astype(dtype, copy=False)
+
     def __getitem__(self, key):
         return self.array[key]
 
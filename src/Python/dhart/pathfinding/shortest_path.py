@@ -29,6 +29,10 @@ def ConvertNodesToIds(graph: Graph, nodes: List[Union[Tuple, int]]) -> List[int]
             a valid node in Graph. 
     """
 
+    # Numpy arrays of IDs are passed to C++ as is
+    if isinstance(nodes, numpy.ndarray) and numpy.issubdtype(nodes.dtype, numpy.integer):
+        return nodes.reshape(-1)
+
     # If nodes is a single element, make it a list.
     if not isinstance(nodes, List):
         nodes = [nodes]
@@ -214,6 +214,9 @@ def IntersectForPoint(
     Returns:
         List: an ordered list containing None where rays did not intersect any geometry
             and tuples of 3 floats where the rays did intersect geometry
+        numpy.ndarray: If the list of origins or directions was an (n, 3) numpy array, an
+            (n, 3) array of hit points instead, with NaN for rays that didn't hit. Numpy
+            arrays of float32 are passed to C++ without being copied.
     Raises:
         TypeError : When the passed BVH is invalid
 
@@ -238,7 +241,7 @@ def IntersectForPoint(
     direction = None
 
     # Check if origins is a list
-    if isinstance(origins, list):
+    if isinstance(origins, list) or (isinstance(origins, numpy.ndarray) and origins.ndim == 2):
         # If origin only has a single element then just take the first
         # value and act as if it was a single instance
         if len(origins) == 1:
@@ -249,7 +252,7 @@ def IntersectForPoint(
         origin = origins
 
     # Check if Directions is a list
-    if isinstance(directions, list):
+    if isinstance(directions, list) or (isinstance(directions, numpy.ndarray) and directions.ndim == 2):
         # If directions only has a single element then just take the first
         # value and act as if it was a single instance
         if len(directions) == 1:
@@ -296,7 +299,8 @@ def IntersectOccluded(
     Returns:
         List[bool] or bool : an ordered list of booleans where true indicates a
             hit, and false indicates a miss. If a single element is passed, only
-            bool is returned.
+            bool is returned. If origins or directions is a numpy array, a numpy
+            array of bools is returned instead of a list.
     
     Args:
         origins : A list of origin points, or a single origin point
@@ -324,7 +328,10 @@ def IntersectOccluded(
     """
     isValidBVH(bvh)
 
-    if len(origins) == 1 or not isinstance(origins, List):
+    # Numpy arrays are passed straight through, whatever their shape
+    if isinstance(origins, numpy.ndarray):
+        pass
+    elif len(origins) == 1 or not isinstance(origins, List):
         origins = (origins[0], origins[1], origins[2])
 
     res = raytracer_native_functions.CastOcclusionRays(
@@ -1,4 +1,5 @@
 from ctypes import *
+import numpy
 from dhart.Exceptions import *
 from dhart.common_native_functions import (
     getDLLHandle,
@@ -9,6 +10,37 @@ from typing import *
 HFPython = getDLLHandle()
 
 
+def ConvertHitsToPoints(
+    points: Array,
+    hits: Array,
+    as_numpy: bool
+) -> Union[List[Union[Tuple[float, float, float], None]], numpy.ndarray]:
+    """ Read the results of a raycast that wrote its hit points into points
+
+    Args:
+        points: The flat array of points that C++ overwrote with hit points
+        hits: An array of bools indicating whether each ray hit
+        as_numpy: Return a numpy array instead of a list
+
+    Returns:
+        numpy.ndarray: If as_numpy is true, an (n, 3) array of hit points that
+            shares memory with points. Rows for rays that missed are NaN.
+        List: Otherwise, an ordered list containing None for misses and a tuple
+            for every hit point
+    """
+    point_array = numpy.ctypeslib.as_array(points).reshape(-1, 3)
+    hit_array = numpy.ctypeslib.as_array(hits)
+
+    if as_numpy:
+        point_array[~hit_array] = numpy.nan
+        return point_array
+
+    return [
+        tuple(point) if hit else None
+        for point, hit in zip(point_array.tolist(), hit_array.tolist())
+    ]
+
+
 def CreateRayTracer(mesh_info_ptr: Union[c_void_p, List[c_void_p]], use_precise: bool) -> c_void_p:
     """ Create a raytracer from a pointer to valid meshinfo previously created by CreateOBJ
 
@@ -31,11 +63,9 @@ def CreateRayTracer(mesh_info_ptr: Union[c_void_p, List[c_void_p]], use_precise:
     # If this is a list, call the multi-mesh version
     else:
         
-        # Create an array of c_void_p and fill it with values from input array
+        # Create an array of c_void_p from the input array
         num_ptrs = len(mesh_info_ptr)
-        meshinfo_ptrs = (c_void_p * len(mesh_info_ptr))()
-        for i in range(0, num_ptrs):
-            meshinfo_ptrs[i] = mesh_info_ptr[i]
+        meshinfo_ptrs = (c_void_p * num_ptrs)(*mesh_info_ptr)
 
         # Create the raytracer
         error_code = HFPython.CreateRaytracerMultiMesh(
@@ -96,12 +126,13 @@ def CastMultipleRays(
         List: an ordered list of results containing None for misses and hitpoints for hits
     """
 
-    num_rays = len(origin)
-
-    origin_array = ConvertPointsToArray(origin)
+    # Hit points are written into origin_array, so it must not share memory
+    # with the caller's origins
+    origin_array = ConvertPointsToArray(origin, copy=True)
     direction_array = ConvertPointsToArray(direction)
+    num_rays = len(origin_array) // 3
 
-    result_array_type = c_bool * len(origin)
+    result_array_type = c_bool * num_rays
     result_array = result_array_type()
 
     HFPython.CastMultipleRays(
@@ -113,20 +144,9 @@ def CastMultipleRays(
         byref(result_array),
     )
 
-    return_array = [None] * num_rays
-    print(result_array[1])
-    for i in range(0, len(origin)):
-        if not result_array[i]:
-            return_array[i] = None
-        else:
-            offset = 3 * i
-            return_array[i] = (
-                origin_array[offset],
-                origin_array[offset + 1],
-                origin_array[offset + 2],
-            )
-
-    return return_array
+    return ConvertHitsToPoints(
+        origin_array, result_array, isinstance(origin, numpy.ndarray)
+    )
 
 
 def CastOneOriginMultipleDirections(
@@ -141,9 +161,10 @@ def CastOneOriginMultipleDirections(
         List: an ordered list of hitspoints or None
     """
 
-    num_rays = len(direction)
-    direction_array = ConvertPointsToArray(direction)
+    # Hit points are written into direction_array
+    direction_array = ConvertPointsToArray(direction, copy=True)
     origin_array = ConvertPointsToArray(origin)
+    num_rays = len(direction_array) // 3
 
     result_array_type = c_bool * num_rays
     result_array = result_array_type()
@@ -157,19 +178,9 @@ def CastOneOriginMultipleDirections(
         byref(result_array),
     )
 
-    return_array = [None] * num_rays
-    for i in range(0, num_rays):
-        if not result_array[i]:
-            return_array[i] = None
-        else:
-            offset = 3 * i
-            return_array[i] = (
-                direction_array[offset],
-                direction_array[offset + 1],
-                direction_array[offset + 2],
-            )
-
-    return return_array
+    return ConvertHitsToPoints(
+        direction_array, result_array, isinstance(direction, numpy.ndarray)
+    )
 
 
 def CastMultipleOriginsOneDirection(
@@ -180,9 +191,10 @@ def CastMultipleOriginsOneDirection(
 ) -> List[Union[Tuple[float, float, float], None]]:
     """ Cast multiple rays in the same direction """
 
-    num_rays = len(origin)
+    # Hit points are written into origin_array
     direction_array = ConvertPointsToArray(direction)
-    origin_array = ConvertPointsToArray(origin)
+    origin_array = ConvertPointsToArray(origin, copy=True)
+    num_rays = len(origin_array) // 3
 
     result_array_type = c_bool * num_rays
     result_array = result_array_type()
@@ -196,19 +208,9 @@ def CastMultipleOriginsOneDirection(
         byref(result_array),
     )
 
-    return_array = [None] * num_rays
-    for i in range(0, num_rays):
-        if not result_array[i]:
-            return_array[i] = None
-        else:
-            offset = 3 * i
-            return_array[i] = (
-                origin_array[offset],
-                origin_array[offset + 1],
-                origin_array[offset + 2],
-            )
-
-    return return_array
+    return ConvertHitsToPoints(
+        origin_array, result_array, isinstance(origin, numpy.ndarray)
+    )
 
 
 def CastOcclusionRays(
@@ -217,19 +219,16 @@ def CastOcclusionRays(
     direction: Union[Tuple[float, float, float], List[Tuple[float, float, float]]],
     max_distance: float,
 ) -> List[bool]:
-    """ Cast one or more Occlusion Rays """
-    if isinstance(origin, tuple):
-        num_origins = 1
-    else:
-        num_origins = len(origin)
-
-    if isinstance(direction, tuple):
-        num_directions = 1
-    else:
-        num_directions = len(direction)
+    """ Cast one or more Occlusion Rays
 
+    Returns:
+        A numpy array of bools if origin or direction was a numpy array,
+        otherwise a list of bools
+    """
     origin_array = ConvertPointsToArray(origin)
     direction_array = ConvertPointsToArray(direction)
+    num_origins = len(origin_array) // 3
+    num_directions = len(direction_array) // 3
 
     result_size = max(num_directions, num_origins)
     result_array_type = c_bool * result_size
@@ -245,11 +244,11 @@ def CastOcclusionRays(
         result_array,
     )
 
-    return_array = [False] * result_size
-    for i in range(0, result_size):
-        return_array[i] = result_array[i]
+    hits = numpy.ctypeslib.as_array(result_array)
+    if isinstance(origin, numpy.ndarray) or isinstance(direction, numpy.ndarray):
+        return hits
 
-    return return_array
+    return hits.tolist()
 
 
 def CastRaySingleDistance(
@@ -341,11 +340,9 @@ def C_AddMeshes(bvh_ptr: c_void_p, mesh_ptrs : List[c_void_p]):
         bvh_ptr (c_void_p): Pointer to the raytracer to add meshes to
         mesh_ptrs (List[c_void_p]): Pointers to MeshInfos to add to the bvh
     """
-    # Create a ctypes array of pointers and insert thes epointersj
+    # Create a ctypes array of pointers from mesh_ptrs
     num_meshes = len(mesh_ptrs)
-    pointer_array = (c_void_p * num_meshes)()
-    for i in range(0, num_meshes):
-        pointer_array[i] = mesh_ptrs[i]
+    pointer_array = (c_void_p * num_meshes)(*mesh_ptrs)
 
     # Call C++ function to add the meshinfos
     HFPython.AddMeshes(bvh_ptr, pointer_array, c_int(num_meshes))
@@ -5,6 +5,7 @@ from dhart.raytracer import EmbreeBVH
 from dhart.raytracer.embree_raytracer import *
 
 from time import time
+import numpy
 
 import dhart
 # Setup
@@ -235,3 +236,38 @@ def test_addmeshestobvh():
     # Add every mesh in sponza. This should still intersect.
     BVH.AddMesh(objs_to_add)
     assert IntersectOccluded(BVH, (0, 0, 1), (0, 0, -1), -1)
+
+def test_IntersectForPointWithNumpy():
+    plane = LoadOBJ(dhart.get_sample_model("plane.obj"), rotation=CommonRotations.Yup_to_Zup)
+    bvh = EmbreeBVH(plane)
+
+    # Every other ray points away from the plane
+    origins = numpy.zeros((1000, 3), dtype=numpy.float32)
+    origins[:, 2] = 1
+    directions = numpy.zeros((1000, 3), dtype=numpy.float32)
+    directions[:, 2] = -1
+    directions[1::2, 2] = 1
+
+    hits = IntersectForPoint(bvh, origins, directions, -1)
+
+    # The caller's arrays must not be overwritten with the results
+    assert isinstance(hits, numpy.ndarray)
+    assert hits.shape == (1000, 3)
+    assert numpy.all(origins[:, 2] == 1)
+    assert numpy.allclose(hits[0::2, 2], 0, atol=0.0001)
+    assert numpy.all(numpy.isnan(hits[1::2]))
+
+    # Lists still return lists
+    list_hits = IntersectForPoint(bvh, origins[:4].tolist(), directions[:4].tolist(), -1)
+    assert list_hits[1] is None
+    assert abs(list_hits[0][2]) < 0.0001
+
+def test_IntersectOccludedWithNumpy():
+    plane = LoadOBJ(dhart.get_sample_model("plane.obj"), rotation=CommonRotations.Yup_to_Zup)
+    bvh = EmbreeBVH(plane)
+
+    origins = numpy.array([(0, 0, 1), (0, 0, -1), (1, 1, 1)], dtype=numpy.float32)
+    hits = IntersectOccluded(bvh, origins, (0, 0, -1), -1)
+
+    assert isinstance(hits, numpy.ndarray)
+    assert hits.tolist() == [True, False, True]
@@ -38,13 +38,26 @@ class NodeList(NativeNumpyLike):
 
 
 def CreateListOfNodeStructs(points: Tuple[float, float, float]) -> numpy.array:
-    """ Create an array of NodeStructs from a list of tuples. """
-    arr = numpy.empty((len(points),), dtype=NodeStruct)
-    for i in range(0, len(points)):
-        arr[i][0] = points[i][0]
-        arr[i][1] = points[i][1]
-        arr[i][2] = points[i][2]
-        arr[i][3] = 0
-        arr[i][4] = -1
+    """ Create an array of NodeStructs from a list of tuples.
+
+    Args:
+        points: A list of points, an (n, 3) numpy array, or an array of
+            NodeStructs such as a NodeList. Arrays of NodeStructs are
+            returned without being copied.
+    """
+    # Nodes from C++ are already in the right layout
+    as_array = numpy.asarray(points)
+    if as_array.dtype == numpy.dtype(NodeStruct) and as_array.flags.c_contiguous:
+        return as_array
+
+    coordinates = as_array.reshape(-1, 3) if as_array.dtype.names is None \
+        else numpy.stack([as_array[name] for name in as_array.dtype.names[:3]], axis=-1)
+
+    arr = numpy.empty((len(coordinates),), dtype=NodeStruct)
+    arr["x"] = coordinates[:, 0]
+    arr["y"] = coordinates[:, 1]
+    arr["z"] = coordinates[:, 2]
+    arr["type"] = 0
+    arr["id"] = -1
 
     return arr
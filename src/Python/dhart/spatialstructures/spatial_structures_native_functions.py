@@ -92,9 +92,10 @@ def C_CreateGraph(nodes: Union[List[Tuple[float, float, float]], None]) -> c_voi
     Returns:
         c_void_p: A pointer to the underlying graph object in C++
     """
-    if nodes:
-        num_nodes = len(nodes)
+    # Numpy arrays can't be used as a bool, so check the length instead
+    if nodes is not None and len(nodes) > 0:
         node_float_ptr = ConvertPointsToArray(nodes)
+        num_nodes = len(node_float_ptr) // 3
     else:
         node_float_ptr = c_void_p()
         num_nodes = 0